@@ -69,16 +69,30 @@ int main(int argc, char** argv)
     bool use_range(false);
     bool validate(false);
     bool showvariables(false);
-    const char* options = "hj:o:r:lva";
+    bool memoryreport(false);
+    std::string capture;
+    std::string replay;
+    bool freewheel(false);
+    const char* options = "hj:o:r:lvamc:p:f";
     struct option long_options[] = {
         {"help", 0, 0, 'h'},      {"jackname", 1, 0, 'j'},
         {"output", 1, 0, 'o'},    {"range", 1, 0, 'r'},
         {"licenses", 0, 0, 'l'},  {"validate", 0, 0, 'v'},
-        {"variables", 0, 0, 'a'}, {0, 0, 0, 0}};
+        {"variables", 0, 0, 'a'}, {"memoryreport", 0, 0, 'm'},
+        {"capture", 1, 0, 'c'},   {"replay", 1, 0, 'p'},
+        {"freewheel", 0, 0, 'f'}, {0, 0, 0, 0}};
     std::map<std::string, std::string> helpmap;
     helpmap["output"] = "Output sound file name.";
     helpmap["licenses"] = "Show licenses";
     helpmap["variables"] = "Show variables";
+    helpmap["memoryreport"] =
+        "Start the session, show memory usage of scenes and exit";
+    helpmap["capture"] =
+        "Record all incoming OSC messages with frame time to a log file.";
+    helpmap["replay"] = "Replay OSC messages from a log file. With output "
+                        "file, the replay is synchronized to the transport.";
+    helpmap["freewheel"] =
+        "Render output file in freewheeling mode, i.e., as fast as possible.";
     int opt(0);
     int option_index(0);
     while((opt = getopt_long(argc, argv, options, long_options,
@@ -103,6 +117,18 @@ int main(int argc, char** argv)
       case 'v':
         validate = true;
         break;
+      case 'm':
+        memoryreport = true;
+        break;
+      case 'c':
+        capture = optarg;
+        break;
+      case 'p':
+        replay = optarg;
+        break;
+      case 'f':
+        freewheel = true;
+        break;
       case 'r':
         range = optarg;
         use_range = true;
@@ -120,6 +146,12 @@ int main(int argc, char** argv)
     std::thread closestdinthread;
     if(showvariables)
       std::cout << session.list_variables();
+    if(memoryreport) {
+      session.start();
+      std::cout << session.memory_report();
+      session.stop();
+      return 0;
+    }
     if(validate) {
       session.start();
       sleep(1);
@@ -147,7 +179,11 @@ int main(int argc, char** argv)
         std::cout << session.ranges[k]->name << std::endl;
       return 0;
     }
+    if(!capture.empty())
+      session.start_capture(capture);
     if(output.empty()) {
+      if(!replay.empty())
+        session.start_replay(replay);
       session.run(b_quit, false);
     } else {
       double t_start(0);
@@ -169,17 +205,31 @@ int main(int argc, char** argv)
                 << " seconds to \"" << output << "\":" << std::endl;
       for(uint32_t k = 0; k < ports.size(); k++)
         std::cout << k << " " << ports[k] << std::endl;
-      jackio_t* iow(
-          new jackio_t(t_dur, output, ports, session.name + "jackio"));
+      jackio_t* iow(new jackio_t(t_dur, output, ports, session.name + "jackio",
+                                 freewheel));
       iow->set_transport_start(t_start, false);
+      if(!replay.empty())
+        session.start_replay(replay, true);
+      TASCAR::tictoc_t tictoc;
       iow->run();
+      double t_render(tictoc.toc());
       std::cout << iow->get_xruns()
                 << " xruns (total latency: " << iow->get_xrun_latency() << ")"
                 << std::endl;
+      std::cout << "Rendering took " << t_render << " s (" << t_dur / t_render
+                << " times real time)." << std::endl;
+      if(!replay.empty())
+        std::cout << session.get_replay_remaining()
+                  << " replayed OSC messages were not dispatched." << std::endl;
       delete iow;
       sleep(1);
       session.stop();
     }
+    if(!capture.empty()) {
+      std::cout << "Captured " << session.get_capture_size()
+                << " OSC messages." << std::endl;
+      session.stop_capture();
+    }
   }
   catch(const std::exception& msg) {
     std::cerr << "Error: " << msg.what() << std::endl;
@@ -74,6 +74,8 @@ App::pdf_export_t::pdf_export_t(const std::string& session_filename,
       tmargin(72 * 18 / 25.4), bmargin(72 * 12 / 25.4),
       surface(Cairo::PdfSurface::create(pdfname, width, height))
 {
+  // keep vector output:
+  drawer.set_retained(false);
   read_xml();
 }
 
@@ -38,9 +38,10 @@ int main(int argc, char** argv)
     uint32_t ism_max(-1);
     bool b_verbose(false);
     uint32_t inchannel(0);
+    bool b_sparse(false);
     std::string scene;
     std::string schmap;
-    const char* options = "hs:o:t:l:f:0:1:4vi:";
+    const char* options = "hs:o:t:l:f:0:1:4vi:p";
     struct option long_options[] = {{"help", 0, 0, 'h'},
                                     {"scene", 1, 0, 's'},
                                     {"outputfile", 1, 0, 'o'},
@@ -51,6 +52,7 @@ int main(int argc, char** argv)
                                     {"ismmax", 1, 0, '1'},
                                     {"inchannel", 1, 0, 'i'},
                                     {"verbose", 0, 0, 'v'},
+                                    {"sparse", 0, 0, 'p'},
                                     {0, 0, 0, 0}};
     std::map<std::string, std::string> helpmap;
     helpmap["scene"] = "Scene name, or empty to select first scene.";
@@ -67,6 +69,15 @@ int main(int argc, char** argv)
         "Input channel number. This defines from which sound vertex the IR is "
         "measured. Sound vertices are numbered in the order of their "
         "appearance in the session file, starting with zero.";
+    helpmap["sparse"] =
+        "Synthesize the impulse response from the list of sound paths "
+        "instead of processing an impulse by the complete signal chain. "
+        "This is much faster for long impulse responses and high image "
+        "source orders of static scenes. Only the sound paths of point "
+        "sources are synthesized; diffuse sound fields are not rendered. "
+        "Scenes with diffuse reverbs (e.g., feedback delay networks) or "
+        "source clustering are processed by the complete signal chain "
+        "instead.";
     helpmap["channelmap"] =
         "List of output channels (zero-base), or empty to use all.\n"
         "Example: -m 0-5,8,12";
@@ -107,6 +118,9 @@ int main(int argc, char** argv)
       case 'v':
         b_verbose = true;
         break;
+      case 'p':
+        b_sparse = true;
+        break;
       case 'm':
         schmap = optarg;
         break;
@@ -150,7 +164,13 @@ int main(int argc, char** argv)
     r.set_channelmap(chmap);
     if(ism_max != (uint32_t)(-1))
       r.set_ism_order_range(ism_min, ism_max);
+    r.set_sparse_ir(b_sparse);
     r.render_ir(irlen, fs, current_path + out_fname, starttime, inchannel);
+    if(b_verbose)
+      std::cerr << "render time: " << (double)(r.t2 - r.t1) / CLOCKS_PER_SEC
+                << " s\n";
+    for(auto warn : TASCAR::get_warnings())
+      std::cerr << "Warning: " << warn << std::endl;
 #ifndef TSCDEBUG
   }
   catch(const std::exception& msg) {
@@ -0,0 +1,153 @@
+/*
+ * This file is part of the TASCAR software, see <http://tascar.org/>
+ *
+ * Copyright (c) 2026 agent
+ */
+/*
+ * TASCAR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, version 3 of the License.
+ *
+ * TASCAR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHATABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License, version 3 for more details.
+ *
+ * You should have received a copy of the GNU General Public License,
+ * Version 3 along with TASCAR. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "binarytrack.h"
+#include "cli.h"
+#include "dynamicobjects.h"
+#include "errorhandling.h"
+#include <algorithm>
+#include <fstream>
+#include <getopt.h>
+#include <iostream>
+#include <numeric>
+
+namespace {
+
+  /**
+     Read CSV file with time and three coordinates per line. Lines
+     are sorted by time, for duplicate time stamps the last line is
+     used.
+   */
+  void read_csv(const std::string& fname, std::vector<double>& t,
+                std::vector<double>& v)
+  {
+    std::ifstream fh(TASCAR::env_expand(fname));
+    if(fh.fail())
+      throw TASCAR::ErrMsg("Unable to open track csv file \"" + fname + "\".");
+    std::vector<double> rt;
+    std::vector<double> rv;
+    std::string line;
+    while(std::getline(fh, line)) {
+      auto vals(TASCAR::str2vecstr(line, ","));
+      if(vals.size() == 4) {
+        rt.push_back(atof(vals[0].c_str()));
+        for(size_t k = 1; k < 4; ++k)
+          rv.push_back(atof(vals[k].c_str()));
+      }
+    }
+    std::vector<size_t> idx(rt.size());
+    std::iota(idx.begin(), idx.end(), 0u);
+    std::stable_sort(idx.begin(), idx.end(),
+                     [&rt](size_t a, size_t b) { return rt[a] < rt[b]; });
+    t.clear();
+    v.clear();
+    for(auto k : idx) {
+      if(t.size() && (t.back() == rt[k])) {
+        t.pop_back();
+        v.resize(v.size() - 3);
+      }
+      t.push_back(rt[k]);
+      v.insert(v.end(), rv.begin() + 3 * k, rv.begin() + 3 * k + 3);
+    }
+  }
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+  double geo_lon(0);
+  double geo_lat(0);
+  bool orientation(false);
+  const char* options = "hr";
+  struct option long_options[] = {{"help", 0, 0, 'h'},
+                                  {"orientation", 0, 0, 'r'},
+                                  {"lon", 1, 0, 'o'},
+                                  {"lat", 1, 0, 'a'},
+                                  {0, 0, 0, 0}};
+  const std::string help(
+      "Convert a position track (CSV file with time, x, y, z, or GPX file)\n"
+      "or an orientation track (CSV file with time, z, y, x in degrees)\n"
+      "into a binary track file for the 'importbin' attribute.");
+  int opt(0);
+  int option_index(0);
+  while((opt = getopt_long(argc, argv, options, long_options, &option_index)) !=
+        -1) {
+    switch(opt) {
+    case 'h':
+      TASCAR::app_usage("tascar_track2bin", long_options, "input output",
+                        help);
+      return 0;
+    case 'r':
+      orientation = true;
+      break;
+    case 'o':
+      geo_lon = atof(optarg);
+      break;
+    case 'a':
+      geo_lat = atof(optarg);
+      break;
+    }
+  }
+  if(optind + 2 != argc) {
+    TASCAR::app_usage("tascar_track2bin", long_options, "input output", help);
+    return 1;
+  }
+  std::string infile(argv[optind]);
+  std::string outfile(argv[optind + 1]);
+  std::vector<double> t;
+  std::vector<double> v;
+  if((infile.size() > 4) && (infile.substr(infile.size() - 4) == ".gpx")) {
+    if(orientation)
+      throw TASCAR::ErrMsg("GPX files contain no orientation.");
+    TASCAR::track_t track;
+    track.load_from_gpx(infile);
+    if((geo_lon != 0) || (geo_lat != 0)) {
+      TASCAR::pos_t p;
+      p.set_sphere(R_EARTH, DEG2RAD * geo_lon, DEG2RAD * geo_lat);
+      track.project_tangent(p);
+    }
+    for(auto& p : track) {
+      t.push_back(p.first);
+      v.push_back(p.second.x);
+      v.push_back(p.second.y);
+      v.push_back(p.second.z);
+    }
+  } else {
+    read_csv(infile, t, v);
+    if(orientation)
+      for(auto& x : v)
+        x *= DEG2RAD;
+  }
+  TASCAR::binary_track_t::write(outfile,
+                                orientation
+                                    ? TASCAR::binary_track_t::orientation
+                                    : TASCAR::binary_track_t::position,
+                                t, v);
+  std::cerr << "Wrote " << t.size() << " points to " << outfile << ".\n";
+  return 0;
+}
+
+/*
+ * Local Variables:
+ * mode: c++
+ * c-basic-offset: 2
+ * indent-tabs-mode: nil
+ * compile-command: "make -C .."
+ * End:
+ */
@@ -0,0 +1,133 @@
+/*
+ * This file is part of the TASCAR software, see <http://tascar.org/>
+ *
+ * Copyright (c) 2026 agent
+ */
+/*
+ * TASCAR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, version 3 of the License.
+ *
+ * TASCAR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHATABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License, version 3 for more details.
+ *
+ * You should have received a copy of the GNU General Public License,
+ * Version 3 along with TASCAR. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+  Benchmark of delay lines with large maximum distance, with single
+  and half precision storage: Memory, processing time and hardware
+  cache misses of one second of audio.
+
+  Usage: test_delayline [nlines [maxdist]]
+ */
+
+#include "delayline.h"
+#include <chrono>
+#include <iostream>
+#include <string.h>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/// Hardware cache miss counter of calling thread, if available
+class cache_misses_t {
+public:
+  cache_misses_t()
+  {
+#ifdef __linux__
+    struct perf_event_attr pe;
+    memset(&pe, 0, sizeof(pe));
+    pe.type = PERF_TYPE_HARDWARE;
+    pe.size = sizeof(pe);
+    pe.config = PERF_COUNT_HW_CACHE_MISSES;
+    pe.disabled = 1;
+    pe.exclude_kernel = 1;
+    pe.exclude_hv = 1;
+    fd = (int)syscall(__NR_perf_event_open, &pe, 0, -1, -1, 0);
+    if(fd >= 0) {
+      ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+      ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+  };
+  ~cache_misses_t()
+  {
+#ifdef __linux__
+    if(fd >= 0)
+      close(fd);
+#endif
+  };
+  /// Number of cache misses since construction, or -1 if not available
+  int64_t get()
+  {
+    int64_t count(-1);
+#ifdef __linux__
+    if((fd < 0) || (read(fd, &count, sizeof(count)) != sizeof(count)))
+      count = -1;
+#endif
+    return count;
+  };
+
+private:
+  int fd = -1;
+};
+
+int main(int argc, char** argv)
+{
+  // 64 sources with default maximum distance of 3700 m:
+  uint32_t nlines(64);
+  float maxdist(3700.0f);
+  if(argc > 1)
+    nlines = atoi(argv[1]);
+  if(argc > 2)
+    maxdist = atof(argv[2]);
+  const float fs(48000.0f);
+  const float c(340.0f);
+  const uint32_t maxdelay((uint32_t)(maxdist / c * fs));
+  for(auto storage :
+      {TASCAR::varidelay_t::float32, TASCAR::varidelay_t::float16}) {
+    std::vector<TASCAR::varidelay_t> lines(
+        nlines, TASCAR::varidelay_t(maxdelay, fs, c, 3, 64, storage));
+    size_t bytes(0);
+    for(auto& line : lines)
+      bytes += line.get_num_bytes();
+    float sum(0.0f);
+    cache_misses_t misses;
+    auto t0(std::chrono::steady_clock::now());
+    // one second of audio, reading from the most recent 0.5 s:
+    for(uint32_t k = 0; k < 48000; ++k)
+      for(uint32_t kl = 0; kl < nlines; ++kl)
+        sum += lines[kl].get_dist_push(100.0f + 2.0f * kl + 1e-3f * k,
+                                       1e-3f * (float)(k % 100));
+    double t(std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                           t0)
+                 .count());
+    int64_t nmisses(misses.get());
+    std::cout << ((storage == TASCAR::varidelay_t::float16) ? "half "
+                                                            : "float ")
+              << bytes / 1048576 << " MB, " << t * 1000.0 << " ms, ";
+    if(nmisses >= 0)
+      std::cout << nmisses << " cache misses";
+    else
+      std::cout << "cache misses n/a";
+    // print the sum, to keep the loop from being optimized away:
+    std::cout << " (" << sum << ")" << std::endl;
+  }
+  return 0;
+}
+
+/*
+ * Local Variables:
+ * mode: c++
+ * c-basic-offset: 2
+ * indent-tabs-mode: nil
+ * compile-command: "make -C .."
+ * End:
+ */
@@ -0,0 +1,155 @@
+/*
+ * This file is part of the TASCAR software, see <http://tascar.org/>
+ *
+ * Copyright (c) 2026 agent
+ */
+/*
+ * TASCAR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, version 3 of the License.
+ *
+ * TASCAR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHATABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License, version 3 for more details.
+ *
+ * You should have received a copy of the GNU General Public License,
+ * Version 3 along with TASCAR. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+  Frame time benchmark of the scene view: a synthetic scene with long
+  trajectories, a large face group and image sources is drawn into an
+  offscreen surface, with and without retained-mode rendering.
+
+  Usage: test_drawscene [nsrc [nfaces [nframes]]]
+ */
+
+#include "gui_elements.h"
+#include "tictoctimer.h"
+#include <sstream>
+
+std::string create_scene(uint32_t nsrc, uint32_t nfaces)
+{
+  std::stringstream xml;
+  xml << "<session><scene name=\"bench\" guiscale=\"40\">\n";
+  for(uint32_t s = 0; s < nsrc; ++s) {
+    // trajectory with 1 point per 10 ms and 60 seconds:
+    xml << "<source name=\"src" << s << "\"><position>";
+    for(uint32_t k = 0; k < 6000; ++k) {
+      double t(0.01 * k);
+      double a(TASCAR_2PI * (0.01 * t + (double)s / nsrc));
+      double r(4.0 + 0.1 * s + 0.5 * sin(TASCAR_2PI * 0.2 * t));
+      xml << t << " " << r * cos(a) << " " << r * sin(a) << " 0 ";
+    }
+    xml << "</position><sound/></source>\n";
+  }
+  // face group, a cylindrical wall segmented into small faces:
+  xml << "<facegroup name=\"walls\" reflectivity=\"0.8\"><faces>\n";
+  for(uint32_t k = 0; k < nfaces; ++k) {
+    double a1(TASCAR_2PI * k / nfaces);
+    double a2(TASCAR_2PI * (k + 1) / nfaces);
+    double r(20.0);
+    xml << r * cos(a1) << " " << r * sin(a1) << " 0 " << r * cos(a2) << " "
+        << r * sin(a2) << " 0 " << r * cos(a2) << " " << r * sin(a2) << " 3 "
+        << r * cos(a1) << " " << r * sin(a1) << " 3\n";
+  }
+  xml << "</faces></facegroup>\n";
+  xml << "<facegroup name=\"room\" shoebox=\"30 30 4\" "
+         "reflectivity=\"0.8\"/>\n";
+  xml << "<receiver name=\"out\" type=\"omni\" ismmax=\"1\"/>\n";
+  xml << "</scene></session>\n";
+  return xml.str();
+}
+
+int main(int argc, char** argv)
+{
+  uint32_t nsrc(32);
+  uint32_t nfaces(2000);
+  uint32_t nframes(50);
+  if(argc > 1)
+    nsrc = atoi(argv[1]);
+  if(argc > 2)
+    nfaces = atoi(argv[2]);
+  if(argc > 3)
+    nframes = atoi(argv[3]);
+  TASCAR::xml_doc_t doc(create_scene(nsrc, nfaces),
+                        TASCAR::xml_doc_t::LOAD_STRING);
+  std::vector<tsccfg::node_t> scenes(
+      tsccfg::node_get_children(doc.root(), "scene"));
+  TASCAR::render_core_t scene(scenes[0]);
+  chunk_cfg_t cf(44100, 64, 1);
+  scene.prepare(cf);
+  scene.post_prepare();
+  std::vector<float*> a_in;
+  for(uint32_t k = 0; k < scene.num_input_ports(); ++k)
+    a_in.push_back(new float[cf.n_fragment]());
+  std::vector<float*> a_out;
+  for(uint32_t k = 0; k < scene.num_output_ports(); ++k)
+    a_out.push_back(new float[cf.n_fragment]());
+  const int width(1280);
+  const int height(800);
+  Cairo::RefPtr<Cairo::ImageSurface> surface(
+      Cairo::ImageSurface::create(Cairo::FORMAT_ARGB32, width, height));
+  for(bool acmodel : {false, true})
+    for(bool retained : {false, true}) {
+      TSCGUI::scene_draw_t drawer;
+      drawer.set_scene(&scene);
+      drawer.set_viewport(TSCGUI::scene_draw_t::xy);
+      drawer.view.set_scale(scene.guiscale);
+      drawer.set_show_acoustic_model(acmodel);
+      drawer.set_retained(retained);
+      TASCAR::transport_t tp;
+      tp.rolling = true;
+      TASCAR::tictoc_t tictoc;
+      double t_draw(0.0);
+      for(uint32_t frame = 0; frame < nframes; ++frame) {
+        // advance the scene by one GUI frame of 40 ms:
+        tp.session_time_seconds = 0.04 * frame;
+        tp.session_time_samples = cf.f_sample * tp.session_time_seconds;
+        tp.object_time_seconds = tp.session_time_seconds;
+        tp.object_time_samples = tp.session_time_samples;
+        scene.process(cf.n_fragment, tp, a_in, a_out);
+        drawer.set_time(tp.session_time_seconds);
+        tictoc.tic();
+        Cairo::RefPtr<Cairo::Context> cr(Cairo::Context::create(surface));
+        cr->rectangle(0, 0, width, height);
+        cr->clip();
+        cr->save();
+        cr->set_source_rgb(1, 1, 1);
+        cr->paint();
+        cr->restore();
+        // same transformation as in the scene view of the main window:
+        double wscale(0.5 * std::max(height, width));
+        double markersize(5.0 / wscale);
+        cr->translate(0.5 * width, 0.5 * height);
+        cr->scale(wscale, wscale);
+        cr->set_line_width(0.3 * markersize);
+        cr->set_font_size(3 * markersize);
+        drawer.set_markersize(markersize);
+        drawer.draw(cr);
+        surface->flush();
+        t_draw += tictoc.toc();
+      }
+      std::cout << (acmodel ? "acoustic model, " : "tracks, ")
+                << (retained ? "retained: " : "immediate: ")
+                << 1000.0 * t_draw / nframes << " ms per frame ("
+                << drawer.get_static_updates() << " static updates, " << nsrc
+                << " sources, " << nfaces << " faces)" << std::endl;
+    }
+  scene.release();
+  for(auto p : a_in)
+    delete[] p;
+  for(auto p : a_out)
+    delete[] p;
+  return 0;
+}
+
+/*
+ * Local Variables:
+ * mode: c++
+ * c-basic-offset: 2
+ * indent-tabs-mode: nil
+ * compile-command: "make -C .."
+ * End:
+ */
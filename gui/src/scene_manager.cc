@@ -19,6 +19,7 @@
  */
 
 #include "scene_manager.h"
+#include "threadrole.h"
 #include <fstream>
 #include <string.h>
 #include <fstream>
@@ -52,6 +53,8 @@ void scene_manager_t::scene_load(const std::string& fname)
   session = NULL;
   if( fname.size() ){
     session = new TASCAR::session_t( fname, TASCAR::xml_doc_t::LOAD_FILE, fname );
+    // the session configuration defines the role of the GUI thread:
+    TASCAR::register_thread(TASCAR::thread_roles_t::gui);
     try{
       session->start();
     }
@@ -329,7 +329,8 @@ bool tascar_window_t::on_timeout_statusbar()
                    "scenes: %zu  point sources: %d/%d  diffuse sound fields: "
                    "%d/%d | jack: %1.1f%% (scene \"%s\" load: %1.1f%% init: "
                    "%1.1f%%  geo: %1.1f%%  preproc: %1.1f%%  acoustic: "
-                   "%1.1f%%  postproc: %1.1f%%)",
+                   "%1.1f%%  postproc: %1.1f%%  geometry cache: %1.0f%%  "
+                   "page faults: %1.2f/%1.2f)",
                    session->scenes.size(), session->get_active_pointsources(),
                    session->get_total_pointsources(),
                    session->get_active_diffuse_sound_fields(),
@@ -339,7 +340,9 @@ bool tascar_window_t::on_timeout_statusbar()
                    100.0 * (prof.t_geo - prof.t_init),
                    100.0 * (prof.t_preproc - prof.t_geo),
                    100.0 * (prof.t_acoustics - prof.t_preproc),
-                   100.0 * (prof.t_postproc - prof.t_acoustics));
+                   100.0 * (prof.t_postproc - prof.t_acoustics),
+                   100.0 * prof.geometry_hitrate, prof.minor_faults,
+                   prof.major_faults);
         } else {
           snprintf(cmp, 1023,
                    "scenes: %ld  point sources: %d/%d  diffuse sound fields: "
@@ -205,16 +205,19 @@ bool spkeq_display_t::on_draw(const Cairo::RefPtr<Cairo::Context>& cr)
   s += " dB FS";
   cr->show_text(s.c_str());
   cr->restore();
-  // coherence
-  cr->save();
-  if(get_min(coh) < 0.75f) {
-    cr->set_source_rgb(0.8, 0, 0);
-    cr->select_font_face("", Cairo::FONT_SLANT_NORMAL, Cairo::FONT_WEIGHT_BOLD);
+  // coherence, not available in simultaneous measurements:
+  if(!coh.empty()) {
+    cr->save();
+    if(get_min(coh) < 0.75f) {
+      cr->set_source_rgb(0.8, 0, 0);
+      cr->select_font_face("", Cairo::FONT_SLANT_NORMAL,
+                           Cairo::FONT_WEIGHT_BOLD);
+    }
+    cr->move_to(405, 15);
+    s = std::string("c=") + TASCAR::to_string(coh, "%1.2f");
+    cr->show_text(s.c_str());
+    cr->restore();
   }
-  cr->move_to(405, 15);
-  s = std::string("c=") + TASCAR::to_string(coh, "%1.2f");
-  cr->show_text(s.c_str());
-  cr->restore();
   //
   if(vF.size()) {
     cr->save();
@@ -29,6 +29,7 @@
 #ifndef ACOUSTICMODEL_H
 #define ACOUSTICMODEL_H
 
+#include "arena.h"
 #include "dynamicobjects.h"
 #include "fdn.h"
 #include "levelmeter.h"
@@ -36,6 +37,8 @@
 #include "pluginprocessor.h"
 #include "receivermod.h"
 #include "sourcemod.h"
+#include <array>
+#include <limits>
 
 /*
 
@@ -171,6 +174,12 @@ namespace TASCAR {
       void release();
       virtual void process_plugins(const TASCAR::transport_t& tp);
       void add_licenses(licensehandler_t*);
+      /**
+         \brief Update version of position, orientation and of all
+         parameters which modify the result of
+         receiver_t::update_refpoint()
+      */
+      void update_geometry_version();
       uint32_t ismmin;
       uint32_t ismmax;
       uint32_t layers;
@@ -178,6 +187,8 @@ namespace TASCAR {
       float minlevel;
       float nearfieldlimit;
       uint32_t sincorder;
+      /// Sample format of delay lines of this source
+      varidelay_t::storage_t delaylinestorage = varidelay_t::float32;
       gainmodel_t gainmodel;
       bool airabsorption;
       bool delayline;
@@ -187,6 +198,11 @@ namespace TASCAR {
       std::vector<wave_t*> inchannelsp;
       bool active;
       plugin_processor_t plugins;
+      /// Version of geometry, see update_geometry_version()
+      transform_version_t geometry_version;
+
+    private:
+      std::array<float, 2> geometry_par = {};
     };
 
     /**
@@ -239,6 +255,11 @@ namespace TASCAR {
       virtual void add_variables(TASCAR::osc_server_t* srv);
       void validate_attributes(std::string& msg) const;
       void add_licenses(licensehandler_t*);
+      /**
+         \brief Update version of position, orientation and of all
+         parameters which modify the result of update_refpoint()
+      */
+      void update_geometry_version();
       // configuration/control variables:
       TASCAR::pos_t volumetric;
       bool volumetricgainwithdistance = false;
@@ -257,6 +278,12 @@ namespace TASCAR {
       float recdelaycomp = 0.0f;
       float layerfadelen = 1.0f;
       bool muteonstop = false;
+      // clustering of distant sources:
+      uint32_t clusters = 0u;
+      float clusterdist = 20.0f;
+      float clusterhysteresis = 5.0f * DEG2RADf;
+      float clusterfadelen = 0.05f;
+      float cluster_error = 0.0f;
       // scatter filter parameters:
       uint32_t scatterreflections = 0;
       float scatterspread = TASCAR_PIf * 0.125;
@@ -279,8 +306,11 @@ namespace TASCAR {
       bool gain_zero = false;
       float external_gain = 1.0f;
       const bool is_reverb;
+      /// Version of geometry, see update_geometry_version()
+      transform_version_t geometry_version;
 
     private:
+      std::array<float, 14> geometry_par = {};
       // gain state:
       float x_gain;
       // target gain:
@@ -353,6 +383,52 @@ namespace TASCAR {
       bool edgereflection;
       float scattering;
       std::string material;
+      /// Use multiband filter of material instead of first-order low-pass
+      bool multiband = false;
+      /// Multiband reflection filter design, or NULL to use low-pass
+      const TASCAR::reflectionfilter_design_t* multiband_design = NULL;
+      /// Lowest image source order at which the reflector is used
+      uint32_t minorder = 1;
+      /// Highest image source order at which the reflector is used
+      uint32_t maxorder = std::numeric_limits<uint32_t>::max();
+      bool is_used_at_order(uint32_t order) const
+      {
+        return (minorder <= order) && (order <= maxorder);
+      };
+      /// Angle tolerance of coplanarity test in rad
+      double coplanar_angle = 0.0;
+      /// Distance tolerance of coplanarity test in m
+      double coplanar_dist = 0.0;
+      /**
+         \brief Test if another reflector lies in the same plane
+
+         The faces are coplanar if their normals point into the same
+         direction and all vertices of the other face are close to
+         the plane of this face. The larger tolerances of both
+         reflectors are used. Image sources are not created from
+         consecutive reflections at coplanar faces, e.g., at a face of
+         the full mesh and a face of the reduced level-of-detail mesh
+         which replaces it.
+      */
+      bool is_coplanar(const reflector_t& other) const;
+      /**
+         \brief Owner of reflectors which move only together, e.g., a
+         face group, or NULL
+      */
+      const void* rigid_body = NULL;
+      /**
+         \brief Test if another reflector lies in the same plane for
+         the whole session
+
+         Coplanarity is evaluated only once, when the receiver graph
+         is created. It remains valid only if both reflectors belong
+         to the same rigid body, otherwise false is returned.
+      */
+      bool is_always_coplanar(const reflector_t& other) const
+      {
+        return rigid_body && (rigid_body == other.rigid_body) &&
+               is_coplanar(other);
+      };
     };
 
     /**
@@ -380,10 +456,126 @@ namespace TASCAR {
       std::vector<double>
           reflectionfilterstates; ///< Filter states for first-order reflection
                                   ///< filters
+      const TASCAR::reflectionfilter_design_t*
+          multiband_design; ///< Combined design of all multiband reflectors,
+                            ///< shared with other paths via the same
+                            ///< reflectors
+      std::vector<float> multiband_state; ///< State of multiband filter
       bool visible;
       pos_t p_cut;
     };
 
+    /**
+       \brief Perceptual clustering of distant point sources of one receiver
+
+       Point sources beyond a distance threshold are grouped by their
+       direction relative to the receiver into a bounded number of
+       clusters. The signals of all members of a cluster are mixed,
+       and each cluster is rendered as a single point source at the
+       energy-weighted mean direction and distance of its members.
+
+       Cluster centers are updated once per period (one k-means
+       iteration). A source changes to another cluster only if that
+       cluster is closer by more than the angular hysteresis, and a
+       free cluster is seeded if a source is further than twice the
+       hysteresis from all clusters. Clusters closer than the
+       hysteresis are merged. All membership changes, including the
+       transition between individual and clustered rendering, are
+       cross-faded.
+    */
+    class source_clusterer_t {
+    public:
+      /**
+         \param numclusters Maximal number of clusters
+         \param numslots Number of sources, i.e., acoustic models
+         \param chunksize Period size in samples
+         \param fs Sampling rate in Hz
+       */
+      source_clusterer_t(uint32_t numclusters, uint32_t numslots,
+                         uint32_t chunksize, float fs);
+      /**
+         \brief Start a new period, clear cluster signals
+       */
+      void clear();
+      /**
+         \brief Add a source signal to its cluster
+
+         The part of the signal which is rendered by a cluster is
+         removed from the audio chunk.
+
+         \param slot Index of source
+         \param prel Source position relative to receiver
+         \param distance Distance between source and receiver
+         \param audio Source signal, after delay, gain and air absorption
+         \return True if the remaining signal needs to be rendered
+         individually
+       */
+      bool add(uint32_t slot, const pos_t& prel, float distance, wave_t& audio);
+      /**
+         \brief Update cluster centers and error metric, after all
+         sources of the period were added
+       */
+      void update();
+      /// Number of cluster slots
+      uint32_t size() const { return (uint32_t)clusters.size(); };
+      /// True if the cluster contains signal in the current period
+      bool is_used(uint32_t c) const { return clusters[c].used; };
+      /// Position of cluster relative to receiver
+      pos_t get_position(uint32_t c) const;
+      /// Angular spread of the cluster members, in radians
+      float get_width(uint32_t c) const { return clusters[c].width; };
+      /// Mixed signal of cluster members
+      const wave_t& get_audio(uint32_t c) const { return clusters[c].audio; };
+      /// Cluster index of a source, or -1 if not clustered
+      int32_t get_cluster(uint32_t slot) const;
+      /// Number of clusters which are in use
+      uint32_t get_num_used() const;
+      /// Energy-weighted RMS angle between sources and their cluster
+      /// center, in degrees
+      float get_error() const { return error; };
+      /// Minimal distance of clustered sources, in m
+      float mindist = 20.0f;
+      /// Angular hysteresis, in radians
+      float hysteresis = 5.0f * DEG2RADf;
+      /// Duration of cross-fades, in seconds
+      float fadelen = 0.05f;
+
+    private:
+      class cluster_t {
+      public:
+        cluster_t(uint32_t chunksize) : audio(chunksize){};
+        bool active = false;
+        bool used = false;
+        pos_t center = pos_t(1, 0, 0);
+        float distance = 1.0f;
+        float width = 0.0f;
+        wave_t audio;
+        // statistics of current period:
+        pos_t sum_dir;
+        double sum_w = 0.0;
+        double sum_wd = 0.0;
+      };
+      class slot_t {
+      public:
+        bool clustered = false;
+        bool touched = false;
+        int32_t cluster = -1;
+        int32_t prev_cluster = -1;
+        // share of signal rendered by clusters:
+        float mix = 0.0f;
+        // share of current (vs. previous) cluster:
+        float xfade = 1.0f;
+        pos_t dir;
+        double w = 0.0;
+      };
+      int32_t select_cluster(const slot_t& s, const pos_t& dir,
+                             float distance);
+      float fs;
+      std::vector<cluster_t> clusters;
+      std::vector<slot_t> slots;
+      float error = 0.0f;
+    };
+
     /** \brief A model for a sound wave propagating from a point source to a
      * receiver
      *
@@ -405,6 +597,40 @@ namespace TASCAR {
        */
       uint32_t process(const TASCAR::transport_t& tp);
       float get_gain() const { return gain; };
+      /**
+         \brief Filter a period of source signal by the sound path up
+         to the delay line
+
+         Source characteristics, obstacles and reflection filters are
+         applied with the geometry of the last call of process(). Used
+         for offline impulse response synthesis, see
+         TASCAR::ir_synthesizer_t.
+
+         \return Filtered signal
+      */
+      const wave_t& process_predelay();
+      /**
+         \brief Response of delay line, gain and air absorption
+
+         The steady state of the last call of process() is used.
+
+         \param input Output of process_predelay() in consecutive periods
+         \param threshold Air absorption tails are truncated when
+         their magnitude drops below this value
+         \param maxlen Maximum length of the response in samples
+         \retval offset Time of first sample of response in samples
+         \retval h Response, or empty if the path is silent
+      */
+      void get_path_response(const std::vector<float>& input, float threshold,
+                             uint32_t maxlen, uint32_t& offset,
+                             std::vector<float>& h) const;
+      /**
+         \brief Add a chunk to the receiver, with direction, width and
+         scattering of the last call of process()
+      */
+      void add_to_receiver(const wave_t& chunk);
+      /// Memory footprint of delay line buffer in bytes
+      size_t get_delayline_bytes() const { return delayline.get_num_bytes(); };
 
     protected:
       float c_;
@@ -433,6 +659,57 @@ namespace TASCAR {
 
     public:
       uint32_t ismorder;
+      /// Clustering stage of receiver graph, or NULL
+      source_clusterer_t* clusterer = NULL;
+      /// Index of this model in clustering stage
+      uint32_t cluster_slot = 0u;
+      /// Reuse geometry of previous period if all inputs are unchanged
+      bool use_geometry_cache = true;
+      /// Geometry was evaluated in last call of process()
+      bool geometry_evaluated = false;
+      /// Geometry of last call of process() was taken from cache
+      bool geometry_cache_hit = false;
+      /**
+         \brief Last call of process() added the sound path to the
+         receiver, ignoring the minimum level of the source
+
+         Paths which are rendered by a cluster are not flagged.
+      */
+      bool rendered = false;
+
+    private:
+      /**
+         \brief Geometry of a previous period and its inputs
+
+         Inputs are the versions of source, receiver and reflector,
+         and the final position of the parent sound path.
+      */
+      class geometry_cache_t {
+      public:
+        bool valid = false;
+        uint64_t source_version = 0u;
+        uint64_t receiver_version = 0u;
+        uint64_t reflector_version = 0u;
+        bool edgereflection = false;
+        pos_t parent_position;
+        // results:
+        pos_t position;
+        float srcgainmod = 1.0f;
+        pos_t prel;
+        float distance = 0.0f;
+        float traveltime_in_m = 0.0f;
+        float gain = 0.0f;
+      };
+      bool is_geometry_unchanged() const;
+      bool read_source_and_obstacles();
+      void set_panning_hint(const pos_t& prel, float width);
+      geometry_cache_t geometry_cache;
+      // position and width of last call of add_pointsource():
+      pos_t panned_prel;
+      float panned_width = -1.0f;
+      // effective position of last call of process() which reached
+      // the receiver:
+      pos_t predelay_position;
     };
 
     /** \brief A model for a sound wave propagating from a point source to a
@@ -490,10 +767,28 @@ namespace TASCAR {
       {
         return (uint32_t)(diffuse_acoustic_model.size());
       };
+      /// Receiver of this graph
+      receiver_t* get_receiver() const { return receiver_; };
+      /// Number of bytes reserved for acoustic models
+      size_t get_arena_bytes() const { return arena.get_num_bytes(); };
       std::vector<acoustic_model_t*> acoustic_model;
       std::vector<diffuse_acoustic_model_t*> diffuse_acoustic_model;
+      /// Heap growth during creation of graph, see TASCAR::get_heap_bytes()
+      size_t heap_bytes = 0u;
       uint32_t active_pointsource;
       uint32_t active_diffuse_sound_field;
+      /// Number of acoustic models with evaluated geometry in last period
+      uint32_t geometry_evaluated = 0u;
+      /// Number of acoustic models with cached geometry in last period
+      uint32_t geometry_cache_hits = 0u;
+
+    private:
+      /// Storage of acoustic model objects, freed in one operation
+      /// (their delay lines, buffers and filters are not in the arena)
+      TASCAR::arena_t arena;
+      receiver_t* receiver_;
+      source_clusterer_t* clusterer = NULL;
+      std::vector<receivermod_base_t::data_t*> cluster_data;
     };
 
     /** \brief The render model of an acoustic scenario.
@@ -546,13 +841,25 @@ namespace TASCAR {
       {
         return total_diffuse_sound_field;
       };
+      /**
+         \brief Ratio of acoustic models which reused cached geometry
+         in last period, or zero if no geometry was evaluated
+      */
+      float get_geometry_cache_hitrate() const;
+      /// Memory footprint of all delay line buffers in bytes
+      size_t get_delayline_bytes() const;
       std::vector<receiver_graph_t*> receivergraphs;
+      std::vector<source_t*> sources_;
       std::vector<receiver_t*> receivers_;
       std::vector<mask_t*> masks_;
       uint32_t active_pointsource;
       uint32_t active_diffuse_sound_field;
       uint32_t total_pointsource;
       uint32_t total_diffuse_sound_field;
+      /// Number of acoustic models with evaluated geometry in last period
+      uint32_t geometry_evaluated = 0u;
+      /// Number of acoustic models with cached geometry in last period
+      uint32_t geometry_cache_hits = 0u;
     };
 
   } // namespace Acousticmodel
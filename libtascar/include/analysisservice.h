@@ -0,0 +1,147 @@
+/*
+ * This file is part of the TASCAR software, see <http://tascar.org/>
+ *
+ * Copyright (c) 2026 agent
+ */
+/*
+ * TASCAR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, version 3 of the License.
+ *
+ * TASCAR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHATABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License, version 3 for more details.
+ *
+ * You should have received a copy of the GNU General Public License,
+ * Version 3 along with TASCAR. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef ANALYSISSERVICE_H
+#define ANALYSISSERVICE_H
+
+#include "audiostates.h"
+#include "filterclass.h"
+#include "stft.h"
+
+namespace TASCAR {
+
+  /**
+     \brief Shared signal analysis of audio plugins
+
+     Analysis plugins which process the same signal can subscribe to
+     signal features (STFT frames, band-pass filtered signals, block
+     levels) instead of computing them on their own. Each feature is
+     computed once per channel and block, independent of the number
+     of subscribers.
+
+     Subscriptions are done in the configuration phase of the plugins,
+     i.e., after prepare() of the service, and are cleared by
+     release(). Subscriptions with identical parameters return the
+     same handle. In the processing phase, update() computes all
+     subscribed features from the current audio chunk, and the getter
+     methods provide access to the results.
+  */
+  class analysis_service_t : public audiostates_t {
+  public:
+    analysis_service_t();
+    ~analysis_service_t();
+    void release();
+    /**
+       \brief Subscribe to short-time Fourier transform of a channel
+       \param channel Audio channel number
+       \param fftlen FFT length
+       \param wndlen Length of analysis window
+       \param wnd Analysis window type
+       \param wndpos Position of analysis window, see TASCAR::stft_t
+       \return Handle, to be used in get_stft()
+    */
+    size_t subscribe_stft(uint32_t channel, uint32_t fftlen, uint32_t wndlen,
+                          stft_t::windowtype_t wnd, double wndpos);
+    /**
+       \brief Subscribe to band-pass filtered signal of a channel
+       \param channel Audio channel number
+       \param fmin Lower edge frequency in Hz
+       \param fmax Upper edge frequency in Hz
+       \param stages Number of cascaded fourth order band-pass filters
+       \return Handle, to be used in get_band() and get_band_ms()
+    */
+    size_t subscribe_band(uint32_t channel, float fmin, float fmax,
+                          uint32_t stages = 1u);
+    /**
+       \brief Subscribe to block levels of a channel
+       \param channel Audio channel number
+       \return Handle, to be used in get_ms(), get_rms() and get_peak()
+    */
+    size_t subscribe_level(uint32_t channel);
+    /**
+       \brief Compute all subscribed features
+       \param chunk Audio signal of current block
+    */
+    void update(const std::vector<wave_t>& chunk);
+    /// STFT frame of current block
+    const stft_t& get_stft(size_t handle) const { return *stfts[handle].stft; };
+    /// Band-pass filtered signal of current block
+    const wave_t& get_band(size_t handle) const
+    {
+      return bands[handle].signal;
+    };
+    /// Mean square of band-pass filtered signal of current block
+    float get_band_ms(size_t handle) const { return bands[handle].ms; };
+    /// Mean square of current block
+    float get_ms(size_t handle) const { return levels[handle].ms; };
+    /// Root mean square of current block
+    float get_rms(size_t handle) const { return sqrtf(levels[handle].ms); };
+    /// Maximum absolute value of current block
+    float get_peak(size_t handle) const { return levels[handle].peak; };
+    /// Total number of subscriptions
+    size_t get_num_subscriptions() const { return num_subscriptions; };
+    /// Number of distinct features which are computed in each block
+    size_t get_num_features() const
+    {
+      return stfts.size() + bands.size() + levels.size();
+    };
+
+  private:
+    analysis_service_t(const analysis_service_t&);
+    void check_channel(uint32_t channel) const;
+    struct stft_feature_t {
+      uint32_t channel;
+      uint32_t fftlen;
+      uint32_t wndlen;
+      stft_t::windowtype_t wnd;
+      double wndpos;
+      stft_t* stft;
+    };
+    struct band_feature_t {
+      uint32_t channel;
+      float fmin;
+      float fmax;
+      std::vector<bandpass_t> filters;
+      wave_t signal;
+      float ms;
+    };
+    struct level_feature_t {
+      uint32_t channel;
+      float ms;
+      float peak;
+    };
+    std::vector<stft_feature_t> stfts;
+    std::vector<band_feature_t> bands;
+    std::vector<level_feature_t> levels;
+    size_t num_subscriptions = 0u;
+  };
+
+} // namespace TASCAR
+
+#endif
+
+/*
+ * Local Variables:
+ * mode: c++
+ * c-basic-offset: 2
+ * indent-tabs-mode: nil
+ * compile-command: "make -C .."
+ * End:
+ */
@@ -0,0 +1,103 @@
+/*
+ * This file is part of the TASCAR software, see <http://tascar.org/>
+ *
+ * Copyright (c) 2026 agent
+ */
+/*
+ * TASCAR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, version 3 of the License.
+ *
+ * TASCAR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHATABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License, version 3 for more details.
+ *
+ * You should have received a copy of the GNU General Public License,
+ * Version 3 along with TASCAR. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace TASCAR {
+
+  /**
+     \brief Region-based allocator for objects with common lifetime
+
+     Objects are placed contiguously in large blocks, in the order of
+     creation. All objects are destroyed, in reverse order of
+     creation, and the blocks are freed in one operation with
+     clear(). Individual objects can not be freed. The arena is not
+     thread safe.
+  */
+  class arena_t {
+  public:
+    /**
+       \brief Constructor
+       \param blocksize Default size of memory blocks in bytes
+    */
+    arena_t(size_t blocksize = 65536u);
+    ~arena_t();
+    /**
+       \brief Allocate uninitialized memory
+       \param size Number of bytes
+       \param alignment Alignment, needs to be a power of two
+    */
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+    /**
+       \brief Construct an object in the arena
+
+       The object is destroyed by clear() or by the destructor of
+       the arena.
+    */
+    template <class T, class... Args> T* create(Args&&... args)
+    {
+      void* mem(allocate(sizeof(T), alignof(T)));
+      T* obj(new(mem) T(std::forward<Args>(args)...));
+      dtors.push_back(
+          std::make_pair((void*)obj, [](void* p) { ((T*)p)->~T(); }));
+      return obj;
+    };
+    /// Destroy all objects and free all memory blocks
+    void clear();
+    /// Number of bytes reserved in memory blocks
+    size_t get_num_bytes() const { return reserved; };
+    /// Number of bytes allocated from the arena
+    size_t get_num_used() const { return used; };
+    /// Number of objects constructed in the arena
+    size_t get_num_objects() const { return dtors.size(); };
+
+  private:
+    arena_t(const arena_t&);
+    struct block_t {
+      std::unique_ptr<char[]> data;
+      size_t size = 0u;
+      size_t pos = 0u;
+    };
+    size_t blocksize;
+    std::vector<block_t> blocks;
+    std::vector<std::pair<void*, void (*)(void*)>> dtors;
+    size_t reserved = 0u;
+    size_t used = 0u;
+  };
+
+} // namespace TASCAR
+
+#endif
+
+/*
+ * Local Variables:
+ * mode: c++
+ * c-basic-offset: 2
+ * indent-tabs-mode: nil
+ * compile-command: "make -C .."
+ * End:
+ */
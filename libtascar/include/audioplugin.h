@@ -26,6 +26,7 @@
 #ifndef AUDIOPLUGIN_H
 #define AUDIOPLUGIN_H
 
+#include "analysisservice.h"
 #include "audiostates.h"
 #include "audiochunks.h"
 #include "tascarplugin.h"
@@ -56,10 +57,26 @@ namespace TASCAR {
     const std::string& get_name() const { return name; };
     std::string get_fullname() const { return parentname+"."+name; };
     const std::string& get_modname() const { return modname; };
+    /**
+       \brief Return true if the plugin modifies the audio signal
+
+       Analysis plugins which do not modify the audio signal should
+       return false, to share analysis results with subsequent plugins.
+    */
+    virtual bool modifies_audio() const { return true; };
+    /// Set analysis service, before the plugin is prepared
+    virtual void set_analysis_service(analysis_service_t* srv)
+    {
+      analysis = srv;
+    };
   protected:
+    /// Return analysis service of the input signal, to be used in configure()
+    analysis_service_t& get_analysis_service();
     std::string name;
     std::string parentname;
     std::string modname;
+  private:
+    analysis_service_t* analysis = NULL;
   };
 
   class audioplugin_t : public audioplugin_base_t {
@@ -73,6 +90,8 @@ namespace TASCAR {
     virtual void add_variables( TASCAR::osc_server_t* srv );
     virtual void add_licenses( licensehandler_t* srv );
     virtual void validate_attributes(std::string&) const;
+    virtual bool modifies_audio() const;
+    virtual void set_analysis_service(analysis_service_t* srv);
   private:
     audioplugin_t(const audioplugin_t&);
     std::string plugintype;
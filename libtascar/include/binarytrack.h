@@ -0,0 +1,129 @@
+/*
+ * This file is part of the TASCAR software, see <http://tascar.org/>
+ *
+ * Copyright (c) 2026 agent
+ */
+/*
+ * TASCAR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, version 3 of the License.
+ *
+ * TASCAR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHATABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License, version 3 for more details.
+ *
+ * You should have received a copy of the GNU General Public License,
+ * Version 3 along with TASCAR. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef BINARYTRACK_H
+#define BINARYTRACK_H
+
+#include "coordinates.h"
+#include <limits>
+
+namespace TASCAR {
+
+  /**
+     \brief Memory-mapped binary trajectory file
+
+     The file consists of a header of 64 bytes, followed by records of
+     a time stamp and three coordinates, in double precision, native
+     byte order and ascending time order. Coordinates are either
+     positions (x, y, z in m) or Euler orientations (z, y, x in rad).
+
+     The file is memory-mapped and interpolated in place. If a time
+     range is given, only the records of that range are accessed, and
+     time stamps outside of the range are clamped to the range.
+     Binary track files can be created with tascar_track2bin.
+  */
+  class binary_track_t {
+  public:
+    enum content_t { position = 0, orientation = 1 };
+    /**
+       \brief Open a binary track file
+       \param fname File name
+       \param t_begin Start of time range to load, in seconds
+       \param t_end End of time range to load, in seconds
+    */
+    binary_track_t(
+        const std::string& fname,
+        double t_begin = -std::numeric_limits<double>::infinity(),
+        double t_end = std::numeric_limits<double>::infinity());
+    ~binary_track_t();
+    /// Type of coordinates
+    content_t get_content() const { return content; };
+    /// Number of records in the loaded time range
+    size_t size() const { return n; };
+    /// Number of records in the file
+    size_t get_num_total() const { return ntotal; };
+    /// Number of bytes of the loaded time range
+    size_t get_num_bytes() const { return n * sizeof(record_t); };
+    /// Time of first record in the loaded time range
+    double t_min() const;
+    /// Time of last record in the loaded time range
+    double t_max() const;
+    /// Time of a record
+    double get_time(size_t k) const { return rec[k].t; };
+    /// Position of a record
+    pos_t get_position(size_t k) const
+    {
+      return pos_t(rec[k].v[0], rec[k].v[1], rec[k].v[2]);
+    };
+    /// Orientation of a record
+    zyx_euler_t get_orientation(size_t k) const
+    {
+      return zyx_euler_t(rec[k].v[0], rec[k].v[1], rec[k].v[2]);
+    };
+    /**
+       \brief Find interpolation interval of a time
+
+       \param t Time in seconds
+       \retval k Index of first record of the interval
+       \retval w Weight of the record k+1, or zero if t is not within
+       the loaded time range
+       \return False if the track is empty
+    */
+    bool find(double t, size_t& k, double& w) const;
+    /**
+       \brief Write a binary track file
+
+       \param fname File name
+       \param content Type of coordinates
+       \param t Time stamps, in ascending order
+       \param v Coordinates, three values per time stamp
+    */
+    static void write(const std::string& fname, content_t content,
+                      const std::vector<double>& t,
+                      const std::vector<double>& v);
+
+  private:
+    binary_track_t(const binary_track_t&);
+    struct record_t {
+      double t;
+      double v[3];
+    };
+    content_t content;
+    size_t ntotal = 0u;
+    size_t n = 0u;
+    const record_t* rec = NULL;
+    // mapped file, or read records on systems without mmap:
+    void* map = NULL;
+    size_t maplen = 0u;
+    std::vector<record_t> data;
+  };
+
+} // namespace TASCAR
+
+#endif
+
+/*
+ * Local Variables:
+ * mode: c++
+ * c-basic-offset: 2
+ * indent-tabs-mode: nil
+ * compile-command: "make -C .."
+ * End:
+ */
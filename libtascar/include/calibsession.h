@@ -53,6 +53,10 @@ namespace TASCAR {
     std::vector<float>
         miccalib;        ///< Calibration values of reference microphones
     bool initcal = true; ///< Initial calibration (or re-calibration if false)
+    bool simultaneous =
+        false; ///< Measure all broadband speakers simultaneously
+    float irlen = 0.25f; ///< Maximum impulse response length in
+                         ///< simultaneous measurement, in s
   private:
     bool has_sub = false;
   };
@@ -75,6 +79,116 @@ namespace TASCAR {
     std::vector<float> coh;
   };
 
+  /**
+     @brief Interleaved exponential sweeps for simultaneous measurement
+     of multiple loudspeakers.
+
+     All channels play the same exponential sweep, each delayed by a
+     multiple of the maximum impulse response length plus a guard
+     interval. Deconvolution of the recorded sum with the inverse
+     sweep yields the impulse responses of all channels in
+     non-overlapping time windows. Harmonic distortion products of an
+     exponential sweep appear before the linear impulse response; the
+     guard interval is long enough to keep the harmonics up to
+     multisweep_t::max_harmonic of the next channel out of the window
+     of the previous channel.
+   */
+  class multisweep_t {
+  public:
+    /**
+       @param channels Number of channels
+       @param fs Sampling rate in Hz
+       @param fmin Lower limit of frequency range of interest in Hz
+       @param fmax Upper limit of frequency range of interest in Hz
+       @param duration Sweep duration in s
+       @param irlen Maximum impulse response length in s, including
+       system latency
+     */
+    multisweep_t(uint32_t channels, float fs, float fmin, float fmax,
+                 float duration, float irlen);
+    /**
+       @brief Return total length of stimulus and recording in samples
+     */
+    uint32_t get_length() const { return len; };
+    /**
+       @brief Return length of separated impulse responses in samples
+     */
+    uint32_t get_irlen() const { return irlen_; };
+    /**
+       @brief Return length of guard interval between impulse
+       response windows in samples
+     */
+    uint32_t get_guard() const { return guard_; };
+    /**
+       @brief Highest order of harmonic distortion products which are
+       kept out of the impulse response windows
+     */
+    static const uint32_t max_harmonic = 5u;
+    /**
+       @brief Create excitation signals
+       @retval stim One excitation signal per channel
+       @param gain Peak amplitude of sweep
+     */
+    void get_stimulus(std::vector<TASCAR::wave_t>& stim, float gain) const;
+    /**
+       @brief Separate impulse responses from recording
+       @param rec Recording of the sum of all channels, length get_length()
+       @param gain Peak amplitude of sweep used in excitation
+       @retval irs One impulse response per channel
+     */
+    void get_irs(const TASCAR::wave_t& rec, float gain,
+                 std::vector<TASCAR::wave_t>& irs) const;
+
+  private:
+    uint32_t channels_;
+    uint32_t irlen_;
+    uint32_t guard_;
+    uint32_t len;
+    TASCAR::wave_t sweep;
+    TASCAR::spec_t inverse;
+  };
+
+  /**
+     @brief Create periodic pink noise stimulus, as used in the
+     calibration session.
+     @retval w Output waveform, one period
+     @param fs Sampling rate in Hz
+     @param par Calibration parameters (frequency range and level)
+   */
+  void create_pink_stimulus(TASCAR::wave_t& w, float fs,
+                            const spk_eq_param_t& par);
+
+  /**
+     @brief Circular convolution of periodic signal with impulse response.
+     @param x One period of input signal, replaced by output signal
+     @param ir Impulse response
+   */
+  void circular_convolve(TASCAR::wave_t& x, const TASCAR::wave_t& ir);
+
+  /**
+     @brief Analyse levels and frequency response of one speaker
+     @param recbuf Recorded microphone signals followed by reference
+     signal; microphone signals are modified (calibration gain applied)
+     @param miccalib Calibration factor of each microphone
+     @param weight Frequency weighting of broadband levels
+     @param calibpar Calibration parameters
+     @param fs Sampling rate in Hz
+     @retval levels Broadband level re reference level is appended
+     @retval vF Center frequencies of bands
+     @retval vG Gain in bands, median normalized
+     @retval level_fs Level of each microphone in dB re full scale
+     @retval vcoh Coherence between microphone signals and reference, or NULL
+   */
+  void analyse_speaker_recording(const std::vector<TASCAR::wave_t>& recbuf,
+                                 const std::vector<float>& miccalib,
+                                 levelmeter::weight_t weight,
+                                 const spk_eq_param_t& calibpar, float fs,
+                                 std::vector<float>& levels,
+                                 std::vector<float>& vF,
+                                 std::vector<float>& vG,
+                                 std::vector<float>& level_fs,
+                                 std::vector<float>* vcoh);
+
   /**
      @brief Dedicated TASCAR session for calibration of speaker layout files.
 
@@ -131,8 +245,12 @@ namespace TASCAR {
     size_t get_num_channels() const { return get_num_bb() + get_num_sub(); };
     double get_measurement_duration() const
     {
-      return (cfg_.par_speaker.duration + cfg_.par_speaker.prewait) *
-                 (double)get_num_bb() *
+      double bbduration((cfg_.par_speaker.duration + cfg_.par_speaker.prewait) *
+                        (double)get_num_bb());
+      if(cfg_.simultaneous)
+        bbduration = cfg_.par_speaker.duration + cfg_.par_speaker.prewait +
+                     cfg_.irlen * (double)get_num_bb();
+      return bbduration *
                  (1.0 + (double)(cfg_.par_speaker.max_eqstages > 0u)) +
              (cfg_.par_sub.duration + cfg_.par_sub.prewait) *
                  (double)get_num_sub() *
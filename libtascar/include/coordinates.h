@@ -775,6 +775,8 @@ namespace TASCAR {
     std::string print(const std::string& delim = ", ") const;
     ngon_t& operator+=(const pos_t& p);
     ngon_t& operator+=(double p);
+    /// Version number, incremented whenever the vertices are updated
+    uint64_t get_version() const { return version; };
 
   protected:
     /**
@@ -793,6 +795,7 @@ namespace TASCAR {
     pos_t local_normal;
     double area;
     double aperture;
+    uint64_t version = 0u;
   };
 
   /**
@@ -826,6 +829,42 @@ namespace TASCAR {
     zyx_euler_t orientation;
   };
 
+  /**
+     \brief Change detection of position and orientation
+
+     The version number is incremented whenever the transformation
+     differs from the transformation of the last version by more than
+     the tolerance in any component. Slow drifts below the tolerance
+     accumulate until they are detected. Consumers of the
+     transformation can store the version number and skip updates of
+     derived data while it is unchanged.
+  */
+  class transform_version_t {
+  public:
+    /**
+       \brief Constructor, the tolerance is read from configuration
+       variable "tascar.geometry.tolerance".
+    */
+    transform_version_t();
+    /**
+       \brief Compare a transformation to the last version
+       \param p Position
+       \param o Orientation
+       \return True if a new version was created
+    */
+    bool update(const pos_t& p, const zyx_euler_t& o);
+    /// Create a new version with the next call of update()
+    void invalidate() { valid = false; };
+    uint64_t get_version() const { return version; };
+    /// Tolerance in meters (position) and radians (orientation)
+    double tolerance;
+
+  private:
+    c6dof_t last;
+    uint64_t version = 0u;
+    bool valid = false;
+  };
+
   class quickhull_t {
   public:
     struct simplex_t {
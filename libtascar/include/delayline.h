@@ -30,14 +30,24 @@
 
 #include "audiochunks.h"
 #include <math.h>
+#include <memory>
+#include <string.h>
+#include <vector>
 
 namespace TASCAR {
 
+  /**
+     \brief Tabulated sinc function
+
+     The tables are immutable and shared between all instances with
+     the same order and oversampling factor.
+  */
   class sinctable_t {
   public:
     sinctable_t(uint32_t order, uint32_t oversampling);
     sinctable_t(const sinctable_t& src);
-    ~sinctable_t();
+    /// Number of distinct tables in the process-wide registry
+    static size_t get_num_tables();
     inline float operator()(float x) const
     {
       if(N0 > 0)
@@ -52,14 +62,69 @@ namespace TASCAR {
     uint32_t N;
     uint32_t N1;
     float scale;
-    float* data;
+    std::shared_ptr<const std::vector<float>> table;
+    const float* data;
   };
 
+  /**
+     \brief Convert to IEEE 754 half precision, with rounding to nearest
+
+     Values outside of the half precision range are clipped to the
+     largest finite value.
+  */
+  inline uint16_t float2half(float f)
+  {
+    uint32_t x;
+    memcpy(&x, &f, sizeof(x));
+    const uint16_t sign((x >> 16) & 0x8000u);
+    const int32_t e((int32_t)((x >> 23) & 0xffu) - 127 + 15);
+    uint32_t m(x & 0x7fffffu);
+    if(e >= 31)
+      return sign | 0x7bffu;
+    if(e <= 0) {
+      // subnormal or zero:
+      if(e < -10)
+        return sign;
+      m |= 0x800000u;
+      const uint32_t shift(14 - e);
+      return sign | (uint16_t)((m >> shift) + ((m >> (shift - 1)) & 1u));
+    }
+    uint32_t h(((uint32_t)e << 10) | (m >> 13));
+    h += (m >> 12) & 1u;
+    if(h > 0x7bffu)
+      h = 0x7bffu;
+    return sign | (uint16_t)h;
+  }
+
+  /// Convert from IEEE 754 half precision
+  inline float half2float(uint16_t h)
+  {
+    const uint32_t e((h >> 10) & 0x1fu);
+    const uint32_t m(h & 0x3ffu);
+    if(e == 0) {
+      const float f((float)m * 5.9604645e-8f);
+      return (h & 0x8000u) ? -f : f;
+    }
+    const uint32_t x(((uint32_t)(h & 0x8000u) << 16) | ((e + 112u) << 23) |
+                     (m << 13));
+    float f;
+    memcpy(&f, &x, sizeof(f));
+    return f;
+  }
+
   /**
      \brief Delay line with variable length (no subsampling)
   */
   class varidelay_t {
   public:
+    /**
+       \brief Sample format of delay line buffer
+
+       Half precision storage halves the memory footprint of long
+       delay lines, at the cost of a relative accuracy of about 1e-3
+       (-66 dB) and a range of +-65504.
+    */
+    enum storage_t { float32, float16 };
     /**
        \brief Primary constructor
        \param maxdelay Maximum delay in samples
@@ -67,9 +132,10 @@ namespace TASCAR {
        \param c Speed of sound
        \param order Sinc interpolation order
        \param oversampling Oversampling factor
+       \param storage Sample format of buffer
     */
     varidelay_t(uint32_t maxdelay, double fs, double c, uint32_t order,
-                uint32_t oversampling);
+                uint32_t oversampling, storage_t storage = float32);
     /// Copy constructor
     varidelay_t(const varidelay_t& src);
     ~varidelay_t();
@@ -82,7 +148,7 @@ namespace TASCAR {
       pos++;
       if(pos >= dmax)
         pos = 0;
-      dline[pos] = x;
+      store(x);
     };
 
     /**
@@ -101,7 +167,7 @@ namespace TASCAR {
       pos++;
       if(pos >= dmax)
         pos = 0;
-      dline[pos] = x;
+      store(x);
       if(sinc.O)
         return get_sinc(dist2sample * dist);
       else
@@ -119,6 +185,8 @@ namespace TASCAR {
       uint32_t npos = pos + dmax - delay;
       while(npos >= dmax)
         npos -= dmax;
+      if(hline)
+        return half2float(hline[npos]);
       return dline[npos];
     };
     /**
@@ -135,9 +203,37 @@ namespace TASCAR {
               get((uint32_t)(std::max(0, (int32_t)integerdelay + order)));
       return rv;
     };
+    /**
+       \brief Interpolation taps of a spatial distance
+
+       The output of get_dist() is the sum of the buffer values at
+       the returned delays, weighted with the returned weights.
+
+       \param dist Distance
+       \retval delay Delay of each tap in samples
+       \retval weight Weight of each tap
+    */
+    void get_dist_taps(float dist, std::vector<uint32_t>& delay,
+                       std::vector<float>& weight) const;
+    /// Sample format of buffer
+    storage_t get_storage() const { return hline ? float16 : float32; };
+    /// Size of delay line buffer in bytes
+    size_t get_num_bytes() const
+    {
+      return (size_t)dmax * (hline ? sizeof(uint16_t) : sizeof(float));
+    };
 
   private:
-    float* dline;
+    inline void store(float x)
+    {
+      if(hline)
+        hline[pos] = float2half(x);
+      else
+        dline[pos] = x;
+    };
+    void alloc(storage_t storage);
+    float* dline = NULL;
+    uint16_t* hline = NULL;
     uint32_t dmax;
     float dist2sample;
     float delay2sample;
@@ -0,0 +1,89 @@
+/*
+ * This file is part of the TASCAR software, see <http://tascar.org/>
+ *
+ * Copyright (c) 2026 agent
+ */
+/*
+ * TASCAR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, version 3 of the License.
+ *
+ * TASCAR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHATABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License, version 3 for more details.
+ *
+ * You should have received a copy of the GNU General Public License,
+ * Version 3 along with TASCAR. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DISKCACHE_H
+#define DISKCACHE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace TASCAR {
+
+  /**
+     \brief Persistent cache of numeric results on disk
+
+     Each entry is stored in a separate file in a category
+     sub-directory of the cache directory. The file name is derived
+     from a hash of the key, and the full key is stored in the file to
+     detect hash collisions. The cache directory is taken from the
+     global configuration variable "tascar.cachedir" (default
+     ${HOME}/.cache/tascar).
+
+     Failure to read or write the cache is never an error: a missing or
+     invalid entry is reported as a cache miss, and failed writes are
+     ignored.
+  */
+  class diskcache_t {
+  public:
+    /**
+       \param category Name of sub-directory, e.g., name of the module
+       \param dir Cache directory, or empty to use global configuration
+     */
+    diskcache_t(const std::string& category, const std::string& dir = "");
+    /**
+       \brief Read entry from cache
+       \param key Key of entry
+       \retval data Cached values
+       \return True if entry was found, false otherwise
+     */
+    bool read(const std::string& key, std::vector<float>& data) const;
+    /**
+       \brief Write entry to cache, replacing existing entries of same key
+       \param key Key of entry
+       \param data Values to store
+     */
+    void write(const std::string& key, const std::vector<float>& data) const;
+    /**
+       \brief Return name of file which is used to store an entry
+     */
+    std::string get_filename(const std::string& key) const;
+    /**
+       \brief 64 bit hash of a string, e.g., to derive compact keys
+       from large data
+     */
+    static uint64_t hash(const std::string& key);
+    const std::string& get_path() const { return path; };
+
+  private:
+    std::string path;
+  };
+
+} // namespace TASCAR
+
+#endif
+
+/*
+ * Local Variables:
+ * mode: c++
+ * c-basic-offset: 2
+ * indent-tabs-mode: nil
+ * compile-command: "make -C .."
+ * End:
+ */
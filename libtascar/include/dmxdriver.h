@@ -27,6 +27,7 @@
 #define DMXDRIVER_H
 
 #include "serialport.h"
+#include <map>
 #include <netdb.h>
 #include <stdint.h>
 #include <sys/socket.h>
@@ -45,6 +46,18 @@ namespace DMX {
     driver_t();
     virtual ~driver_t();
     virtual void send(uint8_t universe, const std::vector<uint16_t>& data) = 0;
+    /**
+       \brief Send the first slots of a universe
+
+       Drivers which can not transmit partial universes send the
+       full universe.
+
+       \param universe DMX universe
+       \param data DMX data of the full universe
+       \param n Number of slots to transmit
+    */
+    virtual void send_partial(uint8_t universe,
+                              const std::vector<uint16_t>& data, uint32_t n);
   };
 
   class OpenDMX_USB_t : public driver_t, public TASCAR::serialport_t {
@@ -61,6 +74,8 @@ namespace DMX {
   public:
     ArtnetDMX_t(const char* hostname, const char* port);
     void send(uint8_t universe, const std::vector<uint16_t>& data);
+    void send_partial(uint8_t universe, const std::vector<uint16_t>& data,
+                      uint32_t n);
 
   private:
     uint8_t msg[530];
@@ -83,6 +98,52 @@ namespace DMX {
     std::string path_;
   };
 
+  /**
+     \brief Transmit only changed DMX data
+
+     In mode \a changed_universes, a universe is transmitted only if at
+     least one slot changed since the last transmission. In mode \a
+     changed_slots, only the slots up to the last changed slot are
+     transmitted, if the driver supports partial universes. A full
+     universe is transmitted when the keep-alive interval has elapsed.
+  */
+  class delta_sender_t {
+  public:
+    enum mode_t { full, changed_universes, changed_slots };
+    /**
+       \param driver DMX driver used for transmission
+       \param mode Transmission mode
+       \param keepalive Maximum interval between transmissions, in seconds
+    */
+    delta_sender_t(driver_t* driver, mode_t mode, double keepalive);
+    /**
+       \brief Send a universe, if needed
+       \param universe DMX universe
+       \param data DMX data of the full universe
+       \param t Current time in seconds
+       \return True if data was transmitted
+    */
+    bool send(uint8_t universe, const std::vector<uint16_t>& data, double t);
+    /// Convert mode name ("full", "universe" or "slots") to mode
+    static mode_t get_mode(const std::string& name);
+    /// Number of transmissions
+    size_t get_num_sent() const { return num_sent; };
+    /// Number of skipped transmissions
+    size_t get_num_skipped() const { return num_skipped; };
+
+  private:
+    struct universe_t {
+      std::vector<uint16_t> data;
+      double t_sent = 0.0;
+    };
+    driver_t* driver;
+    mode_t mode;
+    double keepalive;
+    std::map<uint8_t, universe_t> universes;
+    size_t num_sent = 0u;
+    size_t num_skipped = 0u;
+  };
+
 } // namespace DMX
 
 #endif
@@ -26,7 +26,9 @@
 #ifndef DYNAMICOBJECTS_H
 #define DYNAMICOBJECTS_H
 
+#include "binarytrack.h"
 #include "tscconfig.h"
+#include <memory>
 
 namespace TASCAR {
 
@@ -64,6 +66,8 @@ namespace TASCAR {
      */
     double t_min()
     {
+      if(binary)
+        return binary->t_min();
       if(size())
         return begin()->first;
       else
@@ -71,12 +75,23 @@ namespace TASCAR {
     };
     double t_max()
     {
+      if(binary)
+        return binary->t_max();
       if(size())
         return rbegin()->first;
       else
         return 0;
     };
     double duration() { return t_max() - t_min(); };
+    /**
+       \brief Return decimated polyline of track positions
+
+       Points which are closer than a tolerance to the previously
+       kept point are removed. First and last point are always kept.
+
+       \param tol Tolerance in meters
+    */
+    std::vector<TASCAR::pos_t> get_decimated(double tol) const;
     /**
        \brief Return the interpolated position for a given time.
     */
@@ -137,6 +152,20 @@ namespace TASCAR {
        \brief load a track from a csv file
     */
     void load_from_csv(const std::string& fname);
+    /**
+       \brief Use a memory-mapped binary track file
+
+       The binary data replaces all track points. Track manipulations
+       are not applied to binary data.
+
+       \param fname File name of binary track, see TASCAR::binary_track_t
+       \param t_begin Start of time range to load, in seconds
+       \param t_end End of time range to load, in seconds
+    */
+    void load_from_binary(
+        const std::string& fname,
+        double t_begin = -std::numeric_limits<double>::infinity(),
+        double t_end = std::numeric_limits<double>::infinity());
     /**
        \brief manipulate track based on a set of XML entries
     */
@@ -166,8 +195,12 @@ namespace TASCAR {
     void fill_gaps(double dt);
     /// Loop time
     double loop;
+    /// Binary track data, or empty pointer if track points are used
+    std::shared_ptr<const binary_track_t> binary;
 
   private:
+    TASCAR::pos_t interp(const TASCAR::pos_t& p1, const TASCAR::pos_t& p2,
+                         double w) const;
     interp_t interpt;
     table1_t time_dist;
     table1_t dist_time;
@@ -192,7 +225,14 @@ namespace TASCAR {
     void write_xml(tsccfg::node_t);
     void read_xml(tsccfg::node_t);
     std::string print(const std::string& delim = ", ");
+    /// Use a memory-mapped binary track file, see track_t::load_from_binary()
+    void load_from_binary(
+        const std::string& fname,
+        double t_begin = -std::numeric_limits<double>::infinity(),
+        double t_end = std::numeric_limits<double>::infinity());
     double loop;
+    /// Binary track data, or empty pointer if track points are used
+    std::shared_ptr<const binary_track_t> binary;
   };
 
   class dynobject_t : public xml_element_t {
@@ -206,6 +246,17 @@ namespace TASCAR {
     void get_6dof_prev(pos_t&, zyx_euler_t&) const;
     void set_parent(dynobject_t* p);
     size_t get_num_descendants() const;
+    /**
+       \brief Version number of the transformation
+
+       The version is incremented in geometry_update() whenever
+       position or orientation changed by more than the tolerance,
+       see TASCAR::transform_version_t.
+    */
+    uint64_t get_transform_version() const
+    {
+      return transform_version.get_version();
+    };
     double starttime;
     double sampledorientation;
     track_t location;
@@ -227,6 +278,7 @@ namespace TASCAR {
     tsccfg::node_t xml_orientation;
     navmesh_t* navmesh;
     pos_t localpos;
+    transform_version_t transform_version;
   };
 
 } // namespace TASCAR
@@ -108,6 +108,13 @@ namespace TASCAR {
     };
     void set_lp(float g, float c);
     void set_eta(float e) { eta = e; };
+    /**
+     * Return magnitude of transfer function at a normalized angular
+     * frequency (allpass section has unit magnitude)
+     *
+     * @param w Angular frequency in radians per sample
+     */
+    float get_gain(float w) const;
 
   protected:
     float B1 = 0.0f;  ///< non-recursive filter coefficient for all channels
@@ -222,6 +229,29 @@ namespace TASCAR {
       for(auto& path : fdnpath)
         path.set_zero();
     };
+    /**
+     * Estimate reverberation time from reflection filters and delays,
+     * without rendering an impulse response
+     *
+     * The feedback matrix is energy preserving, thus the late decay
+     * rate is the attenuation of the reflection filters divided by the
+     * mean path delay.
+     *
+     * @param f Frequency in Hz
+     * @param fs Sampling rate in Hz
+     * @return Estimated T60 in seconds, or -1 if the network does not decay
+     */
+    float get_t60_estimate(float f, float fs) const;
+    /**
+     * Estimate reverberation time in a frequency band, as measured from
+     * the Schroeder integral between -10 dB and -30 dB
+     *
+     * @param f Center frequency in Hz
+     * @param fs Sampling rate in Hz
+     * @param bw Bandwidth in octaves, or zero for single frequency
+     * @return Estimated T60 in seconds, or -1 if the network does not decay
+     */
+    float get_t60_estimate(float f, float fs, float bw) const;
 
     // private:
     bool logdelays_ = true;
@@ -28,9 +28,18 @@
 
 #include "spectrum.h"
 #include <fftw3.h>
+#include <mutex>
 
 namespace TASCAR {
 
+  /**
+     \brief Lock for creation and destruction of fftw plans
+
+     The fftw planner is not thread safe; all code which creates or
+     destroys plans has to hold this lock.
+  */
+  std::mutex& fftw_planner_mutex();
+
   /**
      \brief Wrapper class around real-to-complex and complex-to-real fftw
    */
@@ -89,6 +98,7 @@ namespace TASCAR {
     TASCAR::wave_t w; ///< waveform container
     TASCAR::spec_t s; ///< spectrum container
   private:
+    void create_plans();
     TASCAR::spec_t fullspec;
     float* wp;
     fftwf_complex* sp;
@@ -452,6 +452,99 @@ namespace TASCAR {
                  const std::vector<float>& freq, float fs,
                  uint32_t numiter = 2000u);
 
+  /**
+     \brief Return reflection filter gains from absorption coefficients
+
+     The magnitude is \f$1-\sqrt{\alpha}\f$, which is consistent with
+     TASCAR::rflt2alpha.
+  */
+  std::vector<float> alpha2gain(const std::vector<float>& alpha);
+
+  /**
+     \brief Multiband reflection filter design
+
+     The filter is a cascade of second-order shelving filters at the
+     geometric mean of neighbouring band frequencies, with an overall
+     gain. The shelf gains are fitted iteratively to given band
+     gains.
+
+     For processing, the cascade is expanded into a parallel sum of
+     second-order sections. The sections are independent of each other,
+     thus the per-sample kernel is vectorized across sections. If the
+     expansion is numerically ill-conditioned, the cascade is used
+     instead.
+  */
+  class reflectionfilter_design_t {
+  public:
+    /// Maximum number of shelving sections, i.e., number of bands - 1
+    static const uint32_t maxsections = 16;
+    /**
+       \brief Design filter
+       \param freq Band frequencies in Hz
+       \param gain Linear magnitude of each band
+       \param fs Sampling rate in Hz
+    */
+    reflectionfilter_design_t(const std::vector<float>& freq,
+                              const std::vector<float>& gain, float fs);
+    /// Magnitude response of the filter at frequency f (in Hz)
+    float get_response(float f) const;
+    /**
+       \brief Apply filter to audio
+       \param audio Audio signal, modified in place
+       \param state Filter state, 2*maxsections entries
+    */
+    void filter(TASCAR::wave_t& audio, float* state) const;
+    const std::vector<float>& get_freq() const { return freq; };
+    const std::vector<float>& get_gain() const { return gain; };
+    float get_fs() const { return fs; };
+    bool is_parallel() const { return parallel; };
+    uint32_t get_num_sections() const { return (uint32_t)b0.size(); };
+
+  private:
+    void set_shelves(const std::vector<double>& level_db);
+    void expand_parallel();
+    std::vector<float> freq;
+    std::vector<float> gain;
+    float fs;
+    // cascade:
+    double g0 = 1.0;
+    std::vector<double> b0;
+    std::vector<double> b1;
+    std::vector<double> b2;
+    std::vector<double> a1;
+    std::vector<double> a2;
+    // parallel form:
+    bool parallel = false;
+    float d = 1.0f;
+    float p1[maxsections];
+    float p2[maxsections];
+    float r0[maxsections];
+    float r1[maxsections];
+  };
+
+  /**
+     \brief Return a shared multiband reflection filter design
+
+     Designs are computed once for each combination of band
+     frequencies, gains and sampling rate, and are kept until the end
+     of the process. The returned pointer remains valid.
+  */
+  const reflectionfilter_design_t*
+  get_reflectionfilter_design(const std::vector<float>& freq,
+                              const std::vector<float>& gain, float fs);
+
+  /**
+     \brief Return the shared design of two consecutive reflections
+
+     The band gains are the product of the responses of both designs,
+     evaluated at the band frequencies of the first design. Image
+     sources with the same sequence of reflection filters thus share
+     one design.
+  */
+  const reflectionfilter_design_t*
+  combine_reflectionfilter_design(const reflectionfilter_design_t* a,
+                                  const reflectionfilter_design_t* b);
+
   /**
    \brief First order attack-release lowpass filter
 
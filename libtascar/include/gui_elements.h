@@ -36,6 +36,7 @@
 #include <gtkmm/drawingarea.h>
 #include <gtkmm/main.h>
 #include <gtkmm/window.h>
+#include <set>
 
 /// Name space for graphical user interface components
 namespace TSCGUI {
@@ -185,6 +186,44 @@ namespace TSCGUI {
     dameter_t::mode_t lmode;
   };
 
+  /**
+     \brief Level-of-detail representation of a track
+
+     The track is decimated with increasing tolerance, starting from
+     the full track.
+  */
+  class track_lod_t {
+  public:
+    /// Update levels, if the track has changed
+    void update(const TASCAR::track_t& track);
+    /**
+       \brief Return polyline with the coarsest level which is still
+       finer than a tolerance
+       \param tol Tolerance in meters
+    */
+    const std::vector<TASCAR::pos_t>& get(double tol) const;
+
+  private:
+    size_t npoints = 0;
+    double t_min = 0.0;
+    double t_max = 0.0;
+    std::vector<double> tolerance;
+    std::vector<std::vector<TASCAR::pos_t>> levels;
+  };
+
+  /**
+     \brief Draw a scene into a Cairo context
+
+     In retained mode (default), the static content of the scene
+     (faces, face groups, obstacles and tracks) is rendered into an
+     offscreen surface, which is only updated if the viewport or the
+     state of these objects change. Faces, face groups and obstacles
+     are moved to the dynamic content once their transformation
+     changes. Tracks are drawn with a level of detail adapted to the
+     pixel size. The acoustic model is drawn from a snapshot, which is
+     published by the audio thread, see
+     render_core_t::get_acousticmodel_snapshot().
+  */
   class scene_draw_t {
   public:
     enum viewt_t { xy, xz, yz, xyz, p };
@@ -199,6 +238,15 @@ namespace TSCGUI {
     void set_time(double t);
     void set_print_labels(bool print_labels);
     void set_show_acoustic_model(bool acmodel);
+    /**
+       \brief Enable or disable retained-mode rendering
+
+       Disable for vector output, e.g., PDF export.
+    */
+    void set_retained(bool retained);
+    bool get_retained() const { return b_retained; };
+    /// Number of updates of the offscreen surface with static content
+    uint32_t get_static_updates() const { return static_updates; };
     double get_time() const { return time; };
     bool draw_edge(Cairo::RefPtr<Cairo::Context> cr, pos_t p1, pos_t p2);
 
@@ -216,6 +264,10 @@ namespace TSCGUI {
     // object draw functions:
     virtual void draw_track(TASCAR::Scene::object_t* obj,
                             Cairo::RefPtr<Cairo::Context> cr, double msize);
+    void draw_track_line(TASCAR::Scene::object_t* obj,
+                         Cairo::RefPtr<Cairo::Context> cr, double msize);
+    void draw_track_origin(TASCAR::Scene::object_t* obj,
+                           Cairo::RefPtr<Cairo::Context> cr, double msize);
     virtual void draw_src(TASCAR::Scene::src_object_t* obj,
                           Cairo::RefPtr<Cairo::Context> cr, double msize);
     virtual void draw_receiver_object(TASCAR::Scene::receiver_obj_t* obj,
@@ -235,6 +287,17 @@ namespace TSCGUI {
     virtual void draw_mask(TASCAR::Scene::mask_object_t* obj,
                            Cairo::RefPtr<Cairo::Context> cr, double msize);
     virtual void draw_acousticmodel(Cairo::RefPtr<Cairo::Context> cr);
+    /// Draw static content of all objects
+    void draw_static(Cairo::RefPtr<Cairo::Context> cr);
+    /// Draw dynamic content of all objects
+    void draw_dynamic(Cairo::RefPtr<Cairo::Context> cr);
+    /**
+       \brief Update offscreen surface with static content if needed,
+       and copy it to the context
+    */
+    void draw_retained(Cairo::RefPtr<Cairo::Context> cr);
+    /// Copy state of acoustic model, needed for drawing
+    void update_acousticmodel_snapshot();
     TASCAR::render_core_t* scene_;
 
   public:
@@ -247,9 +310,29 @@ namespace TSCGUI {
     bool blink;
     bool b_print_labels;
     bool b_acoustic_model;
+    bool b_retained;
 
   private:
+    /// Return state which affects static content
+    void get_static_key(Cairo::RefPtr<Cairo::Context> cr,
+                        std::vector<double>& key);
+    /// Detect faces, face groups and obstacles which changed their
+    /// transformation since they were drawn first
+    void update_moving_objects();
+    /// True if object is drawn as static content
+    bool is_static(TASCAR::Scene::object_t* obj) const;
     pthread_mutex_t mtx;
+    // retained mode:
+    Cairo::RefPtr<Cairo::ImageSurface> static_layer;
+    int static_layer_x;
+    int static_layer_y;
+    std::vector<double> static_key;
+    std::vector<double> current_key;
+    uint32_t static_updates;
+    std::map<const TASCAR::Scene::object_t*, track_lod_t> track_lod;
+    std::map<const TASCAR::Scene::object_t*, uint64_t> static_version;
+    std::set<const TASCAR::Scene::object_t*> moving_objects;
+    std::vector<TASCAR::acousticmodel_snapshot_t> acousticmodel_snapshot;
     // void draw_source_trace(Cairo::RefPtr<Cairo::Context> cr,TASCAR::pos_t
     // rpos,TASCAR::Acousticmodel::source_t*
     // src,TASCAR::Acousticmodel::acoustic_model_t* am);
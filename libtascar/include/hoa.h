@@ -23,8 +23,16 @@
 #include "audiochunks.h"
 #include "errorhandling.h"
 #include "tscconfig.h"
+#include <atomic>
 #include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <future>
 #include <gsl/gsl_sf.h>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 /// Encoder and decoder classes for Higher Order Ambisonics
@@ -72,6 +80,29 @@ namespace HOA {
     void create_pinv(uint32_t order, const std::vector<TASCAR::pos_t>& spkpos);
     void create_allrad(uint32_t order,
                        const std::vector<TASCAR::pos_t>& spkpos);
+    /**
+       \brief Request a decoder matrix from the decoder cache
+
+       If the matrix is not found in the cache, it is computed in a
+       worker thread. wait() needs to be called before the decoder
+       can be used.
+
+       \param order Ambisonics order
+       \param spkpos Speaker positions
+       \param method Decoder generation method
+       \param m Decoder modifier, applied after generation
+    */
+    void request(uint32_t order, const std::vector<TASCAR::pos_t>& spkpos,
+                 method_t method, modifier_t m);
+    /// Wait until a requested decoder matrix is available
+    void wait();
+    /// Create decoder matrix via the decoder cache
+    void create(uint32_t order, const std::vector<TASCAR::pos_t>& spkpos,
+                method_t method, modifier_t m)
+    {
+      request(order, spkpos, method, m);
+      wait();
+    };
     inline float& operator()(uint32_t acn, uint32_t outc)
     {
       return dec[outc + acn * out_channels];
@@ -144,6 +175,75 @@ namespace HOA {
     int32_t M;
     mode_t dectype;
     method_t method;
+    std::shared_future<std::shared_ptr<const std::vector<float>>> pending;
+  };
+
+  /**
+     \brief Process-wide cache of decoder matrices
+
+     Decoder matrices are identified by order, generation method,
+     modifier and speaker layout. They are kept in memory, and stored
+     in the disk cache (category "hoadecoder") unless the global
+     configuration variable "tascar.hoa.decodercache" is zero. Missing
+     matrices are computed by a fixed pool of worker threads, the
+     number of workers is "tascar.hoa.decoderthreads" (default: number
+     of CPU cores). If a computation fails, the matrix is removed from
+     memory, so the next request computes it again.
+  */
+  class decoder_cache_t {
+  public:
+    typedef std::shared_ptr<const std::vector<float>> matrix_t;
+    static decoder_cache_t& get();
+    /**
+       \brief Request decoder matrix
+
+       Concurrent requests of the same matrix share one computation.
+
+       \return Future of the decoder matrix, with the layout of
+       decoder_t, i.e., output channels are the inner dimension.
+    */
+    std::shared_future<matrix_t>
+    request(uint32_t order, const std::vector<TASCAR::pos_t>& spkpos,
+            decoder_t::method_t method, decoder_t::modifier_t m);
+    /// Key of decoder matrix in cache
+    static std::string get_key(uint32_t order,
+                               const std::vector<TASCAR::pos_t>& spkpos,
+                               decoder_t::method_t method,
+                               decoder_t::modifier_t m);
+    /// Remove all matrices from memory (the disk cache is not cleared)
+    void clear();
+    /// Number of requests which were served from memory
+    size_t get_num_memory_hits() const { return num_memory_hits; };
+    /// Number of matrices which were read from the disk cache
+    size_t get_num_disk_hits() const { return num_disk_hits; };
+    /// Number of matrices which were computed
+    size_t get_num_computed() const { return num_computed; };
+    /// Number of worker threads which were started
+    size_t get_num_workers();
+    /// Use disk cache
+    bool usediskcache;
+    /// Version of the matrix format, part of the disk cache key
+    static const uint32_t format_version = 1u;
+
+  private:
+    decoder_cache_t();
+    ~decoder_cache_t();
+    decoder_cache_t(const decoder_cache_t&);
+    matrix_t compute(const std::string& key, uint32_t order,
+                     const std::vector<TASCAR::pos_t>& spkpos,
+                     decoder_t::method_t method, decoder_t::modifier_t m);
+    void workerthread();
+    std::mutex mtx;
+    std::map<std::string, std::shared_future<matrix_t>> entries;
+    std::mutex mtxworkers;
+    std::condition_variable cvworkers;
+    std::deque<std::packaged_task<matrix_t()>> jobs;
+    std::vector<std::thread> workers;
+    bool stopworkers = false;
+    uint32_t maxworkers;
+    std::atomic<size_t> num_memory_hits = 0u;
+    std::atomic<size_t> num_disk_hits = 0u;
+    std::atomic<size_t> num_computed = 0u;
   };
 
   std::vector<double> legendre_poly(size_t n);
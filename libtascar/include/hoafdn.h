@@ -0,0 +1,276 @@
+/*
+ * This file is part of the TASCAR software, see <http://tascar.org/>
+ *
+ * Copyright (c) 2018 Giso Grimm
+ * Copyright (c) 2020 Giso Grimm
+ * Copyright (c) 2021 Giso Grimm
+ */
+/*
+ * TASCAR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, version 3 of the License.
+ *
+ * TASCAR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHATABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License, version 3 for more details.
+ *
+ * You should have received a copy of the GNU General Public License,
+ * Version 3 along with TASCAR. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HOAFDN_H
+#define HOAFDN_H
+
+#include "spectrum.h"
+#include <string>
+#include <vector>
+
+namespace TASCAR {
+
+  class cmat3_t {
+  public:
+    cmat3_t(uint32_t d1, uint32_t d2, uint32_t d3);
+    inline std::complex<float>& elem(uint32_t p1, uint32_t p2, uint32_t p3)
+    {
+      return data[p1 * s23 + p2 * s3 + p3];
+    };
+    inline const std::complex<float>& elem(uint32_t p1, uint32_t p2,
+                                           uint32_t p3) const
+    {
+      return data[p1 * s23 + p2 * s3 + p3];
+    };
+    inline std::complex<float>& elem000() { return data[0]; };
+    inline const std::complex<float>& elem000() const { return data[0]; };
+    inline std::complex<float>& elem00x(uint32_t p3) { return data[p3]; };
+    inline const std::complex<float>& elem00x(uint32_t p3) const
+    {
+      return data[p3];
+    };
+    inline void clear() { data.clear(); };
+
+  protected:
+    uint32_t s1;
+    uint32_t s2;
+    uint32_t s3;
+    uint32_t s23;
+    TASCAR::spec_t data;
+  };
+
+  class cmat2_t {
+  public:
+    cmat2_t(uint32_t d1, uint32_t d2);
+    inline std::complex<float>& elem(uint32_t p1, uint32_t p2)
+    {
+      return data[p1 * s2 + p2];
+    };
+    inline const std::complex<float>& elem(uint32_t p1, uint32_t p2) const
+    {
+      return data[p1 * s2 + p2];
+    };
+    inline std::complex<float>& elem00() { return data[0]; };
+    inline const std::complex<float>& elem00() const { return data[0]; };
+    inline std::complex<float>& elem0x(uint32_t p2) { return data[p2]; };
+    inline const std::complex<float>& elem0x(uint32_t p2) const
+    {
+      return data[p2];
+    };
+    inline void clear() { data.clear(); };
+
+  protected:
+    uint32_t s1;
+    uint32_t s2;
+    TASCAR::spec_t data;
+  };
+
+  class cmat1_t {
+  public:
+    cmat1_t(uint32_t d1);
+    inline std::complex<float>& elem(uint32_t p1) { return data[p1]; };
+    inline const std::complex<float>& elem(uint32_t p1) const
+    {
+      return data[p1];
+    };
+    inline std::complex<float>& elem0() { return data[0]; };
+    inline const std::complex<float>& elem0() const { return data[0]; };
+    inline void clear() { data.clear(); };
+
+  protected:
+    uint32_t s1;
+    TASCAR::spec_t data;
+  };
+
+  /**
+     \brief Low-pass and allpass reflection filter for complex-valued
+     2D HOA signals
+
+     y[n] = -g x[n] + x[n-1] + g y[n-1]
+  */
+  class hoa2d_reflectionfilter_t {
+  public:
+    hoa2d_reflectionfilter_t(uint32_t d1, uint32_t d2);
+    inline void filter(std::complex<float>& x, uint32_t p1, uint32_t p2)
+    {
+      x = B1 * x - A2 * sy.elem(p1, p2);
+      sy.elem(p1, p2) = x;
+      // all pass section:
+      std::complex<float> tmp(eta[p1] * x + sapx.elem(p1, p2));
+      sapx.elem(p1, p2) = x;
+      x = tmp - eta[p1] * sapy.elem(p1, p2);
+      sapy.elem(p1, p2) = x;
+    };
+    void set_lp(float g, float c);
+
+  protected:
+    float B1;
+    float A2;
+    std::vector<float> eta;
+    cmat2_t sy;
+    cmat2_t sapx;
+    cmat2_t sapy;
+  };
+
+  /**
+     \brief Feedback delay network with rotation of 2D HOA signals
+
+     The feedback matrix can be either a dense circulant matrix, which
+     is applied sample by sample with a cost of O(N^2) per order, or
+     one of the structured unitary matrices (Householder or
+     normalized Hadamard), which are applied as fast transforms with
+     a cost of O(N) or O(N log N), respectively. Structured feedback
+     matrices are processed in blocks of up to the shortest delay
+     line length.
+  */
+  class hoa2d_fdn_t {
+  public:
+    enum feedback_t { dense, householder, hadamard };
+    /**
+       \param fdnorder Number of FDN paths
+       \param amborder Ambisonics order
+       \param maxdelay Maximum delay line length in samples
+       \param logdelays Use logarithmic delay distribution
+       \param dumpmatrix Show feedback matrix on console
+       \param fb Feedback matrix type
+       \param maxblock Maximum block size for block processing
+     */
+    hoa2d_fdn_t(uint32_t fdnorder, uint32_t amborder, uint32_t maxdelay,
+                bool logdelays, bool dumpmatrix, feedback_t fb = dense,
+                uint32_t maxblock = 1u);
+    ~hoa2d_fdn_t();
+    /**
+       \brief Process one sample with the dense feedback matrix
+
+       Input is taken from inval, output is written to outval.
+     */
+    inline void process(bool b_prefilt)
+    {
+      if(b_prefilt) {
+        for(uint32_t o = 0; o < amborder1; ++o) {
+          prefilt.filter(inval.elem(o), 0, o);
+          prefilt.filter(inval.elem(o), 1, o);
+        }
+      }
+      outval.clear();
+      // get output values from delayline, apply reflection filters and
+      // rotation:
+      for(uint32_t tap = 0; tap < fdnorder_; ++tap)
+        for(uint32_t o = 0; o < amborder1; ++o) {
+          std::complex<float> tmp(delayline.elem(tap, pos[tap], o));
+          reflection.filter(tmp, tap, o);
+          tmp *= rotation.elem(tap, o);
+          dlout.elem(tap, o) = tmp;
+          outval.elem(o) += tmp;
+        }
+      // put rotated+attenuated value to delayline, add input:
+      for(uint32_t tap = 0; tap < fdnorder_; ++tap) {
+        // first put input into delayline:
+        for(uint32_t o = 0; o < amborder1; ++o)
+          delayline.elem(tap, pos[tap], o) = inval.elem(o);
+        // now add feedback signal:
+        for(uint32_t otap = 0; otap < fdnorder_; ++otap)
+          for(uint32_t o = 0; o < amborder1; ++o)
+            delayline.elem(tap, pos[tap], o) +=
+                dlout.elem(otap, o) * feedbackmat.elem(tap, otap, o);
+        // iterate delayline:
+        if(!pos[tap])
+          pos[tap] = delay[tap];
+        if(pos[tap])
+          --pos[tap];
+      }
+    };
+    /**
+       \brief Process a block of samples
+
+       Dense feedback is processed sample by sample, structured
+       feedback is processed in sub-blocks of up to the shortest delay
+       line length.
+
+       \param in Input samples, n x (amborder+1), modified if b_prefilt
+       is true
+       \param out Output samples, n x (amborder+1)
+       \param n Number of samples, must not exceed maxblock
+       \param b_prefilt Apply pre-filters to input
+     */
+    void process(cmat2_t& in, cmat2_t& out, uint32_t n, bool b_prefilt);
+    void setpar(float az, float daz, float t, float dt, float g, float damping);
+    void set_logdelays(bool ld) { logdelays_ = ld; };
+    uint32_t get_mindelay() const { return mindelay; };
+    feedback_t get_feedback() const { return feedback_; };
+    /**
+       \brief Apply structured feedback matrix to matrix of FDN path
+       signals (fdnorder x amborder+1) in place
+     */
+    void apply_feedback(cmat2_t& x) const;
+
+  private:
+    void process_subblock(cmat2_t& in, cmat2_t& out, uint32_t t0,
+                          uint32_t n);
+    bool logdelays_;
+    uint32_t fdnorder_;
+    uint32_t amborder1;
+    uint32_t maxdelay_;
+    feedback_t feedback_;
+    uint32_t maxblock_;
+    // delayline:
+    cmat3_t delayline;
+    // feedback matrix:
+    cmat3_t feedbackmat;
+    // reflection filter:
+    hoa2d_reflectionfilter_t reflection;
+    hoa2d_reflectionfilter_t prefilt;
+    // rotation:
+    cmat2_t rotation;
+    // delayline output for reflection filters:
+    cmat2_t dlout;
+    // delayline output of one block, for block processing:
+    cmat3_t dlblock;
+    // delays:
+    uint32_t* delay;
+    // delayline pointer:
+    uint32_t* pos;
+    // shortest delay:
+    uint32_t mindelay;
+    // show feedback matrix on console:
+    bool dumpmatrix;
+
+  public:
+    // input HOA sample:
+    cmat1_t inval;
+    // output HOA sample:
+    cmat1_t outval;
+  };
+
+  hoa2d_fdn_t::feedback_t hoa2d_fdn_feedback_type(const std::string& s);
+
+} // namespace TASCAR
+
+#endif
+
+/*
+ * Local Variables:
+ * mode: c++
+ * c-basic-offset: 2
+ * indent-tabs-mode: nil
+ * compile-command: "make -C .."
+ * End:
+ */
@@ -46,6 +46,18 @@ namespace TASCAR {
                  const std::string& ofname, double starttime, bool b_dynamic );
     void render_ir( uint32_t len, double fs, const std::string& ofname,
                     double starttime, uint32_t inputchannel );
+    /**
+       \brief Select sparse synthesis of impulse responses
+
+       If enabled, render_ir() uses TASCAR::ir_synthesizer_t, which
+       evaluates each sound path once instead of processing the
+       impulse by the complete signal chain. If the scene is not
+       supported, a warning is issued and the complete signal chain
+       is used.
+       \param sparse Use sparse synthesis
+       \param fragsize Period length of receiver processing in samples
+    */
+    void set_sparse_ir( bool sparse, uint32_t fragsize = 64u );
     ~wav_render_t();
     virtual void validate_attributes(std::string&) const;
 
@@ -55,6 +67,8 @@ namespace TASCAR {
     render_core_t* pscene;
     bool verbose_;
     std::vector<size_t> ochannels;
+    bool sparse_ir;
+    uint32_t sparse_fragsize;
 
   public:
     clock_t t0;
@@ -0,0 +1,107 @@
+/*
+ * This file is part of the TASCAR software, see <http://tascar.org/>
+ *
+ * Copyright (c) 2026 agent
+ */
+/*
+ * TASCAR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, version 3 of the License.
+ *
+ * TASCAR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHATABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License, version 3 for more details.
+ *
+ * You should have received a copy of the GNU General Public License,
+ * Version 3 along with TASCAR. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef IRSYNTH_H
+#define IRSYNTH_H
+
+#include "render.h"
+
+namespace TASCAR {
+
+  /**
+     \brief Offline impulse response synthesis from the list of sound
+     paths
+
+     Instead of feeding a unit impulse through the complete signal
+     chain, the response of each sound path (primary source or image
+     source) is evaluated once: The delay line reduces to the taps of
+     the fractional delay, followed by gain and air absorption. Source
+     characteristics, obstacles and reflection filters are processed
+     only as long as their output is not zero. Receivers render a
+     sound path only in the periods to which it contributes, unless
+     their point source rendering has memory (see
+     receivermod_base_t::is_memoryless()). Post-processing of the
+     receivers, e.g., scattering, decoding and receiver plugins, is
+     processed in every period.
+
+     For static scenes, the result matches the impulse response of
+     the complete signal chain within numerical precision. Diffuse
+     sound fields are not rendered, and delay lines with half
+     precision storage are evaluated at full precision. Scenes with
+     diffuse reverbs or source clustering are not supported.
+  */
+  class ir_synthesizer_t {
+  public:
+    /**
+       \param scene Prepared scene, the fragment size defines the
+       period length of receiver processing
+       \param threshold Magnitude below which filter tails are truncated
+    */
+    ir_synthesizer_t(render_core_t& scene, float threshold = 1e-9f);
+    /**
+       \brief Check if a scene can be rendered by sparse synthesis
+       \param scene Scene
+       \param inputchannel Input channel of impulse
+       \retval reason Reason if not supported
+       \return True if supported
+    */
+    static bool is_supported(const render_core_t& scene,
+                             uint32_t inputchannel, std::string& reason);
+    /**
+       \brief Synthesize impulse response
+       \param len Length of impulse response in samples
+       \param tp Transport state, defines time of geometry
+       \param inputchannel Input channel of impulse
+       \retval output Output buffers, one per output port, with len samples
+    */
+    void process(uint32_t len, const TASCAR::transport_t& tp,
+                 uint32_t inputchannel, const std::vector<float*>& output);
+    /// Number of sound paths with a response in last call of process()
+    size_t get_num_paths() const { return num_paths; };
+    /// Total length of all path responses in samples
+    size_t get_num_taps() const { return num_taps; };
+
+  private:
+    class path_t {
+    public:
+      Acousticmodel::acoustic_model_t* model = NULL;
+      bool memoryless = true;
+      bool live = false;
+      std::vector<float> input;
+      uint32_t offset = 0u;
+      std::vector<float> h;
+    };
+    render_core_t& scene;
+    float threshold;
+    size_t num_paths = 0u;
+    size_t num_taps = 0u;
+  };
+
+} // namespace TASCAR
+
+#endif
+
+/*
+ * Local Variables:
+ * mode: c++
+ * c-basic-offset: 2
+ * indent-tabs-mode: nil
+ * compile-command: "make -C .."
+ * End:
+ */
@@ -30,7 +30,9 @@
 
 #include <atomic>
 #include <jack/jack.h>
+#include <map>
 #include <pthread.h>
+#include <set>
 #include <string>
 #include <vector>
 #include <mutex>
@@ -163,6 +165,80 @@ private:
   uint32_t inner_pos;
 };
 
+/**
+   \brief Batched creation of JACK port connections
+
+   The port graph is read once with update_graph(). Port name patterns
+   are then resolved locally, and connections which already exist are
+   skipped, so that only missing connections are requested from the
+   JACK server in apply().
+*/
+class jack_connection_planner_t {
+public:
+  jack_connection_planner_t(jack_client_t* jc);
+  /// Read all audio ports and their connections from the JACK server
+  void update_graph();
+  /**
+     \brief Add connections to the plan
+
+     The parameters are the same as in jackc_portless_t::connect().
+     Ports are resolved from the port graph as read by
+     update_graph(), including the connections planned so far.
+     Failures to resolve port names are reported immediately, failures
+     to connect are reported in apply().
+  */
+  void add(const std::string& src, const std::string& dest, bool btry = false,
+           bool allowoutputsource = false, bool connectmulti = false,
+           bool allowinputdest = false, bool noconnecttoself = false);
+  /**
+     \brief Create all planned connections
+     \return Number of new connections
+  */
+  size_t apply();
+  /// Remove all connections which were created by apply()
+  void disconnect();
+  /// Number of connections requested from the JACK server
+  size_t get_num_planned() const { return num_planned; };
+  /// Number of skipped connections, which already existed
+  size_t get_num_existing() const { return num_existing; };
+  /// Number of connections created by apply()
+  size_t get_num_connected() const { return connected.size(); };
+  /// Time spent in update_graph(), in seconds
+  double get_graph_time() const { return t_graph; };
+  /// Time spent in add(), in seconds
+  double get_plan_time() const { return t_plan; };
+  /// Time spent in apply(), in seconds
+  double get_connect_time() const { return t_connect; };
+
+private:
+  struct port_t {
+    int flags = 0;
+    bool mine = false;
+    std::set<std::string> connections;
+  };
+  struct connection_t {
+    std::string src;
+    std::string dest;
+    bool btry;
+  };
+  std::vector<std::string> match(std::string pattern) const;
+  bool is_mine(const std::string& port) const;
+  void resolve(const std::string& src, const std::string& dest, bool btry,
+               bool allowoutputsource, bool connectmulti, bool allowinputdest,
+               bool noconnecttoself);
+  void plan(const std::string& src, const std::string& dest, bool btry);
+  jack_client_t* jc;
+  std::vector<std::string> portnames;
+  std::map<std::string, port_t> ports;
+  std::vector<connection_t> planned;
+  std::vector<connection_t> connected;
+  size_t num_planned = 0u;
+  size_t num_existing = 0u;
+  double t_graph = 0.0;
+  double t_plan = 0.0;
+  double t_connect = 0.0;
+};
+
 class jackc_transport_t : public jackc_t {
 public:
   jackc_transport_t(const std::string& clientname);
@@ -30,6 +30,14 @@ namespace TASCAR {
     scene_render_rt_t(tsccfg::node_t xmlsrc);
     virtual ~scene_render_rt_t();
     void run(bool &b_quit);
+    /**
+       \brief Prepare all objects for audio processing
+
+       Called by start() if not called before. Scenes are independent
+       of each other, thus several scenes can be prepared in parallel
+       before their ports are created in start().
+    */
+    void prepare_audio();
     void start();
     void stop();
   private:
@@ -0,0 +1,104 @@
+/*
+ * This file is part of the TASCAR software, see <http://tascar.org/>
+ *
+ * Copyright (c) 2026 agent
+ */
+/*
+ * TASCAR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, version 3 of the License.
+ *
+ * TASCAR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHATABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License, version 3 for more details.
+ *
+ * You should have received a copy of the GNU General Public License,
+ * Version 3 along with TASCAR. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MESH_H
+#define MESH_H
+
+#include "coordinates.h"
+
+namespace TASCAR {
+
+  /// Polygon mesh, each face is a list of vertices
+  typedef std::vector<std::vector<TASCAR::pos_t>> mesh_t;
+
+  /**
+     \brief Merge adjacent coplanar faces of a polygon mesh
+
+     Vertices closer than the distance tolerance are treated as
+     identical. Two faces are adjacent if they share an edge with
+     opposite direction, i.e., same orientation of the faces. They are
+     merged if their normals differ by less than the angle tolerance,
+     all vertices are within the distance tolerance of the plane of
+     the merged face, and the result is a simple polygon without
+     holes. Finally, vertices on straight edges are removed.
+
+     \param faces Input mesh
+     \param angle Angle tolerance in radians
+     \param dist Distance tolerance in meters
+     \return Merged mesh
+  */
+  mesh_t merge_coplanar_faces(const mesh_t& faces, double angle, double dist);
+
+  /**
+     \brief Remove faces with an aperture below a threshold
+
+     The aperture is the diameter of a circle of same area as the
+     face, see TASCAR::ngon_t::get_aperture().
+
+     \param faces Input mesh
+     \param minaperture Minimal aperture in meters
+     \return Mesh with large faces only
+  */
+  mesh_t remove_small_faces(const mesh_t& faces, double minaperture);
+
+  /**
+     \brief Parameters of mesh preprocessing
+  */
+  class mesh_preprocessing_cfg_t {
+  public:
+    /// Merge adjacent coplanar faces
+    bool merge = false;
+    /// Angle tolerance for merging, in radians
+    double angle = 0.0;
+    /// Distance tolerance for merging, in meters
+    double dist = 0.0;
+    /// Minimal face aperture in meters, or zero to keep all faces
+    double minaperture = 0.0;
+  };
+
+  /**
+     \brief Merge coplanar faces and remove small faces, using a disk cache
+
+     The results are stored in the "mesh" category of
+     TASCAR::diskcache_t, with a hash of the input mesh and the
+     parameters as a key. Vertices are stored in single precision.
+
+     \param faces Input mesh
+     \param cfg Preprocessing parameters
+     \param usecache Read results from and write to disk cache
+     \retval cachehit Optional pointer to flag set to true if the
+     results were read from the disk cache
+     \return Processed mesh
+  */
+  mesh_t preprocess_mesh(const mesh_t& faces,
+                         const mesh_preprocessing_cfg_t& cfg,
+                         bool usecache = true, bool* cachehit = NULL);
+
+} // namespace TASCAR
+
+#endif
+
+/*
+ * Local Variables:
+ * mode: c++
+ * c-basic-offset: 2
+ * indent-tabs-mode: nil
+ * compile-command: "make -C .."
+ * End:
+ */
@@ -0,0 +1,239 @@
+/*
+ * This file is part of the TASCAR software, see <http://tascar.org/>
+ *
+ * Copyright (c) 2021 FSchwark, Giso Grimm
+ */
+/*
+ * TASCAR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, version 3 of the License.
+ *
+ * TASCAR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHATABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License, version 3 for more details.
+ *
+ * You should have received a copy of the GNU General Public License,
+ * Version 3 along with TASCAR. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MICARRAY_H
+#define MICARRAY_H
+
+#include "delayline.h"
+#include "filterclass.h"
+#include <limits>
+
+namespace TASCAR {
+
+  /**
+     \brief Generator of filter coefficients of a microphone array
+     node, based on axis and relative source position
+  */
+  class micarray_filter_t {
+  public:
+    // filter types, extend as needed:
+    enum filtertype_t { equalizer, highshelf };
+    /**
+       \brief The model function, called once in each process cycle
+       \param flt Reference to a filter to be updated
+       \param rel_pos Relative position
+       \param fs Sampling rate in Hz
+    */
+    void update_par(TASCAR::biquad_t& flt, const TASCAR::pos_t& rel_pos,
+                    double fs) const;
+
+    // Model parameters:
+    TASCAR::pos_t axis;
+    filtertype_t filtertype = equalizer;
+    // high-shelf parameters
+    double theta_st = std::numeric_limits<double>::quiet_NaN();
+    double beta = std::numeric_limits<double>::quiet_NaN();
+    double omega = std::numeric_limits<double>::quiet_NaN();
+    double alpha_st = std::numeric_limits<double>::quiet_NaN();
+    double alpha_m = std::numeric_limits<double>::quiet_NaN();
+    // equalizer parameters
+    double theta_end = std::numeric_limits<double>::quiet_NaN();
+    double gain_st = std::numeric_limits<double>::quiet_NaN();
+    double gain_end = std::numeric_limits<double>::quiet_NaN();
+    double omega_st = std::numeric_limits<double>::quiet_NaN();
+    double omega_end = std::numeric_limits<double>::quiet_NaN();
+    double Q = std::numeric_limits<double>::quiet_NaN();
+  };
+
+  /**
+     \brief Single node of a hierarchical microphone array
+
+     Each node represents one output channel. Its transfer function
+     relative to the parent node is given by a delay model and a
+     cascade of filter models.
+  */
+  class micarray_node_t {
+  public:
+    // delay line model types:
+    enum delayline_model_t { freefield, sphere };
+    /// Index of parent node, or -1 for the origin
+    int32_t parent = -1;
+    /// Position relative to receiver origin
+    TASCAR::pos_t position;
+    /// Position of parent node
+    TASCAR::pos_t parentposition;
+    delayline_model_t delaylinemodel = freefield;
+    uint32_t sincorder = 0;
+    uint32_t sincsampling = 64;
+    std::vector<micarray_filter_t> filters;
+    /**
+       \brief Delay w.r.t. parent node, in meters
+       \param rel_pos Source position relative to receiver
+    */
+    double get_tau(const TASCAR::pos_t& rel_pos) const;
+  };
+
+  /**
+     \brief Compiled description of a hierarchical microphone array
+
+     Nodes are stored in depth-first order, i.e., each parent
+     precedes its children, and the node index is the output channel
+     index.
+  */
+  class micarray_layout_t {
+  public:
+    micarray_layout_t(double c = 340.0);
+    /**
+       \brief Append a node
+       \return Index of the new node
+    */
+    size_t add_node(const micarray_node_t& node);
+    /// Maximal possible delay due to sphere delay model, in seconds
+    double get_delay_comp() const;
+    size_t size() const { return nodes.size(); };
+    double c;
+    std::vector<micarray_node_t> nodes;
+  };
+
+  /**
+     \brief Signal processor and state of one source rendered to a
+     microphone array
+  */
+  class micarray_processor_t {
+  public:
+    micarray_processor_t(const micarray_layout_t& layout, double fs,
+                         uint32_t fragsize);
+    virtual ~micarray_processor_t(){};
+    /**
+       \brief Add source signal to microphone array outputs
+       \param input Source signal
+       \param rel_pos Source position relative to receiver
+       \param output Output channels, one per node
+    */
+    virtual void process(const TASCAR::wave_t& input,
+                         const TASCAR::pos_t& rel_pos,
+                         std::vector<TASCAR::wave_t>& output) = 0;
+
+  protected:
+    /// Compute delay of each node at the end of the chunk, in meters
+    void update_target_tau(const TASCAR::pos_t& rel_pos);
+    const micarray_layout_t& layout;
+    double fs;
+    double dt;
+    /// Delay of the origin, to keep all delays positive, in meters
+    double tau_origin;
+    /// Delay line length of each node, in samples
+    std::vector<uint32_t> maxdelay;
+    /// Total delay at begin of chunk, in meters
+    std::vector<double> tau;
+    /// Total delay at end of chunk, in meters
+    std::vector<double> target_tau;
+  };
+
+  /**
+     \brief Reference implementation, traversing the tree
+
+     Each node owns a delay line and a filter cascade, the filtered
+     signal of a node is the input of its children.
+  */
+  class micarray_tree_processor_t : public micarray_processor_t {
+  public:
+    micarray_tree_processor_t(const micarray_layout_t& layout, double fs,
+                              uint32_t fragsize);
+    ~micarray_tree_processor_t();
+    void process(const TASCAR::wave_t& input, const TASCAR::pos_t& rel_pos,
+                 std::vector<TASCAR::wave_t>& output);
+
+  private:
+    std::vector<TASCAR::wave_t> sigbuf;
+    std::vector<TASCAR::varidelay_t*> dline;
+    std::vector<std::vector<TASCAR::biquad_t>> filters;
+  };
+
+  /**
+     \brief Flattened processing of all nodes
+
+     The source signal, filtered by the filters of the origin, is
+     stored in one shared delay history, from which each node reads
+     its total delay as a single tap. The remaining filters of all
+     nodes along their path to the origin are then applied with a
+     structure-of-arrays biquad bank, processing all nodes of one
+     sample in the inner loop.
+
+     Since delay and filters below the origin are swapped with respect
+     to the tree processor, the output is identical only for static
+     sources; for moving sources they differ by the Doppler shift of
+     the filter responses.
+  */
+  class micarray_flat_processor_t : public micarray_processor_t {
+  public:
+    micarray_flat_processor_t(const micarray_layout_t& layout, double fs,
+                              uint32_t fragsize);
+    void process(const TASCAR::wave_t& input, const TASCAR::pos_t& rel_pos,
+                 std::vector<TASCAR::wave_t>& output);
+
+  private:
+    uint32_t nnodes;
+    uint32_t nstages;
+    float dist2sample;
+    // filters of origin:
+    std::vector<TASCAR::biquad_t> prefilt;
+    TASCAR::wave_t prebuf;
+    // shared delay history:
+    std::vector<float> history;
+    uint32_t mask;
+    uint32_t pos = 0u;
+    // sinc tables, one per distinct order and sampling:
+    std::vector<TASCAR::sinctable_t> sinc;
+    std::vector<uint32_t> sincidx;
+    // interpolation weights and delays for constant delay:
+    std::vector<float> weights;
+    std::vector<uint32_t> taps;
+    // node index of each slot, sorted by number of filter stages:
+    std::vector<uint32_t> slot_node;
+    // delayed signals, slots are the fastest varying dimension:
+    std::vector<float> buf;
+    // filter models (node, index) of all nodes except the origin:
+    std::vector<std::pair<uint32_t, uint32_t>> flt_src;
+    std::vector<TASCAR::biquad_t> flt;
+    // filter bank, stage-major, number of active slots per stage:
+    std::vector<uint32_t> stage_nodes;
+    // index into flt of each stage and slot:
+    std::vector<uint32_t> stage_src;
+    std::vector<double> a1;
+    std::vector<double> a2;
+    std::vector<double> b0;
+    std::vector<double> b1;
+    std::vector<double> b2;
+    std::vector<double> z1;
+    std::vector<double> z2;
+  };
+
+} // namespace TASCAR
+
+#endif
+
+/*
+ * Local Variables:
+ * mode: c++
+ * c-basic-offset: 2
+ * indent-tabs-mode: nil
+ * compile-command: "make -C .."
+ * End:
+ */
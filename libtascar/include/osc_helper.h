@@ -35,6 +35,7 @@
 #endif
 #include <atomic>
 #include <condition_variable>
+#include <functional>
 #include <lo/lo.h>
 #include <mutex>
 #include <string>
@@ -164,6 +165,16 @@ namespace TASCAR {
     void add_float(const std::string& path, float* data,
                    const std::string& range = "",
                    const std::string& comment = "");
+    /** \brief Register a float variable for read-only OSC access
+
+        Only the "/get" method is registered, the value can not be
+        changed via OSC.
+
+        \param path OSC path
+        \param data Pointer to data
+     */
+    void add_float_readonly(const std::string& path, float* data,
+                            const std::string& comment = "");
     /** \brief Register a float variable for OSC access, convert from dB values
 
         In coming messages will be converted from dB to linear representation.
@@ -304,6 +315,22 @@ namespace TASCAR {
     void set_variable_owner(const std::string& owner);
     void unset_variable_owner();
 
+    /**
+       @brief Set a handler which is called for every message received
+       from the network, e.g., for recording
+
+       Messages which are dispatched internally, e.g., from scripts,
+       timed messages or replays, are not passed to the handler. The
+       control messages /capture/... and /replay/... are not passed
+       either.
+
+       @param h Handler, or empty function to remove the handler
+     */
+    void
+    set_capture_handler(std::function<void(const char*, lo_message)> h);
+    /// Call capture handler, used by the OSC server thread
+    void capture(const char* path, lo_message msg);
+
     void generate_osc_documentation_files();
 
   private:
@@ -328,6 +355,9 @@ namespace TASCAR {
     std::vector<std::string> nextscripts;
     std::condition_variable cond_var_script;
     std::mutex mtxdispatch;
+    std::mutex mtxcapture;
+    std::atomic_bool capturing;
+    std::function<void(const char*, lo_message)> capture_handler;
     std::map<double, std::vector<msg_t>> timed_messages;
     std::mutex mtxtimedmessages;
     std::map<std::string, std::map<std::string, descriptor_t>> owned_vars;
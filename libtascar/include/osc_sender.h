@@ -0,0 +1,173 @@
+/*
+ * This file is part of the TASCAR software, see <http://tascar.org/>
+ *
+ * Copyright (c) 2026 agent
+ */
+/*
+ * TASCAR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, version 3 of the License.
+ *
+ * TASCAR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHATABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License, version 3 for more details.
+ *
+ * You should have received a copy of the GNU General Public License,
+ * Version 3 along with TASCAR. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef OSC_SENDER_H
+#define OSC_SENDER_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <lo/lo.h>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace TASCAR {
+
+  /**
+     \brief Real-time safe sending of OSC messages
+
+     Messages are registered in the configuration phase with a fixed
+     destination, path and type specification. In the real-time
+     thread, the arguments are written into preallocated slots of a
+     lock-free queue, without memory allocation or system calls. A
+     sender thread collects the messages, combines all pending
+     messages of a destination into one OSC bundle, and sends them.
+
+     State messages (e.g., levels or positions) are coalesced: If
+     more than one state message with the same destination and path
+     is pending, only the latest one is sent, also if they were posted
+     via different slots. Event messages (e.g., onsets) are sent
+     completely. Messages are dropped if the queue of a slot is full.
+  */
+  class osc_sender_t {
+  public:
+    /// Maximum length of string arguments, including terminating zero
+    static const size_t max_strlen = 64u;
+    class target_t;
+    /**
+       \brief Message slot, to be used by one real-time producer
+    */
+    class message_t {
+    public:
+      /// Set float argument of next message
+      void set_float(size_t k, float v) { next().num[k] = v; };
+      /// Set integer argument of next message
+      void set_int(size_t k, int32_t v) { next().num[k] = v; };
+      /// Set double argument of next message
+      void set_double(size_t k, double v) { next().num[k] = v; };
+      /// Set string argument of next message, truncated if too long
+      void set_string(size_t k, const char* s);
+      /**
+         \brief Send message with current arguments
+         \return False if the message was dropped
+      */
+      bool post();
+      const std::string& get_path() const { return path; };
+      const std::string& get_typespec() const { return typespec; };
+
+    private:
+      message_t(target_t* target, const std::string& path,
+                const std::string& typespec, bool coalesce,
+                size_t queuelen);
+      struct entry_t {
+        std::vector<double> num;
+        std::vector<std::array<char, max_strlen>> str;
+        std::chrono::steady_clock::time_point t;
+      };
+      entry_t& next() { return queue[wpos.load(std::memory_order_relaxed)]; };
+      lo_message create_lo_message(const entry_t& e) const;
+      target_t* target;
+      std::string path;
+      std::string typespec;
+      bool coalesce;
+      std::vector<entry_t> queue;
+      std::atomic<size_t> wpos = 0u;
+      std::atomic<size_t> rpos = 0u;
+      std::atomic<size_t> dropped = 0u;
+      // latest pending state message, accessed only by sender:
+      entry_t latest;
+      bool has_latest = false;
+      friend class osc_sender_t;
+    };
+    /**
+       \brief Constructor
+       \param period Period of sender thread in seconds, or zero to not
+       start a sender thread (messages are sent by process())
+    */
+    osc_sender_t(double period);
+    ~osc_sender_t();
+    /// Session-wide sender, period is configured by "tascar.osc.sendperiod"
+    static osc_sender_t& get();
+    /**
+       \brief Register a message slot
+       \param url Destination URL
+       \param path OSC path
+       \param typespec Argument types, any of 'f', 'd', 'i', 's'
+       \param coalesce Send only latest pending message (state message)
+       \param maxrate Maximum rate of bundles to this destination in Hz,
+       or zero for no limit (applies to all messages of the destination)
+       \param ttl Time to live of multicast messages; messages to the
+       same URL with a different ttl are sent via a separate address
+       \param queuelen Number of messages which can be pending
+    */
+    message_t* add_message(const std::string& url, const std::string& path,
+                           const std::string& typespec, bool coalesce = true,
+                           double maxrate = 0.0, int ttl = 1,
+                           size_t queuelen = 16u);
+    /// Remove a message slot, the slot can not be used after this call
+    void remove_message(message_t* msg);
+    /// Send all pending messages, return number of sent messages
+    size_t process();
+    /// Number of messages dropped because of queue overflow
+    size_t get_num_dropped();
+    /// Number of sent messages
+    size_t get_num_sent() const { return num_sent; };
+    /// Number of state messages which were replaced by a newer message
+    size_t get_num_coalesced() const { return num_coalesced; };
+    /// Number of sent OSC bundles
+    size_t get_num_bundles() const { return num_bundles; };
+    /// Maximum latency between posting and sending of a message, in seconds
+    double get_max_latency() const { return max_latency; };
+    /// Average latency between posting and sending of a message, in seconds
+    double get_mean_latency() const;
+    /// Reset counters
+    void reset_counters();
+
+  private:
+    osc_sender_t(const osc_sender_t&);
+    void sendthread();
+    std::mutex mtx;
+    std::vector<target_t*> targets;
+    std::vector<message_t*> messages;
+    double period;
+    std::atomic<bool> run_thread = true;
+    std::thread thread;
+    std::atomic<size_t> num_sent = 0u;
+    std::atomic<size_t> num_coalesced = 0u;
+    std::atomic<size_t> num_bundles = 0u;
+    std::atomic<size_t> num_dropped_removed = 0u;
+    std::atomic<double> max_latency = 0.0;
+    std::atomic<double> sum_latency = 0.0;
+  };
+
+} // namespace TASCAR
+
+#endif
+
+/*
+ * Local Variables:
+ * mode: c++
+ * c-basic-offset: 2
+ * indent-tabs-mode: nil
+ * compile-command: "make -C .."
+ * End:
+ */
@@ -0,0 +1,159 @@
+/*
+ * This file is part of the TASCAR software, see <http://tascar.org/>
+ *
+ * Copyright (c) 2026 agent
+ */
+/*
+ * TASCAR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, version 3 of the License.
+ *
+ * TASCAR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHATABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License, version 3 for more details.
+ *
+ * You should have received a copy of the GNU General Public License,
+ * Version 3 along with TASCAR. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef OSCLOG_H
+#define OSCLOG_H
+
+#include <lo/lo.h>
+#include <mutex>
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+namespace TASCAR {
+
+  /**
+     \brief Header of a binary OSC log file
+
+     The file consists of this header, followed by records of a frame
+     time stamp (uint64), the message size in bytes (uint32) and the
+     serialized OSC message, in native byte order. Frame time stamps
+     are relative to the start of recording.
+  */
+  struct osc_log_header_t {
+    char magic[8] = {'T', 'S', 'C', 'O', 'S', 'C', 'L', 'G'};
+    uint32_t version = 1u;
+    /// Sampling rate of recording session in Hz
+    uint32_t srate = 0u;
+    /// Fragment size of recording session
+    uint32_t fragsize = 0u;
+    uint32_t reserved = 0u;
+    /// Frame at which the transport started rolling
+    uint64_t anchor = 0u;
+  };
+
+  /**
+     \brief Writer of binary OSC log files
+
+     Messages can be added from any thread.
+  */
+  class osc_log_writer_t {
+  public:
+    osc_log_writer_t(const std::string& fname, uint32_t srate,
+                     uint32_t fragsize);
+    ~osc_log_writer_t();
+    /// Add serialized OSC message
+    void add(uint64_t frame, const void* data, uint32_t size);
+    /// Serialize and add OSC message
+    void add(uint64_t frame, const char* path, lo_message msg);
+    /// Set frame at which the transport started rolling
+    void set_anchor(uint64_t frame);
+    size_t get_num_messages() const { return nmsg; };
+    size_t get_num_bytes() const { return nbytes; };
+
+  private:
+    osc_log_writer_t(const osc_log_writer_t&);
+    std::mutex mtx;
+    FILE* fh = NULL;
+    osc_log_header_t header;
+    size_t nmsg = 0u;
+    size_t nbytes = 0u;
+  };
+
+  /**
+     \brief Reader of binary OSC log files
+
+     The complete file is loaded into memory.
+  */
+  class osc_log_reader_t {
+  public:
+    osc_log_reader_t(const std::string& fname);
+    /// Number of messages
+    size_t size() const { return msgs.size(); };
+    /// Frame time stamp of a message
+    uint64_t get_frame(size_t k) const { return msgs[k].frame; };
+    /// Serialized OSC message
+    void* get_data(size_t k) { return &(data[msgs[k].offset]); };
+    /// Size of serialized OSC message in bytes
+    uint32_t get_size(size_t k) const { return msgs[k].size; };
+    /// OSC path of a message
+    std::string get_path(size_t k) const;
+    const osc_log_header_t& get_header() const { return header; };
+
+  private:
+    struct msg_t {
+      uint64_t frame;
+      size_t offset;
+      uint32_t size;
+    };
+    osc_log_header_t header;
+    std::vector<char> data;
+    std::vector<msg_t> msgs;
+  };
+
+  /**
+     \brief Replay schedule of an OSC log file
+
+     Each message is due at the beginning of the first period after
+     its recorded frame, which is the period in which it took effect
+     during recording.
+  */
+  class osc_log_player_t {
+  public:
+    /**
+       \param fname Log file name
+       \param sync Synchronize to transport: Messages recorded before
+       the transport started are due in the first period, and the
+       replay time advances only while the transport is rolling.
+    */
+    osc_log_player_t(const std::string& fname, bool sync);
+    /**
+       \brief Select the messages which are due at the beginning of a
+       period, then advance the replay time by one period
+       \param nframes Period size
+       \param rolling Transport is rolling
+       \param first Index of first due message
+       \param last Index after last due message
+    */
+    void next_period(uint32_t nframes, bool rolling, size_t& first,
+                     size_t& last);
+    /// Number of messages which are not yet due
+    size_t get_remaining() const { return log.size() - next; };
+    osc_log_reader_t log;
+
+  private:
+    bool sync;
+    size_t next = 0u;
+    uint64_t frame = 0u;
+  };
+
+} // namespace TASCAR
+
+#endif
+
+/*
+ * Local Variables:
+ * mode: c++
+ * c-basic-offset: 2
+ * indent-tabs-mode: nil
+ * compile-command: "make -C .."
+ * End:
+ */
@@ -41,6 +41,13 @@ namespace TASCAR {
     void validate_attributes(std::string& msg) const;
     void add_variables(TASCAR::osc_server_t* srv);
     void add_licenses(licensehandler_t*);
+    /**
+       \brief Heap memory of plugins
+
+       \return Module name of each plugin, and heap growth during its
+       preparation (see TASCAR::get_heap_bytes())
+    */
+    std::vector<std::pair<std::string, size_t>> get_memory_usage() const;
 
   protected:
     xml_element_t eplug;
@@ -48,7 +55,13 @@ namespace TASCAR {
     bool use_profiler = false;
     std::string profilingpath = "";
     std::vector<TASCAR::audioplugin_t*> plugins;
+    /// Analysis services, one for each group of plugins with same input
+    std::vector<TASCAR::analysis_service_t*> analysis;
   private:
+    /// Analysis service to be updated before processing of each plugin
+    std::vector<TASCAR::analysis_service_t*> analysis_update;
+    /// Heap growth during preparation of each plugin
+    std::vector<size_t> heap_bytes;
     lo_message msg;
     lo_arg** oscmsgargv;
     TASCAR::osc_server_t* oscsrv = NULL;
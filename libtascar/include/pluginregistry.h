@@ -0,0 +1,124 @@
+/*
+ * This file is part of the TASCAR software, see <http://tascar.org/>
+ *
+ * Copyright (c) 2026 agent
+ */
+/*
+ * TASCAR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, version 3 of the License.
+ *
+ * TASCAR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHATABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License, version 3 for more details.
+ *
+ * You should have received a copy of the GNU General Public License,
+ * Version 3 along with TASCAR. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PLUGINREGISTRY_H
+#define PLUGINREGISTRY_H
+
+#include "tscconfig.h"
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace TASCAR {
+
+  /**
+     \brief Process-wide registry of plugin libraries
+
+     Each plugin library is opened only once and stays loaded until
+     the end of the process. The factory functions of plugin base
+     classes are resolved and version-checked once per library, and
+     then taken from a cache. All methods are thread safe.
+  */
+  class plugin_registry_t {
+  public:
+    /// Access the registry instance
+    static plugin_registry_t& get();
+    /**
+       \brief Open a plugin library, or return handle of opened library
+       \param libname File name of library, relative to TASCAR::get_libdir()
+       \retval errmsg Error message in case of failure
+       \return Library handle, or NULL on error
+    */
+    void* open(const std::string& libname, std::string& errmsg);
+    /**
+       \brief Return factory function of a plugin base class
+
+       On first call for a library, the TASCAR version of the plugin
+       is checked. An exception of type TASCAR::ErrMsg is thrown if
+       the version does not match or a symbol can not be resolved.
+
+       \param lib Library handle, as returned by open()
+       \param libname File name of library, used in error messages
+       \param baseclass Name of plugin base class
+       \return Address of factory function
+    */
+    void* get_factory(void* lib, const std::string& libname,
+                      const std::string& baseclass);
+    /**
+       \brief Open a list of plugin libraries in advance
+
+       Errors are ignored here, they are reported when the plugin is
+       instantiated.
+
+       \param libnames File names of libraries
+       \param numthreads Number of worker threads
+       \return Number of libraries which could not be opened
+    */
+    size_t preload(const std::vector<std::string>& libnames,
+                   uint32_t numthreads = 1u);
+    /// Return true if a library was already opened
+    bool is_loaded(const std::string& libname);
+    /// Number of opened libraries
+    size_t get_num_libraries();
+    /// Number of calls of open() which returned an already opened library
+    size_t get_num_cache_hits();
+    /// Number of calls of open() which had to load the library
+    size_t get_num_cache_misses();
+
+  private:
+    plugin_registry_t(){};
+    plugin_registry_t(const plugin_registry_t&);
+    std::mutex mtx;
+    std::map<std::string, void*> libs;
+    std::map<std::pair<void*, std::string>, void*> factories;
+    size_t cache_hits = 0u;
+    size_t cache_misses = 0u;
+  };
+
+  /**
+     \brief Return library file name of a plugin
+     \param prefix Category prefix, e.g., "tascar_ap_" for audio plugins
+     \param type Plugin type
+  */
+  std::string plugin_libname(const std::string& prefix,
+                             const std::string& type);
+
+  /**
+     \brief Return library file names of all plugins referenced in a session
+
+     Receiver types, source types, audio plugins, mask plugins and
+     session modules are collected recursively.
+
+     \param e Root node of session or scene definition
+  */
+  std::vector<std::string> get_plugin_libnames(tsccfg::node_t e);
+
+} // namespace TASCAR
+
+#endif
+
+/*
+ * Local Variables:
+ * mode: c++
+ * c-basic-offset: 2
+ * indent-tabs-mode: nil
+ * compile-command: "make -C .."
+ * End:
+ */
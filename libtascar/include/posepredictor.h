@@ -0,0 +1,124 @@
+/*
+ * This file is part of the TASCAR software, see <http://tascar.org/>
+ *
+ * Copyright (c) 2026 agent
+ */
+/*
+ * TASCAR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, version 3 of the License.
+ *
+ * TASCAR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHATABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License, version 3 for more details.
+ *
+ * You should have received a copy of the GNU General Public License,
+ * Version 3 along with TASCAR. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef POSEPREDICTOR_H
+#define POSEPREDICTOR_H
+
+#include "coordinates.h"
+#include <deque>
+
+namespace TASCAR {
+
+  /**
+     \brief Extrapolation of head orientation to compensate for latency
+
+     The orientation is extrapolated by the prediction horizon with
+     the current angular velocity, taken from a gyroscope or from
+     finite differences of subsequent orientations. Orientations are
+     rotations from body to world coordinates; angular velocities are
+     in body coordinates.
+
+     Each prediction is compared to the orientation measured at its
+     target time. The velocity gain is adapted by a recursive least
+     squares fit of the predicted to the actual rotation, which damps
+     the prediction when it overshoots, e.g., at reversals of head
+     movement.
+  */
+  class pose_predictor_t {
+  public:
+    pose_predictor_t();
+    /// Discard all history
+    void reset();
+    /**
+       \brief Add measured orientation
+       \param t Time in seconds
+       \param q Orientation
+    */
+    void add_orientation(double t, const quaternion_t& q);
+    /**
+       \brief Add measured angular velocity, e.g., from a gyroscope
+       \param t Time in seconds
+       \param omega Angular velocity in body coordinates in rad/s
+    */
+    void add_angular_velocity(double t, const pos_t& omega);
+    /// Orientation predicted for the current time plus horizon
+    quaternion_t predict() const { return predict(horizon); };
+    /// Orientation predicted for the current time plus given horizon
+    quaternion_t predict(double h) const;
+    /// Last measured orientation
+    const quaternion_t& get_orientation() const { return q_cur; };
+    /// Current angular velocity estimate in rad/s
+    const pos_t& get_angular_velocity() const { return omega; };
+    /// Adapted velocity gain, between zero and one
+    double get_gain() const;
+    /// RMS error of predicted orientation in rad
+    double get_error() const { return sqrt(err2_pred); };
+    /// RMS error without prediction, i.e., the lag error, in rad
+    double get_error_unpredicted() const { return sqrt(err2_unpred); };
+    /// Average interval between orientation samples in seconds
+    double get_interval() const { return interval; };
+    /// Prediction horizon in seconds
+    double horizon = 0.05;
+    /// Upper limit of prediction horizon in seconds
+    double maxhorizon = 0.25;
+    /// Adaptation coefficient of velocity gain, or zero for unity gain
+    double adaptation = 0.01;
+    /// Filter coefficient of prediction error estimates
+    double errorsmoothing = 0.01;
+    /// Non-recursive filter coefficient of finite difference velocity
+    double velocitysmoothing = 0.5;
+    /// Gyroscope data older than this are ignored, in seconds
+    double gyrtimeout = 0.1;
+
+  private:
+    /// Prediction waiting for the measurement at its target time
+    struct pending_t {
+      double t;
+      quaternion_t q0;
+      pos_t r;
+      quaternion_t qpred;
+    };
+    void evaluate(double t, const quaternion_t& q);
+    bool has_orientation = false;
+    double t_cur = 0.0;
+    quaternion_t q_cur;
+    pos_t omega;
+    bool has_gyr = false;
+    double t_gyr = 0.0;
+    double interval = 0.0;
+    double err2_pred = 0.0;
+    double err2_unpred = 0.0;
+    double gain_num = 0.0;
+    double gain_den = 0.0;
+    std::deque<pending_t> pending;
+  };
+
+} // namespace TASCAR
+
+#endif
+
+/*
+ * Local Variables:
+ * mode: c++
+ * c-basic-offset: 2
+ * indent-tabs-mode: nil
+ * compile-command: "make -C .."
+ * End:
+ */
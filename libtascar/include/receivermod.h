@@ -41,6 +41,14 @@ namespace TASCAR {
     public:
       data_t(){};
       virtual ~data_t(){};
+      /**
+         \brief Position and width are identical to the previous call
+         of add_pointsource() with this state data
+
+         Set by the acoustic model. Receiver modules may use this flag
+         to reuse their panning gains.
+      */
+      bool unchanged = false;
     };
     /**
        \brief Constructor, mainly parsing of configuration.
@@ -89,6 +97,16 @@ namespace TASCAR {
        This value will be added to the user-provided delay compensation.
      */
     virtual float get_delay_comp() const { return 0.0f; };
+    /**
+       \brief Point source rendering has no memory
+
+       Return true if the contribution of add_pointsource() to a
+       sample depends only on the input sample at the same time, once
+       the panning weights reached their target. Offline impulse
+       response synthesis (TASCAR::ir_synthesizer_t) then skips
+       periods in which the input of a sound path is zero.
+     */
+    virtual bool is_memoryless() const { return false; };
 
   protected:
   };
@@ -174,6 +192,7 @@ namespace TASCAR {
     virtual void add_variables(TASCAR::osc_server_t* srv);
     virtual void validate_attributes(std::string&) const;
     virtual float get_delay_comp() const;
+    virtual bool is_memoryless() const;
 
   private:
     receivermod_t(const receivermod_t&);
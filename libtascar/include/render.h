@@ -22,6 +22,9 @@
 
 #include "async_file.h"
 #include "tascar.h"
+#include "tascar_os.h"
+#include <atomic>
+#include <mutex>
 
 namespace TASCAR {
 
@@ -40,11 +43,29 @@ namespace TASCAR {
     double t_acoustics;
     double t_postproc;
     double t_copy;
+    /// Ratio of acoustic models which reused cached geometry
+    double geometry_hitrate;
+    /// Minor page faults of the render thread per period
+    double minor_faults;
+    /// Major page faults of the render thread per period
+    double major_faults;
 
   private:
     double B0, A1;
   };
 
+  /**
+     \brief Drawable state of an acoustic model, see
+     render_core_t::get_acousticmodel_snapshot()
+   */
+  class acousticmodel_snapshot_t {
+  public:
+    pos_t position;
+    pos_t receiver_position;
+    float gain;
+    uint32_t ismorder;
+  };
+
   /**
      \brief Container class for components of virtual acoustic environments
    */
@@ -64,6 +85,29 @@ namespace TASCAR {
                  const std::vector<float*>& outBuffer);
     uint32_t num_input_ports() const { return (uint32_t)input_ports.size(); };
     uint32_t num_output_ports() const { return (uint32_t)output_ports.size(); };
+    /**
+       \brief Memory used by the render state of the scene
+
+       Heap growth during creation of the world and of each receiver
+       graph, the delay line memory of each sound vertex and the heap
+       growth during preparation of each plugin, in XML format. The
+       report is created in configure(), this function does not lock
+       the render thread.
+    */
+    std::string get_memory_report();
+    /**
+       \brief Copy the state of the rendered acoustic models, e.g., for
+       drawing
+
+       The state is published by the render thread at the end of a
+       period, after it was requested by a previous call of this
+       function. The render thread never waits for the caller, and the
+       world is not locked.
+
+       \retval snapshot State of rendered acoustic models
+    */
+    void get_acousticmodel_snapshot(
+        std::vector<acousticmodel_snapshot_t>& snapshot);
     // protected:
     std::vector<Acousticmodel::source_t*> sources;
     std::vector<Acousticmodel::diffuse_t*> diffuse_sound_fields;
@@ -87,11 +131,27 @@ namespace TASCAR {
     uint32_t active_diffuse_sound_fields;
     uint32_t total_pointsources;
     uint32_t total_diffuse_sound_fields;
+    /// Count page faults of the render thread in the load average
+    bool sample_page_faults = false;
 
   private:
     bool is_prepared;
     TASCAR::amb1wave_t* ambbuf;
     render_profiler_t load_cycle;
+    // page faults of the render thread at the end of previous period:
+    TASCAR::page_faults_t page_faults;
+    bool page_faults_valid = false;
+    // heap growth during creation of world:
+    size_t world_heap_bytes = 0u;
+    std::string create_memory_report();
+    // memory report of configured scene:
+    std::string memory_report;
+    std::mutex mtx_memory_report;
+    // called by render thread, with pre-allocated snapshot:
+    void publish_acousticmodel_snapshot();
+    std::vector<acousticmodel_snapshot_t> acmodel_snapshot;
+    std::mutex mtx_acmodel_snapshot;
+    std::atomic_bool acmodel_snapshot_requested = false;
   };
 
 } // namespace TASCAR
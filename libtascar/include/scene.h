@@ -28,6 +28,7 @@
 #define SCENE_H
 
 #include "acousticmodel.h"
+#include "taskpool.h"
 
 namespace TASCAR {
 
@@ -50,6 +51,8 @@ namespace TASCAR {
       std::vector<float> alpha = {0.013f, 0.015f, 0.02f, 0.03f, 0.04f, 0.05};
       float reflectivity = 1.0f;
       float damping = 0.0f;
+      /// Multiband reflection filter design, valid after update_coeff()
+      const TASCAR::reflectionfilter_design_t* design = NULL;
     };
 
     class route_t : public xml_element_t {
@@ -160,6 +163,9 @@ namespace TASCAR {
       double width;
       double height;
       std::vector<TASCAR::pos_t> vertices;
+
+    private:
+      uint64_t applied_transform_version = 0u;
     };
 
     class face_group_t : public object_t,
@@ -173,6 +179,23 @@ namespace TASCAR {
       std::string importraw;
       TASCAR::pos_t shoebox;
       TASCAR::pos_t shoeboxwalls;
+      // mesh preprocessing:
+      bool mergefaces = false;
+      double mergeangle = 1.0;
+      double mergedist = 0.01;
+      double minfacefreq = 0.0;
+      uint32_t lodorder = 0u;
+      double lodangle = 10.0;
+      double loddist = 0.1;
+      double lodminfacefreq = 500.0;
+      bool meshcache = true;
+      /// Number of faces before preprocessing
+      uint32_t num_raw_faces = 0u;
+      /// Number of faces with reduced level of detail
+      uint32_t num_lod_faces = 0u;
+
+    private:
+      uint64_t applied_transform_version = 0u;
     };
 
     class obstacle_group_t : public object_t {
@@ -194,6 +217,9 @@ namespace TASCAR {
       std::string importraw;
       bool ishole;
       float aperture;
+
+    private:
+      uint64_t applied_transform_version = 0u;
     };
 
     class src_object_t;
@@ -502,6 +528,8 @@ namespace TASCAR {
       void validate_attributes(std::string& msg) const;
       bool active;
       std::mutex mtx_geometry;
+      /// Timing of object preparation in the last call of configure()
+      std::vector<TASCAR::task_timing_t> prepare_timing;
 
     private:
       void clean_children();
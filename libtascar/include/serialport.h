@@ -20,9 +20,15 @@
 #ifndef SERIALPORT_H
 #define SERIALPORT_H
 
-#include <string>
+#include <functional>
+#include <jack/jack.h>
+#include <map>
+#include <mutex>
 #include <stdint.h>
+#include <string>
 #include <termios.h>
+#include <thread>
+#include <vector>
 
 namespace TASCAR {
 
@@ -34,10 +40,127 @@ namespace TASCAR {
     void set_interface_attribs( int speed, int parity, int stopbits, bool xbaud );
     void set_blocking( int should_block );
     bool isopen();
+    /**
+       \brief Read a line
+
+       Data is read in blocks and buffered, remaining data is
+       returned by the next call.
+       \param maxlen Maximum number of characters and read timeouts
+       \param delim Line delimiter, not included in the result
+    */
     std::string readline(uint32_t maxlen,char delim);
     void close();
+    /// File descriptor, e.g., for use with serial_dispatcher_t
+    int get_fd() const { return fd; };
   protected:
     int fd;
+  private:
+    char rbuf[256];
+    size_t rlen = 0u;
+    size_t rpos = 0u;
+  };
+
+  /**
+     \brief Split a byte stream into text lines or binary packets
+  */
+  class serial_framer_t {
+  public:
+    /**
+       \brief Text lines
+       \param delim Line delimiter, not included in the frames
+       \param maxlen Maximum line length, longer lines are split
+    */
+    serial_framer_t(char delim = '\n', size_t maxlen = 1024u);
+    /**
+       \brief Binary packets of fixed length
+       \param sync Start sequence of each packet, included in the frames
+       \param packetlen Length of packets, including start sequence
+
+       Data before a start sequence is discarded.
+    */
+    serial_framer_t(const std::string& sync, size_t packetlen);
+    /**
+       \brief Process received data
+       \param data Received data
+       \param len Number of bytes
+       \retval frames Complete frames are appended
+    */
+    void feed(const char* data, size_t len, std::vector<std::string>& frames);
+    /// Discard incomplete frame
+    void clear() { buf.clear(); };
+
+  private:
+    bool binary;
+    char delim;
+    size_t maxlen;
+    std::string sync;
+    size_t packetlen;
+    std::string buf;
+  };
+
+  /// Received frame with arrival time
+  struct serial_frame_t {
+    /// Line without delimiter, or binary packet
+    std::string data;
+    /// Arrival time on steady clock in seconds, compatible with
+    /// lsl::local_clock()
+    double time = 0.0;
+    /// JACK frame time at arrival, or zero if no JACK client is given
+    jack_nframes_t frametime = 0u;
+  };
+
+  /**
+     \brief Shared thread which reads from several serial devices
+
+     The devices are monitored with poll(). Available data is read in
+     blocks, split into frames and passed to a callback together with
+     the arrival time. The callbacks are called from the dispatch
+     thread; they must not call add() or remove(). A device is no
+     longer polled after end of file, a read error, or a hangup, error
+     or invalid descriptor reported by poll().
+  */
+  class serial_dispatcher_t {
+  public:
+    typedef std::function<void(const serial_frame_t&)> callback_t;
+    /// Access the process-wide dispatcher
+    static serial_dispatcher_t& get();
+    serial_dispatcher_t();
+    ~serial_dispatcher_t();
+    /**
+       \brief Add a device
+       \param fd File descriptor of open device
+       \param framer Framing of data
+       \param cb Callback for each complete frame
+       \param jc JACK client for frame time stamps, or NULL
+    */
+    void add(int fd, const serial_framer_t& framer, callback_t cb,
+             jack_client_t* jc = NULL);
+    /**
+       \brief Remove a device
+
+       After return, the callback of the device is not called anymore.
+    */
+    void remove(int fd);
+    /// Return false if reading from a device failed, e.g., on hangup
+    bool is_active(int fd);
+    /// Number of devices
+    size_t get_num_devices();
+
+  private:
+    serial_dispatcher_t(const serial_dispatcher_t&);
+    struct device_t {
+      serial_framer_t framer;
+      callback_t cb;
+      jack_client_t* jc = NULL;
+      bool active = true;
+    };
+    void service();
+    void wakeup();
+    std::mutex mtx;
+    std::map<int, device_t> devices;
+    std::thread thread;
+    int wakeup_pipe[2] = {-1, -1};
+    bool run_service = true;
   };
 
 }
@@ -21,6 +21,7 @@
 #define SESSION_H
 
 #include "jackrender.h"
+#include "osclog.h"
 #include "session_reader.h"
 
 namespace TASCAR {
@@ -66,6 +67,8 @@ namespace TASCAR {
     void update(uint32_t frame, bool running);
     virtual void validate_attributes(std::string&) const;
     const std::string& modulename() const { return name; };
+    /// Module can be prepared in parallel with neighbouring modules
+    bool parallelprepare = false;
 
   private:
     std::string name;
@@ -187,12 +190,67 @@ namespace TASCAR {
     void unlock_vars();
     bool trylock_vars();
     bool is_running() { return started_; };
+    /// Connection planner used for the connections of the session
+    const jack_connection_planner_t& get_connection_planner() const
+    {
+      return connplanner;
+    };
+    /// Remove connections made by the session when it is stopped
+    bool disconnectonstop = false;
+    /// Lock all memory pages while the session is running
+    bool rtmemory = false;
     virtual void validate_attributes(std::string&) const;
     TASCAR::scene_render_rt_t& scene_by_id(const std::string& id);
     TASCAR::Scene::sound_t& sound_by_id(const std::string& id);
     TASCAR::Scene::src_object_t& source_by_id(const std::string& id);
     TASCAR::Scene::receiver_obj_t& receiver_by_id(const std::string& id);
     void send_xml(const std::string& url, const std::string& path);
+    /**
+       \brief Memory report of all scenes and heap usage of the process
+
+       Comparing the heap usage across reconfigurations reveals
+       memory leaks.
+    */
+    std::string memory_report();
+    void send_memory_report(const std::string& url, const std::string& path);
+    /**
+       \brief Time needed for loading and preparation of scenes,
+       objects and modules, in seconds
+
+       One XML element per line, valid after start().
+    */
+    std::string startup_report() const;
+    /**
+       \brief Record all OSC messages received from the network
+
+       The messages are stored with their jack frame time, relative to
+       the start of the recording, in a binary log file. The frame at
+       which the transport starts rolling is stored in the header.
+    */
+    void start_capture(const std::string& fname);
+    void stop_capture();
+    /// Number of recorded messages
+    size_t get_capture_size() const;
+    /**
+       \brief Replay a log file created with start_capture()
+
+       Each message is dispatched at the beginning of the first period
+       after its recorded frame, as if it was received from the
+       network.
+
+       Recorded /capture/ and /replay/ messages are not dispatched,
+       and these methods are ignored while they are called from a
+       replay.
+
+       \param fname Log file name
+       \param sync Synchronize to transport: Messages recorded before
+       the transport started are dispatched immediately, and the
+       replay time advances only while the transport is rolling.
+    */
+    void start_replay(const std::string& fname, bool sync = false);
+    void stop_replay();
+    /// Number of messages which are not yet dispatched
+    size_t get_replay_remaining();
 
   protected:
     // derived variables:
@@ -201,8 +259,11 @@ namespace TASCAR {
   private:
     void add_transport_methods();
     void read_xml();
+    void wait_for_replay();
     double period_time;
     bool started_;
+    jack_connection_planner_t connplanner;
+    bool memory_locked = false;
     pthread_mutex_t mtx;
     std::set<std::string> namelist;
     std::map<std::string, TASCAR::scene_render_rt_t*> scenemap;
@@ -214,6 +275,23 @@ namespace TASCAR {
     lo_message profilermsg;
     lo_arg** profilermsgargv;
     std::vector<std::string> initoscscript;
+    // startup time of each scene and module:
+    std::vector<TASCAR::task_timing_t> scene_load_timing;
+    std::vector<TASCAR::task_timing_t> module_load_timing;
+    std::vector<TASCAR::task_timing_t> scene_timing;
+    std::vector<TASCAR::task_timing_t> module_timing;
+    size_t startup_threads = 0u;
+    double startup_prepare_time = 0.0;
+    // capture and replay of OSC messages:
+    std::unique_ptr<TASCAR::osc_log_writer_t> capturelog;
+    jack_nframes_t capture_start = 0u;
+    std::atomic_bool capture_active = false;
+    std::atomic_bool capture_anchored = false;
+    std::atomic<uint64_t> capture_anchor = 0u;
+    std::mutex mtxreplay;
+    std::unique_ptr<TASCAR::osc_log_player_t> replaylog;
+    // audio thread dispatches replayed messages outside of mtxreplay:
+    std::atomic_bool replay_busy = false;
   };
 
   /// Control 'actors' in a scene
@@ -20,6 +20,8 @@
  */
 #ifndef TASCAR_OS_H
 #define TASCAR_OS_H
+#include <stdint.h>
+#include <string>
 #include <sys/types.h>
 #include <time.h>
 
@@ -87,6 +89,52 @@ namespace TASCAR {
   /// See manpage of dlopen for details.
   void* dlopen(const char* filename, int flags);
 
+  /// @brief Number of page faults
+  struct page_faults_t {
+    /// Page faults which were serviced without disk access
+    uint64_t minor = 0u;
+    /// Page faults which required disk access
+    uint64_t major = 0u;
+  };
+
+  /// @brief Return the number of page faults of the calling thread.
+  /// On Linux, getrusage with RUSAGE_THREAD is used. On other POSIX
+  /// systems the page faults of the process are returned, on Windows
+  /// zero is returned.
+  page_faults_t get_page_faults();
+
+  /// @brief Return the number of bytes allocated from the heap by the
+  /// process, including memory mapped chunks. Available with glibc
+  /// only, zero is returned on other systems. Allocations of other
+  /// threads are included, so differences are only approximations of
+  /// the memory used by a specific operation.
+  size_t get_heap_bytes();
+
+  /// @brief Lock pages of the process in memory.
+  /// On POSIX systems, this function calls mlockall with MCL_CURRENT,
+  /// and with MCL_FUTURE if lockfuture is true. All mapped pages are
+  /// faulted in. With MCL_FUTURE, pages which are mapped later are
+  /// faulted in when they are mapped, and allocations fail once the
+  /// memlock limit is reached.
+  /// @param errmsg error message in case of failure
+  /// @param lockfuture lock also pages which are mapped later
+  /// @return true on success
+  bool lock_memory(std::string& errmsg, bool lockfuture = true);
+
+  /// @brief Unlock all pages locked with lock_memory().
+  void unlock_memory();
+
+  /// @brief Maximum number of bytes which may be locked in memory.
+  /// @return RLIMIT_MEMLOCK, or UINT64_MAX if unlimited or unknown
+  uint64_t get_memlock_limit();
+
+  /// @brief Advise the kernel to use transparent huge pages for a buffer.
+  /// Only the huge page aligned part of the buffer can be backed by
+  /// huge pages, thus this is useful only for buffers of several
+  /// Megabytes. No-op on systems without madvise(MADV_HUGEPAGE).
+  /// @return true if the advise was accepted
+  bool advise_hugepages(void* data, size_t len);
+
 } // namespace TASCAR
 
 #endif
@@ -20,6 +20,7 @@
 #ifndef TASCARPLUGIN_H
 #define TASCARPLUGIN_H
 
+#include "pluginregistry.h"
 #include "tascarver.h"
 #include <string.h>
 
@@ -30,22 +31,13 @@
 
 #define TASCAR_RESOLVER( baseclass, cfgclass )    \
   void baseclass ## _resolver( baseclass** instance, cfgclass cfg, void* lib, const std::string& libname ){\
-  typedef const char* (*baseclass ## _tascar_version_t)(); \
-  baseclass ## _tascar_version_t tscver((baseclass ## _tascar_version_t)dlsym(lib, #baseclass "_tascar_version"));\
-  if( !tscver ) throw TASCAR::ErrMsg("Unable to resolve tascar version function\n(module: "+libname+")." );\
-  std::string cl_tscver(TASCARVER);\
-  std::string pl_tscver(tscver());\
-  if( cl_tscver != pl_tscver ) \
-      throw TASCAR::ErrMsg("Invalid plugin version "+ pl_tscver + ".\n(module: "+libname+", expected version "+cl_tscver+")."); \
   typedef baseclass* (*baseclass ## factory_t)( cfgclass, std::string& );      \
-  baseclass ## factory_t factory((baseclass ## factory_t)dlsym(lib, #baseclass "_factory"));\
-    if(!factory) throw TASCAR::ErrMsg("Unable to resolve factory of " + std::string(#baseclass) + "\n(module: "+libname+")." );\
+  baseclass ## factory_t factory((baseclass ## factory_t)TASCAR::plugin_registry_t::get().get_factory(lib, libname, #baseclass));\
   std::string emsg;\
   *instance = factory( cfg, emsg );                  \
   if(!(*instance)) throw TASCAR::ErrMsg("Error while loading \""+libname+"\": "+emsg); \
 }
 
-
 #endif
 
 /*
@@ -0,0 +1,96 @@
+/*
+ * This file is part of the TASCAR software, see <http://tascar.org/>
+ *
+ * Copyright (c) 2026 agent
+ */
+/*
+ * TASCAR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, version 3 of the License.
+ *
+ * TASCAR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHATABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License, version 3 for more details.
+ *
+ * You should have received a copy of the GNU General Public License,
+ * Version 3 along with TASCAR. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef TASKPOOL_H
+#define TASKPOOL_H
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace TASCAR {
+
+  /// Timing of a task executed by a task pool
+  struct task_timing_t {
+    /// Name of the task, e.g., the object name
+    std::string name;
+    /// Start time relative to the start of the pool, in seconds
+    double start = 0.0;
+    /// Duration of the task in seconds
+    double duration = 0.0;
+    /// Index of the worker which executed the task
+    size_t worker = 0u;
+  };
+
+  /**
+     \brief Fork-join execution of independent tasks on worker threads
+
+     Used for expensive configuration steps at session start, e.g.,
+     the preparation of objects and their plugins. The tasks must not
+     depend on each other; anything which needs to happen in a
+     deterministic order, e.g., registration of ports or OSC
+     variables, has to be done before or after run().
+
+     If a task throws an exception, the remaining tasks are still
+     executed, and the exception of the first failing task in the
+     order of add() is re-thrown.
+  */
+  class task_pool_t {
+  public:
+    /**
+       \param numthreads Number of worker threads, or zero to use the
+       global configuration variable "tascar.startup.threads" (default:
+       number of CPU cores)
+    */
+    task_pool_t(size_t numthreads = 0u);
+    /// Append a task
+    void add(const std::string& name, std::function<void()> fn);
+    /// Execute all tasks and wait for completion, then clear task list
+    void run();
+    /// Number of worker threads
+    size_t get_num_threads() const { return numthreads; };
+    /// Timing of all tasks executed so far, in the order of add()
+    const std::vector<task_timing_t>& get_timings() const { return timings; };
+    /// Wall clock time of all calls of run(), in seconds
+    double get_wall_time() const { return walltime; };
+
+  private:
+    struct task_t {
+      std::string name;
+      std::function<void()> fn;
+    };
+    size_t numthreads;
+    std::vector<task_t> tasks;
+    std::vector<task_timing_t> timings;
+    double walltime = 0.0;
+  };
+
+} // namespace TASCAR
+
+#endif
+
+/*
+ * Local Variables:
+ * mode: c++
+ * c-basic-offset: 2
+ * indent-tabs-mode: nil
+ * compile-command: "make -C .."
+ * End:
+ */
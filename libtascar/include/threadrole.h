@@ -0,0 +1,122 @@
+/*
+ * This file is part of the TASCAR software, see <http://tascar.org/>
+ *
+ * Copyright (c) 2026 agent
+ */
+/*
+ * TASCAR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, version 3 of the License.
+ *
+ * TASCAR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHATABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License, version 3 for more details.
+ *
+ * You should have received a copy of the GNU General Public License,
+ * Version 3 along with TASCAR. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef THREADROLE_H
+#define THREADROLE_H
+
+#include "tscconfig.h"
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace TASCAR {
+
+  /**
+     \brief Process-wide scheduling configuration of thread roles
+
+     Threads created by TASCAR register with a role at the beginning
+     of their thread function. If the role is configured, the CPU
+     affinity, scheduling policy, priority and nice value of the
+     calling thread are set accordingly. Unconfigured roles leave the
+     thread settings unchanged. All methods are thread safe.
+  */
+  class thread_roles_t {
+  public:
+    enum role_t {
+      /// Audio processing threads, e.g., the jack process callback
+      audio = 0,
+      /// Sound file reading and recording
+      disk,
+      /// OSC servers and senders, network clients
+      network,
+      /// Graphical user interface
+      gui,
+      /// Non-time-critical computations and services
+      background
+    };
+    static const size_t num_roles = 5u;
+    enum policy_t {
+      /// Keep scheduling policy and priority of the thread
+      keep,
+      /// SCHED_OTHER with nice value
+      other,
+      /// SCHED_FIFO with real-time priority
+      fifo
+    };
+    struct cfg_t {
+      /// CPU cores of affinity mask, or empty for no restriction
+      std::vector<int32_t> cpus;
+      policy_t policy = keep;
+      /// Real-time priority, used with SCHED_FIFO
+      int32_t priority = 0;
+      /// Nice value, used with SCHED_OTHER
+      int32_t nice = 0;
+    };
+    /// Access the registry instance
+    static thread_roles_t& get();
+    /// Set configuration of a role
+    void configure(role_t role, const cfg_t& cfg);
+    /// Read configuration of a role from a threadrole element
+    void read_xml(tsccfg::node_t e);
+    /// Remove configuration of all roles and reset counters
+    void clear();
+    /// Return true if any role is configured
+    bool is_configured();
+    /**
+       \brief Apply the configuration of a role to the calling thread
+       \return False if the configuration could not be applied
+    */
+    bool register_thread(role_t role);
+    /// Number of threads which registered with a role
+    size_t get_num_threads(role_t role);
+    /// Number of threads for which the configuration failed
+    size_t get_num_failed(role_t role);
+    /// Active mapping of roles, one XML element per line
+    std::string report();
+    /// Return role from name, throws TASCAR::ErrMsg for invalid names
+    static role_t get_role(const std::string& name);
+    /// Return name of role
+    static std::string get_name(role_t role);
+
+  private:
+    thread_roles_t(){};
+    thread_roles_t(const thread_roles_t&);
+    std::mutex mtx;
+    cfg_t cfg[num_roles];
+    bool configured[num_roles] = {false, false, false, false, false};
+    size_t numthreads[num_roles] = {0u, 0u, 0u, 0u, 0u};
+    size_t numfailed[num_roles] = {0u, 0u, 0u, 0u, 0u};
+    std::string lasterror[num_roles];
+  };
+
+  /// Register the calling thread with a role, see thread_roles_t
+  void register_thread(thread_roles_t::role_t role);
+
+} // namespace TASCAR
+
+#endif
+
+/*
+ * Local Variables:
+ * mode: c++
+ * c-basic-offset: 2
+ * indent-tabs-mode: nil
+ * compile-command: "make -C .."
+ * End:
+ */
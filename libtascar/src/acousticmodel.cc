@@ -22,6 +22,8 @@
 
 #include "acousticmodel.h"
 #include "errorhandling.h"
+#include "tascar_os.h"
+#include <algorithm>
 
 using namespace TASCAR;
 using namespace TASCAR::Acousticmodel;
@@ -101,7 +103,7 @@ acoustic_model_t::acoustic_model_t(float c, float fs, uint32_t chunksize,
       dt(1.0f / std::max(1.0f, (float)chunksize)), distance(1.0), gain(1.0),
       dscale(fs / (c_ * 7782.0f)), air_absorption(0.5),
       delayline((uint32_t)((src->maxdist / c_) * fs), fs, c_, src->sincorder,
-                64),
+                64, src->delaylinestorage),
       airabsorption_state(0.0), layergain(0.0),
       dlayergain(1.0f / (receiver->layerfadelen * fs)), ismorder(getorder())
 {
@@ -124,9 +126,151 @@ acoustic_model_t::~acoustic_model_t()
     delete source_data;
 }
 
+bool acoustic_model_t::is_geometry_unchanged() const
+{
+  if((geometry_cache.source_version != src_->geometry_version.get_version()) ||
+     (geometry_cache.receiver_version !=
+      receiver_->geometry_version.get_version()))
+    return false;
+  if(reflector)
+    return (geometry_cache.reflector_version == reflector->get_version()) &&
+           (geometry_cache.edgereflection == reflector->edgereflection) &&
+           (geometry_cache.parent_position == parent->position);
+  return true;
+}
+
+void acoustic_model_t::set_panning_hint(const pos_t& prel, float width)
+{
+  if(receiver_data)
+    receiver_data->unchanged = (prel == panned_prel) && (width == panned_width);
+  panned_prel = prel;
+  panned_width = width;
+}
+
+bool acoustic_model_t::read_source_and_obstacles()
+{
+  bool position_modified(false);
+  // read audio from source, update radation position:
+  pos_t prelsrc(receiver_->position);
+  prelsrc -= src_->position;
+  prelsrc /= src_->orientation;
+  if(receiver_->volumetric.has_volume()) {
+    if(src_->read_source_diffuse(prelsrc, src_->inchannels, audio,
+                                 source_data)) {
+      prelsrc *= src_->orientation;
+      prelsrc -= receiver_->position;
+      prelsrc *= -1.0;
+      position = prelsrc;
+      position_modified = true;
+    }
+  } else {
+    if(src_->read_source(prelsrc, src_->inchannels, audio, source_data)) {
+      prelsrc *= src_->orientation;
+      prelsrc -= receiver_->position;
+      prelsrc *= -1.0;
+      position = prelsrc;
+      position_modified = true;
+    }
+  }
+  // calculate obstacles:
+  for(uint32_t kobj = 0; kobj != obstacles_.size(); ++kobj) {
+    obstacle_t* p_obj(obstacles_[kobj]);
+    if(p_obj->active) {
+      // apply diffraction model:
+      if(p_obj->b_inner)
+        p_obj->process(position, receiver_->position, audio, c_, fs_,
+                       vstate[kobj], p_obj->transmission);
+      else {
+        position = p_obj->process(position, receiver_->position, audio, c_,
+                                  fs_, vstate[kobj], p_obj->transmission);
+        position_modified = true;
+      }
+    }
+  }
+  return position_modified;
+}
+
+const wave_t& acoustic_model_t::process_predelay()
+{
+  position = predelay_position;
+  read_source_and_obstacles();
+  apply_reflectionfilter(audio);
+  return audio;
+}
+
+void acoustic_model_t::get_path_response(const std::vector<float>& input,
+                                         float threshold, uint32_t maxlen,
+                                         uint32_t& offset,
+                                         std::vector<float>& h) const
+{
+  h.clear();
+  offset = 0u;
+  // support of input signal:
+  size_t k0(0);
+  while((k0 < input.size()) && (input[k0] == 0.0f))
+    ++k0;
+  if(k0 == input.size())
+    return;
+  size_t k1(input.size());
+  while(input[k1 - 1] == 0.0f)
+    --k1;
+  const float scale(layergain * gain);
+  if(scale == 0.0f)
+    return;
+  std::vector<uint32_t> tapdelay;
+  std::vector<float> tapweight;
+  if(src_->delayline)
+    delayline.get_dist_taps(distance, tapdelay, tapweight);
+  else {
+    tapdelay.push_back(0u);
+    tapweight.push_back(1.0f);
+  }
+  const uint32_t dmin(*std::min_element(tapdelay.begin(), tapdelay.end()));
+  const uint32_t dmax(*std::max_element(tapdelay.begin(), tapdelay.end()));
+  if(k0 + dmin >= maxlen)
+    return;
+  offset = (uint32_t)k0 + dmin;
+  h.resize(std::min(k1 - k0 + dmax - dmin, (size_t)(maxlen - offset)), 0.0f);
+  for(size_t kt = 0; kt < tapdelay.size(); ++kt) {
+    const float w(scale * tapweight[kt]);
+    for(size_t k = k0; k < k1; ++k) {
+      size_t idx(k + tapdelay[kt] - offset);
+      if(idx < h.size())
+        h[idx] += w * input[k];
+    }
+  }
+  if(src_->airabsorption) {
+    const float c1(air_absorption);
+    const float c2(1.0f - c1);
+    float state(0.0f);
+    for(auto& v : h)
+      v = state = c2 * state + c1 * v;
+    // decaying tail of the low pass filter:
+    while((offset + h.size() < maxlen) && (fabsf(state) > threshold))
+      h.push_back(state *= c2);
+  }
+}
+
+void acoustic_model_t::add_to_receiver(const wave_t& chunk)
+{
+  float scattering(0.0);
+  if(reflector)
+    scattering = reflector->scattering;
+  set_panning_hint(panned_prel, panned_width);
+  receiver_->add_pointsource_with_scattering(panned_prel, panned_width,
+                                             scattering, chunk, receiver_data);
+}
+
 uint32_t acoustic_model_t::process(const TASCAR::transport_t& tp)
 {
-  if(src_->active)
+  geometry_evaluated = false;
+  geometry_cache_hit = false;
+  rendered = false;
+  // reuse geometry of previous period if nothing has changed:
+  bool cache_valid(use_geometry_cache && geometry_cache.valid &&
+                   is_geometry_unchanged());
+  geometry_cache.valid = false;
+  if(src_->active && (!cache_valid))
     update_position();
   if((!receiver_->gain_zero) && receiver_->active && src_->active &&
      ((!reflector) || reflector->active)) {
@@ -145,49 +289,47 @@ uint32_t acoustic_model_t::process(const TASCAR::transport_t& tp)
           float nextgain(1.0);
           // calculate relative geometry between source and receiver:
           float srcgainmod(1.0);
+          geometry_evaluated = true;
           // update effective position/calculate ISM geometry:
-          position = get_effective_position(receiver_->position, srcgainmod);
-          // read audio from source, update radation position:
-          pos_t prelsrc(receiver_->position);
-          prelsrc -= src_->position;
-          prelsrc /= src_->orientation;
-          if(receiver_->volumetric.has_volume()) {
-            if(src_->read_source_diffuse(prelsrc, src_->inchannels, audio,
-                                         source_data)) {
-              prelsrc *= src_->orientation;
-              prelsrc -= receiver_->position;
-              prelsrc *= -1.0;
-              position = prelsrc;
-            }
-          } else {
-            if(src_->read_source(prelsrc, src_->inchannels, audio,
-                                 source_data)) {
-              prelsrc *= src_->orientation;
-              prelsrc -= receiver_->position;
-              prelsrc *= -1.0;
-              position = prelsrc;
-            }
-          }
-          // calculate obstacles:
-          for(uint32_t kobj = 0; kobj != obstacles_.size(); ++kobj) {
-            obstacle_t* p_obj(obstacles_[kobj]);
-            if(p_obj->active) {
-              // apply diffraction model:
-              if(p_obj->b_inner)
-                p_obj->process(position, receiver_->position, audio, c_, fs_,
-                               vstate[kobj], p_obj->transmission);
-              else
-                position =
-                    p_obj->process(position, receiver_->position, audio, c_,
-                                   fs_, vstate[kobj], p_obj->transmission);
+          if(cache_valid) {
+            position = geometry_cache.position;
+            srcgainmod = geometry_cache.srcgainmod;
+          } else
+            position = get_effective_position(receiver_->position, srcgainmod);
+          const pos_t effective_position(position);
+          predelay_position = effective_position;
+          // source characteristics or obstacles may modify the position:
+          bool position_modified(read_source_and_obstacles());
+          float nexttraveltime_in_m = 0.0f;
+          if(cache_valid && (!position_modified)) {
+            prel = geometry_cache.prel;
+            nextdistance = geometry_cache.distance;
+            nexttraveltime_in_m = geometry_cache.traveltime_in_m;
+            nextgain = geometry_cache.gain;
+            geometry_cache_hit = true;
+          } else
+            receiver_->update_refpoint(primary->position, position, prel,
+                                       nextdistance, nexttraveltime_in_m,
+                                       nextgain, ismorder > 0, src_->gainmodel,
+                                       src_->nearfieldlimit);
+          if(use_geometry_cache && (!position_modified)) {
+            geometry_cache.valid = true;
+            geometry_cache.source_version =
+                src_->geometry_version.get_version();
+            geometry_cache.receiver_version =
+                receiver_->geometry_version.get_version();
+            if(reflector) {
+              geometry_cache.reflector_version = reflector->get_version();
+              geometry_cache.edgereflection = reflector->edgereflection;
+              geometry_cache.parent_position = parent->position;
             }
+            geometry_cache.position = effective_position;
+            geometry_cache.srcgainmod = srcgainmod;
+            geometry_cache.prel = prel;
+            geometry_cache.distance = nextdistance;
+            geometry_cache.traveltime_in_m = nexttraveltime_in_m;
+            geometry_cache.gain = nextgain;
           }
-          // end obstacles
-          float nexttraveltime_in_m = 0.0f;
-          receiver_->update_refpoint(primary->position, position, prel,
-                                     nextdistance, nexttraveltime_in_m,
-                                     nextgain, ismorder > 0, src_->gainmodel,
-                                     src_->nearfieldlimit);
           if(nextdistance > src_->maxdist)
             return 0;
           nextgain *= srcgainmod;
@@ -238,6 +380,7 @@ uint32_t acoustic_model_t::process(const TASCAR::transport_t& tp)
           gain = nextgain;
           air_absorption = next_air_absorption;
           if(((gain != 0) || (dgain != 0))) {
+            rendered = !clusterer;
             if(src_->minlevel > 0) {
               if(audio.rms() <= src_->minlevel)
                 return 0;
@@ -246,12 +389,24 @@ uint32_t acoustic_model_t::process(const TASCAR::transport_t& tp)
             float scattering(0.0);
             if(reflector)
               scattering = reflector->scattering;
+            float width(std::min(TASCAR_PI2f,
+                                 0.25f * TASCAR_PIf * src_->size /
+                                     std::max(0.01f, nextdistance)));
+            if(clusterer) {
+              // scattering is added for each source, the direct sound
+              // may be rendered by a cluster:
+              receiver_->scatterbuffer->add_panned(prel, audio, scattering);
+              if(!clusterer->add(cluster_slot, prel, nextdistance, audio))
+                return 0;
+              set_panning_hint(prel, width);
+              receiver_->receivermod_t::add_pointsource(
+                  prel, width, audio, receiver_->outchannels, receiver_data);
+              return 1;
+            }
             // add to receiver:
-            receiver_->add_pointsource_with_scattering(
-                prel,
-                std::min(TASCAR_PI2f, 0.25f * TASCAR_PIf * src_->size /
-                                          std::max(0.01f, nextdistance)),
-                scattering, audio, receiver_data);
+            set_panning_hint(prel, width);
+            receiver_->add_pointsource_with_scattering(prel, width, scattering,
+                                                       audio, receiver_data);
             return 1;
           }
         } // of visible
@@ -276,12 +431,30 @@ void reflector_t::read_xml(TASCAR::xml_element_t& e)
   e.GET_ATTRIBUTE(reflectivity, "", "Reflectivity coefficient");
   e.GET_ATTRIBUTE(damping, "", "Damping coefficient");
   e.GET_ATTRIBUTE(material, "", "Material name, or empty to use coefficients");
+  e.GET_ATTRIBUTE_BOOL(multiband, "Use multiband reflection filter fitted to "
+                                  "absorption coefficients of material");
   e.GET_ATTRIBUTE_BOOL(
       edgereflection,
       "Apply edge reflection in case of not directly visible image source");
   e.GET_ATTRIBUTE(scattering, "", "Relative amount of scattering");
 }
 
+bool reflector_t::is_coplanar(const reflector_t& other) const
+{
+  const double angle(std::max(1e-6, std::max(coplanar_angle,
+                                             other.coplanar_angle)));
+  const double dist(std::max(1e-6, std::max(coplanar_dist,
+                                            other.coplanar_dist)));
+  if(dot_prod(normal, other.normal) < cos(angle))
+    return false;
+  if(verts_.empty())
+    return false;
+  for(const auto& v : other.verts_)
+    if(fabs(dot_prod(normal, v - verts_[0])) > dist)
+      return false;
+  return true;
+}
+
 void reflector_t::apply_reflectionfilter(TASCAR::wave_t& audio,
                                          double& lpstate) const
 {
@@ -299,18 +472,19 @@ receiver_graph_t::receiver_graph_t(
     const std::vector<reflector_t*>& reflectors,
     const std::vector<obstacle_t*>& obstacles, receiver_t* receiver,
     uint32_t ism_order)
-    : active_pointsource(0), active_diffuse_sound_field(0)
+    : active_pointsource(0), active_diffuse_sound_field(0),
+      receiver_(receiver)
 {
   // diffuse models:
   if(receiver->render_diffuse)
     for(uint32_t kSrc = 0; kSrc < diffuse_sound_fields.size(); ++kSrc)
-      diffuse_acoustic_model.push_back(new diffuse_acoustic_model_t(
+      diffuse_acoustic_model.push_back(arena.create<diffuse_acoustic_model_t>(
           fs, chunksize, diffuse_sound_fields[kSrc], receiver));
   // all primary and image sources:
   if(receiver->render_point) {
     // primary sources:
     for(uint32_t kSrc = 0; kSrc < sources.size(); ++kSrc)
-      acoustic_model.push_back(new acoustic_model_t(
+      acoustic_model.push_back(arena.create<acoustic_model_t>(
           c, fs, chunksize, sources[kSrc], receiver, obstacles));
     if(receiver->render_image && (ism_order > 0)) {
       auto num_mirrors_start = acoustic_model.size();
@@ -318,24 +492,42 @@ receiver_graph_t::receiver_graph_t(
       for(uint32_t ksrc = 0; ksrc < sources.size(); ++ksrc)
         for(uint32_t kreflector = 0; kreflector < reflectors.size();
             ++kreflector)
-          acoustic_model.push_back(new acoustic_model_t(
-              c, fs, chunksize, sources[ksrc], receiver, obstacles,
-              acoustic_model[ksrc], reflectors[kreflector]));
+          if(reflectors[kreflector]->is_used_at_order(1))
+            acoustic_model.push_back(arena.create<acoustic_model_t>(
+                c, fs, chunksize, sources[ksrc], receiver, obstacles,
+                acoustic_model[ksrc], reflectors[kreflector]));
       // now higher order image sources:
       auto num_mirrors_end = acoustic_model.size();
       for(uint32_t korder = 1; korder < ism_order; ++korder) {
         for(size_t ksrc = num_mirrors_start; ksrc < num_mirrors_end; ++ksrc)
           for(size_t kreflector = 0; kreflector < reflectors.size();
               ++kreflector)
-            if(acoustic_model[ksrc]->reflector != reflectors[kreflector])
-              acoustic_model.push_back(new acoustic_model_t(
+            if((acoustic_model[ksrc]->reflector != reflectors[kreflector]) &&
+               reflectors[kreflector]->is_used_at_order(korder + 1) &&
+               !reflectors[kreflector]->is_always_coplanar(
+                   *(acoustic_model[ksrc]->reflector)))
+              acoustic_model.push_back(arena.create<acoustic_model_t>(
                   c, fs, chunksize, acoustic_model[ksrc]->src_, receiver,
                   obstacles, acoustic_model[ksrc], reflectors[kreflector]));
         num_mirrors_start = num_mirrors_end;
         num_mirrors_end = acoustic_model.size();
       }
     }
+    if(receiver->clusters > 0) {
+      clusterer = new source_clusterer_t(receiver->clusters,
+                                         (uint32_t)acoustic_model.size(),
+                                         chunksize, fs);
+      for(uint32_t k = 0; k < clusterer->size(); ++k)
+        cluster_data.push_back(receiver->create_state_data(fs, chunksize));
+      for(uint32_t k = 0; k < acoustic_model.size(); ++k) {
+        acoustic_model[k]->clusterer = clusterer;
+        acoustic_model[k]->cluster_slot = k;
+      }
+    }
   }
+  bool use_geometry_cache(TASCAR::config("tascar.geometry.cache", 1.0) != 0.0);
+  for(auto model : acoustic_model)
+    model->use_geometry_cache = use_geometry_cache;
 }
 
 world_t::world_t(float c, float fs, uint32_t chunksize,
@@ -345,14 +537,18 @@ world_t::world_t(float c, float fs, uint32_t chunksize,
                  const std::vector<obstacle_t*>& obstacles,
                  const std::vector<receiver_t*>& receivers,
                  const std::vector<mask_t*>& masks, uint32_t ism_order)
-    : receivers_(receivers), masks_(masks), active_pointsource(0),
-      active_diffuse_sound_field(0), total_pointsource(0),
-      total_diffuse_sound_field(0)
+    : sources_(sources), receivers_(receivers), masks_(masks),
+      active_pointsource(0), active_diffuse_sound_field(0),
+      total_pointsource(0), total_diffuse_sound_field(0)
 {
   for(uint32_t krec = 0; krec < receivers.size(); ++krec) {
+    size_t heap_before(TASCAR::get_heap_bytes());
     receivergraphs.push_back(new receiver_graph_t(
         c, fs, chunksize, sources, diffuse_sound_fields, reflectors, obstacles,
         receivers[krec], ism_order));
+    size_t heap_after(TASCAR::get_heap_bytes());
+    receivergraphs.back()->heap_bytes =
+        heap_after - std::min(heap_before, heap_after);
     total_pointsource += receivergraphs.back()->get_total_pointsource();
     total_diffuse_sound_field +=
         receivergraphs.back()->get_total_diffuse_sound_field();
@@ -371,6 +567,13 @@ void world_t::process(const TASCAR::transport_t& tp)
 {
   uint32_t local_active_point(0);
   uint32_t local_active_diffuse(0);
+  uint32_t local_evaluated(0);
+  uint32_t local_hits(0);
+  // detect changes of geometry:
+  for(auto src : sources_)
+    src->update_geometry_version();
+  for(auto rec : receivers_)
+    rec->update_geometry_version();
   // calculate mask gains:
   for(uint32_t k = 0; k < receivers_.size(); ++k) {
     float gain_inner(1.0);
@@ -416,7 +619,11 @@ void world_t::process(const TASCAR::transport_t& tp)
       ig != receivergraphs.end(); ++ig) {
     (*ig)->process(tp);
     local_active_point += (*ig)->get_active_pointsource();
+    local_evaluated += (*ig)->geometry_evaluated;
+    local_hits += (*ig)->geometry_cache_hits;
   }
+  geometry_evaluated = local_evaluated;
+  geometry_cache_hits = local_hits;
   // apply post-processing and receiver gain of reverb receivers:
   for(auto it = receivers_.begin(); it != receivers_.end(); ++it)
     if((*it)->is_reverb) {
@@ -442,12 +649,53 @@ void world_t::process(const TASCAR::transport_t& tp)
 void receiver_graph_t::process(const TASCAR::transport_t& tp)
 {
   uint32_t local_active_point(0);
+  if(clusterer) {
+    clusterer->mindist = receiver_->clusterdist;
+    clusterer->hysteresis = receiver_->clusterhysteresis;
+    clusterer->fadelen = receiver_->clusterfadelen;
+    clusterer->clear();
+  }
+  uint32_t local_evaluated(0);
+  uint32_t local_hits(0);
   // calculate acoustic model:
-  for(unsigned int k = 0; k < acoustic_model.size(); k++)
+  for(unsigned int k = 0; k < acoustic_model.size(); k++) {
     local_active_point += acoustic_model[k]->process(tp);
+    local_evaluated += acoustic_model[k]->geometry_evaluated;
+    local_hits += acoustic_model[k]->geometry_cache_hit;
+  }
+  geometry_evaluated = local_evaluated;
+  geometry_cache_hits = local_hits;
+  if(clusterer) {
+    // render clusters:
+    clusterer->update();
+    for(uint32_t k = 0; k < clusterer->size(); ++k)
+      if(clusterer->is_used(k)) {
+        receiver_->receivermod_t::add_pointsource(
+            clusterer->get_position(k), clusterer->get_width(k),
+            clusterer->get_audio(k), receiver_->outchannels, cluster_data[k]);
+        ++local_active_point;
+      }
+    receiver_->cluster_error = clusterer->get_error();
+  }
   active_pointsource = local_active_point;
 }
 
+float world_t::get_geometry_cache_hitrate() const
+{
+  if(geometry_evaluated == 0u)
+    return 0.0f;
+  return (float)geometry_cache_hits / (float)geometry_evaluated;
+}
+
+size_t world_t::get_delayline_bytes() const
+{
+  size_t bytes(0u);
+  for(auto graph : receivergraphs)
+    for(auto model : graph->acoustic_model)
+      bytes += model->get_delayline_bytes();
+  return bytes;
+}
+
 void receiver_graph_t::process_diffuse(const TASCAR::transport_t& tp)
 {
   uint32_t local_active_diffuse(0);
@@ -459,14 +707,237 @@ void receiver_graph_t::process_diffuse(const TASCAR::transport_t& tp)
 
 receiver_graph_t::~receiver_graph_t()
 {
-  for(std::vector<acoustic_model_t*>::reverse_iterator it =
-          acoustic_model.rbegin();
-      it != acoustic_model.rend(); ++it)
-    delete(*it);
-  for(std::vector<diffuse_acoustic_model_t*>::reverse_iterator it =
-          diffuse_acoustic_model.rbegin();
-      it != diffuse_acoustic_model.rend(); ++it)
-    delete(*it);
+  // acoustic models are destroyed in reverse order of creation:
+  arena.clear();
+  for(auto d : cluster_data)
+    delete d;
+  if(clusterer)
+    delete clusterer;
+}
+
+source_clusterer_t::source_clusterer_t(uint32_t numclusters, uint32_t numslots,
+                                       uint32_t chunksize, float fs_)
+    : fs(fs_), clusters(numclusters, cluster_t(chunksize)), slots(numslots)
+{
+}
+
+void source_clusterer_t::clear()
+{
+  for(auto& c : clusters) {
+    c.audio.clear();
+    c.used = false;
+    c.sum_dir = pos_t(0, 0, 0);
+    c.sum_w = 0.0;
+    c.sum_wd = 0.0;
+  }
+  for(auto& s : slots)
+    s.touched = false;
+}
+
+int32_t source_clusterer_t::select_cluster(const slot_t& s, const pos_t& dir,
+                                           float distance)
+{
+  int32_t best(-1);
+  double bestcos(-2.0);
+  for(uint32_t k = 0; k < clusters.size(); ++k)
+    if(clusters[k].active) {
+      double c(dot_prod(dir, clusters[k].center));
+      if(c > bestcos) {
+        bestcos = c;
+        best = (int32_t)k;
+      }
+    }
+  double bestangle(acos(std::min(1.0, std::max(-1.0, bestcos))));
+  if((best < 0) || (bestangle > 2.0 * hysteresis)) {
+    // seed a free cluster:
+    for(uint32_t k = 0; k < clusters.size(); ++k)
+      if(!clusters[k].active) {
+        bool referenced(false);
+        for(auto& os : slots)
+          if((os.mix > 0.0f) && ((os.cluster == (int32_t)k) ||
+                                 (os.prev_cluster == (int32_t)k)))
+            referenced = true;
+        if(!referenced) {
+          clusters[k].active = true;
+          clusters[k].center = dir;
+          clusters[k].distance = distance;
+          return (int32_t)k;
+        }
+      }
+  }
+  // hysteresis of membership:
+  if((best >= 0) && (s.cluster >= 0) && (s.cluster != best) &&
+     clusters[s.cluster].active) {
+    double c(dot_prod(dir, clusters[s.cluster].center));
+    if(acos(std::min(1.0, std::max(-1.0, c))) < bestangle + hysteresis)
+      return s.cluster;
+  }
+  return best;
+}
+
+bool source_clusterer_t::add(uint32_t kslot, const pos_t& prel,
+                             float distance, wave_t& audio)
+{
+  slot_t& s(slots[kslot]);
+  // distance threshold, with 10% hysteresis:
+  if(s.clustered) {
+    if(distance < 0.9f * mindist)
+      s.clustered = false;
+  } else {
+    if(distance > mindist)
+      s.clustered = true;
+  }
+  if((!s.clustered) && (s.mix == 0.0f))
+    return true;
+  pos_t dir(prel);
+  double r(dir.norm());
+  if(r > 0.0)
+    dir /= r;
+  else
+    dir = pos_t(1, 0, 0);
+  if(s.clustered) {
+    int32_t c(select_cluster(s, dir, distance));
+    if(c < 0)
+      // no cluster available, render individually:
+      s.clustered = false;
+    else if((c != s.cluster) && (s.prev_cluster < 0)) {
+      // changes are deferred until previous cross-fade is complete
+      if((s.cluster >= 0) && (s.mix > 0.0f)) {
+        s.prev_cluster = s.cluster;
+        s.xfade = 0.0f;
+      } else {
+        s.prev_cluster = -1;
+        s.xfade = 1.0f;
+      }
+      s.cluster = c;
+    }
+  }
+  if(s.cluster < 0)
+    return true;
+  // cross-fade between individual and clustered rendering, and
+  // between previous and current cluster:
+  const float dfade(1.0f / std::max(1.0f, fadelen * fs));
+  const float dmix(s.clustered ? dfade : -dfade);
+  const float mix_start(s.mix);
+  cluster_t& cur(clusters[s.cluster]);
+  float* p_prev(NULL);
+  if(s.prev_cluster >= 0) {
+    p_prev = clusters[s.prev_cluster].audio.d;
+    clusters[s.prev_cluster].used = true;
+  }
+  double energy(0.0);
+  for(uint32_t k = 0; k < audio.n; ++k) {
+    s.mix = std::min(1.0f, std::max(0.0f, s.mix + dmix));
+    s.xfade = std::min(1.0f, s.xfade + dfade);
+    float v(audio.d[k]);
+    float vc(v * s.mix);
+    energy += vc * vc;
+    cur.audio.d[k] += vc * s.xfade;
+    if(p_prev)
+      p_prev[k] += vc * (1.0f - s.xfade);
+    audio.d[k] = v - vc;
+  }
+  cur.used = true;
+  if(s.xfade >= 1.0f)
+    s.prev_cluster = -1;
+  if(s.mix == 0.0f) {
+    s.cluster = -1;
+    s.prev_cluster = -1;
+  }
+  // statistics for update of cluster center:
+  s.touched = true;
+  s.dir = dir;
+  s.w = energy + 1e-20;
+  cur.sum_dir += pos_t(s.w * dir.x, s.w * dir.y, s.w * dir.z);
+  cur.sum_w += s.w;
+  cur.sum_wd += s.w * distance;
+  if(s.cluster < 0)
+    s.touched = false;
+  return (mix_start < 1.0f) || (s.mix < 1.0f);
+}
+
+void source_clusterer_t::update()
+{
+  // update centers:
+  for(auto& c : clusters)
+    if(c.active && (c.sum_w > 0.0)) {
+      double r(c.sum_dir.norm());
+      if(r > 0.0) {
+        c.center = c.sum_dir;
+        c.center /= r;
+      }
+      c.distance = (float)(c.sum_wd / c.sum_w);
+    }
+  // angular spread and error metric:
+  std::vector<double> sum_a2(clusters.size(), 0.0);
+  double sum_a2_total(0.0);
+  double sum_w_total(0.0);
+  for(auto& s : slots)
+    if(s.touched) {
+      double a(acos(std::min(
+          1.0, std::max(-1.0, dot_prod(s.dir, clusters[s.cluster].center)))));
+      sum_a2[s.cluster] += s.w * a * a;
+      sum_a2_total += s.w * a * a;
+      sum_w_total += s.w;
+    }
+  for(uint32_t k = 0; k < clusters.size(); ++k) {
+    if(clusters[k].sum_w > 0.0)
+      clusters[k].width = (float)sqrt(sum_a2[k] / clusters[k].sum_w);
+  }
+  if(sum_w_total > 0.0)
+    error = (float)(RAD2DEG * sqrt(sum_a2_total / sum_w_total));
+  else
+    error = 0.0f;
+  // slots which were not rendered by a cluster in this period are
+  // unassigned; stale mixing weights would block free clusters and
+  // cause a jump when the source is clustered again:
+  for(auto& s : slots)
+    if(!s.touched) {
+      s.mix = 0.0f;
+      s.xfade = 1.0f;
+      s.cluster = -1;
+      s.prev_cluster = -1;
+    }
+  // release clusters without members:
+  for(uint32_t k = 0; k < clusters.size(); ++k)
+    if(clusters[k].active && (clusters[k].sum_w == 0.0))
+      clusters[k].active = false;
+  // merge clusters which are closer than the hysteresis, members of
+  // the weaker cluster will move in the next period:
+  for(uint32_t k1 = 0; k1 < clusters.size(); ++k1)
+    for(uint32_t k2 = k1 + 1; k2 < clusters.size(); ++k2)
+      if(clusters[k1].active && clusters[k2].active) {
+        double c(dot_prod(clusters[k1].center, clusters[k2].center));
+        double a(acos(std::min(1.0, std::max(-1.0, c))));
+        if(a < hysteresis) {
+          if(clusters[k1].sum_w < clusters[k2].sum_w)
+            clusters[k1].active = false;
+          else
+            clusters[k2].active = false;
+        }
+      }
+}
+
+pos_t source_clusterer_t::get_position(uint32_t c) const
+{
+  pos_t p(clusters[c].center);
+  p *= clusters[c].distance;
+  return p;
+}
+
+int32_t source_clusterer_t::get_cluster(uint32_t slot) const
+{
+  if(slots[slot].mix > 0.0f)
+    return slots[slot].cluster;
+  return -1;
+}
+
+uint32_t source_clusterer_t::get_num_used() const
+{
+  uint32_t n(0);
+  for(auto& c : clusters)
+    n += c.used;
+  return n;
 }
 
 diffuse_acoustic_model_t::diffuse_acoustic_model_t(float fs, uint32_t chunksize,
@@ -600,6 +1071,15 @@ receiver_t::receiver_t(tsccfg::node_t xmlsrc, const std::string& name,
   GET_ATTRIBUTE(scatterstructuresize, "m", "size of scatter structure");
   GET_ATTRIBUTE(scatterdamping, "", "damping of scatter reflection filter");
   GET_ATTRIBUTE_DEG(scatterspread, "Spatial spread of scattering");
+  // clustering:
+  GET_ATTRIBUTE(clusters, "",
+                "Maximal number of clusters of distant point sources, or 0 to "
+                "render all point sources individually");
+  GET_ATTRIBUTE(clusterdist, "m", "Minimal distance of clustered sources");
+  GET_ATTRIBUTE_DEG(clusterhysteresis,
+                    "Angular hysteresis of cluster membership");
+  GET_ATTRIBUTE(clusterfadelen, "s",
+                "Duration of cross-fades when cluster membership changes");
   // end proxy
   if(avgdist <= 0)
     avgdist = 0.5f * powf(volumetric.boxvolumef(), 0.33333f);
@@ -861,6 +1341,29 @@ void receiver_t::update_refpoint(const pos_t& psrc_physical,
   make_friendly_number(gain);
 }
 
+void receiver_t::update_geometry_version()
+{
+  const std::array<float, 14> par = {(float)volumetric.x,
+                                     (float)volumetric.y,
+                                     (float)volumetric.z,
+                                     (float)volumetricgainwithdistance,
+                                     avgdist,
+                                     falloff,
+                                     (float)proxy_position.x,
+                                     (float)proxy_position.y,
+                                     (float)proxy_position.z,
+                                     (float)proxy_is_relative,
+                                     (float)proxy_delay,
+                                     (float)proxy_airabsorption,
+                                     (float)proxy_gain,
+                                     (float)proxy_direction};
+  if(par != geometry_par) {
+    geometry_par = par;
+    geometry_version.invalidate();
+  }
+  geometry_version.update(position, orientation);
+}
+
 void receiver_t::set_next_gain(float g)
 {
   next_gain = g;
@@ -1006,6 +1509,17 @@ source_t::source_t(tsccfg::node_t xmlsrc, const std::string& name,
     throw TASCAR::ErrMsg("Invalid gain model " + gr +
                          "(valid gain models: \"1/r\", \"1\").");
   GET_ATTRIBUTE(sincorder, "", "order of sinc interpolation in delayline");
+  std::string dlformat("float");
+  get_attribute("delaylineformat", dlformat, "",
+                "sample format of delay line, \"float\" or \"half\" (half "
+                "precision halves the memory of long delay lines)");
+  if(dlformat == "float")
+    delaylinestorage = varidelay_t::float32;
+  else if(dlformat == "half")
+    delaylinestorage = varidelay_t::float16;
+  else
+    throw TASCAR::ErrMsg("Invalid delay line format " + dlformat +
+                         " (valid formats: \"float\", \"half\").");
   GET_ATTRIBUTE(ismmin, "", "minimal ISM order to render");
   GET_ATTRIBUTE(ismmax, "", "maximal ISM order to render");
   GET_ATTRIBUTE_BITS(layers, "render layers");
@@ -1013,6 +1527,17 @@ source_t::source_t(tsccfg::node_t xmlsrc, const std::string& name,
 
 source_t::~source_t() {}
 
+void source_t::update_geometry_version()
+{
+  // gain model and near field limit can be modified at runtime:
+  const std::array<float, 2> par = {(float)gainmodel, nearfieldlimit};
+  if(par != geometry_par) {
+    geometry_par = par;
+    geometry_version.invalidate();
+  }
+  geometry_version.update(position, orientation);
+}
+
 void source_t::configure()
 {
   sourcemod_t::configure();
@@ -1073,6 +1598,15 @@ void receiver_t::add_variables(TASCAR::osc_server_t* srv)
   srv->add_bool("/proxy/gain", &proxy_gain, "Use proxy position for gain");
   srv->add_bool("/proxy/direction", &proxy_direction,
                 "Use proxy position for direction");
+  if(clusters > 0) {
+    srv->add_float("/cluster/dist", &clusterdist, "[0,1000]",
+                   "Minimal distance of clustered sources in m");
+    srv->add_float_degree("/cluster/hysteresis", &clusterhysteresis, "[0,90]",
+                          "Angular hysteresis of cluster membership");
+    srv->add_float_readonly("/cluster/error", &cluster_error,
+                            "RMS angular error of clustered sources in "
+                            "degrees");
+  }
   srv->unset_variable_owner();
 }
 
@@ -1080,11 +1614,18 @@ soundpath_t::soundpath_t(const source_t* src, const soundpath_t* parent_,
                          const reflector_t* generator_)
     : parent((parent_ ? parent_ : this)),
       primary((parent_ ? (parent_->primary) : src)), reflector(generator_),
-      visible(true)
+      multiband_design(NULL), visible(true)
 {
   reflectionfilterstates.resize(getorder());
   for(uint32_t k = 0; k < reflectionfilterstates.size(); ++k)
     reflectionfilterstates[k] = 0;
+  // all multiband reflections of the path are combined into one filter:
+  if(reflector && (parent != this))
+    multiband_design = TASCAR::combine_reflectionfilter_design(
+        parent->multiband_design, reflector->multiband_design);
+  if(multiband_design)
+    multiband_state.resize(2 * TASCAR::reflectionfilter_design_t::maxsections,
+                           0.0f);
 }
 
 void soundpath_t::update_position()
@@ -1122,11 +1663,14 @@ void soundpath_t::apply_reflectionfilter(TASCAR::wave_t& audio)
   const reflector_t* pr(reflector);
   const soundpath_t* ps(this);
   while(pr) {
-    pr->apply_reflectionfilter(audio, reflectionfilterstates[k]);
+    if(!pr->multiband_design)
+      pr->apply_reflectionfilter(audio, reflectionfilterstates[k]);
     ++k;
     ps = ps->parent;
     pr = ps->reflector;
   }
+  if(multiband_design)
+    multiband_design->filter(audio, multiband_state.data());
 }
 
 pos_t soundpath_t::get_effective_position(const pos_t& p_rec, float& gain)
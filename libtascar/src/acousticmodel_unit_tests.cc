@@ -0,0 +1,215 @@
+/*
+ * This file is part of the TASCAR software, see <http://tascar.org/>
+ *
+ * Copyright (c) 2026 agent
+ */
+/*
+ * TASCAR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, version 3 of the License.
+ *
+ * TASCAR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHATABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License, version 3 for more details.
+ *
+ * You should have received a copy of the GNU General Public License,
+ * Version 3 along with TASCAR. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "acousticmodel.h"
+
+using namespace TASCAR;
+using namespace TASCAR::Acousticmodel;
+
+namespace {
+
+  const uint32_t fragsize = 64;
+  const float fs = 44100.0f;
+
+  /**
+     Process one period of sources with constant signals, return the
+     sum of individually rendered signals and cluster signals
+   */
+  wave_t process(source_clusterer_t& cl, const std::vector<pos_t>& pos,
+                 uint32_t& nindividual)
+  {
+    wave_t sum(fragsize);
+    cl.clear();
+    nindividual = 0;
+    for(uint32_t k = 0; k < pos.size(); ++k) {
+      wave_t audio(fragsize);
+      for(uint32_t t = 0; t < fragsize; ++t)
+        audio.d[t] = 1.0f + 0.01f * k;
+      if(cl.add(k, pos[k], (float)pos[k].norm(), audio)) {
+        sum += audio;
+        ++nindividual;
+      }
+    }
+    cl.update();
+    for(uint32_t c = 0; c < cl.size(); ++c)
+      if(cl.is_used(c))
+        sum += cl.get_audio(c);
+    return sum;
+  }
+
+  float expected_sum(size_t n)
+  {
+    float s(0.0f);
+    for(uint32_t k = 0; k < n; ++k)
+      s += 1.0f + 0.01f * k;
+    return s;
+  }
+
+} // namespace
+
+TEST(source_clusterer_t, near_sources)
+{
+  source_clusterer_t cl(4, 10, fragsize, fs);
+  std::vector<pos_t> pos;
+  for(uint32_t k = 0; k < 10; ++k)
+    pos.push_back(pos_t(5.0, 0.1 * k, 0.0));
+  uint32_t nind(0);
+  for(uint32_t p = 0; p < 10; ++p) {
+    wave_t sum(process(cl, pos, nind));
+    EXPECT_EQ(10u, nind);
+    EXPECT_EQ(0u, cl.get_num_used());
+    EXPECT_NEAR(expected_sum(pos.size()), sum.d[fragsize - 1], 1e-4f);
+  }
+}
+
+TEST(source_clusterer_t, distant_sources)
+{
+  // 100 sources in four groups, within +-2 degrees:
+  source_clusterer_t cl(8, 100, fragsize, fs);
+  std::vector<pos_t> pos;
+  for(uint32_t k = 0; k < 100; ++k) {
+    double az(DEG2RAD * (90.0 * (k % 4) + 4.0 * (k / 4) / 25.0 - 2.0));
+    pos.push_back(pos_t(50.0 * cos(az), 50.0 * sin(az), 0.0));
+  }
+  uint32_t nind(0);
+  // complete fade from individual to clustered rendering:
+  for(uint32_t p = 0; p < 40; ++p) {
+    wave_t sum(process(cl, pos, nind));
+    for(uint32_t t = 0; t < fragsize; ++t)
+      ASSERT_NEAR(expected_sum(pos.size()), sum.d[t], 1e-3f);
+  }
+  EXPECT_EQ(0u, nind);
+  EXPECT_EQ(4u, cl.get_num_used());
+  EXPECT_LT(cl.get_error(), 2.0f);
+  EXPECT_GT(cl.get_error(), 0.5f);
+  for(uint32_t k = 0; k < pos.size(); ++k) {
+    int32_t c(cl.get_cluster(k));
+    ASSERT_GE(c, 0);
+    EXPECT_EQ(c, cl.get_cluster(k % 4));
+    EXPECT_NEAR(50.0, cl.get_position(c).norm(), 1e-3);
+    EXPECT_NEAR(0.0, distance(pos[k % 4].normal(), cl.get_position(c).normal()),
+                0.05);
+  }
+  // sources come closer and are rendered individually again:
+  for(auto& p : pos)
+    p *= 0.1;
+  for(uint32_t p = 0; p < 40; ++p) {
+    wave_t sum(process(cl, pos, nind));
+    for(uint32_t t = 0; t < fragsize; ++t)
+      ASSERT_NEAR(expected_sum(pos.size()), sum.d[t], 1e-3f);
+  }
+  EXPECT_EQ(100u, nind);
+  EXPECT_EQ(0u, cl.get_num_used());
+  for(uint32_t k = 0; k < pos.size(); ++k)
+    EXPECT_EQ(-1, cl.get_cluster(k));
+}
+
+TEST(source_clusterer_t, bounded_number)
+{
+  // sources uniformly distributed on a circle:
+  source_clusterer_t cl(6, 60, fragsize, fs);
+  std::vector<pos_t> pos;
+  for(uint32_t k = 0; k < 60; ++k) {
+    double az(DEG2RAD * 6.0 * k);
+    pos.push_back(pos_t(30.0 * cos(az), 30.0 * sin(az), 0.0));
+  }
+  uint32_t nind(0);
+  for(uint32_t p = 0; p < 200; ++p) {
+    wave_t sum(process(cl, pos, nind));
+    for(uint32_t t = 0; t < fragsize; ++t)
+      ASSERT_NEAR(expected_sum(pos.size()), sum.d[t], 1e-3f);
+    EXPECT_LE(cl.get_num_used(), 6u);
+  }
+  EXPECT_EQ(0u, nind);
+  // each cluster covers about 60 degrees:
+  EXPECT_LT(cl.get_error(), 30.0f);
+}
+
+TEST(source_clusterer_t, hysteresis)
+{
+  // two groups of sources, and one source oscillating between them:
+  source_clusterer_t cl(2, 3, fragsize, fs);
+  cl.hysteresis = 10.0f * DEG2RADf;
+  std::vector<pos_t> pos(3);
+  pos[0] = pos_t(40, 0, 0);
+  pos[1].set_sphere(40, DEG2RAD * 60.0, 0);
+  uint32_t nind(0);
+  uint32_t changes(0);
+  int32_t prev(-1);
+  for(uint32_t p = 0; p < 400; ++p) {
+    // +-3 degrees around center between the groups:
+    pos[2].set_sphere(40, DEG2RAD * (30.0 + 3.0 * sin(0.1 * p)), 0);
+    process(cl, pos, nind);
+    int32_t c(cl.get_cluster(2));
+    if((p > 40) && (c != prev))
+      ++changes;
+    prev = c;
+  }
+  EXPECT_EQ(2u, cl.get_num_used());
+  EXPECT_EQ(0u, changes);
+}
+
+TEST(source_clusterer_t, unassigned_slots)
+{
+  // a source which is not rendered releases its cluster slot, which
+  // can then be used by another source:
+  source_clusterer_t cl(2, 3, fragsize, fs);
+  std::vector<pos_t> pos(3);
+  pos[0] = pos_t(40, 0, 0);
+  pos[1] = pos_t(0, 40, 0);
+  pos[2] = pos_t(-40, 0, 0);
+  auto run([&](const std::vector<uint32_t>& active) {
+    cl.clear();
+    for(auto k : active) {
+      wave_t audio(fragsize);
+      audio += 1.0f;
+      cl.add(k, pos[k], (float)pos[k].norm(), audio);
+    }
+    cl.update();
+  });
+  for(uint32_t p = 0; p < 200; ++p)
+    run({0, 1});
+  EXPECT_GE(cl.get_cluster(0), 0);
+  EXPECT_GE(cl.get_cluster(1), 0);
+  // source 1 is not rendered, e.g., inactive:
+  run({0});
+  EXPECT_EQ(-1, cl.get_cluster(1));
+  for(uint32_t p = 0; p < 200; ++p)
+    run({0, 2});
+  EXPECT_EQ(-1, cl.get_cluster(1));
+  EXPECT_GE(cl.get_cluster(2), 0);
+  EXPECT_EQ(2u, cl.get_num_used());
+  // a returning source starts with individual rendering:
+  cl.clear();
+  wave_t audio(fragsize);
+  audio += 1.0f;
+  EXPECT_TRUE(cl.add(1, pos[1], (float)pos[1].norm(), audio));
+  EXPECT_NEAR(1.0f, audio.d[0], 1e-3f);
+}
+
+/*
+ * Local Variables:
+ * mode: c++
+ * c-basic-offset: 2
+ * indent-tabs-mode: nil
+ * compile-command: "make -C .."
+ * End:
+ */
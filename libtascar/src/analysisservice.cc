@@ -0,0 +1,135 @@
+/*
+ * This file is part of the TASCAR software, see <http://tascar.org/>
+ *
+ * Copyright (c) 2026 agent
+ */
+/*
+ * TASCAR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, version 3 of the License.
+ *
+ * TASCAR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHATABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License, version 3 for more details.
+ *
+ * You should have received a copy of the GNU General Public License,
+ * Version 3 along with TASCAR. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "analysisservice.h"
+#include "errorhandling.h"
+
+using namespace TASCAR;
+
+analysis_service_t::analysis_service_t() {}
+
+analysis_service_t::~analysis_service_t()
+{
+  for(auto& f : stfts)
+    delete f.stft;
+}
+
+void analysis_service_t::release()
+{
+  audiostates_t::release();
+  for(auto& f : stfts)
+    delete f.stft;
+  stfts.clear();
+  bands.clear();
+  levels.clear();
+  num_subscriptions = 0u;
+}
+
+void analysis_service_t::check_channel(uint32_t channel) const
+{
+  if(!is_prepared())
+    throw TASCAR::ErrMsg("Programming error: Subscription to analysis "
+                         "service before it was prepared.");
+  if(channel >= n_channels)
+    throw TASCAR::ErrMsg("Invalid analysis channel " +
+                         std::to_string(channel) + " (only " +
+                         std::to_string(n_channels) + " channels).");
+}
+
+size_t analysis_service_t::subscribe_stft(uint32_t channel, uint32_t fftlen,
+                                          uint32_t wndlen,
+                                          stft_t::windowtype_t wnd,
+                                          double wndpos)
+{
+  check_channel(channel);
+  ++num_subscriptions;
+  for(size_t k = 0; k < stfts.size(); ++k)
+    if((stfts[k].channel == channel) && (stfts[k].fftlen == fftlen) &&
+       (stfts[k].wndlen == wndlen) && (stfts[k].wnd == wnd) &&
+       (stfts[k].wndpos == wndpos))
+      return k;
+  stft_feature_t f;
+  f.channel = channel;
+  f.fftlen = fftlen;
+  f.wndlen = wndlen;
+  f.wnd = wnd;
+  f.wndpos = wndpos;
+  f.stft = new stft_t(fftlen, wndlen, n_fragment, wnd, wndpos);
+  stfts.push_back(f);
+  return stfts.size() - 1u;
+}
+
+size_t analysis_service_t::subscribe_band(uint32_t channel, float fmin,
+                                          float fmax, uint32_t stages)
+{
+  check_channel(channel);
+  ++num_subscriptions;
+  stages = std::max(1u, stages);
+  for(size_t k = 0; k < bands.size(); ++k)
+    if((bands[k].channel == channel) && (bands[k].fmin == fmin) &&
+       (bands[k].fmax == fmax) && (bands[k].filters.size() == stages))
+      return k;
+  band_feature_t f;
+  f.channel = channel;
+  f.fmin = fmin;
+  f.fmax = fmax;
+  f.filters.resize(stages);
+  for(auto& bp : f.filters)
+    bp.set_range(fmin, fmax, f_sample);
+  f.signal.resize(n_fragment);
+  f.ms = 0.0f;
+  bands.push_back(f);
+  return bands.size() - 1u;
+}
+
+size_t analysis_service_t::subscribe_level(uint32_t channel)
+{
+  check_channel(channel);
+  ++num_subscriptions;
+  for(size_t k = 0; k < levels.size(); ++k)
+    if(levels[k].channel == channel)
+      return k;
+  levels.push_back({channel, 0.0f, 0.0f});
+  return levels.size() - 1u;
+}
+
+void analysis_service_t::update(const std::vector<wave_t>& chunk)
+{
+  for(auto& f : stfts)
+    f.stft->process(chunk[f.channel]);
+  for(auto& f : bands) {
+    f.signal.copy(chunk[f.channel]);
+    for(auto& bp : f.filters)
+      bp.filter(f.signal);
+    f.ms = f.signal.ms();
+  }
+  for(auto& f : levels) {
+    f.ms = chunk[f.channel].ms();
+    f.peak = chunk[f.channel].maxabs();
+  }
+}
+
+/*
+ * Local Variables:
+ * mode: c++
+ * c-basic-offset: 2
+ * indent-tabs-mode: nil
+ * compile-command: "make -C .."
+ * End:
+ */
@@ -0,0 +1,165 @@
+/*
+ * This file is part of the TASCAR software, see <http://tascar.org/>
+ *
+ * Copyright (c) 2026 agent
+ */
+/*
+ * TASCAR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, version 3 of the License.
+ *
+ * TASCAR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHATABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License, version 3 for more details.
+ *
+ * You should have received a copy of the GNU General Public License,
+ * Version 3 along with TASCAR. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "analysisservice.h"
+#include "errorhandling.h"
+
+using namespace TASCAR;
+
+namespace {
+
+  const uint32_t fragsize = 256;
+  const double fs = 44100.0;
+
+  std::vector<wave_t> test_signal(uint32_t channels, uint32_t block)
+  {
+    std::vector<wave_t> chunk(channels, wave_t(fragsize));
+    for(uint32_t ch = 0; ch < channels; ++ch)
+      for(uint32_t k = 0; k < fragsize; ++k)
+        chunk[ch].d[k] =
+            (float)(sin(0.01 * (ch + 1) * (block * fragsize + k)) +
+                    0.1 * sin(0.3 * (block * fragsize + k)));
+    return chunk;
+  }
+
+  /// Subscribe to the features of a typical analysis plugin
+  void subscribe_plugin(analysis_service_t& srv, std::vector<size_t>& bands)
+  {
+    srv.subscribe_stft(0, 2 * fragsize, 2 * fragsize, stft_t::WND_BLACKMAN,
+                       0);
+    bands.clear();
+    for(float fc : {250.0f, 500.0f, 1000.0f, 2000.0f, 4000.0f})
+      bands.push_back(srv.subscribe_band(0, fc / sqrtf(2.0f),
+                                         fc * sqrtf(2.0f), 2));
+    srv.subscribe_level(0);
+  }
+
+} // namespace
+
+TEST(analysis_service_t, subscribe)
+{
+  analysis_service_t srv;
+  chunk_cfg_t cfg(fs, fragsize, 2);
+  EXPECT_THROW(srv.subscribe_level(0), TASCAR::ErrMsg);
+  srv.prepare(cfg);
+  EXPECT_THROW(srv.subscribe_level(2), TASCAR::ErrMsg);
+  size_t h1(srv.subscribe_stft(0, 512, 256, stft_t::WND_HANNING, 0.5));
+  size_t h2(srv.subscribe_stft(0, 512, 256, stft_t::WND_HANNING, 0.5));
+  size_t h3(srv.subscribe_stft(1, 512, 256, stft_t::WND_HANNING, 0.5));
+  EXPECT_EQ(h1, h2);
+  EXPECT_NE(h1, h3);
+  EXPECT_EQ(srv.subscribe_band(0, 100, 200, 2),
+            srv.subscribe_band(0, 100, 200, 2));
+  EXPECT_NE(srv.subscribe_band(0, 100, 200, 2),
+            srv.subscribe_band(0, 100, 200, 1));
+  EXPECT_EQ(srv.subscribe_level(1), srv.subscribe_level(1));
+  EXPECT_EQ(9u, srv.get_num_subscriptions());
+  EXPECT_EQ(5u, srv.get_num_features());
+  srv.release();
+  EXPECT_EQ(0u, srv.get_num_subscriptions());
+  EXPECT_EQ(0u, srv.get_num_features());
+}
+
+TEST(analysis_service_t, features)
+{
+  analysis_service_t srv;
+  chunk_cfg_t cfg(fs, fragsize, 2);
+  srv.prepare(cfg);
+  size_t hstft(srv.subscribe_stft(1, 2 * fragsize, 2 * fragsize,
+                                  stft_t::WND_BLACKMAN, 0));
+  size_t hband(srv.subscribe_band(0, 500, 1000, 2));
+  size_t hlevel(srv.subscribe_level(1));
+  // reference implementation, as used in the analysis plugins:
+  stft_t stft(2 * fragsize, 2 * fragsize, fragsize, stft_t::WND_BLACKMAN, 0);
+  bandpass_t bp1(500, 1000, fs);
+  bandpass_t bp2(500, 1000, fs);
+  wave_t band(fragsize);
+  for(uint32_t block = 0; block < 10; ++block) {
+    auto chunk(test_signal(2, block));
+    srv.update(chunk);
+    stft.process(chunk[1]);
+    const stft_t& sstft(srv.get_stft(hstft));
+    ASSERT_EQ(stft.s.n_, sstft.s.n_);
+    for(uint32_t k = 0; k < stft.s.n_; ++k) {
+      ASSERT_EQ(stft.s.b[k].real(), sstft.s.b[k].real());
+      ASSERT_EQ(stft.s.b[k].imag(), sstft.s.b[k].imag());
+    }
+    band.copy(chunk[0]);
+    bp1.filter(band);
+    bp2.filter(band);
+    for(uint32_t k = 0; k < fragsize; ++k)
+      ASSERT_EQ(band.d[k], srv.get_band(hband).d[k]);
+    EXPECT_EQ(band.ms(), srv.get_band_ms(hband));
+    EXPECT_EQ(chunk[1].ms(), srv.get_ms(hlevel));
+    EXPECT_EQ(chunk[1].rms(), srv.get_rms(hlevel));
+    EXPECT_EQ(chunk[1].maxabs(), srv.get_peak(hlevel));
+  }
+  srv.release();
+}
+
+TEST(analysis_service_t, stacked_plugins)
+{
+  // 1 to 6 stacked analysis plugins share one analysis; the results
+  // are identical to those of a private analysis of each plugin:
+  const uint32_t numblocks(20);
+  chunk_cfg_t cfg(fs, fragsize, 1);
+  std::vector<size_t> bands;
+  std::vector<size_t> sharedbands;
+  for(uint32_t numplugins = 1; numplugins <= 6; ++numplugins) {
+    std::vector<analysis_service_t> privsrv(numplugins);
+    analysis_service_t sharedsrv;
+    sharedsrv.prepare(cfg);
+    for(auto& srv : privsrv) {
+      srv.prepare(cfg);
+      subscribe_plugin(srv, bands);
+      subscribe_plugin(sharedsrv, sharedbands);
+    }
+    EXPECT_EQ(numplugins * 7u, sharedsrv.get_num_subscriptions());
+    EXPECT_EQ(7u, sharedsrv.get_num_features());
+    ASSERT_EQ(bands.size(), sharedbands.size());
+    // identical subscriptions return the same handle:
+    size_t hlevel(privsrv[0].subscribe_level(0));
+    size_t hsharedlevel(sharedsrv.subscribe_level(0));
+    for(uint32_t block = 0; block < numblocks; ++block) {
+      auto chunk(test_signal(1, block));
+      sharedsrv.update(chunk);
+      for(auto& srv : privsrv) {
+        srv.update(chunk);
+        for(size_t b = 0; b < bands.size(); ++b)
+          ASSERT_EQ(srv.get_band_ms(bands[b]),
+                    sharedsrv.get_band_ms(sharedbands[b]));
+        ASSERT_EQ(srv.get_ms(hlevel), sharedsrv.get_ms(hsharedlevel));
+      }
+    }
+    for(auto& srv : privsrv)
+      srv.release();
+    sharedsrv.release();
+  }
+}
+
+/*
+ * Local Variables:
+ * mode: c++
+ * c-basic-offset: 2
+ * indent-tabs-mode: nil
+ * compile-command: "make -C .."
+ * End:
+ */
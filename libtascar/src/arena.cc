@@ -0,0 +1,73 @@
+/*
+ * This file is part of the TASCAR software, see <http://tascar.org/>
+ *
+ * Copyright (c) 2026 agent
+ */
+/*
+ * TASCAR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, version 3 of the License.
+ *
+ * TASCAR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHATABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License, version 3 for more details.
+ *
+ * You should have received a copy of the GNU General Public License,
+ * Version 3 along with TASCAR. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "arena.h"
+#include <algorithm>
+
+using namespace TASCAR;
+
+arena_t::arena_t(size_t blocksize_) : blocksize(blocksize_) {}
+
+arena_t::~arena_t()
+{
+  clear();
+}
+
+void* arena_t::allocate(size_t size, size_t alignment)
+{
+  if(!blocks.empty()) {
+    block_t& b(blocks.back());
+    uintptr_t base((uintptr_t)b.data.get());
+    uintptr_t mask(~(uintptr_t)(alignment - 1u));
+    size_t pos(((base + b.pos + alignment - 1u) & mask) - base);
+    if(pos + size <= b.size) {
+      b.pos = pos + size;
+      used += size;
+      return b.data.get() + pos;
+    }
+  }
+  // new block, large enough for the object and alignment padding:
+  block_t b;
+  b.size = std::max(blocksize, size + alignment);
+  b.data.reset(new char[b.size]);
+  reserved += b.size;
+  blocks.push_back(std::move(b));
+  return allocate(size, alignment);
+}
+
+void arena_t::clear()
+{
+  while(!dtors.empty()) {
+    dtors.back().second(dtors.back().first);
+    dtors.pop_back();
+  }
+  blocks.clear();
+  reserved = 0u;
+  used = 0u;
+}
+
+/*
+ * Local Variables:
+ * mode: c++
+ * c-basic-offset: 2
+ * indent-tabs-mode: nil
+ * compile-command: "make -C .."
+ * End:
+ */
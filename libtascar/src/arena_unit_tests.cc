@@ -0,0 +1,93 @@
+/*
+ * This file is part of the TASCAR software, see <http://tascar.org/>
+ *
+ * Copyright (c) 2026 agent
+ */
+/*
+ * TASCAR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, version 3 of the License.
+ *
+ * TASCAR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHATABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License, version 3 for more details.
+ *
+ * You should have received a copy of the GNU General Public License,
+ * Version 3 along with TASCAR. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include "arena.h"
+#include "audiochunks.h"
+
+namespace {
+
+  /// Object which records the order of destruction
+  class tracked_t {
+  public:
+    tracked_t(std::vector<int>& log_, int id_) : log(log_), id(id_) {}
+    ~tracked_t() { log.push_back(id); }
+    std::vector<int>& log;
+    int id;
+    double value = 0.0;
+  };
+
+} // namespace
+
+TEST(arena_t, allocate)
+{
+  TASCAR::arena_t arena(1024);
+  EXPECT_EQ(0u, arena.get_num_bytes());
+  char* p1((char*)arena.allocate(10, 1));
+  double* p2((double*)arena.allocate(sizeof(double), alignof(double)));
+  EXPECT_EQ(0u, (uintptr_t)p2 % alignof(double));
+  // consecutive allocations are contiguous:
+  EXPECT_LT((char*)p2 - p1, 24);
+  EXPECT_EQ(1024u, arena.get_num_bytes());
+  EXPECT_EQ(10u + sizeof(double), arena.get_num_used());
+  // large allocations get their own block:
+  arena.allocate(4000, 64);
+  EXPECT_GE(arena.get_num_bytes(), 1024u + 4000u);
+  arena.clear();
+  EXPECT_EQ(0u, arena.get_num_bytes());
+  EXPECT_EQ(0u, arena.get_num_used());
+}
+
+TEST(arena_t, create)
+{
+  std::vector<int> log;
+  {
+    TASCAR::arena_t arena(256);
+    std::vector<tracked_t*> objs;
+    for(int k = 0; k < 100; ++k)
+      objs.push_back(arena.create<tracked_t>(log, k));
+    EXPECT_EQ(100u, arena.get_num_objects());
+    for(auto obj : objs)
+      EXPECT_EQ(0u, (uintptr_t)obj % alignof(tracked_t));
+    EXPECT_EQ(42, objs[42]->id);
+    arena.clear();
+    EXPECT_EQ(0u, arena.get_num_objects());
+    ASSERT_EQ(100u, log.size());
+    // reverse order of creation:
+    for(int k = 0; k < 100; ++k)
+      EXPECT_EQ(99 - k, log[k]);
+    log.clear();
+    arena.create<tracked_t>(log, 7);
+    arena.create<TASCAR::wave_t>(64u);
+  }
+  // remaining objects are destroyed with the arena:
+  ASSERT_EQ(1u, log.size());
+  EXPECT_EQ(7, log[0]);
+}
+
+/*
+ * Local Variables:
+ * mode: c++
+ * c-basic-offset: 2
+ * indent-tabs-mode: nil
+ * compile-command: "make -C .."
+ * End:
+ */
@@ -22,6 +22,7 @@
 #include "async_file.h"
 //#include "tascar.h"
 #include "errorhandling.h"
+#include "threadrole.h"
 #include "tscconfig.h"
 #include <stdlib.h>
 #include <string.h>
@@ -239,6 +240,7 @@ void TASCAR::async_sndfile_t::stop_service()
 
 void* TASCAR::async_sndfile_t::service(void* h)
 {
+  TASCAR::register_thread(TASCAR::thread_roles_t::disk);
   ((TASCAR::async_sndfile_t*)h)->service();
   return NULL;
 }
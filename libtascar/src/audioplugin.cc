@@ -41,6 +41,14 @@ audioplugin_base_t::audioplugin_base_t(const audioplugin_cfg_t& cfg)
 
 audioplugin_base_t::~audioplugin_base_t() {}
 
+analysis_service_t& audioplugin_base_t::get_analysis_service()
+{
+  if(!analysis)
+    throw TASCAR::ErrMsg("No analysis service available for plugin " +
+                         get_fullname() + ".");
+  return *analysis;
+}
+
 TASCAR_RESOLVER(audioplugin_base_t, const audioplugin_cfg_t&)
 
 TASCAR::audioplugin_t::audioplugin_t(const audioplugin_cfg_t& cfg)
@@ -49,25 +57,16 @@ TASCAR::audioplugin_t::audioplugin_t(const audioplugin_cfg_t& cfg)
   plugintype = tsccfg::node_get_name(e);
   if(plugintype == "plugin")
     get_attribute("type", plugintype, "", "plugin type");
-  std::string libname("tascar_ap_");
-#ifdef PLUGINPREFIX
-  libname = PLUGINPREFIX + libname;
-#endif
-  libname += plugintype + TASCAR::dynamic_lib_extension();
+  std::string libname(TASCAR::plugin_libname("tascar_ap_", plugintype));
   modname = plugintype;
   audioplugin_cfg_t lcfg(cfg);
   lcfg.modname = modname;
-  lib = TASCAR::dlopen((TASCAR::get_libdir() + libname).c_str(), RTLD_NOW);
+  std::string emsg;
+  lib = TASCAR::plugin_registry_t::get().open(libname, emsg);
   if(!lib)
     throw TASCAR::ErrMsg("Unable to open module \"" + plugintype +
-                         "\": " + dlerror());
-  try {
-    audioplugin_base_t_resolver(&libdata, lcfg, lib, libname);
-  }
-  catch(...) {
-    dlclose(lib);
-    throw;
-  }
+                         "\": " + emsg);
+  audioplugin_base_t_resolver(&libdata, lcfg, lib, libname);
 }
 
 void TASCAR::audioplugin_t::ap_process(std::vector<wave_t>& chunk,
@@ -110,7 +109,6 @@ void TASCAR::audioplugin_t::add_licenses(licensehandler_t* session)
 TASCAR::audioplugin_t::~audioplugin_t()
 {
   delete libdata;
-  dlclose(lib);
 }
 
 void TASCAR::audioplugin_t::validate_attributes(std::string& msg) const
@@ -118,6 +116,17 @@ void TASCAR::audioplugin_t::validate_attributes(std::string& msg) const
   libdata->validate_attributes(msg);
 }
 
+bool TASCAR::audioplugin_t::modifies_audio() const
+{
+  return libdata->modifies_audio();
+}
+
+void TASCAR::audioplugin_t::set_analysis_service(analysis_service_t* srv)
+{
+  audioplugin_base_t::set_analysis_service(srv);
+  libdata->set_analysis_service(srv);
+}
+
 /*
  * Local Variables:
  * mode: c++
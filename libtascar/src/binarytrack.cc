@@ -0,0 +1,227 @@
+/*
+ * This file is part of the TASCAR software, see <http://tascar.org/>
+ *
+ * Copyright (c) 2026 agent
+ */
+/*
+ * TASCAR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, version 3 of the License.
+ *
+ * TASCAR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHATABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License, version 3 for more details.
+ *
+ * You should have received a copy of the GNU General Public License,
+ * Version 3 along with TASCAR. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "binarytrack.h"
+#include "errorhandling.h"
+#include <algorithm>
+#include <stdio.h>
+#include <string.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace TASCAR;
+
+namespace {
+
+  const char magic[8] = {'T', 'S', 'C', 'T', 'R', 'K', '0', '1'};
+
+  struct header_t {
+    char magic[8];
+    uint32_t content;
+    uint32_t recordsize;
+    uint64_t n;
+    double t_min;
+    double t_max;
+    char reserved[24];
+  };
+
+  static_assert(sizeof(header_t) == 64, "unexpected size of track header");
+
+} // namespace
+
+binary_track_t::binary_track_t(const std::string& fname, double t_begin,
+                               double t_end)
+    : content(position)
+{
+  header_t hdr;
+  size_t filesize(0);
+#ifndef _WIN32
+  int fd(open(fname.c_str(), O_RDONLY));
+  if(fd < 0)
+    throw TASCAR::ErrMsg("Unable to open binary track file \"" + fname +
+                         "\".");
+  struct stat st;
+  if(fstat(fd, &st) == 0)
+    filesize = st.st_size;
+  if(filesize >= sizeof(hdr)) {
+    maplen = filesize;
+    map = mmap(NULL, maplen, PROT_READ, MAP_SHARED, fd, 0);
+  }
+  close(fd);
+  if((map == NULL) || (map == MAP_FAILED)) {
+    map = NULL;
+    throw TASCAR::ErrMsg("Unable to map binary track file \"" + fname +
+                         "\".");
+  }
+  memcpy(&hdr, map, sizeof(hdr));
+  rec = (const record_t*)((const char*)map + sizeof(hdr));
+#else
+  FILE* fh(fopen(fname.c_str(), "rb"));
+  if(!fh)
+    throw TASCAR::ErrMsg("Unable to open binary track file \"" + fname +
+                         "\".");
+  if(fread(&hdr, sizeof(hdr), 1, fh) == 1) {
+    filesize = sizeof(hdr);
+    if(memcmp(hdr.magic, magic, sizeof(magic)) == 0) {
+      data.resize(hdr.n);
+      filesize += sizeof(record_t) * fread(data.data(), sizeof(record_t),
+                                           data.size(), fh);
+    }
+  }
+  fclose(fh);
+  rec = data.data();
+#endif
+  if((filesize < sizeof(hdr)) ||
+     (memcmp(hdr.magic, magic, sizeof(magic)) != 0) ||
+     (hdr.recordsize != sizeof(record_t)) ||
+     (hdr.content > (uint32_t)orientation) ||
+     (filesize != sizeof(hdr) + hdr.n * sizeof(record_t))) {
+#ifndef _WIN32
+    munmap(map, maplen);
+#endif
+    throw TASCAR::ErrMsg("Invalid binary track file \"" + fname + "\".");
+  }
+  content = (content_t)hdr.content;
+  ntotal = hdr.n;
+  if(ntotal == 0)
+    return;
+  // restrict to time range, including the records before and after:
+  auto cmp_t([](const record_t& r, double t) { return r.t < t; });
+  const record_t* r0(rec);
+  const record_t* r1(rec + ntotal - 1);
+  if(t_begin > rec[0].t)
+    r0 = std::upper_bound(rec, rec + ntotal, t_begin,
+                          [](double t, const record_t& r) { return t < r.t; }) -
+         1;
+  if(t_end < r1->t)
+    r1 = std::lower_bound(rec, rec + ntotal, t_end, cmp_t);
+  if(r1 < r0)
+    r1 = r0;
+  n = r1 - r0 + 1;
+  rec = r0;
+#ifndef _WIN32
+  // read ahead only the used time range:
+  madvise(map, maplen, MADV_RANDOM);
+  size_t pagesize(sysconf(_SC_PAGESIZE));
+  size_t offset((const char*)rec - (const char*)map);
+  size_t pageoffset(offset - offset % pagesize);
+  madvise((char*)map + pageoffset, offset - pageoffset + get_num_bytes(),
+          MADV_WILLNEED);
+#endif
+}
+
+binary_track_t::~binary_track_t()
+{
+#ifndef _WIN32
+  if(map)
+    munmap(map, maplen);
+#endif
+}
+
+double binary_track_t::t_min() const
+{
+  if(n)
+    return rec[0].t;
+  return 0;
+}
+
+double binary_track_t::t_max() const
+{
+  if(n)
+    return rec[n - 1].t;
+  return 0;
+}
+
+bool binary_track_t::find(double t, size_t& k, double& w) const
+{
+  w = 0;
+  if(n == 0)
+    return false;
+  if(t <= rec[0].t) {
+    k = 0;
+    return true;
+  }
+  if(t >= rec[n - 1].t) {
+    k = n - 1;
+    return true;
+  }
+  const record_t* r2(std::lower_bound(
+      rec, rec + n, t, [](const record_t& r, double t) { return r.t < t; }));
+  k = r2 - rec;
+  if(r2->t == t)
+    return true;
+  --k;
+  w = (t - rec[k].t) / (r2->t - rec[k].t);
+  make_friendly_number(w);
+  return true;
+}
+
+void binary_track_t::write(const std::string& fname, content_t content,
+                           const std::vector<double>& t,
+                           const std::vector<double>& v)
+{
+  if(v.size() != 3 * t.size())
+    throw TASCAR::ErrMsg("Three coordinates per time stamp are required.");
+  for(size_t k = 1; k < t.size(); ++k)
+    if(t[k] <= t[k - 1])
+      throw TASCAR::ErrMsg("Time stamps of binary tracks need to be in "
+                           "ascending order.");
+  header_t hdr;
+  memset(&hdr, 0, sizeof(hdr));
+  memcpy(hdr.magic, magic, sizeof(magic));
+  hdr.content = content;
+  hdr.recordsize = sizeof(record_t);
+  hdr.n = t.size();
+  if(t.size()) {
+    hdr.t_min = t.front();
+    hdr.t_max = t.back();
+  }
+  FILE* fh(fopen(fname.c_str(), "wb"));
+  if(!fh)
+    throw TASCAR::ErrMsg("Unable to create binary track file \"" + fname +
+                         "\".");
+  bool ok(fwrite(&hdr, sizeof(hdr), 1, fh) == 1);
+  for(size_t k = 0; ok && (k < t.size()); ++k) {
+    record_t r;
+    r.t = t[k];
+    r.v[0] = v[3 * k];
+    r.v[1] = v[3 * k + 1];
+    r.v[2] = v[3 * k + 2];
+    ok = (fwrite(&r, sizeof(r), 1, fh) == 1);
+  }
+  if(fclose(fh) != 0)
+    ok = false;
+  if(!ok)
+    throw TASCAR::ErrMsg("Unable to write binary track file \"" + fname +
+                         "\".");
+}
+
+/*
+ * Local Variables:
+ * mode: c++
+ * c-basic-offset: 2
+ * indent-tabs-mode: nil
+ * compile-command: "make -C .."
+ * End:
+ */
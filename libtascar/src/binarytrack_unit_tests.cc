@@ -0,0 +1,189 @@
+/*
+ * This file is part of the TASCAR software, see <http://tascar.org/>
+ *
+ * Copyright (c) 2026 agent
+ */
+/*
+ * TASCAR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, version 3 of the License.
+ *
+ * TASCAR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHATABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License, version 3 for more details.
+ *
+ * You should have received a copy of the GNU General Public License,
+ * Version 3 along with TASCAR. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "binarytrack.h"
+#include "dynamicobjects.h"
+#include "errorhandling.h"
+#include <filesystem>
+#include <fstream>
+
+using namespace TASCAR;
+
+namespace {
+
+  std::string tmpfile(const std::string& name)
+  {
+    return (std::filesystem::temp_directory_path() / name).string();
+  }
+
+  /// Helix with one point per second
+  void helix(size_t n, std::vector<double>& t, std::vector<double>& v)
+  {
+    t.clear();
+    v.clear();
+    for(size_t k = 0; k < n; ++k) {
+      t.push_back(k);
+      v.push_back(10.0 * cos(0.01 * k));
+      v.push_back(10.0 * sin(0.01 * k));
+      v.push_back(0.001 * k);
+    }
+  }
+
+} // namespace
+
+TEST(binary_track_t, interp)
+{
+  std::string fname(tmpfile("tascar_binarytrack_test.tbin"));
+  std::vector<double> t;
+  std::vector<double> v;
+  helix(1000, t, v);
+  binary_track_t::write(fname, binary_track_t::position, t, v);
+  track_t ref;
+  for(size_t k = 0; k < t.size(); ++k)
+    ref[t[k]] = pos_t(v[3 * k], v[3 * k + 1], v[3 * k + 2]);
+  track_t track;
+  track.load_from_binary(fname);
+  ASSERT_TRUE(track.binary != nullptr);
+  EXPECT_EQ(1000u, track.binary->size());
+  EXPECT_EQ(0u, track.size());
+  EXPECT_EQ(0.0, track.t_min());
+  EXPECT_EQ(999.0, track.t_max());
+  for(auto interpt : {track_t::cartesian, track_t::spherical}) {
+    ref.set_interpt(interpt);
+    track.set_interpt(interpt);
+    for(double tp = -10.0; tp < 1010.0; tp += 0.37)
+      ASSERT_NEAR(0.0, distance(ref.interp(tp), track.interp(tp)), 1e-9);
+  }
+  track.loop = 100.0;
+  EXPECT_NEAR(0.0, distance(track.interp(20.5), track.interp(120.5)), 1e-9);
+  // orientation tracks:
+  binary_track_t::write(fname, binary_track_t::orientation, t, v);
+  EXPECT_THROW(track.load_from_binary(fname), TASCAR::ErrMsg);
+  euler_track_t rot;
+  rot.load_from_binary(fname);
+  zyx_euler_t r(rot.interp(10.5));
+  EXPECT_NEAR(0.5 * (v[30] + v[33]), r.z, 1e-9);
+  EXPECT_NEAR(0.5 * (v[31] + v[34]), r.y, 1e-9);
+  EXPECT_NEAR(0.5 * (v[32] + v[35]), r.x, 1e-9);
+  std::filesystem::remove(fname);
+}
+
+TEST(binary_track_t, timerange)
+{
+  std::string fname(tmpfile("tascar_binarytrack_test.tbin"));
+  std::vector<double> t;
+  std::vector<double> v;
+  helix(1000, t, v);
+  binary_track_t::write(fname, binary_track_t::position, t, v);
+  binary_track_t full(fname);
+  // range is extended to the points before and after:
+  binary_track_t part(fname, 100.5, 200.5);
+  EXPECT_EQ(1000u, part.get_num_total());
+  EXPECT_EQ(102u, part.size());
+  EXPECT_EQ(100.0, part.t_min());
+  EXPECT_EQ(201.0, part.t_max());
+  EXPECT_EQ(102u * 32u, part.get_num_bytes());
+  size_t k(0);
+  double w(0);
+  ASSERT_TRUE(part.find(150.25, k, w));
+  EXPECT_EQ(150.0, part.get_time(k));
+  EXPECT_NEAR(0.25, w, 1e-12);
+  // time outside of the range is clamped:
+  ASSERT_TRUE(part.find(500.0, k, w));
+  EXPECT_EQ(101u, k);
+  EXPECT_EQ(0.0, w);
+  binary_track_t exact(fname, 100, 200);
+  EXPECT_EQ(101u, exact.size());
+  binary_track_t outside(fname, 2000, 3000);
+  EXPECT_EQ(1u, outside.size());
+  EXPECT_EQ(999.0, outside.t_min());
+  std::filesystem::remove(fname);
+}
+
+TEST(binary_track_t, invalid)
+{
+  std::string fname(tmpfile("tascar_binarytrack_test.tbin"));
+  std::vector<double> t;
+  std::vector<double> v;
+  helix(10, t, v);
+  EXPECT_THROW(binary_track_t::write(fname, binary_track_t::position, t,
+                                     std::vector<double>(3)),
+               TASCAR::ErrMsg);
+  std::swap(t[2], t[3]);
+  EXPECT_THROW(binary_track_t::write(fname, binary_track_t::position, t, v),
+               TASCAR::ErrMsg);
+  std::swap(t[2], t[3]);
+  binary_track_t::write(fname, binary_track_t::position, t, v);
+  std::filesystem::resize_file(fname, 64 + 9 * 32);
+  EXPECT_THROW(binary_track_t track(fname), TASCAR::ErrMsg);
+  {
+    std::ofstream fh(fname);
+    fh << "0,1,2,3\n";
+  }
+  EXPECT_THROW(binary_track_t track(fname), TASCAR::ErrMsg);
+  std::filesystem::remove(fname);
+  EXPECT_THROW(binary_track_t track(fname), TASCAR::ErrMsg);
+}
+
+TEST(binary_track_t, csv_equivalence)
+{
+  std::string csvname(tmpfile("tascar_binarytrack_test.csv"));
+  std::string binname(tmpfile("tascar_binarytrack_test.tbin"));
+  std::vector<double> t;
+  std::vector<double> v;
+  helix(20000, t, v);
+  {
+    std::ofstream fh(csvname);
+    fh.precision(12);
+    for(size_t k = 0; k < t.size(); ++k)
+      fh << t[k] << "," << v[3 * k] << "," << v[3 * k + 1] << ","
+         << v[3 * k + 2] << "\n";
+  }
+  binary_track_t::write(binname, binary_track_t::position, t, v);
+  track_t csvtrack;
+  csvtrack.load_from_csv(csvname);
+  track_t bintrack;
+  bintrack.load_from_binary(binname);
+  track_t parttrack;
+  parttrack.load_from_binary(binname, 1000, 1600);
+  EXPECT_EQ(20000u, csvtrack.size());
+  EXPECT_EQ(20000u, bintrack.binary->size());
+  EXPECT_EQ(601u, parttrack.binary->size());
+  double dt(0);
+  for(double tp = 0; tp < 20000.0; tp += 0.5)
+    dt = std::max(dt, distance(csvtrack.interp(tp), bintrack.interp(tp)));
+  EXPECT_NEAR(0.0, dt, 1e-9);
+  dt = 0;
+  for(double tp = 1000.0; tp <= 1600.0; tp += 0.5)
+    dt = std::max(dt, distance(csvtrack.interp(tp), parttrack.interp(tp)));
+  EXPECT_NEAR(0.0, dt, 1e-9);
+  std::filesystem::remove(csvname);
+  std::filesystem::remove(binname);
+}
+
+/*
+ * Local Variables:
+ * mode: c++
+ * c-basic-offset: 2
+ * indent-tabs-mode: nil
+ * compile-command: "make -C .."
+ * End:
+ */
@@ -32,6 +32,7 @@
 #include "fft.h"
 #include "jackiowav.h"
 #include <fstream>
+#include <random>
 #include <unistd.h>
 
 using namespace TASCAR;
@@ -269,6 +270,10 @@ void calib_cfg_t::validate() const
   if(refport.size() != miccalib.size())
     throw TASCAR::ErrMsg("For each connected measurement microphone a "
                          "calibration value is required.");
+  if(simultaneous && !(irlen > 0.0f))
+    throw TASCAR::ErrMsg(
+        std::string("irlen needs to be above zero (current value: ") +
+        TASCAR::to_string(irlen) + " s).");
 }
 
 void calib_cfg_t::factory_reset()
@@ -278,6 +283,8 @@ void calib_cfg_t::factory_reset()
   refport.clear();
   miccalib.clear();
   initcal = true;
+  simultaneous = false;
+  irlen = 0.25f;
 }
 
 void calib_cfg_t::read_defaults()
@@ -292,6 +299,8 @@ void calib_cfg_t::read_defaults()
                      TASCAR::to_string(std::vector<float>({0.0f}))));
   for(auto& c : miccalib)
     c = TASCAR::dbspl2lin(c);
+  simultaneous = (TASCAR::config("tascar.spkcalib.simultaneous", 0.0) != 0.0);
+  irlen = (float)TASCAR::config("tascar.spkcalib.irlen", irlen);
 }
 
 #define WRITE_DEF(x)                                                           \
@@ -322,9 +331,13 @@ void calib_cfg_t::save_defaults()
                                 TASCAR::vecstr2str(refport));
   TASCAR::config_forceoverwrite(path + ".miccalib",
                                 TASCAR::to_string_dbspl(miccalib));
-  std::vector<std::string> keys = {"tascar.spkcalib.inputport",
-                                   "tascar.spkcalib.miccalib",
-                                   "tascar.spkcalib.fc"};
+  TASCAR::config_forceoverwrite(path + ".simultaneous",
+                                std::to_string((int)simultaneous));
+  TASCAR::config_forceoverwrite(path + ".irlen", TASCAR::to_string(irlen));
+  std::vector<std::string> keys = {
+      "tascar.spkcalib.inputport", "tascar.spkcalib.miccalib",
+      "tascar.spkcalib.fc", "tascar.spkcalib.simultaneous",
+      "tascar.spkcalib.irlen"};
   for(auto key : {"fmin", "fmax", "duration", "prewait", "reflevel",
                   "bandsperoctave", "bandoverlap", "max_eqstages"}) {
     keys.push_back(std::string("tascar.spkcalib.") + key);
@@ -393,6 +406,18 @@ calibsession_t::calibsession_t(const std::string& fname, const calib_cfg_t& cfg)
   e_rcvr.set_attribute("name", "rec_nsp");
   e_rcvr.set_attribute("type", "nsp");
   e_rcvr.set_attribute("layout", fname);
+  spk_file = new spk_array_diff_render_t(e_rcvr.e, false);
+  if(cfg_.simultaneous) {
+    // add one source with audio input per broadband speaker for
+    // simultaneous measurement, muted for now:
+    for(size_t k = 0; k < spk_file->size(); ++k) {
+      xml_element_t e_msrc(e_scene.add_child("source"));
+      e_msrc.set_attribute("name", "msrc" + std::to_string(k + 1));
+      e_msrc.set_attribute("mute", "true");
+      xml_element_t e_msnd(e_msrc.add_child("sound"));
+      e_msnd.set_attribute("name", "0");
+    }
+  }
   // receiver 2 is specific to the layout, for overall calibration:
   xml_element_t e_rcvr2(e_scene.add_child("receiver"));
   e_rcvr2.set_attribute("name", "rec_spec");
@@ -445,7 +470,6 @@ calibsession_t::calibsession_t(const std::string& fname, const calib_cfg_t& cfg)
   add_module(e_route_pink.e);
   add_module(e_route_sub.e);
   add_module(e_route_levels.e);
-  spk_file = new spk_array_diff_render_t(e_rcvr.e, false);
   levels = std::vector<float>(spk_file->size(), 0.0);
   sublevels = std::vector<float>(spk_file->subs.size(), 0.0);
   // levelsfrg = std::vector<float>(spk_file->size(), 0.0);
@@ -453,11 +477,18 @@ calibsession_t::calibsession_t(const std::string& fname, const calib_cfg_t& cfg)
   // validate scene:
   if(scenes.empty())
     throw TASCAR::ErrMsg("Programming error: no scene");
-  if(scenes[0]->source_objects.size() != 2)
-    throw TASCAR::ErrMsg("Programming error: not exactly two sources.");
+  size_t numsrc(2u);
+  if(cfg_.simultaneous)
+    numsrc += spk_file->size();
+  if(scenes[0]->source_objects.size() != numsrc)
+    throw TASCAR::ErrMsg("Programming error: not exactly " +
+                         std::to_string(numsrc) + " sources.");
   if(scenes[0]->receivermod_objects.size() != 3)
     throw TASCAR::ErrMsg("Programming error: not exactly three receivers.");
   scenes.back()->source_objects[0]->dlocation = pos_t(1, 0, 0);
+  for(size_t k = 2; k < numsrc; ++k)
+    scenes.back()->source_objects[k]->dlocation =
+        (*spk_file)[k - 2].unitvector;
   rec_nsp = scenes.back()->receivermod_objects[0];
   spk_nsp = dynamic_cast<TASCAR::receivermod_base_speaker_t*>(rec_nsp->libdata);
   if(!spk_nsp)
@@ -542,28 +573,18 @@ float getmedian(std::vector<float> vec)
   return vec[size / 2];
 }
 
-/**
- * @brief Record calibration of one single speaker.
- */
-void get_speaker_equalization(
-    const spk_descriptor_t& spk, TASCAR::Scene::src_object_t& src,
-    jackrec2wave_t& jackrec, const std::vector<TASCAR::wave_t>& recbuf,
-    const std::vector<float>& miccalib, const std::vector<std::string>& ports,
-    levelmeter::weight_t weight, const spk_eq_param_t& calibpar,
-    std::vector<float>& levels, std::vector<float>& vF, std::vector<float>& vG,
+void TASCAR::analyse_speaker_recording(
+    const std::vector<TASCAR::wave_t>& recbuf,
+    const std::vector<float>& miccalib, levelmeter::weight_t weight,
+    const spk_eq_param_t& calibpar, float fs, std::vector<float>& levels,
+    std::vector<float>& vF, std::vector<float>& vG,
     std::vector<float>& level_fs, std::vector<float>* vcoh)
 {
   vF.clear();
   vG.clear();
   level_fs.clear();
-  // move source to speaker position:
-  src.dlocation = spk.unitvector;
-  usleep((unsigned int)(1e6f * calibpar.prewait));
   // create level meter:
-  TASCAR::levelmeter_t levelmeter((float)jackrec.get_srate(), calibpar.duration,
-                                  weight);
-  // record measurement signal:
-  jackrec.rec(recbuf, ports);
+  TASCAR::levelmeter_t levelmeter(fs, calibpar.duration, weight);
   // squared broadband levels for averaging:
   float lev_sqr = 0.0f;
   // container for frequency-dependent levels, non-averaged:
@@ -573,12 +594,12 @@ void get_speaker_equalization(
   // container for frequency-dependent reference levels (test stimulus):
   std::vector<float> vLref;
   // calc average across input channels:
-  for(size_t ch = 0u; ch < ports.size() - 1u; ++ch) {
+  for(size_t ch = 0u; ch < recbuf.size() - 1u; ++ch) {
     // calculated calibrated input levels:
     auto& wav = recbuf[ch];
     if(vcoh)
       vcoh->push_back(get_coherence(wav, recbuf.back(), calibpar.fmin,
-                                    calibpar.fmax, jackrec.get_srate()));
+                                    calibpar.fmax, fs));
     level_fs.push_back(10.0f * log10f(wav.ms()));
     float calgain = miccalib[ch];
     float* wav_begin = wav.d;
@@ -589,9 +610,9 @@ void get_speaker_equalization(
     levelmeter.update(wav);
     lev_sqr += levelmeter.ms();
     // get levels in filter bands:
-    TASCAR::get_bandlevels(wav, calibpar.fmin, calibpar.fmax,
-                           (float)jackrec.get_srate(), calibpar.bandsperoctave,
-                           calibpar.bandoverlap, vF, vL);
+    TASCAR::get_bandlevels(wav, calibpar.fmin, calibpar.fmax, fs,
+                           calibpar.bandsperoctave, calibpar.bandoverlap, vF,
+                           vL);
     for(auto& l : vL)
       l = powf(10.0f, 0.1f * l);
     if(vLmean.empty())
@@ -610,26 +631,265 @@ void get_speaker_equalization(
   levels.push_back(lev_sqr);
   // get reference stimulus properties:
   levelmeter.update(recbuf.back());
-  TASCAR::get_bandlevels(recbuf.back(), calibpar.fmin, calibpar.fmax,
-                         (float)jackrec.get_srate(), calibpar.bandsperoctave,
-                         calibpar.bandoverlap, vF, vLref);
+  TASCAR::get_bandlevels(recbuf.back(), calibpar.fmin, calibpar.fmax, fs,
+                         calibpar.bandsperoctave, calibpar.bandoverlap, vF,
+                         vLref);
   for(size_t ch = 0; ch < std::min(vLmean.size(), vLref.size()); ++ch)
     vG.push_back(vLref[ch] - vLmean[ch]);
-  // auto vl_max = vG.back();
-  // for(const auto& l : vG)
-  //  vl_max = std::max(vl_max, l);
-  // for(auto& l : vG)
-  //  l -= vl_max;
   auto med = getmedian(vG);
   for(auto& g : vG)
     g -= med;
 }
 
-void get_levels_(spk_array_t& spks, TASCAR::Scene::src_object_t& src,
-                 jackrec2wave_t& jackrec,
+void TASCAR::create_pink_stimulus(TASCAR::wave_t& w, float fs,
+                                  const spk_eq_param_t& par)
+{
+  // same frozen noise as generated by the 'pink' plugin:
+  TASCAR::fft_t fft(w.n);
+  std::mt19937 gen(1);
+  std::uniform_real_distribution<double> dis(0.0, TASCAR_2PI);
+  std::uniform_real_distribution<double> disx(-1.0, 1.0);
+  for(uint32_t kf = 0; kf < fft.s.n_; ++kf) {
+    double f((double)kf * fs / (double)w.n);
+    if((f >= par.fmin) && (f <= par.fmax))
+      fft.s.b[kf] = (float)(1.0 / sqrt(f)) *
+                    std::exp(std::complex<float>(0.0f, (float)dis(gen)));
+    else
+      fft.s.b[kf] = 0.0f;
+    // skip random numbers used for directional channels:
+    disx(gen);
+    disx(gen);
+    disx(gen);
+  }
+  fft.ifft();
+  w.copy(fft.w);
+  float rms(w.rms());
+  if(rms > 0.0f)
+    w *= TASCAR::dbspl2lin(par.reflevel) / rms;
+}
+
+void TASCAR::circular_convolve(TASCAR::wave_t& x, const TASCAR::wave_t& ir)
+{
+  if(!x.n)
+    return;
+  TASCAR::wave_t irp(x.n);
+  for(uint32_t k = 0; k < ir.n; ++k)
+    irp.d[k % x.n] += ir.d[k];
+  TASCAR::fft_t fft_x(x.n);
+  TASCAR::fft_t fft_ir(x.n);
+  fft_x.execute(x);
+  fft_ir.execute(irp);
+  fft_x.s *= fft_ir.s;
+  fft_x.ifft();
+  x.copy(fft_x.w);
+}
+
+// exponential sweep, extending one octave beyond frequency range of
+// interest; return rate constant L of the sweep in seconds:
+static double sweep_rate(uint32_t n, float fs, float fmin, float fmax)
+{
+  double f1(0.5 * fmin);
+  double f2(std::min(2.0 * fmax, 0.45 * fs));
+  return ((double)n / fs) / log(f2 / f1);
+}
+
+multisweep_t::multisweep_t(uint32_t channels, float fs, float fmin, float fmax,
+                           float duration, float irlen)
+    : channels_(channels), irlen_(std::max(1u, (uint32_t)(irlen * fs))),
+      // the harmonic of order k appears L*log(k) before the linear
+      // response:
+      guard_((uint32_t)ceil(
+          sweep_rate(std::max(2u, (uint32_t)(duration * fs)), fs, fmin,
+                     fmax) *
+          log((double)max_harmonic) * fs)),
+      len(std::max(2u, (uint32_t)(duration * fs)) +
+          channels * (irlen_ + guard_)),
+      sweep(std::max(2u, (uint32_t)(duration * fs))), inverse(len / 2u + 1u)
+{
+  double f1(0.5 * fmin);
+  double L(sweep_rate(sweep.n, fs, fmin, fmax));
+  uint32_t nfade(std::min(sweep.n / 4u, (uint32_t)(0.01 * fs)));
+  for(uint32_t k = 0; k < sweep.n; ++k) {
+    double t((double)k / fs);
+    double v(sin(TASCAR_2PI * f1 * L * (exp(t / L) - 1.0)));
+    if(k < nfade)
+      v *= 0.5 - 0.5 * cos(TASCAR_PI * (double)k / (double)nfade);
+    if(sweep.n - k <= nfade)
+      v *= 0.5 - 0.5 * cos(TASCAR_PI * (double)(sweep.n - k - 1u) /
+                                (double)nfade);
+    sweep.d[k] = (float)v;
+  }
+  // regularized inverse of sweep spectrum:
+  TASCAR::wave_t tmp(len);
+  for(uint32_t k = 0; k < sweep.n; ++k)
+    tmp.d[k] = sweep.d[k];
+  TASCAR::fft_t fft(len);
+  fft.execute(tmp);
+  float pmax(0.0f);
+  for(uint32_t k = 0; k < fft.s.n_; ++k)
+    pmax = std::max(pmax, std::norm(fft.s.b[k]));
+  for(uint32_t k = 0; k < fft.s.n_; ++k)
+    inverse.b[k] =
+        std::conj(fft.s.b[k]) / (std::norm(fft.s.b[k]) + 1e-4f * pmax);
+}
+
+void multisweep_t::get_stimulus(std::vector<TASCAR::wave_t>& stim,
+                                float gain) const
+{
+  stim.clear();
+  for(uint32_t ch = 0; ch < channels_; ++ch) {
+    stim.emplace_back(len);
+    for(uint32_t k = 0; k < sweep.n; ++k)
+      stim.back().d[k + ch * (irlen_ + guard_)] = gain * sweep.d[k];
+  }
+}
+
+void multisweep_t::get_irs(const TASCAR::wave_t& rec, float gain,
+                           std::vector<TASCAR::wave_t>& irs) const
+{
+  TASCAR::wave_t tmp(len);
+  for(uint32_t k = 0; k < std::min(len, rec.n); ++k)
+    tmp.d[k] = rec.d[k];
+  TASCAR::fft_t fft(len);
+  fft.execute(tmp);
+  fft.s *= inverse;
+  fft.ifft();
+  if(gain != 0.0f)
+    fft.w *= 1.0f / gain;
+  irs.clear();
+  for(uint32_t ch = 0; ch < channels_; ++ch) {
+    irs.emplace_back(irlen_);
+    for(uint32_t k = 0; k < irlen_; ++k)
+      irs.back().d[k] = fft.w.d[k + ch * (irlen_ + guard_)];
+  }
+}
+
+/**
+ * @brief Base class for measurement of speaker responses.
+ */
+class spk_recorder_t {
+public:
+  virtual ~spk_recorder_t(){};
+  /**
+   * @brief Prepare one measurement pass of all speakers.
+   */
+  virtual void prepare(spk_array_t&){};
+  /**
+   * @brief Record the response of one speaker to the pink stimulus.
+   */
+  virtual void record(size_t k, const spk_descriptor_t& spk,
+                      const std::vector<TASCAR::wave_t>& recbuf) = 0;
+  /**
+   * @brief True if the coherence between recording and test signal
+   * is meaningful.
+   */
+  virtual bool has_coherence() const { return true; };
+};
+
+/**
+ * @brief Sequential measurement: the pink noise source is moved to
+ * each speaker position, one speaker after the other.
+ */
+class spk_recorder_seq_t : public spk_recorder_t {
+public:
+  spk_recorder_seq_t(TASCAR::Scene::src_object_t& src, jackrec2wave_t& jackrec,
+                     const std::vector<std::string>& ports,
+                     const spk_eq_param_t& calibpar)
+      : src(src), jackrec(jackrec), ports(ports), calibpar(calibpar){};
+  void record(size_t, const spk_descriptor_t& spk,
+              const std::vector<TASCAR::wave_t>& recbuf)
+  {
+    // move source to speaker position:
+    src.dlocation = spk.unitvector;
+    usleep((unsigned int)(1e6f * calibpar.prewait));
+    // record measurement signal:
+    jackrec.rec(recbuf, ports);
+  };
+
+private:
+  TASCAR::Scene::src_object_t& src;
+  jackrec2wave_t& jackrec;
+  const std::vector<std::string>& ports;
+  const spk_eq_param_t& calibpar;
+};
+
+/**
+ * @brief Simultaneous measurement: all speakers are excited at once
+ * by interleaved sweeps, one source per speaker.
+ *
+ * The responses to the pink stimulus are then synthesized from the
+ * separated impulse responses.
+ */
+class spk_recorder_sim_t : public spk_recorder_t {
+public:
+  spk_recorder_sim_t(const std::vector<std::string>& srcports,
+                     const std::vector<std::string>& micports, float fs,
+                     const spk_eq_param_t& calibpar, float irlen)
+      : srcports(srcports), micports(micports), fs(fs), calibpar(calibpar),
+        sweep(srcports.size(), fs, calibpar.fmin, calibpar.fmax,
+              calibpar.duration, irlen)
+  {
+    // peak level of sweep equals RMS of pink stimulus +3 dB:
+    gain = TASCAR::dbspl2lin(calibpar.reflevel) * sqrtf(2.0f);
+  };
+  void prepare(spk_array_t& spks)
+  {
+    std::vector<TASCAR::wave_t> stim;
+    sweep.get_stimulus(stim, gain);
+    // excite only speakers which need calibration:
+    for(size_t k = 0; k < std::min(stim.size(), spks.size()); ++k)
+      if(!spks[k].calibrate)
+        stim[k].clear();
+    std::vector<TASCAR::wave_t> rec;
+    for(size_t k = 0; k < micports.size(); ++k)
+      rec.emplace_back(sweep.get_length());
+    std::vector<std::string> ports(srcports);
+    ports.insert(ports.end(), micports.begin(), micports.end());
+    usleep((unsigned int)(1e6f * calibpar.prewait));
+    {
+      jackio_t jio(stim, rec, ports, "spkcalibsweep");
+      jio.run();
+    }
+    irs.clear();
+    for(const auto& r : rec) {
+      std::vector<TASCAR::wave_t> micirs;
+      sweep.get_irs(r, gain, micirs);
+      irs.push_back(micirs);
+    }
+  };
+  void record(size_t k, const spk_descriptor_t&,
+              const std::vector<TASCAR::wave_t>& recbuf)
+  {
+    // the recording buffers are filled in place, like in
+    // jackrec2wave_t::rec:
+    TASCAR::wave_t pink(recbuf.back().n);
+    create_pink_stimulus(pink, fs, calibpar);
+    for(size_t ch = 0; ch < std::min(irs.size(), recbuf.size() - 1u); ++ch) {
+      TASCAR::wave_t resp(pink);
+      if(k < irs[ch].size())
+        circular_convolve(resp, irs[ch][k]);
+      resp.copy_to(recbuf[ch].d, recbuf[ch].n);
+    }
+    pink.copy_to(recbuf.back().d, recbuf.back().n);
+  };
+  // the synthesized responses are linear filtered copies of the test
+  // signal, their coherence is always one:
+  bool has_coherence() const { return false; };
+
+private:
+  std::vector<std::string> srcports;
+  std::vector<std::string> micports;
+  float fs;
+  const spk_eq_param_t& calibpar;
+  multisweep_t sweep;
+  float gain = 1.0f;
+  // impulse responses, one vector of speakers for each microphone:
+  std::vector<std::vector<TASCAR::wave_t>> irs;
+};
+
+void get_levels_(spk_array_t& spks, spk_recorder_t& recorder, float fs,
                  const std::vector<TASCAR::wave_t>& recbuf,
                  const std::vector<float>& miccalib,
-                 const std::vector<std::string>& ports,
                  levelmeter::weight_t weight, const spk_eq_param_t& calibpar,
                  std::vector<float>& levels,
                  std::vector<spkeq_report_t>& reports,
@@ -642,31 +902,33 @@ void get_levels_(spk_array_t& spks, TASCAR::Scene::src_object_t& src,
   if(miccalib.size() + 1 != recbuf.size())
     throw TASCAR::ErrMsg(std::string("Programming error ") + __FILE__ + ":" +
                          std::to_string(__LINE__));
-  // measure levels of all broadband speakers:
-  size_t c = 0u;
-  for(auto& spk : spks) {
-    ++c;
-    spkeq_report_t report;
-    if(spk.calibrate && (calibpar.max_eqstages > 0u)) {
-      // deactivate frequency correction:
-      spk.eqstages = 0u;
-      // move source to speaker position:
-      get_speaker_equalization(spk, src, jackrec, recbuf, miccalib, ports,
-                               weight, calibpar, levels_tmp, vF, vG,
-                               report.level_db_re_fs, vcoh);
+  std::vector<spkeq_report_t> spkreports(spks.size());
+  // measure frequency response and design equalization filters of
+  // all broadband speakers:
+  if(calibpar.max_eqstages > 0u) {
+    // deactivate frequency correction:
+    for(auto& spk : spks)
+      if(spk.calibrate)
+        spk.eqstages = 0u;
+    recorder.prepare(spks);
+    for(size_t k = 0; k < spks.size(); ++k) {
+      auto& spk = spks[k];
+      if(!spk.calibrate)
+        continue;
+      spkeq_report_t& report(spkreports[k]);
+      recorder.record(k, spk, recbuf);
+      analyse_speaker_recording(recbuf, miccalib, weight, calibpar, fs,
+                                levels_tmp, vF, vG, report.level_db_re_fs,
+                                recorder.has_coherence() ? vcoh : NULL);
       report.vF = vF;
       report.vG_precalib = vG;
       for(auto& g : report.vG_precalib)
         g *= -1.0f;
-      // auto med = getmedian(report.vG_precalib);
-      // for(auto& g : report.vG_precalib)
-      //  g -= med;
       uint32_t numflt =
           std::min(((uint32_t)vF.size() - 1u) / 3u, calibpar.max_eqstages);
       float maxq = std::max(1.0f, (float)vF.size()) /
                    log2f(calibpar.fmax / calibpar.fmin);
-      spk.eq.optim_response((size_t)numflt, maxq, vF, vG,
-                            (float)jackrec.get_srate(), 2000u);
+      spk.eq.optim_response((size_t)numflt, maxq, vF, vG, fs, 2000u);
       report.eq_f = spk.eq.get_f();
       report.eq_g = spk.eq.get_g();
       report.eq_q = spk.eq.get_q();
@@ -674,34 +936,30 @@ void get_levels_(spk_array_t& spks, TASCAR::Scene::src_object_t& src,
       spk.eqgain = vG;
       spk.eqstages = numflt;
     }
+  }
+  // measure levels of all broadband speakers:
+  recorder.prepare(spks);
+  for(size_t k = 0; k < spks.size(); ++k) {
+    auto& spk = spks[k];
+    spkeq_report_t& report(spkreports[k]);
     if(spk.calibrate) {
-      get_speaker_equalization(spk, src, jackrec, recbuf, miccalib, ports,
-                               weight, calibpar, levels, vF, vG,
-                               report.level_db_re_fs, &report.coh);
+      recorder.record(k, spk, recbuf);
+      analyse_speaker_recording(
+          recbuf, miccalib, weight, calibpar, fs, levels, vF, vG,
+          report.level_db_re_fs,
+          recorder.has_coherence() ? &report.coh : NULL);
     }
     report.label = calibpar.issub ? "sub" : "spk";
-    report.label += std::to_string(c);
+    report.label += std::to_string(k + 1);
     if(spk.label.size())
       report.label += " " + spk.label;
-    // report.label += " " + TASCAR::to_string(levels.back()) + " dB";
     report.vF = vF;
     report.vG_postcalib = vG;
     for(auto& g : report.vG_postcalib)
       g *= -1.0f;
-    // auto med = getmedian(report.vG_postcalib);
-    // for(auto& g : report.vG_postcalib)
-    //  g -= med;
-    // auto vl_min = vG.back();
-    // auto vl_max = vG.back();
-    // for(const auto& l : vG) {
-    //  vl_min = std::min(vl_min, l);
-    //  vl_max = std::max(vl_max, l);
-    //}
-    // levelrange.push_back(vl_max - vl_min);
     if(spk.calibrate)
       reports.push_back(report);
   }
-  // return reports;
 }
 
 void calibsession_t::get_levels()
@@ -714,15 +972,32 @@ void calibsession_t::get_levels()
   allports.push_back("render.calib:ref.0");
   // mute subwoofer source:
   scenes.back()->source_objects[1]->set_mute(true);
-  // unmute broadband source:
-  scenes.back()->source_objects[0]->set_mute(false);
   // unmute the NSP receiver:
   rec_spec->set_mute(true);
   rec_nsp->set_mute(false);
   spk_nsp->spkpos.set_enable_subs(false);
-  get_levels_(spk_nsp->spkpos, *(scenes.back()->source_objects[0]), jackrec,
-              bbrecbuf, cfg_.miccalib, allports, TASCAR::levelmeter::C,
-              cfg_.par_speaker, levels, spkeq_report);
+  if(cfg_.simultaneous) {
+    // unmute one sweep source per speaker:
+    std::vector<std::string> srcports;
+    for(size_t k = 0; k < spk_nsp->spkpos.size(); ++k) {
+      scenes.back()->source_objects[k + 2]->set_mute(false);
+      srcports.push_back("render.calib:msrc" + std::to_string(k + 1) + ".0");
+    }
+    spk_recorder_sim_t recorder(srcports, cfg_.refport,
+                                (float)jackrec.get_srate(), cfg_.par_speaker,
+                                cfg_.irlen);
+    get_levels_(spk_nsp->spkpos, recorder, (float)jackrec.get_srate(),
+                bbrecbuf, cfg_.miccalib, TASCAR::levelmeter::C,
+                cfg_.par_speaker, levels, spkeq_report);
+  } else {
+    // unmute broadband source:
+    scenes.back()->source_objects[0]->set_mute(false);
+    spk_recorder_seq_t recorder(*(scenes.back()->source_objects[0]), jackrec,
+                                allports, cfg_.par_speaker);
+    get_levels_(spk_nsp->spkpos, recorder, (float)jackrec.get_srate(),
+                bbrecbuf, cfg_.miccalib, TASCAR::levelmeter::C,
+                cfg_.par_speaker, levels, spkeq_report);
+  }
   spk_nsp->spkpos.set_enable_subs(true);
   //
   // subwoofer:
@@ -733,16 +1008,18 @@ void calibsession_t::get_levels()
     // unmute subwoofer source:
     scenes.back()->source_objects[1]->set_mute(false);
     spk_nsp->spkpos.set_enable_speaker(false);
-    get_levels_(spk_nsp->spkpos.subs, *(scenes.back()->source_objects[1]),
-                jackrec, subrecbuf, cfg_.miccalib, allports,
-                TASCAR::levelmeter::Z, cfg_.par_sub, sublevels, spkeq_report);
+    spk_recorder_seq_t recorder(*(scenes.back()->source_objects[1]), jackrec,
+                                allports, cfg_.par_sub);
+    get_levels_(spk_nsp->spkpos.subs, recorder, (float)jackrec.get_srate(),
+                subrecbuf, cfg_.miccalib, TASCAR::levelmeter::Z, cfg_.par_sub,
+                sublevels, spkeq_report);
     spk_nsp->spkpos.set_enable_speaker(true);
   }
-  // mute source and reset position:
-  for(auto src : scenes.back()->source_objects) {
+  // mute sources and reset position:
+  for(auto src : scenes.back()->source_objects)
     src->set_mute(true);
-    src->dlocation = pos_t(1, 0, 0);
-  }
+  scenes.back()->source_objects[0]->dlocation = pos_t(1, 0, 0);
+  scenes.back()->source_objects[1]->dlocation = pos_t(1, 0, 0);
   // convert levels into gains:
   lmin = levels[0];
   lmax = levels[0];
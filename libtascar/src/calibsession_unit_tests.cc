@@ -20,6 +20,7 @@
 #include <gtest/gtest.h>
 
 #include "calibsession.h"
+#include <random>
 
 TEST(calibparam, readxml)
 {
@@ -53,6 +54,186 @@ TEST(calibparam, savexml)
   ASSERT_NEAR(par2.fmin, 62.5f, 1e-9f);
 }
 
+namespace {
+
+  // simulated room impulse response of one speaker: direct sound,
+  // one strong reflection and an exponentially decaying diffuse tail
+  TASCAR::wave_t simulated_ir(uint32_t k, uint32_t len, std::mt19937& gen)
+  {
+    std::normal_distribution<float> dis(0.0f, 1.0f);
+    TASCAR::wave_t ir(len);
+    float gain(1.0f / (1.0f + 0.1f * (float)k));
+    uint32_t d(40u + 13u * k);
+    ir.d[d] = gain;
+    ir.d[d + 7u + 3u * k] = -0.5f * gain;
+    for(uint32_t t = d + 20u; t < len; ++t)
+      ir.d[t] += 0.02f * gain * expf(-(float)(t - d) / 150.0f) * dis(gen);
+    return ir;
+  }
+
+  // add linear convolution of x and ir to y
+  void add_convolution(TASCAR::wave_t& y, const TASCAR::wave_t& x,
+                       const TASCAR::wave_t& ir)
+  {
+    for(uint32_t k = 0; k < ir.n; ++k)
+      if(ir.d[k] != 0.0f)
+        for(uint32_t t = 0; t + k < y.n && t < x.n; ++t)
+          y.d[t + k] += ir.d[k] * x.d[t];
+  }
+
+  void add_noise(TASCAR::wave_t& w, float level, std::mt19937& gen)
+  {
+    std::normal_distribution<float> dis(0.0f, level);
+    for(uint32_t t = 0; t < w.n; ++t)
+      w.d[t] += dis(gen);
+  }
+
+} // namespace
+
+TEST(multisweep_t, separation)
+{
+  const float fs(16000.0f);
+  const uint32_t channels(6u);
+  TASCAR::multisweep_t sweep(channels, fs, 62.5f, 4000.0f, 1.0f, 0.1f);
+  EXPECT_EQ(1600u, sweep.get_irlen());
+  // harmonics up to 5th order appear up to L*log(5) before the linear
+  // response, L = 1s/log(7200Hz/31.25Hz):
+  EXPECT_EQ(4734u, sweep.get_guard());
+  const uint32_t stride(sweep.get_irlen() + sweep.get_guard());
+  EXPECT_EQ(16000u + channels * stride, sweep.get_length());
+  std::vector<TASCAR::wave_t> stim;
+  sweep.get_stimulus(stim, 0.5f);
+  ASSERT_EQ(channels, stim.size());
+  // each channel gets a delayed sweep:
+  for(uint32_t ch = 0; ch < channels; ++ch) {
+    EXPECT_EQ(sweep.get_length(), stim[ch].n);
+    EXPECT_EQ(0.0f, stim[ch].d[ch * stride]);
+    EXPECT_NEAR(0.5f, stim[ch].maxabs(), 1e-3f);
+  }
+  // delays and gains of separated responses:
+  TASCAR::wave_t rec(sweep.get_length());
+  for(uint32_t ch = 0; ch < channels; ++ch) {
+    TASCAR::wave_t ir(100);
+    ir.d[10u + 5u * ch] = 1.0f + 0.5f * (float)ch;
+    add_convolution(rec, stim[ch], ir);
+  }
+  std::vector<TASCAR::wave_t> irs;
+  sweep.get_irs(rec, 0.5f, irs);
+  ASSERT_EQ(channels, irs.size());
+  for(uint32_t ch = 0; ch < channels; ++ch) {
+    uint32_t idx(0u);
+    float vmax(0.0f);
+    for(uint32_t t = 0; t < irs[ch].n; ++t)
+      if(fabsf(irs[ch].d[t]) > vmax) {
+        vmax = fabsf(irs[ch].d[t]);
+        idx = t;
+      }
+    EXPECT_EQ(10u + 5u * ch, idx);
+    // peak is reduced by band limitation of sweep:
+    EXPECT_NEAR(1.0f + 0.5f * (float)ch, vmax, 0.25f * (1.0f + 0.5f * ch));
+  }
+}
+
+TEST(calibsession, simultaneous_equals_sequential)
+{
+  // compare sequential measurement with pink noise with simultaneous
+  // measurement with interleaved sweeps, in a simulated room:
+  const float fs(16000.0f);
+  const uint32_t channels(8u);
+  const float irlen(0.1f);
+  TASCAR::spk_eq_param_t par;
+  std::mt19937 gen(1);
+  std::vector<TASCAR::wave_t> rirs;
+  for(uint32_t k = 0; k < channels; ++k)
+    rirs.push_back(simulated_ir(k, (uint32_t)(0.8f * irlen * fs), gen));
+  const std::vector<float> miccalib = {1.0f};
+  TASCAR::wave_t pink((uint32_t)(par.duration * fs));
+  TASCAR::create_pink_stimulus(pink, fs, par);
+  EXPECT_NEAR(TASCAR::dbspl2lin(par.reflevel), pink.rms(), 1e-4f);
+  // sequential measurement:
+  std::vector<float> levels_seq;
+  std::vector<std::vector<float>> vG_seq;
+  for(uint32_t k = 0; k < channels; ++k) {
+    // steady state response to periodic noise:
+    TASCAR::wave_t x(2u * pink.n);
+    for(uint32_t t = 0; t < x.n; ++t)
+      x.d[t] = pink.d[t % pink.n];
+    TASCAR::wave_t y(x.n);
+    add_convolution(y, x, rirs[k]);
+    add_noise(y, 1e-4f, gen);
+    std::vector<TASCAR::wave_t> recbuf;
+    recbuf.emplace_back(pink.n);
+    recbuf.emplace_back(pink);
+    for(uint32_t t = 0; t < pink.n; ++t)
+      recbuf[0].d[t] = y.d[t + pink.n];
+    std::vector<float> vF, vG, level_fs;
+    TASCAR::analyse_speaker_recording(recbuf, miccalib, TASCAR::levelmeter::C,
+                                      par, fs, levels_seq, vF, vG, level_fs,
+                                      NULL);
+    vG_seq.push_back(vG);
+  }
+  // simultaneous measurement:
+  TASCAR::multisweep_t sweep(channels, fs, par.fmin, par.fmax, par.duration,
+                             irlen);
+  const float gain(TASCAR::dbspl2lin(par.reflevel) * sqrtf(2.0f));
+  std::vector<TASCAR::wave_t> stim;
+  sweep.get_stimulus(stim, gain);
+  TASCAR::wave_t rec(sweep.get_length());
+  for(uint32_t k = 0; k < channels; ++k)
+    add_convolution(rec, stim[k], rirs[k]);
+  add_noise(rec, 1e-4f, gen);
+  std::vector<TASCAR::wave_t> irs;
+  sweep.get_irs(rec, gain, irs);
+  ASSERT_EQ(channels, irs.size());
+  std::vector<float> levels_sim;
+  for(uint32_t k = 0; k < channels; ++k) {
+    std::vector<TASCAR::wave_t> recbuf;
+    recbuf.emplace_back(pink);
+    recbuf.emplace_back(pink);
+    TASCAR::circular_convolve(recbuf[0], irs[k]);
+    std::vector<float> vF, vG, level_fs;
+    TASCAR::analyse_speaker_recording(recbuf, miccalib, TASCAR::levelmeter::C,
+                                      par, fs, levels_sim, vF, vG, level_fs,
+                                      NULL);
+    ASSERT_EQ(vG_seq[k].size(), vG.size());
+    for(size_t b = 0; b < vG.size(); ++b)
+      EXPECT_NEAR(vG_seq[k][b], vG[b], 0.5f) << "speaker " << k << " band "
+                                             << vF[b] << " Hz";
+  }
+  ASSERT_EQ(channels, levels_seq.size());
+  ASSERT_EQ(channels, levels_sim.size());
+  for(uint32_t k = 0; k < channels; ++k)
+    EXPECT_NEAR(levels_seq[k], levels_sim[k], 0.2f) << "speaker " << k;
+}
+
+TEST(multisweep_t, harmonics)
+{
+  // harmonic distortion of the second channel must not leak into the
+  // impulse response of the first channel:
+  const float fs(16000.0f);
+  TASCAR::multisweep_t sweep(2u, fs, 62.5f, 4000.0f, 1.0f, 0.1f);
+  std::vector<TASCAR::wave_t> stim;
+  sweep.get_stimulus(stim, 0.5f);
+  ASSERT_EQ(2u, stim.size());
+  // second and third order distortion:
+  for(uint32_t t = 0; t < stim[1].n; ++t) {
+    float x(stim[1].d[t]);
+    stim[1].d[t] = x + 0.2f * x * x + 0.2f * x * x * x;
+  }
+  TASCAR::wave_t rec(sweep.get_length());
+  TASCAR::wave_t ir(100);
+  ir.d[10] = 1.0f;
+  add_convolution(rec, stim[0], ir);
+  add_convolution(rec, stim[1], ir);
+  std::vector<TASCAR::wave_t> irs;
+  sweep.get_irs(rec, 0.5f, irs);
+  ASSERT_EQ(2u, irs.size());
+  float vmax(0.0f);
+  for(uint32_t t = 100; t < irs[0].n; ++t)
+    vmax = std::max(vmax, fabsf(irs[0].d[t]));
+  EXPECT_LT(vmax, 1e-3f * irs[0].maxabs());
+}
+
 // Local Variables:
 // compile-command: "make -C ../.. unit-tests"
 // coding: utf-8-unix
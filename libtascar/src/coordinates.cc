@@ -169,6 +169,27 @@ pos_t shoebox_t::nextpoint(pos_t p)
   return prel;
 }
 
+transform_version_t::transform_version_t()
+    : tolerance(TASCAR::config("tascar.geometry.tolerance", 1e-6))
+{
+}
+
+bool transform_version_t::update(const pos_t& p, const zyx_euler_t& o)
+{
+  if(valid && (fabs(p.x - last.position.x) <= tolerance) &&
+     (fabs(p.y - last.position.y) <= tolerance) &&
+     (fabs(p.z - last.position.z) <= tolerance) &&
+     (fabs(o.z - last.orientation.z) <= tolerance) &&
+     (fabs(o.y - last.orientation.y) <= tolerance) &&
+     (fabs(o.x - last.orientation.x) <= tolerance))
+    return false;
+  last.position = p;
+  last.orientation = o;
+  valid = true;
+  ++version;
+  return true;
+}
+
 ngon_t& ngon_t::operator+=(const pos_t& p)
 {
   delta += p;
@@ -270,6 +291,7 @@ void ngon_t::update()
   for(uint32_t k = 0; k < N; ++k) {
     edge_normals_[k] = cross_prod(edges_[k].normal(), normal);
   }
+  ++version;
 }
 
 pos_t ngon_t::nearest_on_plane(const pos_t& p0) const
@@ -919,6 +919,43 @@ TEST(convhull, vertexorder)
   }
 }
 
+TEST(transform_version_t, update)
+{
+  TASCAR::transform_version_t v;
+  v.tolerance = 0.01;
+  EXPECT_EQ(0u, v.get_version());
+  TASCAR::pos_t p(1, 2, 3);
+  TASCAR::zyx_euler_t o(0.1, 0.2, 0.3);
+  EXPECT_TRUE(v.update(p, o));
+  EXPECT_EQ(1u, v.get_version());
+  EXPECT_FALSE(v.update(p, o));
+  EXPECT_EQ(1u, v.get_version());
+  // changes below tolerance accumulate:
+  p.x += 0.006;
+  EXPECT_FALSE(v.update(p, o));
+  p.x += 0.006;
+  EXPECT_TRUE(v.update(p, o));
+  EXPECT_EQ(2u, v.get_version());
+  o.y -= 0.02;
+  EXPECT_TRUE(v.update(p, o));
+  EXPECT_EQ(3u, v.get_version());
+  v.invalidate();
+  EXPECT_TRUE(v.update(p, o));
+  EXPECT_EQ(4u, v.get_version());
+  EXPECT_FALSE(v.update(p, o));
+}
+
+TEST(ngon_t, version)
+{
+  TASCAR::ngon_t ngon;
+  uint64_t v(ngon.get_version());
+  ngon.apply_rot_loc(TASCAR::pos_t(1, 0, 0), TASCAR::zyx_euler_t());
+  EXPECT_LT(v, ngon.get_version());
+  v = ngon.get_version();
+  ngon.nonrt_set_rect(2, 3);
+  EXPECT_LT(v, ngon.get_version());
+}
+
 // Local Variables:
 // compile-command: "make -C ../.. unit-tests"
 // coding: utf-8-unix
@@ -19,59 +19,119 @@
  */
 
 #include "delayline.h"
+#include "tascar_os.h"
+#include "tscconfig.h"
 #include <algorithm>
+#include <map>
 #include <math.h>
+#include <mutex>
 #include <string.h>
 
 using namespace TASCAR;
 
+namespace {
+
+  typedef std::shared_ptr<const std::vector<float>> sinc_data_t;
+
+  std::mutex& sinc_registry_mutex()
+  {
+    static std::mutex mtx;
+    return mtx;
+  }
+
+  std::map<std::pair<uint32_t, uint32_t>, sinc_data_t>& sinc_registry()
+  {
+    static std::map<std::pair<uint32_t, uint32_t>, sinc_data_t> tables;
+    return tables;
+  }
+
+  sinc_data_t get_sinc_data(uint32_t order, uint32_t oversampling)
+  {
+    std::lock_guard<std::mutex> lock(sinc_registry_mutex());
+    auto& entry(sinc_registry()[std::make_pair(order, oversampling)]);
+    if(!entry) {
+      const uint32_t N(order * oversampling + 1);
+      std::vector<float> data(N);
+      data[0] = 1.0f;
+      for(uint32_t k = 1; k < N; k++) {
+        const float x = TASCAR_PIf * k / (float)oversampling;
+        data[k] = sinf(x) / x;
+      }
+      data[N - 1] = 0.0f;
+      entry = std::make_shared<const std::vector<float>>(std::move(data));
+    }
+    return entry;
+  }
+
+} // namespace
+
 sinctable_t::sinctable_t(uint32_t order, uint32_t oversampling)
     : O(order), N0(order * oversampling), N(N0 + 1), N1(N - 1),
-      scale(oversampling), data(new float[N])
+      scale(oversampling), table(get_sinc_data(order, oversampling)),
+      data(table->data())
 {
-  data[0] = 1.0f;
-  for(uint32_t k = 1; k < N; k++) {
-    const float x = TASCAR_PIf * k / scale;
-    data[k] = sinf(x) / x;
-  }
-  data[N1] = 0.0f;
 }
 
 sinctable_t::sinctable_t(const sinctable_t& src)
     : O(src.O), N0(src.N0), N(src.N), N1(N - 1), scale(src.scale),
-      data(new float[N])
+      table(src.table), data(table->data())
 {
-  data[0] = 1.0f;
-  for(uint32_t k = 1; k < N; k++) {
-    const float x = TASCAR_PIf * k / scale;
-    data[k] = sinf(x) / x;
-  }
-  data[N1] = 0.0f;
 }
 
-sinctable_t::~sinctable_t()
+size_t sinctable_t::get_num_tables()
 {
-  delete[] data;
+  std::lock_guard<std::mutex> lock(sinc_registry_mutex());
+  return sinc_registry().size();
 }
 
+namespace {
+
+  /**
+     Request huge pages for large delay lines, if enabled in the
+     configuration. The memset of the caller then faults in the pages.
+   */
+  void use_hugepages(void* data, size_t bytes)
+  {
+    if((bytes >= 4u * 1024u * 1024u) &&
+       (TASCAR::config("tascar.rtmemory.hugepages", 0) > 0))
+      TASCAR::advise_hugepages(data, bytes);
+  }
+
+} // namespace
+
 varidelay_t::varidelay_t(uint32_t maxdelay, double fs, double c, uint32_t order,
-                         uint32_t oversampling)
-    : dline(new float[maxdelay + 1]), dmax(maxdelay + 1), dist2sample(fs / c),
-      delay2sample(fs), pos(0), sinc(order, oversampling)
+                         uint32_t oversampling, storage_t storage)
+    : dmax(maxdelay + 1), dist2sample(fs / c), delay2sample(fs), pos(0),
+      sinc(order, oversampling)
 {
-  memset(dline, 0, sizeof(float) * dmax);
+  alloc(storage);
 }
 
 varidelay_t::varidelay_t(const varidelay_t& src)
-    : dline(new float[src.dmax]), dmax(src.dmax), dist2sample(src.dist2sample),
+    : dmax(src.dmax), dist2sample(src.dist2sample),
       delay2sample(src.delay2sample), pos(0), sinc(src.sinc)
 {
-  memset(dline, 0, sizeof(float) * dmax);
+  alloc(src.get_storage());
 }
 
 varidelay_t::~varidelay_t()
 {
   delete[] dline;
+  delete[] hline;
+}
+
+void varidelay_t::alloc(storage_t storage)
+{
+  // zero is represented by all bits cleared in both formats:
+  if(storage == float16) {
+    hline = new uint16_t[dmax];
+    use_hugepages(hline, get_num_bytes());
+    memset(hline, 0, get_num_bytes());
+  } else {
+    dline = new float[dmax];
+    use_hugepages(dline, get_num_bytes());
+    memset(dline, 0, get_num_bytes());
+  }
 }
 
 void varidelay_t::add_chunk(const TASCAR::wave_t& x)
@@ -80,7 +140,27 @@ void varidelay_t::add_chunk(const TASCAR::wave_t& x)
     pos++;
     if(pos == dmax)
       pos = 0;
-    dline[pos] = x.d[k];
+    store(x.d[k]);
+  }
+}
+
+void varidelay_t::get_dist_taps(float dist, std::vector<uint32_t>& delay,
+                                std::vector<float>& weight) const
+{
+  delay.clear();
+  weight.clear();
+  if(sinc.O) {
+    float fdelay(dist2sample * dist);
+    float integerdelay(roundf(fdelay));
+    float subsampledelay(fdelay - integerdelay);
+    for(int32_t order = -sinc.O; order <= (int32_t)(sinc.O); order++) {
+      delay.push_back(std::min(
+          (uint32_t)(std::max(0, (int32_t)integerdelay + order)), dmax - 1));
+      weight.push_back(sinc((float)order - subsampledelay));
+    }
+  } else {
+    delay.push_back(std::min((uint32_t)(dist2sample * dist), dmax - 1));
+    weight.push_back(1.0f);
   }
 }
 
@@ -97,6 +97,30 @@ TEST(delayline_t, get_dist_sinc)
   ASSERT_NEAR(0, delay.get_dist(8.75), 1e-7);
 }
 
+TEST(delayline_t, get_dist_taps)
+{
+  // the response of the delay line to an impulse is the sum of the
+  // taps:
+  for(uint32_t order : {0u, 5u}) {
+    for(float dist : {0.0f, 1.3f, 7.5f, 13.75f, 40.0f}) {
+      TASCAR::varidelay_t delay(20, 2, 1, order, 64);
+      std::vector<uint32_t> tapdelay;
+      std::vector<float> tapweight;
+      delay.get_dist_taps(dist, tapdelay, tapweight);
+      ASSERT_EQ(tapdelay.size(), tapweight.size());
+      ASSERT_EQ(2u * order + 1u, tapdelay.size());
+      std::vector<float> h(30, 0.0f);
+      for(size_t k = 0; k < tapdelay.size(); ++k)
+        if(tapdelay[k] < h.size())
+          h[tapdelay[k]] += tapweight[k];
+      for(size_t k = 0; k < h.size(); ++k)
+        ASSERT_NEAR(h[k], delay.get_dist_push(dist, (k == 0) ? 1.0f : 0.0f),
+                    1e-6f)
+            << "order=" << order << " dist=" << dist << " k=" << k;
+    }
+  }
+}
+
 TEST(delayline_t, get_dist_push_overflow)
 {
   TASCAR::varidelay_t delay(3, 1, 1, 0, 1);
@@ -125,6 +149,73 @@ TEST(sinctable_t, getval_sinc)
   ASSERT_NEAR(0.63662, s(0.5), 1e-5);
 }
 
+TEST(sinctable_t, shared)
+{
+  TASCAR::sinctable_t s1(11, 37);
+  size_t ntables(TASCAR::sinctable_t::get_num_tables());
+  TASCAR::sinctable_t s2(11, 37);
+  TASCAR::sinctable_t s3(s1);
+  EXPECT_EQ(ntables, TASCAR::sinctable_t::get_num_tables());
+  for(float x = 0.0f; x < 12.0f; x += 0.1f) {
+    EXPECT_EQ(s1(x), s2(x));
+    EXPECT_EQ(s1(x), s3(x));
+  }
+  TASCAR::sinctable_t s4(11, 38);
+  EXPECT_EQ(ntables + 1u, TASCAR::sinctable_t::get_num_tables());
+}
+
+TEST(delayline_t, half2float)
+{
+  for(float x : {0.0f, 1.0f, -1.0f, 0.5f, 2048.0f, -65504.0f, 6.1035156e-5f,
+                 5.9604645e-8f})
+    EXPECT_EQ(x, TASCAR::half2float(TASCAR::float2half(x)));
+  EXPECT_EQ(65504.0f, TASCAR::half2float(TASCAR::float2half(1e6f)));
+  EXPECT_EQ(-65504.0f, TASCAR::half2float(TASCAR::float2half(-1e6f)));
+  EXPECT_EQ(0.0f, TASCAR::half2float(TASCAR::float2half(1e-9f)));
+  // rounding to nearest:
+  EXPECT_EQ(1.0f, TASCAR::half2float(TASCAR::float2half(1.0004f)));
+  EXPECT_EQ(1.0009766f, TASCAR::half2float(TASCAR::float2half(1.0006f)));
+  float maxerr(0.0f);
+  for(float x = 1e-4f; x < 60000.0f; x *= 1.001f)
+    maxerr = std::max(
+        maxerr, fabsf(TASCAR::half2float(TASCAR::float2half(x)) - x) / x);
+  EXPECT_LT(maxerr, 4.9e-4f);
+}
+
+TEST(delayline_t, half_accuracy)
+{
+  TASCAR::varidelay_t dfloat(1000, 44100, 340, 5, 64);
+  TASCAR::varidelay_t dhalf(1000, 44100, 340, 5, 64,
+                            TASCAR::varidelay_t::float16);
+  EXPECT_EQ(TASCAR::varidelay_t::float32, dfloat.get_storage());
+  EXPECT_EQ(TASCAR::varidelay_t::float16, dhalf.get_storage());
+  EXPECT_EQ(2u * dhalf.get_num_bytes(), dfloat.get_num_bytes());
+  TASCAR::varidelay_t dcopy(dhalf);
+  EXPECT_EQ(TASCAR::varidelay_t::float16, dcopy.get_storage());
+  double esum(0.0);
+  double ssum(0.0);
+  for(uint32_t k = 0; k < 20000; ++k) {
+    float x(sinf(0.0123f * k) + 0.3f * sinf(0.371f * k));
+    float dist(3.0f + 2.0f * sinf(0.0001f * k));
+    float yfloat(dfloat.get_dist_push(dist, x));
+    float yhalf(dhalf.get_dist_push(dist, x));
+    esum += (yhalf - yfloat) * (yhalf - yfloat);
+    ssum += yfloat * yfloat;
+  }
+  // signal-to-error ratio of more than 60 dB:
+  EXPECT_LT(10.0 * log10(esum / ssum), -60.0);
+}
+
+TEST(delayline_t, get_num_bytes)
+{
+  // half precision storage uses two bytes per sample:
+  TASCAR::varidelay_t line32(1000, 48000.0f, 340.0f, 0, 64);
+  EXPECT_EQ(1001u * 4u, line32.get_num_bytes());
+  TASCAR::varidelay_t line16(1000, 48000.0f, 340.0f, 0, 64,
+                             TASCAR::varidelay_t::float16);
+  EXPECT_EQ(1001u * 2u, line16.get_num_bytes());
+}
+
 TEST(staticdelay,delay)
 {
   TASCAR::static_delay_t d0(0);
@@ -0,0 +1,119 @@
+/*
+ * This file is part of the TASCAR software, see <http://tascar.org/>
+ *
+ * Copyright (c) 2026 agent
+ */
+/*
+ * TASCAR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, version 3 of the License.
+ *
+ * TASCAR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHATABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License, version 3 for more details.
+ *
+ * You should have received a copy of the GNU General Public License,
+ * Version 3 along with TASCAR. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "diskcache.h"
+#include "tscconfig.h"
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+using namespace TASCAR;
+
+diskcache_t::diskcache_t(const std::string& category, const std::string& dir)
+    : path(dir)
+{
+  if(path.empty())
+    path = TASCAR::env_expand(
+        TASCAR::config("tascar.cachedir", "${HOME}/.cache/tascar"));
+  if(!category.empty())
+    path += "/" + category;
+}
+
+// 64 bit FNV-1a hash:
+uint64_t diskcache_t::hash(const std::string& key)
+{
+  uint64_t h(14695981039346656037ull);
+  for(auto c : key) {
+    h ^= (uint8_t)c;
+    h *= 1099511628211ull;
+  }
+  return h;
+}
+
+std::string diskcache_t::get_filename(const std::string& key) const
+{
+  std::stringstream s;
+  s << path << "/" << std::hex << std::setw(16) << std::setfill('0')
+    << hash(key) << ".txt";
+  return s.str();
+}
+
+bool diskcache_t::read(const std::string& key, std::vector<float>& data) const
+{
+  std::ifstream fh(get_filename(key));
+  if(!fh.good())
+    return false;
+  std::string fkey;
+  std::getline(fh, fkey);
+  if(fkey != key)
+    return false;
+  std::vector<float> tmp;
+  float v(0.0f);
+  while(fh >> v)
+    tmp.push_back(v);
+  if(!fh.eof())
+    return false;
+  data = tmp;
+  return true;
+}
+
+void diskcache_t::write(const std::string& key,
+                        const std::vector<float>& data) const
+{
+  std::error_code ec;
+  std::filesystem::create_directories(path, ec);
+  if(ec)
+    return;
+  std::string fname(get_filename(key));
+  // write to temporary file first, then rename, to avoid incomplete
+  // entries when several processes write the same entry:
+  std::string tmpname(
+      fname + "." +
+      std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) +
+      "." +
+      std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()));
+  {
+    std::ofstream fh(tmpname);
+    if(!fh.good())
+      return;
+    fh << key << "\n" << std::setprecision(9);
+    for(auto v : data)
+      fh << v << "\n";
+    if(!fh.good()) {
+      fh.close();
+      std::filesystem::remove(tmpname, ec);
+      return;
+    }
+  }
+  std::filesystem::rename(tmpname, fname, ec);
+  if(ec)
+    std::filesystem::remove(tmpname, ec);
+}
+
+/*
+ * Local Variables:
+ * mode: c++
+ * c-basic-offset: 2
+ * indent-tabs-mode: nil
+ * compile-command: "make -C .."
+ * End:
+ */
@@ -0,0 +1,84 @@
+/*
+ * This file is part of the TASCAR software, see <http://tascar.org/>
+ *
+ * Copyright (c) 2026 agent
+ */
+/*
+ * TASCAR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, version 3 of the License.
+ *
+ * TASCAR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHATABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License, version 3 for more details.
+ *
+ * You should have received a copy of the GNU General Public License,
+ * Version 3 along with TASCAR. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "diskcache.h"
+#include <filesystem>
+#include <fstream>
+
+TEST(diskcache_t, readwrite)
+{
+  auto dir(std::filesystem::temp_directory_path() / "tascar_diskcache_test");
+  std::filesystem::remove_all(dir);
+  TASCAR::diskcache_t cache("test", dir.string());
+  EXPECT_EQ(dir.string() + "/test", cache.get_path());
+  std::vector<float> data;
+  EXPECT_FALSE(cache.read("key1", data));
+  cache.write("key1", {1.0f, 0.25f, -3.5e-6f});
+  EXPECT_TRUE(cache.read("key1", data));
+  ASSERT_EQ(3u, data.size());
+  EXPECT_EQ(1.0f, data[0]);
+  EXPECT_EQ(0.25f, data[1]);
+  EXPECT_EQ(-3.5e-6f, data[2]);
+  EXPECT_FALSE(cache.read("key2", data));
+  // overwrite entry:
+  cache.write("key1", {2.0f});
+  EXPECT_TRUE(cache.read("key1", data));
+  ASSERT_EQ(1u, data.size());
+  EXPECT_EQ(2.0f, data[0]);
+  // different keys use different files:
+  EXPECT_NE(cache.get_filename("key1"), cache.get_filename("key2"));
+  std::filesystem::remove_all(dir);
+}
+
+TEST(diskcache_t, invalid)
+{
+  auto dir(std::filesystem::temp_directory_path() / "tascar_diskcache_test");
+  std::filesystem::remove_all(dir);
+  TASCAR::diskcache_t cache("test", dir.string());
+  std::vector<float> data;
+  cache.write("key1", {1.0f});
+  // key mismatch, e.g., after hash collision:
+  {
+    std::ofstream fh(cache.get_filename("key1"));
+    fh << "otherkey\n1\n";
+  }
+  EXPECT_FALSE(cache.read("key1", data));
+  // corrupted data:
+  {
+    std::ofstream fh(cache.get_filename("key1"));
+    fh << "key1\n1\nx\n";
+  }
+  EXPECT_FALSE(cache.read("key1", data));
+  // writing to a non-writable location is not an error:
+  TASCAR::diskcache_t cache2("test", "/dev/null/nodir");
+  EXPECT_NO_THROW(cache2.write("key1", {1.0f}));
+  EXPECT_FALSE(cache2.read("key1", data));
+  std::filesystem::remove_all(dir);
+}
+
+/*
+ * Local Variables:
+ * mode: c++
+ * c-basic-offset: 2
+ * indent-tabs-mode: nil
+ * compile-command: "make -C .."
+ * End:
+ */
@@ -34,6 +34,12 @@ driver_t::driver_t() {}
 
 driver_t::~driver_t() {}
 
+void driver_t::send_partial(uint8_t universe, const std::vector<uint16_t>& data,
+                            uint32_t)
+{
+  send(universe, data);
+}
+
 OpenDMX_USB_t::OpenDMX_USB_t(const char* device) : data_(&msg[1])
 {
   msg[0] = 0;
@@ -87,12 +93,21 @@ ArtnetDMX_t::ArtnetDMX_t(const char* hostname, const char* port)
 
 void ArtnetDMX_t::send(uint8_t universe, const std::vector<uint16_t>& data)
 {
+  send_partial(universe, data, data.size());
+}
+
+void ArtnetDMX_t::send_partial(uint8_t universe,
+                               const std::vector<uint16_t>& data, uint32_t n)
+{
+  // Art-Net requires an even number of slots, between 2 and 512:
+  n = std::min((uint32_t)512u, n + (n & 1u));
+  n = std::max(2u, n);
   msg[14] = universe;
-  msg[16] = data.size() >> 8;
-  msg[17] = data.size() & 0xff;
-  for(uint32_t k = 0; k < data.size(); ++k)
-    data_[k] = data[k];
-  if(sendto(fd, msg, 18 + data.size(), 0, res->ai_addr, res->ai_addrlen) == -1)
+  msg[16] = n >> 8;
+  msg[17] = n & 0xff;
+  for(uint32_t k = 0; k < n; ++k)
+    data_[k] = (k < data.size()) ? data[k] : 0;
+  if(sendto(fd, msg, 18 + n, 0, res->ai_addr, res->ai_addrlen) == -1)
     throw TASCAR::ErrMsg(strerror(errno));
 }
 
@@ -114,6 +129,59 @@ void OSC_t::send(uint8_t, const std::vector<uint16_t>& data)
   lo_send_message(target, path_.c_str(), msg);
 }
 
+delta_sender_t::delta_sender_t(driver_t* driver_, mode_t mode_,
+                               double keepalive_)
+    : driver(driver_), mode(mode_), keepalive(keepalive_)
+{
+}
+
+delta_sender_t::mode_t delta_sender_t::get_mode(const std::string& name)
+{
+  if(name == "full")
+    return full;
+  if(name == "universe")
+    return changed_universes;
+  if(name == "slots")
+    return changed_slots;
+  throw TASCAR::ErrMsg("Invalid DMX transmission mode \"" + name +
+                       "\" (must be \"full\", \"universe\" or \"slots\").");
+}
+
+bool delta_sender_t::send(uint8_t universe, const std::vector<uint16_t>& data,
+                          double t)
+{
+  if(!driver)
+    return false;
+  if(mode == full) {
+    driver->send(universe, data);
+    ++num_sent;
+    return true;
+  }
+  universe_t& u(universes[universe]);
+  if(u.data.empty() || (u.data.size() != data.size()) ||
+     (t - u.t_sent >= keepalive)) {
+    // first transmission or keep-alive, send full universe:
+    driver->send(universe, data);
+  } else {
+    // find last changed slot:
+    size_t n(data.size());
+    while((n > 0) && (data[n - 1] == u.data[n - 1]))
+      --n;
+    if(n == 0) {
+      ++num_skipped;
+      return false;
+    }
+    if(mode == changed_slots)
+      driver->send_partial(universe, data, n);
+    else
+      driver->send(universe, data);
+  }
+  u.data = data;
+  u.t_sent = t;
+  ++num_sent;
+  return true;
+}
+
 /*
  * Local Variables:
  * mode: c++
@@ -0,0 +1,136 @@
+/*
+ * This file is part of the TASCAR software, see <http://tascar.org/>
+ *
+ * Copyright (c) 2026 agent
+ */
+/*
+ * TASCAR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, version 3 of the License.
+ *
+ * TASCAR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHATABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License, version 3 for more details.
+ *
+ * You should have received a copy of the GNU General Public License,
+ * Version 3 along with TASCAR. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <gtest/gtest.h>
+
+// DMX drivers are not available on Windows:
+#ifndef _WIN32
+
+#include "dmxdriver.h"
+#include "errorhandling.h"
+
+namespace {
+
+  /// DMX driver which counts the transmitted slots
+  class mock_driver_t : public DMX::driver_t {
+  public:
+    mock_driver_t(bool partial_) : partial(partial_) {}
+    void send(uint8_t universe, const std::vector<uint16_t>& data)
+    {
+      ++frames[universe];
+      bytes += data.size();
+    }
+    void send_partial(uint8_t universe, const std::vector<uint16_t>& data,
+                      uint32_t n)
+    {
+      if(!partial) {
+        DMX::driver_t::send_partial(universe, data, n);
+        return;
+      }
+      ++frames[universe];
+      bytes += n;
+    }
+    bool partial;
+    std::map<uint8_t, size_t> frames;
+    size_t bytes = 0u;
+  };
+
+} // namespace
+
+TEST(delta_sender_t, full)
+{
+  mock_driver_t driver(true);
+  DMX::delta_sender_t sender(&driver, DMX::delta_sender_t::full, 1.0);
+  std::vector<uint16_t> data(512, 0);
+  for(uint32_t k = 0; k < 10; ++k)
+    EXPECT_TRUE(sender.send(0, data, k / 30.0));
+  EXPECT_EQ(10u, driver.frames[0]);
+  EXPECT_EQ(5120u, driver.bytes);
+}
+
+TEST(delta_sender_t, changed_universes)
+{
+  mock_driver_t driver(true);
+  DMX::delta_sender_t sender(&driver, DMX::delta_sender_t::changed_universes,
+                             1.0);
+  std::vector<uint16_t> data(512, 0);
+  // static data at 30 fps, keep-alive after one second:
+  for(uint32_t k = 0; k < 100; ++k)
+    sender.send(0, data, k / 30.0);
+  EXPECT_EQ(4u, driver.frames[0]);
+  EXPECT_EQ(96u, sender.get_num_skipped());
+  // a change is sent once:
+  data[100] = 255;
+  EXPECT_TRUE(sender.send(0, data, 100 / 30.0));
+  EXPECT_FALSE(sender.send(0, data, 101 / 30.0));
+  EXPECT_EQ(5u, driver.frames[0]);
+  EXPECT_EQ(5u * 512u, driver.bytes);
+  // universes are independent:
+  EXPECT_TRUE(sender.send(1, data, 102 / 30.0));
+  EXPECT_FALSE(sender.send(1, data, 103 / 30.0));
+  EXPECT_EQ(1u, driver.frames[1]);
+}
+
+TEST(delta_sender_t, changed_slots)
+{
+  mock_driver_t driver(true);
+  DMX::delta_sender_t sender(&driver, DMX::delta_sender_t::changed_slots, 1.0);
+  std::vector<uint16_t> data(512, 0);
+  EXPECT_TRUE(sender.send(0, data, 0.0));
+  EXPECT_EQ(512u, driver.bytes);
+  // only slots up to the last changed slot are sent:
+  data[3] = 10;
+  data[10] = 20;
+  EXPECT_TRUE(sender.send(0, data, 0.1));
+  EXPECT_EQ(512u + 11u, driver.bytes);
+  EXPECT_FALSE(sender.send(0, data, 0.2));
+  // keep-alive sends the full universe:
+  EXPECT_TRUE(sender.send(0, data, 1.1));
+  EXPECT_EQ(2u * 512u + 11u, driver.bytes);
+  // drivers without partial transmission send full universes:
+  mock_driver_t fulldriver(false);
+  DMX::delta_sender_t sender2(&fulldriver, DMX::delta_sender_t::changed_slots,
+                              1.0);
+  sender2.send(0, data, 0.0);
+  data[0] = 1;
+  sender2.send(0, data, 0.1);
+  EXPECT_EQ(2u * 512u, fulldriver.bytes);
+}
+
+TEST(delta_sender_t, get_mode)
+{
+  EXPECT_EQ(DMX::delta_sender_t::full, DMX::delta_sender_t::get_mode("full"));
+  EXPECT_EQ(DMX::delta_sender_t::changed_universes,
+            DMX::delta_sender_t::get_mode("universe"));
+  EXPECT_EQ(DMX::delta_sender_t::changed_slots,
+            DMX::delta_sender_t::get_mode("slots"));
+  EXPECT_THROW(DMX::delta_sender_t::get_mode("delta"), TASCAR::ErrMsg);
+}
+
+#endif
+
+/*
+ * Local Variables:
+ * mode: c++
+ * c-basic-offset: 2
+ * indent-tabs-mode: nil
+ * compile-command: "make -C .."
+ * End:
+ */
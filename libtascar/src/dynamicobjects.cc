@@ -208,6 +208,7 @@ void TASCAR::dynobject_t::geometry_update(double time)
     c6dof_.position += oparent->c6dof.position;
     c6dof_.orientation += oparent->c6dof.orientation;
   }
+  transform_version.update(c6dof_.position, c6dof_.orientation);
 }
 
 TASCAR::pos_t TASCAR::dynobject_t::get_location() const
@@ -356,10 +357,19 @@ void track_t::shift_time(double dt)
 
 pos_t track_t::interp(double x) const
 {
-  if(begin() == end())
-    return pos_t();
   if((loop > 0) && (x >= loop))
     x = fmod(x, loop);
+  if(binary) {
+    size_t k(0);
+    double w(0);
+    if(!binary->find(x, k, w))
+      return pos_t();
+    if(w == 0)
+      return binary->get_position(k);
+    return interp(binary->get_position(k), binary->get_position(k + 1), w);
+  }
+  if(begin() == end())
+    return pos_t();
   const_iterator lim2 = lower_bound(x);
   if(lim2 == end())
     return rbegin()->second;
@@ -369,28 +379,31 @@ pos_t track_t::interp(double x) const
     return lim2->second;
   const_iterator lim1 = lim2;
   --lim1;
+  double w = (x - lim1->first) / (lim2->first - lim1->first);
+  make_friendly_number(w);
+  return interp(lim1->second, lim2->second, w);
+}
+
+pos_t track_t::interp(const pos_t& p1, const pos_t& p2, double w) const
+{
   if(interpt == track_t::cartesian) {
     // cartesian interpolation:
-    pos_t p1(lim1->second);
-    pos_t p2(lim2->second);
-    double w = (x - lim1->first) / (lim2->first - lim1->first);
-    make_friendly_number(w);
-    p1 *= (1.0 - w);
-    p2 *= w;
-    p1 += p2;
-    return p1;
+    pos_t r1(p1);
+    pos_t r2(p2);
+    r1 *= (1.0 - w);
+    r2 *= w;
+    r1 += r2;
+    return r1;
   } else {
     // spherical interpolation:
-    sphere_t p1(lim1->second);
-    sphere_t p2(lim2->second);
-    double w = (x - lim1->first) / (lim2->first - lim1->first);
-    make_friendly_number(w);
-    p1 *= (1.0 - w);
-    p2 *= w;
-    p1.r += p2.r;
-    p1.az += p2.az;
-    p1.el += p2.el;
-    return p1.cart();
+    sphere_t r1(p1);
+    sphere_t r2(p2);
+    r1 *= (1.0 - w);
+    r2 *= w;
+    r1.r += r2.r;
+    r1.az += r2.az;
+    r1.el += r2.el;
+    return r1.cart();
   }
 }
 
@@ -502,6 +515,19 @@ void track_t::load_from_csv(const std::string& fname)
   prepare();
 }
 
+void track_t::load_from_binary(const std::string& fname, double t_begin,
+                               double t_end)
+{
+  auto bin(std::make_shared<binary_track_t>(TASCAR::env_expand(fname),
+                                            t_begin, t_end));
+  if(bin->get_content() != binary_track_t::position)
+    throw TASCAR::ErrMsg("The binary track file \"" + fname +
+                         "\" does not contain positions.");
+  clear();
+  binary = bin;
+  prepare();
+}
+
 void track_t::edit(tsccfg::node_t cmd)
 {
   if(cmd) {
@@ -717,6 +743,29 @@ double track_t::length()
   return l;
 }
 
+std::vector<TASCAR::pos_t> track_t::get_decimated(double tol) const
+{
+  std::vector<TASCAR::pos_t> r;
+  if(!size())
+    return r;
+  r.push_back(begin()->second);
+  const double tol2(tol * tol);
+  for(const_iterator i = std::next(begin()); i != end(); ++i) {
+    TASCAR::pos_t d(i->second);
+    d -= r.back();
+    if(d.norm2() >= tol2)
+      r.push_back(i->second);
+  }
+  if(size() > 1) {
+    // always keep the last point:
+    if(r.size() == 1)
+      r.push_back(rbegin()->second);
+    else
+      r.back() = rbegin()->second;
+  }
+  return r;
+}
+
 track_t::track_t() : loop(0), interpt(cartesian) {}
 
 double track_t::get_dist(double time) const
@@ -794,6 +843,15 @@ void track_t::read_xml(tsccfg::node_t a)
     }
     fh.close();
   }
+  std::string importbin;
+  te.GET_ATTRIBUTE(importbin, "",
+                   "Read position track from a memory-mapped binary file, "
+                   "created with {\\tt tascar\\_track2bin}. The binary track "
+                   "replaces all other track points.");
+  std::vector<double> timerange;
+  te.GET_ATTRIBUTE(timerange, "s",
+                   "Time range of binary track to be used, or empty to use "
+                   "the whole file.");
   std::stringstream ptxt1(tsccfg::node_get_text(a, ""));
   while(!ptxt1.eof()) {
     std::string meshline;
@@ -824,6 +882,14 @@ void track_t::read_xml(tsccfg::node_t a)
                             meshline);
     }
   }
+  if(!importbin.empty()) {
+    if(timerange.size() == 2)
+      ntrack.load_from_binary(importbin, timerange[0], timerange[1]);
+    else if(timerange.empty())
+      ntrack.load_from_binary(importbin);
+    else
+      throw TASCAR::ErrMsg("The time range of binary tracks needs two values.");
+  }
   *this = ntrack;
 }
 
@@ -847,11 +913,25 @@ euler_track_t::euler_track_t() : loop(0) {}
 
 zyx_euler_t euler_track_t::interp(double x) const
 {
+  if((loop > 0) && (x >= loop))
+    x = fmod(x, loop);
+  if(binary) {
+    size_t k(0);
+    double w(0);
+    if(!binary->find(x, k, w))
+      return zyx_euler_t();
+    zyx_euler_t p1(binary->get_orientation(k));
+    if(w == 0)
+      return p1;
+    zyx_euler_t p2(binary->get_orientation(k + 1));
+    p1 *= (1.0 - w);
+    p2 *= w;
+    p1 += p2;
+    return p1;
+  }
   if(begin() == end()) {
     return zyx_euler_t();
   }
-  if((loop > 0) && (x >= loop))
-    x = fmod(x, loop);
   const_iterator lim2 = lower_bound(x);
   if(lim2 == end())
     return rbegin()->second;
@@ -871,6 +951,18 @@ zyx_euler_t euler_track_t::interp(double x) const
   return p1;
 }
 
+void euler_track_t::load_from_binary(const std::string& fname, double t_begin,
+                                     double t_end)
+{
+  auto bin(std::make_shared<binary_track_t>(TASCAR::env_expand(fname),
+                                            t_begin, t_end));
+  if(bin->get_content() != binary_track_t::orientation)
+    throw TASCAR::ErrMsg("The binary track file \"" + fname +
+                         "\" does not contain orientations.");
+  clear();
+  binary = bin;
+}
+
 void euler_track_t::write_xml(tsccfg::node_t a)
 {
   tsccfg::node_set_text(a, print(" "));
@@ -906,6 +998,9 @@ void euler_track_t::read_xml(tsccfg::node_t a)
     }
     fh.close();
   }
+  std::string importbin(tsccfg::node_get_attribute_value(a, "importbin"));
+  std::vector<double> timerange;
+  get_attribute_value(a, "timerange", timerange);
   std::stringstream ptxt1(tsccfg::node_get_text(a, ""));
   while(!ptxt1.eof()) {
     std::string meshline;
@@ -937,6 +1032,14 @@ void euler_track_t::read_xml(tsccfg::node_t a)
                             meshline);
     }
   }
+  if(!importbin.empty()) {
+    if(timerange.size() == 2)
+      ntrack.load_from_binary(importbin, timerange[0], timerange[1]);
+    else if(timerange.empty())
+      ntrack.load_from_binary(importbin);
+    else
+      throw TASCAR::ErrMsg("The time range of binary tracks needs two values.");
+  }
   *this = ntrack;
 }
 
@@ -0,0 +1,61 @@
+/*
+ * This file is part of the TASCAR software, see <http://tascar.org/>
+ *
+ * Copyright (c) 2026 agent
+ */
+/*
+ * TASCAR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, version 3 of the License.
+ *
+ * TASCAR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHATABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License, version 3 for more details.
+ *
+ * You should have received a copy of the GNU General Public License,
+ * Version 3 along with TASCAR. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "dynamicobjects.h"
+
+TEST(track_t, get_decimated)
+{
+  TASCAR::track_t track;
+  EXPECT_EQ(0u, track.get_decimated(0.1).size());
+  track[0.0] = TASCAR::pos_t(1, 2, 3);
+  EXPECT_EQ(1u, track.get_decimated(0.1).size());
+  // circle with radius 10 m, sampled every 2 mm:
+  const uint32_t N(31416);
+  for(uint32_t k = 0; k < N; ++k) {
+    double a(TASCAR_2PI * k / N);
+    track[k] = TASCAR::pos_t(10.0 * cos(a), 10.0 * sin(a), 0.001 * k);
+  }
+  EXPECT_EQ(N, track.get_decimated(0.0).size());
+  const double tol(0.1);
+  std::vector<TASCAR::pos_t> dec(track.get_decimated(tol));
+  EXPECT_LT(dec.size(), N / 40u);
+  EXPECT_GT(dec.size(), N / 60u);
+  EXPECT_TRUE(track.begin()->second == dec.front());
+  EXPECT_TRUE(track.rbegin()->second == dec.back());
+  // all points of the track are close to a point of the decimated
+  // polyline:
+  size_t kdec(0);
+  for(auto& p : track) {
+    while((kdec + 1 < dec.size()) && (distance(p.second, dec[kdec + 1]) <
+                                      distance(p.second, dec[kdec])))
+      ++kdec;
+    EXPECT_LE(distance(p.second, dec[kdec]), 2.0 * tol);
+  }
+}
+
+/*
+ * Local Variables:
+ * mode: c++
+ * c-basic-offset: 2
+ * indent-tabs-mode: nil
+ * compile-command: "make -C .."
+ * End:
+ */
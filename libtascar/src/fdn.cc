@@ -238,6 +238,65 @@ void fdn_t::set_scatterpar(float daz, float t_min, float t_max, float t60,
   }
 }
 
+float fdn_t::get_t60_estimate(float f, float fs) const
+{
+  if(fdnpath.empty() || (fs <= 0.0f))
+    return -1.0f;
+  float w(TASCAR_2PIf * f / fs);
+  // level change in dB and delay, summed across all paths:
+  float level(0.0f);
+  float delay(0.0f);
+  for(const auto& path : fdnpath) {
+    level += 20.0f * log10f(std::max(1e-10f, path.reflection.get_gain(w)));
+    delay += (float)path.delay;
+  }
+  if((level >= 0.0f) || (delay <= 0.0f))
+    return -1.0f;
+  return -60.0f * delay / (level * fs);
+}
+
+float fdn_t::get_t60_estimate(float f, float fs, float bw) const
+{
+  if(bw <= 0.0f)
+    return get_t60_estimate(f, fs);
+  // energy decay time constants of frequency components in band:
+  const uint32_t nbins(16);
+  std::vector<double> tau;
+  for(uint32_t k = 0; k < nbins; ++k) {
+    float fk(f * powf(2.0f, bw * (((float)k + 0.5f) / (float)nbins - 0.5f)));
+    float t60k(get_t60_estimate(fk, fs));
+    if(t60k <= 0.0f)
+      return -1.0f;
+    tau.push_back(t60k / (6.0 * log(10.0)));
+  }
+  // energy decay curve, assuming equal energy of components:
+  auto edc = [&tau](double t) {
+    double e(0.0);
+    for(auto tk : tau)
+      e += tk * exp(-t / tk);
+    return e;
+  };
+  // time at which the energy decay curve is l dB below its start:
+  double e0(edc(0.0));
+  double tmax(20.0 * tau.back());
+  for(auto tk : tau)
+    tmax = std::max(tmax, 20.0 * tk);
+  auto get_time = [&edc, e0, tmax](double l) {
+    double e(e0 * pow(10.0, -0.1 * l));
+    double t1(0.0);
+    double t2(tmax);
+    for(uint32_t k = 0; k < 40; ++k) {
+      double t((t1 + t2) * 0.5);
+      if(edc(t) > e)
+        t1 = t;
+      else
+        t2 = t;
+    }
+    return 0.5 * (t1 + t2);
+  };
+  return (float)(3.0 * (get_time(30.0) - get_time(10.0)));
+}
+
 reflectionfilter_t::reflectionfilter_t()
 {
   sy.set_zero();
@@ -262,6 +321,11 @@ void reflectionfilter_t::set_lp(float g, float c)
   A2 = -c;
 }
 
+float reflectionfilter_t::get_gain(float w) const
+{
+  return fabsf(B1) / std::abs(1.0f + A2 * std::exp(-i_f * w));
+}
+
 /*
  * Local Variables:
  * mode: c++
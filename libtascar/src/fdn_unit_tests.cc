@@ -0,0 +1,115 @@
+/*
+ * This file is part of the TASCAR software, see <http://tascar.org/>
+ *
+ * Copyright (c) 2026 agent
+ */
+/*
+ * TASCAR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, version 3 of the License.
+ *
+ * TASCAR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHATABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License, version 3 for more details.
+ *
+ * You should have received a copy of the GNU General Public License,
+ * Version 3 along with TASCAR. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "fdn.h"
+#include "filterclass.h"
+
+using namespace TASCAR;
+
+namespace {
+
+  const float fs = 16000.0f;
+
+  /**
+     Measure T60 in octave band around f from Schroeder integral,
+     range -10 dB to -30 dB.
+   */
+  float measure_t60(fdn_t& fdn, float f, uint32_t len)
+  {
+    std::vector<fdnpath_t> src(fdn.fdnpath.size());
+    TASCAR::wave_t ir(len);
+    fdn.set_zero();
+    for(uint32_t k = 0; k < len; ++k) {
+      for(auto& path : src)
+        path.dlout.set_zero();
+      if(k == 0)
+        for(auto& path : src)
+          path.dlout.w = 1.0f;
+      fdn.process(src);
+      ir.d[k] = fdn.outval.w;
+    }
+    TASCAR::bandpass_t bp(f * sqrtf(0.5f), f * sqrtf(2.0f), fs);
+    for(uint32_t k = 0; k < 4; ++k) {
+      bp.clear();
+      bp.filter(ir);
+    }
+    std::vector<double> edc(len);
+    double sum(0.0);
+    for(size_t k = len; k > 0; --k) {
+      sum += ir.d[k - 1] * ir.d[k - 1];
+      edc[k - 1] = sum;
+    }
+    double t10(0.0);
+    double t30(0.0);
+    for(size_t k = 0; k < len; ++k) {
+      double l(10.0 * log10(edc[k] / edc[0]));
+      if((t10 == 0.0) && (l <= -10.0))
+        t10 = k / fs;
+      if((t30 == 0.0) && (l <= -30.0))
+        t30 = k / fs;
+    }
+    return (float)(3.0 * (t30 - t10));
+  }
+
+} // namespace
+
+TEST(reflectionfilter_t, get_gain)
+{
+  reflectionfilter_t flt;
+  flt.set_lp(0.5f, 0.3f);
+  // at DC the lowpass has the gain g:
+  EXPECT_NEAR(0.5f, flt.get_gain(0.0f), 1e-6f);
+  // at Nyquist frequency the gain is g(1-c)/(1+c):
+  EXPECT_NEAR(0.5f * 0.7f / 1.3f, flt.get_gain(TASCAR_PIf), 1e-6f);
+}
+
+TEST(fdn_t, get_t60_estimate)
+{
+  // compare analytic estimate of T60 with T60 measured in the
+  // impulse response. The estimate ignores the skirts of the band
+  // pass filters used in the measurement, thus deviations are larger
+  // for strong damping:
+  const uint32_t len(3 * fs);
+  for(auto damping : {0.1f, 0.4f}) {
+    fdn_t fdn(8, fs, true, fdn_t::original, true);
+    fdn.setpar_t60(0.0f, 0.3f, 0.01f * fs, 0.03f * fs, 0.8f * fs, damping,
+                   true, false);
+    for(auto f : {250.0f, 1000.0f, 4000.0f}) {
+      float t60_est(fdn.get_t60_estimate(f, fs, 1.0f));
+      float t60_meas(measure_t60(fdn, f, len));
+      EXPECT_GT(t60_est, 0.0f);
+      EXPECT_NEAR(t60_meas, t60_est, 0.25f * t60_meas)
+          << "f=" << f << " damping=" << damping;
+    }
+  }
+  // no decay without damping and gain:
+  fdn_t fdn(4, fs, true, fdn_t::original, true);
+  EXPECT_EQ(-1.0f, fdn.get_t60_estimate(1000.0f, fs));
+}
+
+/*
+ * Local Variables:
+ * mode: c++
+ * c-basic-offset: 2
+ * indent-tabs-mode: nil
+ * compile-command: "make -C .."
+ * End:
+ */
@@ -47,22 +47,34 @@ void TASCAR::fft_t::execute(const spec_t& src)
   ifft();
 }
 
+std::mutex& TASCAR::fftw_planner_mutex()
+{
+  static std::mutex mtx;
+  return mtx;
+}
+
+void TASCAR::fft_t::create_plans()
+{
+  std::lock_guard<std::mutex> lock(fftw_planner_mutex());
+  fftwp_w2s = fftwf_plan_dft_r2c_1d(w.n, wp, sp, FFTW_ESTIMATE);
+  fftwp_s2w = fftwf_plan_dft_c2r_1d(w.n, sp, wp, FFTW_ESTIMATE);
+  fftwp_s2s = fftwf_plan_dft_1d(w.n, fsp, fsp, FFTW_BACKWARD, FFTW_ESTIMATE);
+}
+
 TASCAR::fft_t::fft_t(uint32_t fftlen)
     : w(fftlen), s(fftlen / 2 + 1), fullspec(fftlen), wp(w.d),
       sp((fftwf_complex*)(s.b)), fsp((fftwf_complex*)(fullspec.b)),
-      fftwp_w2s(fftwf_plan_dft_r2c_1d(w.n, wp, sp, FFTW_ESTIMATE)),
-      fftwp_s2w(fftwf_plan_dft_c2r_1d(w.n, sp, wp, FFTW_ESTIMATE)),
-      fftwp_s2s(fftwf_plan_dft_1d(w.n, fsp, fsp, FFTW_BACKWARD, FFTW_ESTIMATE))
+      fftwp_w2s(NULL), fftwp_s2w(NULL), fftwp_s2s(NULL)
 {
+  create_plans();
 }
 
 TASCAR::fft_t::fft_t(const fft_t& src)
     : w(src.w.n), s(src.s.n_), fullspec(src.fullspec.n_), wp(w.d),
       sp((fftwf_complex*)(s.b)), fsp((fftwf_complex*)(fullspec.b)),
-      fftwp_w2s(fftwf_plan_dft_r2c_1d(w.n, wp, sp, FFTW_ESTIMATE)),
-      fftwp_s2w(fftwf_plan_dft_c2r_1d(w.n, sp, wp, FFTW_ESTIMATE)),
-      fftwp_s2s(fftwf_plan_dft_1d(w.n, fsp, fsp, FFTW_BACKWARD, FFTW_ESTIMATE))
+      fftwp_w2s(NULL), fftwp_s2w(NULL), fftwp_s2s(NULL)
 {
+  create_plans();
 }
 
 void TASCAR::fft_t::hilbert(const TASCAR::wave_t& src)
@@ -79,6 +91,7 @@ void TASCAR::fft_t::hilbert(const TASCAR::wave_t& src)
 
 TASCAR::fft_t::~fft_t()
 {
+  std::lock_guard<std::mutex> lock(fftw_planner_mutex());
   fftwf_destroy_plan(fftwp_w2s);
   fftwf_destroy_plan(fftwp_s2w);
   fftwf_destroy_plan(fftwp_s2s);
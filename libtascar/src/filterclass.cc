@@ -25,7 +25,12 @@
 #include "errorhandling.h"
 #include "optim.h"
 #include "tscconfig.h"
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <string.h>
+#include <tuple>
 
 const std::complex<double> i(0.0, 1.0);
 const std::complex<float> i_f(0.0f, 1.0f);
@@ -830,6 +835,361 @@ int TASCAR::alpha2rflt(float& reflectivity, float& damping,
   return err;
 }
 
+std::vector<float> TASCAR::alpha2gain(const std::vector<float>& alpha)
+{
+  std::vector<float> gain;
+  for(auto a : alpha)
+    gain.push_back(1.0f - sqrtf(std::min(1.0f, std::max(0.0f, a))));
+  return gain;
+}
+
+TASCAR::reflectionfilter_design_t::reflectionfilter_design_t(
+    const std::vector<float>& freq_, const std::vector<float>& gain_,
+    float fs_)
+    : fs(fs_)
+{
+  if(gain_.empty())
+    throw TASCAR::ErrMsg("Invalid gains in reflection filter (empty)");
+  if(gain_.size() != freq_.size())
+    throw TASCAR::ErrMsg(
+        "Different number of gains and frequencies in reflection filter: " +
+        std::to_string(gain_.size()) + " gains, " +
+        std::to_string(freq_.size()) + " frequencies.");
+  // sort bands by frequency, use only bands below Nyquist frequency:
+  std::vector<std::pair<float, float>> bands;
+  for(size_t k = 0; k < freq_.size(); ++k)
+    if((freq_[k] > 0.0f) && (freq_[k] < 0.45f * fs))
+      bands.push_back(std::pair<float, float>(freq_[k], gain_[k]));
+  if(bands.empty())
+    throw TASCAR::ErrMsg(
+        "No reflection filter band below the Nyquist frequency.");
+  std::sort(bands.begin(), bands.end());
+  if(bands.size() > maxsections + 1)
+    throw TASCAR::ErrMsg("Too many bands in reflection filter (" +
+                         std::to_string(bands.size()) + ", maximum is " +
+                         std::to_string(maxsections + 1) + ").");
+  for(auto& b : bands) {
+    freq.push_back(b.first);
+    gain.push_back(b.second);
+  }
+  // target levels, limited to -60 dB:
+  std::vector<double> target;
+  for(auto g : gain)
+    target.push_back(20.0 * log10(std::max(1e-3, (double)g)));
+  // neighbouring shelves overlap, thus the shelf levels are fitted
+  // with Newton iterations, using a numerical Jacobian:
+  size_t n(freq.size());
+  std::vector<double> level(target);
+  std::vector<double> resp(n);
+  std::vector<double> resp2(n);
+  std::vector<double> jac(n * (n + 1));
+  auto get_response_db = [&](const std::vector<double>& lev,
+                             std::vector<double>& r) {
+    set_shelves(lev);
+    for(size_t k = 0; k < n; ++k)
+      r[k] = 20.0 * log10(std::max(1e-12, (double)get_response(freq[k])));
+  };
+  auto get_error = [&](const std::vector<double>& lev) {
+    get_response_db(lev, resp);
+    double err(0.0);
+    for(size_t k = 0; k < n; ++k)
+      err += (target[k] - resp[k]) * (target[k] - resp[k]);
+    return err;
+  };
+  double err(get_error(level));
+  for(uint32_t it = 0; (it < 40) && (err > 1e-6); ++it) {
+    // augmented matrix [J | target - response]:
+    for(size_t j = 0; j < n; ++j) {
+      std::vector<double> lev2(level);
+      lev2[j] += 0.01;
+      get_response_db(lev2, resp2);
+      for(size_t k = 0; k < n; ++k)
+        jac[k * (n + 1) + j] = resp2[k];
+    }
+    get_response_db(level, resp);
+    for(size_t k = 0; k < n; ++k) {
+      for(size_t j = 0; j < n; ++j)
+        jac[k * (n + 1) + j] = (jac[k * (n + 1) + j] - resp[k]) / 0.01;
+      jac[k * (n + 1) + n] = target[k] - resp[k];
+    }
+    // Gaussian elimination with partial pivoting:
+    bool singular(false);
+    for(size_t c = 0; c < n; ++c) {
+      size_t piv(c);
+      for(size_t k = c + 1; k < n; ++k)
+        if(fabs(jac[k * (n + 1) + c]) > fabs(jac[piv * (n + 1) + c]))
+          piv = k;
+      if(fabs(jac[piv * (n + 1) + c]) < 1e-9) {
+        singular = true;
+        break;
+      }
+      for(size_t j = 0; j <= n; ++j)
+        std::swap(jac[c * (n + 1) + j], jac[piv * (n + 1) + j]);
+      for(size_t k = c + 1; k < n; ++k) {
+        double fac(jac[k * (n + 1) + c] / jac[c * (n + 1) + c]);
+        for(size_t j = c; j <= n; ++j)
+          jac[k * (n + 1) + j] -= fac * jac[c * (n + 1) + j];
+      }
+    }
+    if(singular)
+      break;
+    std::vector<double> step(n);
+    for(size_t c = n; c-- > 0;) {
+      double v(jac[c * (n + 1) + n]);
+      for(size_t j = c + 1; j < n; ++j)
+        v -= jac[c * (n + 1) + j] * step[j];
+      step[c] = v / jac[c * (n + 1) + c];
+    }
+    // damped step, accept only if the error decreases:
+    bool improved(false);
+    for(double scale = 1.0; scale > 1e-3; scale *= 0.5) {
+      std::vector<double> lev2(level);
+      for(size_t k = 0; k < n; ++k)
+        lev2[k] += scale * step[k];
+      double err2(get_error(lev2));
+      if(err2 < err) {
+        level = lev2;
+        err = err2;
+        improved = true;
+        break;
+      }
+    }
+    if(!improved)
+      break;
+  }
+  set_shelves(level);
+  expand_parallel();
+}
+
+void TASCAR::reflectionfilter_design_t::set_shelves(
+    const std::vector<double>& level_db)
+{
+  g0 = pow(10.0, 0.05 * level_db[0]);
+  b0.clear();
+  b1.clear();
+  b2.clear();
+  a1.clear();
+  a2.clear();
+  for(size_t k = 1; k < freq.size(); ++k) {
+    double gain_db(level_db[k] - level_db[k - 1]);
+    if(fabs(gain_db) < 1e-6)
+      continue;
+    // second order high shelf with slope S=1 and transition at the
+    // geometric mean of the band frequencies (RBJ audio EQ cookbook):
+    double fc(sqrt((double)freq[k - 1] * (double)freq[k]));
+    double A(pow(10.0, gain_db / 40.0));
+    double w0(TASCAR_2PI * fc / fs);
+    double cw(cos(w0));
+    double alpha(sin(w0) / sqrt(2.0));
+    double sqa(2.0 * sqrt(A) * alpha);
+    double a0((A + 1.0) - (A - 1.0) * cw + sqa);
+    b0.push_back(A * ((A + 1.0) + (A - 1.0) * cw + sqa) / a0);
+    b1.push_back(-2.0 * A * ((A - 1.0) + (A + 1.0) * cw) / a0);
+    b2.push_back(A * ((A + 1.0) + (A - 1.0) * cw - sqa) / a0);
+    a1.push_back(2.0 * ((A - 1.0) - (A + 1.0) * cw) / a0);
+    a2.push_back(((A + 1.0) - (A - 1.0) * cw - sqa) / a0);
+  }
+}
+
+void TASCAR::reflectionfilter_design_t::expand_parallel()
+{
+  // partial fraction expansion of
+  //   H(w) = g0 prod N_k(w) / D_k(w), w = z^-1
+  // with D_k(w) = (1 - pa_k w)(1 - pb_k w) into
+  //   H(w) = d + sum (c_ak / (1 - pa_k w) + c_bk / (1 - pb_k w)),
+  // the two terms of each section are combined into one real
+  // second-order section.
+  typedef std::complex<double> cplx_t;
+  parallel = false;
+  for(uint32_t k = 0; k < maxsections; ++k) {
+    p1[k] = p2[k] = r0[k] = r1[k] = 0.0f;
+  }
+  d = (float)g0;
+  size_t n(b0.size());
+  if(n == 0) {
+    parallel = true;
+    return;
+  }
+  std::vector<cplx_t> pa(n);
+  std::vector<cplx_t> pb(n);
+  double dd(g0);
+  for(size_t k = 0; k < n; ++k) {
+    if(fabs(a2[k]) < 1e-9)
+      return;
+    dd *= b2[k] / a2[k];
+    // poles are the roots of z^2 + a1 z + a2:
+    cplx_t sq(std::sqrt(cplx_t(a1[k] * a1[k] - 4.0 * a2[k], 0.0)));
+    pa[k] = 0.5 * (-a1[k] + sq);
+    pb[k] = 0.5 * (-a1[k] - sq);
+  }
+  auto num = [&](size_t k, cplx_t w) { return b0[k] + (b1[k] + b2[k] * w) * w; };
+  auto den = [&](size_t k, cplx_t w) { return 1.0 + (a1[k] + a2[k] * w) * w; };
+  auto residue = [&](size_t k, cplx_t p, cplx_t q) {
+    // residue at pole p of section k, q is the other pole:
+    cplx_t w(1.0 / p);
+    cplx_t v(g0 * num(k, w) / (1.0 - q * w));
+    for(size_t l = 0; l < n; ++l)
+      if(l != k)
+        v *= num(l, w) / den(l, w);
+    return v;
+  };
+  double maxres(0.0);
+  for(size_t k = 0; k < n; ++k) {
+    if(std::abs(pa[k] - pb[k]) < 1e-9)
+      return;
+    cplx_t ca(residue(k, pa[k], pb[k]));
+    cplx_t cb(residue(k, pb[k], pa[k]));
+    p1[k] = (float)std::real(pa[k] + pb[k]);
+    p2[k] = (float)(-std::real(pa[k] * pb[k]));
+    r0[k] = (float)std::real(ca + cb);
+    r1[k] = (float)(-std::real(ca * pb[k] + cb * pa[k]));
+    maxres = std::max(maxres, (double)std::max(fabsf(r0[k]), fabsf(r1[k])));
+  }
+  d = (float)dd;
+  // large residues of alternating sign cause cancellation errors in
+  // single precision, thus validate the expansion:
+  bool valid(maxres < 1000.0 * std::max(1.0, g0));
+  for(auto f : freq) {
+    cplx_t w(std::exp(-i * TASCAR_2PI * (double)f / (double)fs));
+    cplx_t h(d);
+    for(size_t k = 0; k < n; ++k)
+      h += ((double)r0[k] + (double)r1[k] * w) /
+           (1.0 - ((double)p1[k] + (double)p2[k] * w) * w);
+    double href(get_response(f));
+    if(fabs(std::abs(h) - href) > 1e-3 * href)
+      valid = false;
+  }
+  if(!valid) {
+    d = (float)g0;
+    for(uint32_t k = 0; k < maxsections; ++k)
+      p1[k] = p2[k] = r0[k] = r1[k] = 0.0f;
+    return;
+  }
+  parallel = true;
+}
+
+float TASCAR::reflectionfilter_design_t::get_response(float f) const
+{
+  std::complex<double> w(std::exp(-i * TASCAR_2PI * (double)f / (double)fs));
+  std::complex<double> h(g0);
+  for(size_t k = 0; k < b0.size(); ++k)
+    h *= (b0[k] + (b1[k] + b2[k] * w) * w) / (1.0 + (a1[k] + a2[k] * w) * w);
+  return (float)std::abs(h);
+}
+
+template <uint32_t N>
+void filter_parallel(TASCAR::wave_t& audio, float* state, float d,
+                     const float* p1_, const float* p2_, const float* r0_,
+                     const float* r1_)
+{
+  // all sections are processed in the inner loop, unused sections
+  // have zero poles and residues. Local copies of coefficients and
+  // states allow the compiler to keep them in vector registers.
+  float p1[N];
+  float p2[N];
+  float r0[N];
+  float r1[N];
+  float s1[N];
+  float s2[N];
+  float y[N];
+  for(uint32_t k = 0; k < N; ++k) {
+    p1[k] = p1_[k];
+    p2[k] = p2_[k];
+    r0[k] = r0_[k];
+    r1[k] = r1_[k];
+    s1[k] = state[k];
+    s2[k] = state[k + N];
+  }
+  for(uint32_t t = 0; t < audio.n; ++t) {
+    float x(audio.d[t]);
+    for(uint32_t k = 0; k < N; ++k) {
+      float s0(x + p1[k] * s1[k] + p2[k] * s2[k]);
+      y[k] = r0[k] * s0 + r1[k] * s1[k];
+      s2[k] = s1[k];
+      s1[k] = s0;
+    }
+    float acc(d * x);
+    for(uint32_t k = 0; k < N; ++k)
+      acc += y[k];
+    audio.d[t] = acc;
+  }
+  for(uint32_t k = 0; k < N; ++k) {
+    make_friendly_number(s1[k]);
+    make_friendly_number(s2[k]);
+    state[k] = s1[k];
+    state[k + N] = s2[k];
+  }
+}
+
+void TASCAR::reflectionfilter_design_t::filter(TASCAR::wave_t& audio,
+                                               float* state) const
+{
+  if(parallel) {
+    if(b0.size() <= maxsections / 2)
+      filter_parallel<maxsections / 2>(audio, state, d, p1, p2, r0, r1);
+    else
+      filter_parallel<maxsections>(audio, state, d, p1, p2, r0, r1);
+  } else {
+    // cascade, transposed direct form II:
+    audio *= (float)g0;
+    for(size_t k = 0; k < b0.size(); ++k) {
+      float fb0((float)b0[k]);
+      float fb1((float)b1[k]);
+      float fb2((float)b2[k]);
+      float fa1((float)a1[k]);
+      float fa2((float)a2[k]);
+      float z1(state[2 * k]);
+      float z2(state[2 * k + 1]);
+      for(uint32_t t = 0; t < audio.n; ++t) {
+        float x(audio.d[t]);
+        float y(fb0 * x + z1);
+        z1 = fb1 * x - fa1 * y + z2;
+        z2 = fb2 * x - fa2 * y;
+        audio.d[t] = y;
+      }
+      make_friendly_number(z1);
+      make_friendly_number(z2);
+      state[2 * k] = z1;
+      state[2 * k + 1] = z2;
+    }
+  }
+}
+
+namespace {
+  std::mutex reflectionfilter_mtx;
+  std::map<std::tuple<std::vector<float>, std::vector<float>, float>,
+           std::unique_ptr<TASCAR::reflectionfilter_design_t>>
+      reflectionfilter_designs;
+} // namespace
+
+const TASCAR::reflectionfilter_design_t*
+TASCAR::get_reflectionfilter_design(const std::vector<float>& freq,
+                                    const std::vector<float>& gain, float fs)
+{
+  std::lock_guard<std::mutex> lock(reflectionfilter_mtx);
+  auto key(std::make_tuple(freq, gain, fs));
+  auto it(reflectionfilter_designs.find(key));
+  if(it != reflectionfilter_designs.end())
+    return it->second.get();
+  auto& design(reflectionfilter_designs[key]);
+  design.reset(new reflectionfilter_design_t(freq, gain, fs));
+  return design.get();
+}
+
+const TASCAR::reflectionfilter_design_t*
+TASCAR::combine_reflectionfilter_design(const reflectionfilter_design_t* a,
+                                        const reflectionfilter_design_t* b)
+{
+  if(!a)
+    return b;
+  if(!b)
+    return a;
+  std::vector<float> gain(a->get_gain());
+  for(size_t k = 0; k < gain.size(); ++k)
+    gain[k] *= b->get_response(a->get_freq()[k]);
+  return get_reflectionfilter_design(a->get_freq(), gain, a->get_fs());
+}
+
 TASCAR::o1flt_lowpass_t::o1flt_lowpass_t(const std::vector<float>& tau,
                                          float fs, float startval)
     : TASCAR::o1_ar_filter_t(tau.size(), fs)
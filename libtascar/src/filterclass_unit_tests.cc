@@ -489,6 +489,72 @@ TEST(alpha2rflt, vals)
   // ASSERT_EQ(0, err);
 }
 
+TEST(reflectionfilter_design_t, fit)
+{
+  std::vector<float> vfreq = {125.0f,  250.0f,  500.0f,
+                              1000.0f, 2000.0f, 4000.0f};
+  for(auto alpha : std::vector<std::vector<float>>(
+          {{0.013f, 0.015f, 0.02f, 0.03f, 0.04f, 0.05f},
+           {0.02f, 0.06f, 0.14f, 0.37f, 0.60f, 0.65f},
+           {0.05f, 0.22f, 0.52f, 0.56f, 0.45f, 0.32f},
+           {0.50f, 0.35f, 0.15f, 0.05f, 0.05f, 0.00f}})) {
+    auto gain(TASCAR::alpha2gain(alpha));
+    TASCAR::reflectionfilter_design_t flt(vfreq, gain, 44100.0f);
+    EXPECT_TRUE(flt.is_parallel());
+    EXPECT_EQ(5u, flt.get_num_sections());
+    for(size_t k = 0; k < vfreq.size(); ++k)
+      EXPECT_NEAR(20.0f * log10f(gain[k]),
+                  20.0f * log10f(flt.get_response(vfreq[k])), 0.1f);
+  }
+  EXPECT_THROW(TASCAR::reflectionfilter_design_t({125.0f}, {}, 44100.0f),
+               TASCAR::ErrMsg);
+  EXPECT_THROW(TASCAR::reflectionfilter_design_t({30000.0f}, {1.0f}, 44100.0f),
+               TASCAR::ErrMsg);
+}
+
+TEST(reflectionfilter_design_t, filter)
+{
+  // steady state response to a sinusoid equals the design response:
+  std::vector<float> vfreq = {125.0f,  250.0f,  500.0f,
+                              1000.0f, 2000.0f, 4000.0f};
+  auto gain(TASCAR::alpha2gain({0.02f, 0.06f, 0.14f, 0.37f, 0.60f, 0.65f}));
+  const float fs(44100.0f);
+  TASCAR::reflectionfilter_design_t flt(vfreq, gain, fs);
+  for(auto f : {100.0f, 300.0f, 1000.0f, 3000.0f, 8000.0f}) {
+    std::vector<float> state(2 * TASCAR::reflectionfilter_design_t::maxsections,
+                             0.0f);
+    TASCAR::wave_t sig(44100);
+    for(uint32_t t = 0; t < sig.n; ++t)
+      sig.d[t] = sinf(TASCAR_2PIf * f * t / fs);
+    // process in chunks:
+    for(uint32_t t = 0; t < sig.n; t += 441) {
+      TASCAR::wave_t chunk(441, sig.d + t);
+      flt.filter(chunk, state.data());
+    }
+    TASCAR::wave_t tail(22050, sig.d + 22050);
+    EXPECT_NEAR(flt.get_response(f), sqrtf(2.0f) * tail.rms(), 1e-3f);
+  }
+}
+
+TEST(reflectionfilter_design_t, cache)
+{
+  std::vector<float> vfreq = {125.0f, 500.0f, 2000.0f};
+  auto g1(TASCAR::alpha2gain({0.1f, 0.2f, 0.4f}));
+  auto g2(TASCAR::alpha2gain({0.3f, 0.2f, 0.1f}));
+  auto d1(TASCAR::get_reflectionfilter_design(vfreq, g1, 44100.0f));
+  auto d2(TASCAR::get_reflectionfilter_design(vfreq, g2, 44100.0f));
+  EXPECT_EQ(d1, TASCAR::get_reflectionfilter_design(vfreq, g1, 44100.0f));
+  EXPECT_NE(d1, TASCAR::get_reflectionfilter_design(vfreq, g1, 48000.0f));
+  EXPECT_NE(d1, d2);
+  // the same sequence of reflections shares one design:
+  auto d12(TASCAR::combine_reflectionfilter_design(d1, d2));
+  EXPECT_EQ(d12, TASCAR::combine_reflectionfilter_design(d1, d2));
+  EXPECT_EQ(d1, TASCAR::combine_reflectionfilter_design(NULL, d1));
+  for(size_t k = 0; k < vfreq.size(); ++k)
+    EXPECT_NEAR(g1[k] * g2[k], d12->get_response(vfreq[k]),
+                0.02f * g1[k] * g2[k]);
+}
+
 // Local Variables:
 // compile-command: "make -C ../.. unit-tests"
 // coding: utf-8-unix
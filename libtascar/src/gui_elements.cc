@@ -684,9 +684,53 @@ void source_panel_t::set_levelmeter_weight(TASCAR::levelmeter::weight_t w)
     (*it)->set_levelmeter_weight(w);
 }
 
+void track_lod_t::update(const TASCAR::track_t& track)
+{
+  if(track.empty()) {
+    npoints = 0;
+    tolerance.clear();
+    levels.clear();
+    return;
+  }
+  if((track.size() == npoints) && (track.begin()->first == t_min) &&
+     (track.rbegin()->first == t_max))
+    return;
+  npoints = track.size();
+  t_min = track.begin()->first;
+  t_max = track.rbegin()->first;
+  tolerance.clear();
+  levels.clear();
+  // finest level is the full track, then increase tolerance by a
+  // factor of four, starting at 1 cm:
+  tolerance.push_back(0.0);
+  levels.push_back(track.get_decimated(0.0));
+  double tol(0.01);
+  while(levels.back().size() > 2) {
+    std::vector<TASCAR::pos_t> level(track.get_decimated(tol));
+    if(level.size() < levels.back().size()) {
+      tolerance.push_back(tol);
+      levels.push_back(level);
+    }
+    tol *= 4.0;
+  }
+}
+
+const std::vector<TASCAR::pos_t>& track_lod_t::get(double tol) const
+{
+  static const std::vector<TASCAR::pos_t> empty;
+  if(levels.empty())
+    return empty;
+  size_t k(0);
+  while((k + 1 < levels.size()) && (tolerance[k + 1] <= tol))
+    ++k;
+  return levels[k];
+}
+
 scene_draw_t::scene_draw_t()
     : scene_(NULL), time(0), selection(NULL), markersize(0.02), blink(false),
-      b_print_labels(true), b_acoustic_model(false)
+      b_print_labels(true), b_acoustic_model(false),
+      b_retained(TASCAR::config("tascar.gui.retained", true) != 0.0),
+      static_layer_x(0), static_layer_y(0), static_updates(0)
 {
   pthread_mutex_init(&mtx, NULL);
 }
@@ -702,6 +746,10 @@ void scene_draw_t::set_scene(TASCAR::render_core_t* scene)
 {
   pthread_mutex_lock(&mtx);
   scene_ = scene;
+  track_lod.clear();
+  static_version.clear();
+  moving_objects.clear();
+  static_key.clear();
   if(scene_)
     view.set_ref(scene_->guicenter);
   else
@@ -751,72 +799,248 @@ void scene_draw_t::set_viewport(const viewt_t& viewt)
   }
 }
 
+void scene_draw_t::update_acousticmodel_snapshot()
+{
+  // the snapshot is published by the audio thread, the world is not
+  // locked:
+  if(scene_)
+    scene_->get_acousticmodel_snapshot(acousticmodel_snapshot);
+  else
+    acousticmodel_snapshot.clear();
+}
+
 void scene_draw_t::draw_acousticmodel(Cairo::RefPtr<Cairo::Context> cr)
 {
-  // draw acoustic model:
+  // draw acoustic model. Sources are grouped by their quantized
+  // gain, and each group is drawn with a single path per primitive
+  // type:
+  const uint32_t nlevels(16);
+  update_acousticmodel_snapshot();
+  std::vector<std::vector<uint32_t>> groups(nlevels + 1);
+  std::vector<pos_t> psrc(acousticmodel_snapshot.size());
+  std::vector<pos_t> prec(acousticmodel_snapshot.size());
+  for(uint32_t k = 0; k < acousticmodel_snapshot.size(); ++k) {
+    const TASCAR::acousticmodel_snapshot_t& snap(acousticmodel_snapshot[k]);
+    psrc[k] = view(snap.position);
+    prec[k] = view(snap.receiver_position);
+    // group 0 contains the sources with zero gain:
+    uint32_t level(0);
+    if(snap.gain >= EPS)
+      level = 1 + (uint32_t)((nlevels - 1) * snap.gain + 0.5f);
+    groups[level].push_back(k);
+  }
   cr->save();
   cr->set_source_rgb(0, 0, 0);
   cr->set_line_width(0.2 * markersize);
-  for(std::vector<TASCAR::Acousticmodel::receiver_graph_t*>::iterator irc =
-          scene_->world->receivergraphs.begin();
-      irc != scene_->world->receivergraphs.end(); ++irc)
-    for(std::vector<TASCAR::Acousticmodel::acoustic_model_t*>::iterator iam =
-            (*irc)->acoustic_model.begin();
-        iam != (*irc)->acoustic_model.end(); ++iam) {
-      if((*iam)->receiver_->volumetric.is_null() && (*iam)->src_->active &&
-         (*iam)->receiver_->active &&
-         ((*iam)->src_->ismmin <= (*iam)->ismorder) &&
-         ((*iam)->src_->ismmax >= (*iam)->ismorder) &&
-         ((*iam)->receiver_->ismmin <= (*iam)->ismorder) &&
-         ((*iam)->receiver_->ismmax >= (*iam)->ismorder)) {
-        pos_t psrc(view((*iam)->position));
-        pos_t prec(view((*iam)->receiver_->position));
-        cr->save();
-        float gain_color(std::min(1.0f, std::max(0.0f, (*iam)->get_gain())));
-        if(gain_color < EPS)
-          // sources with zero gain but active are shown in red:
-          cr->set_source_rgba(1, 0, 0, 0.5);
-        else
-          // regular sources are gray:
-          cr->set_source_rgba(0, 0, 0, 0.1 + 0.9 * gain_color);
-        // mark sources as circle with cross:
-        cr->arc(psrc.x, -psrc.y, markersize, 0, TASCAR_2PI);
-        cr->move_to(psrc.x - 0.7 * markersize, -psrc.y + 0.7 * markersize);
-        cr->line_to(psrc.x + 0.7 * markersize, -psrc.y - 0.7 * markersize);
-        cr->move_to(psrc.x - 0.7 * markersize, -psrc.y - 0.7 * markersize);
-        cr->line_to(psrc.x + 0.7 * markersize, -psrc.y + 0.7 * markersize);
-        cr->stroke();
-        // draw source traces:
-        if(gain_color > EPS) {
-          cr->set_source_rgba(0, 0.6, 0, 0.1 + 0.9 * gain_color);
-          draw_edge(cr, psrc, prec);
-          cr->stroke();
-        }
-        // image source or primary source:
-        if((*iam)->ismorder > 0) {
-          // image source:
-          cr->save();
-          char ctmp[1024];
-          ctmp[1023] = 0;
-          snprintf(ctmp, 1023, "%u", (*iam)->ismorder);
-          if(gain_color < EPS)
-            // sources with zero gain but active are shown in red:
-            cr->set_source_rgba(1, 0, 0, 0.5);
-          else
-            // regular sources are gray:
-            cr->set_source_rgba(0, 0, 0, 0.1 + 0.9 * gain_color);
-          cr->move_to(psrc.x + 1.2 * markersize, -psrc.y);
-          cr->show_text(ctmp);
-          cr->stroke();
-          cr->restore();
-        } else {
-          // primary source:
-          cr->arc(psrc.x, -psrc.y, markersize, 0, TASCAR_2PI);
-          cr->fill();
-        }
-        cr->restore();
+  for(uint32_t level = 0; level <= nlevels; ++level) {
+    const std::vector<uint32_t>& group(groups[level]);
+    if(group.empty())
+      continue;
+    double gain_color(0.0);
+    if(level > 0)
+      gain_color = (level - 1.0) / (nlevels - 1.0);
+    if(level == 0)
+      // sources with zero gain but active are shown in red:
+      cr->set_source_rgba(1, 0, 0, 0.5);
+    else
+      // regular sources are gray:
+      cr->set_source_rgba(0, 0, 0, 0.1 + 0.9 * gain_color);
+    // mark sources as circle with cross:
+    for(auto k : group) {
+      const pos_t& p(psrc[k]);
+      cr->move_to(p.x + markersize, -p.y);
+      cr->arc(p.x, -p.y, markersize, 0, TASCAR_2PI);
+      cr->move_to(p.x - 0.7 * markersize, -p.y + 0.7 * markersize);
+      cr->line_to(p.x + 0.7 * markersize, -p.y - 0.7 * markersize);
+      cr->move_to(p.x - 0.7 * markersize, -p.y - 0.7 * markersize);
+      cr->line_to(p.x + 0.7 * markersize, -p.y + 0.7 * markersize);
+    }
+    cr->stroke();
+    // image source order:
+    char ctmp[32];
+    for(auto k : group)
+      if(acousticmodel_snapshot[k].ismorder > 0) {
+        snprintf(ctmp, sizeof(ctmp), "%u", acousticmodel_snapshot[k].ismorder);
+        cr->move_to(psrc[k].x + 1.2 * markersize, -psrc[k].y);
+        cr->show_text(ctmp);
       }
+    cr->begin_new_path();
+    // primary sources:
+    for(auto k : group)
+      if(acousticmodel_snapshot[k].ismorder == 0) {
+        cr->move_to(psrc[k].x + markersize, -psrc[k].y);
+        cr->arc(psrc[k].x, -psrc[k].y, markersize, 0, TASCAR_2PI);
+      }
+    cr->fill();
+    // draw source traces:
+    if(level > 0) {
+      cr->set_source_rgba(0, 0.6, 0, 0.1 + 0.9 * gain_color);
+      for(auto k : group)
+        draw_edge(cr, psrc[k], prec[k]);
+      cr->stroke();
+    }
+  }
+  cr->restore();
+}
+
+void scene_draw_t::set_retained(bool retained)
+{
+  pthread_mutex_lock(&mtx);
+  b_retained = retained;
+  static_layer.clear();
+  static_key.clear();
+  pthread_mutex_unlock(&mtx);
+}
+
+void scene_draw_t::get_static_key(Cairo::RefPtr<Cairo::Context> cr,
+                                  std::vector<double>& key)
+{
+  key.clear();
+  Cairo::Matrix m;
+  cr->get_matrix(m);
+  key.insert(key.end(), {m.xx, m.yx, m.xy, m.yy, m.x0, m.y0});
+  double x1(0.0);
+  double y1(0.0);
+  double x2(0.0);
+  double y2(0.0);
+  cr->get_clip_extents(x1, y1, x2, y2);
+  key.insert(key.end(), {x1, y1, x2, y2});
+  key.insert(key.end(),
+             {view.euler.z, view.euler.y, view.euler.x, view.ref.x, view.ref.y,
+              view.ref.z, (double)view.perspective, view.fov, view.scale,
+              markersize, (double)b_print_labels, (double)b_acoustic_model});
+  for(auto obj : scene_->all_objects) {
+    bool active(obj->isactive(time));
+    key.insert(key.end(),
+               {(double)active, (double)(obj->get_solo() && blink),
+                (double)(obj == selection), (double)obj->location.size(),
+                (double)moving_objects.count(obj)});
+  }
+}
+
+bool scene_draw_t::is_static(TASCAR::Scene::object_t* obj) const
+{
+  return (dynamic_cast<TASCAR::Scene::face_object_t*>(obj) ||
+          dynamic_cast<TASCAR::Scene::face_group_t*>(obj) ||
+          dynamic_cast<TASCAR::Scene::obstacle_group_t*>(obj)) &&
+         (moving_objects.count(obj) == 0);
+}
+
+void scene_draw_t::update_moving_objects()
+{
+  for(auto obj : scene_->all_objects)
+    if(is_static(obj)) {
+      uint64_t version(obj->get_transform_version());
+      auto it(static_version.find(obj));
+      if(it == static_version.end())
+        static_version[obj] = version;
+      else if(it->second != version)
+        moving_objects.insert(obj);
+    }
+}
+
+void scene_draw_t::draw_static(Cairo::RefPtr<Cairo::Context> cr)
+{
+  for(auto obj : scene_->all_objects) {
+    if(!b_acoustic_model)
+      draw_track_line(obj, cr, markersize);
+    if(is_static(obj)) {
+      draw_face(dynamic_cast<TASCAR::Scene::face_object_t*>(obj), cr,
+                markersize);
+      draw_facegroup(dynamic_cast<TASCAR::Scene::face_group_t*>(obj), cr,
+                     markersize);
+      draw_obstaclegroup(dynamic_cast<TASCAR::Scene::obstacle_group_t*>(obj),
+                         cr, markersize);
     }
+  }
+}
+
+void scene_draw_t::draw_dynamic(Cairo::RefPtr<Cairo::Context> cr)
+{
+  for(auto obj : scene_->all_objects) {
+    if(!b_acoustic_model) {
+      draw_track_origin(obj, cr, markersize);
+      draw_src(dynamic_cast<TASCAR::Scene::src_object_t*>(obj), cr,
+               markersize);
+    }
+    draw_receiver_object(dynamic_cast<TASCAR::Scene::receiver_obj_t*>(obj),
+                         cr, markersize);
+    draw_room_src(dynamic_cast<TASCAR::Scene::diff_snd_field_obj_t*>(obj), cr,
+                  markersize);
+    draw_mask(dynamic_cast<TASCAR::Scene::mask_object_t*>(obj), cr,
+              markersize);
+    if(moving_objects.count(obj)) {
+      draw_face(dynamic_cast<TASCAR::Scene::face_object_t*>(obj), cr,
+                markersize);
+      draw_facegroup(dynamic_cast<TASCAR::Scene::face_group_t*>(obj), cr,
+                     markersize);
+      draw_obstaclegroup(dynamic_cast<TASCAR::Scene::obstacle_group_t*>(obj),
+                         cr, markersize);
+    }
+  }
+}
+
+void scene_draw_t::draw_retained(Cairo::RefPtr<Cairo::Context> cr)
+{
+  update_moving_objects();
+  get_static_key(cr, current_key);
+  if(!static_layer || (current_key != static_key)) {
+    // bounding box of the clip region in device space:
+    double x1(0.0);
+    double y1(0.0);
+    double x2(0.0);
+    double y2(0.0);
+    cr->get_clip_extents(x1, y1, x2, y2);
+    double dx[4] = {x1, x2, x1, x2};
+    double dy[4] = {y1, y1, y2, y2};
+    double dxmin(std::numeric_limits<double>::max());
+    double dymin(std::numeric_limits<double>::max());
+    double dxmax(-std::numeric_limits<double>::max());
+    double dymax(-std::numeric_limits<double>::max());
+    for(uint32_t k = 0; k < 4; ++k) {
+      cr->user_to_device(dx[k], dy[k]);
+      dxmin = std::min(dxmin, dx[k]);
+      dymin = std::min(dymin, dy[k]);
+      dxmax = std::max(dxmax, dx[k]);
+      dymax = std::max(dymax, dy[k]);
+    }
+    int w((int)ceil(dxmax) - (int)floor(dxmin));
+    int h((int)ceil(dymax) - (int)floor(dymin));
+    if((w <= 0) || (h <= 0) || (w > 16384) || (h > 16384)) {
+      // unbounded target, draw directly:
+      static_layer.clear();
+      static_key.clear();
+      draw_static(cr);
+      return;
+    }
+    static_layer_x = (int)floor(dxmin);
+    static_layer_y = (int)floor(dymin);
+    if(!static_layer || (static_layer->get_width() != w) ||
+       (static_layer->get_height() != h))
+      static_layer = Cairo::ImageSurface::create(Cairo::FORMAT_ARGB32, w, h);
+    Cairo::RefPtr<Cairo::Context> lcr(Cairo::Context::create(static_layer));
+    lcr->save();
+    lcr->set_operator(Cairo::OPERATOR_CLEAR);
+    lcr->paint();
+    lcr->restore();
+    Cairo::Matrix m;
+    cr->get_matrix(m);
+    m.x0 -= static_layer_x;
+    m.y0 -= static_layer_y;
+    lcr->set_matrix(m);
+    Cairo::Matrix fm;
+    cr->get_font_matrix(fm);
+    lcr->set_font_face(cr->get_font_face());
+    lcr->set_font_matrix(fm);
+    lcr->set_line_width(cr->get_line_width());
+    draw_static(lcr);
+    static_key = current_key;
+    ++static_updates;
+  }
+  cr->save();
+  cr->set_identity_matrix();
+  cr->set_source(static_layer, static_layer_x, static_layer_y);
+  cr->paint();
   cr->restore();
 }
 
@@ -826,9 +1050,15 @@ void scene_draw_t::draw(Cairo::RefPtr<Cairo::Context> cr)
     if(scene_) {
       if(scene_->guitrackobject)
         view.set_ref(scene_->guitrackobject->c6dof.position);
-      // std::vector<TASCAR::Scene::object_t*> objects(scene_->get_objects());
-      for(uint32_t k = 0; k < scene_->all_objects.size(); k++)
-        draw_object(scene_->all_objects[k], cr);
+      if(b_retained) {
+        draw_retained(cr);
+        draw_dynamic(cr);
+      } else {
+        // std::vector<TASCAR::Scene::object_t*>
+        // objects(scene_->get_objects());
+        for(uint32_t k = 0; k < scene_->all_objects.size(); k++)
+          draw_object(scene_->all_objects[k], cr);
+      }
       if(b_acoustic_model && scene_->world) {
         draw_acousticmodel(cr);
       }
@@ -980,20 +1210,34 @@ void scene_draw_t::draw_cube(TASCAR::pos_t pos, TASCAR::zyx_euler_t orient,
 void scene_draw_t::draw_track(TASCAR::Scene::object_t* obj,
                               Cairo::RefPtr<Cairo::Context> cr, double msize)
 {
-  if(obj && obj->isactive(time)) {
+  draw_track_line(obj, cr, msize);
+  draw_track_origin(obj, cr, msize);
+}
+
+void scene_draw_t::draw_track_line(TASCAR::Scene::object_t* obj,
+                                   Cairo::RefPtr<Cairo::Context> cr,
+                                   double msize)
+{
+  if(obj && obj->isactive(time) && (obj->location.size() > 1)) {
+    // tracks are drawn with a tolerance of half a pixel (one pixel
+    // is 0.2 marker sizes). In perspective mode the full track is
+    // used:
+    track_lod_t& lod(track_lod[obj]);
+    lod.update(obj->location);
+    double tol(0.0);
+    if(!view.get_perspective())
+      tol = 0.1 * msize * view.scale;
+    const std::vector<pos_t>& track(lod.get(tol));
+    std::vector<pos_t> ptrack(track.size());
+    for(size_t k = 0; k < track.size(); ++k)
+      ptrack[k] = view(track[k]);
     bool solo(obj->get_solo());
-    pos_t p0;
     cr->save();
     if(solo && blink) {
       cr->set_source_rgba(1, 0, 0, 0.5);
       cr->set_line_width(1.2 * msize);
-      for(TASCAR::track_t::const_iterator it = obj->location.begin();
-          it != obj->location.end(); ++it) {
-        pos_t p(view(it->second));
-        if(it != obj->location.begin())
-          draw_edge(cr, p0, p);
-        p0 = p;
-      }
+      for(size_t k = 1; k < ptrack.size(); ++k)
+        draw_edge(cr, ptrack[k - 1], ptrack[k]);
       cr->stroke();
     }
     cr->set_source_rgb(obj->color.r, obj->color.g, obj->color.b);
@@ -1001,17 +1245,21 @@ void scene_draw_t::draw_track(TASCAR::Scene::object_t* obj,
       cr->set_line_width(0.3 * msize);
     else
       cr->set_line_width(0.1 * msize);
-    for(TASCAR::track_t::const_iterator it = obj->location.begin();
-        it != obj->location.end(); ++it) {
-      pos_t p(view(it->second));
-      if(it != obj->location.begin())
-        draw_edge(cr, p0, p);
-      p0 = p;
-    }
+    for(size_t k = 1; k < ptrack.size(); ++k)
+      draw_edge(cr, ptrack[k - 1], ptrack[k]);
     cr->stroke();
+    cr->restore();
+  }
+}
+
+void scene_draw_t::draw_track_origin(TASCAR::Scene::object_t* obj,
+                                     Cairo::RefPtr<Cairo::Context> cr,
+                                     double msize)
+{
+  if(obj && obj->isactive(time)) {
+    cr->save();
     // draw origin and local position:
-    p0 = obj->c6dof_nodelta.position;
-    p0 = view(p0);
+    pos_t p0(view(obj->c6dof_nodelta.position));
     cr->set_source_rgba(obj->color.r, obj->color.g, obj->color.b, 0.6);
     if(!p0.has_infinity()) {
       cr->arc(p0.x, -p0.y, 0.8 * msize, 0, TASCAR_2PI);
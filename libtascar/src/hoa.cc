@@ -20,11 +20,16 @@
  */
 
 #include "hoa.h"
+#include "diskcache.h"
+#include "threadrole.h"
 #include "vbap3d.h"
 #include <Eigen/QR>
 #include <Eigen/SVD>
 #include <cfloat>
+#include <functional>
 #include <gsl/gsl_poly.h>
+#include <sstream>
+#include <thread>
 
 using namespace HOA;
 
@@ -198,6 +203,170 @@ void decoder_t::create_allrad(uint32_t order,
   method = allrad;
 }
 
+void decoder_t::request(uint32_t order,
+                        const std::vector<TASCAR::pos_t>& spkpos,
+                        method_t method_, modifier_t m)
+{
+  if(spkpos.empty())
+    throw TASCAR::ErrMsg("Invalid (empty) speaker layout.");
+  pending = decoder_cache_t::get().request(order, spkpos, method_, m);
+  if(dec)
+    delete[] dec;
+  dec = NULL;
+  M = order;
+  amb_channels = (M + 1) * (M + 1);
+  out_channels = spkpos.size();
+  dectype = m;
+  method = method_;
+}
+
+void decoder_t::wait()
+{
+  if(!pending.valid())
+    return;
+  auto matrix(pending.get());
+  pending = std::shared_future<decoder_cache_t::matrix_t>();
+  if(matrix->size() != amb_channels * out_channels)
+    throw TASCAR::ErrMsg("Invalid size of cached decoder matrix.");
+  dec = new float[amb_channels * out_channels];
+  std::copy(matrix->begin(), matrix->end(), dec);
+}
+
+decoder_cache_t& decoder_cache_t::get()
+{
+  static decoder_cache_t cache;
+  return cache;
+}
+
+decoder_cache_t::decoder_cache_t()
+    : usediskcache(TASCAR::config("tascar.hoa.decodercache", 1.0) != 0.0),
+      maxworkers(std::max(1u, (uint32_t)TASCAR::config(
+                                  "tascar.hoa.decoderthreads",
+                                  (double)std::thread::hardware_concurrency())))
+{
+}
+
+decoder_cache_t::~decoder_cache_t()
+{
+  {
+    std::lock_guard<std::mutex> lock(mtxworkers);
+    stopworkers = true;
+  }
+  cvworkers.notify_all();
+  for(auto& th : workers)
+    th.join();
+}
+
+size_t decoder_cache_t::get_num_workers()
+{
+  std::lock_guard<std::mutex> lock(mtxworkers);
+  return workers.size();
+}
+
+void decoder_cache_t::workerthread()
+{
+  TASCAR::register_thread(TASCAR::thread_roles_t::background);
+  while(true) {
+    std::packaged_task<matrix_t()> job;
+    {
+      std::unique_lock<std::mutex> lock(mtxworkers);
+      cvworkers.wait(lock, [this] { return stopworkers || !jobs.empty(); });
+      if(jobs.empty())
+        return;
+      job = std::move(jobs.front());
+      jobs.pop_front();
+    }
+    job();
+  }
+}
+
+std::string decoder_cache_t::get_key(uint32_t order,
+                                     const std::vector<TASCAR::pos_t>& spkpos,
+                                     decoder_t::method_t method,
+                                     decoder_t::modifier_t m)
+{
+  std::stringstream layout;
+  layout.precision(17);
+  for(const auto& p : spkpos)
+    layout << p.x << " " << p.y << " " << p.z << " ";
+  std::stringstream key;
+  key << "hoadecoder v" << format_version << " " << order << " " << method
+      << " " << m << " " << spkpos.size() << " " << std::hex
+      << TASCAR::diskcache_t::hash(layout.str());
+  return key.str();
+}
+
+std::shared_future<decoder_cache_t::matrix_t>
+decoder_cache_t::request(uint32_t order,
+                         const std::vector<TASCAR::pos_t>& spkpos,
+                         decoder_t::method_t method, decoder_t::modifier_t m)
+{
+  std::string key(get_key(order, spkpos, method, m));
+  std::lock_guard<std::mutex> lock(mtx);
+  auto it(entries.find(key));
+  if(it != entries.end()) {
+    ++num_memory_hits;
+    return it->second;
+  }
+  std::packaged_task<matrix_t()> job(
+      std::bind(&decoder_cache_t::compute, this, key, order, spkpos, method,
+                m));
+  std::shared_future<matrix_t> f(job.get_future().share());
+  entries[key] = f;
+  {
+    // workers are started on demand, up to the configured number:
+    std::lock_guard<std::mutex> lockw(mtxworkers);
+    jobs.push_back(std::move(job));
+    if(workers.size() < std::min((size_t)maxworkers, jobs.size()))
+      workers.emplace_back(&decoder_cache_t::workerthread, this);
+  }
+  cvworkers.notify_one();
+  return f;
+}
+
+void decoder_cache_t::clear()
+{
+  std::lock_guard<std::mutex> lock(mtx);
+  entries.clear();
+}
+
+decoder_cache_t::matrix_t
+decoder_cache_t::compute(const std::string& key, uint32_t order,
+                         const std::vector<TASCAR::pos_t>& spkpos,
+                         decoder_t::method_t method, decoder_t::modifier_t m)
+{
+  try {
+    std::vector<float> data;
+    TASCAR::diskcache_t diskcache("hoadecoder");
+    uint32_t amb_channels((order + 1) * (order + 1));
+    if(usediskcache && diskcache.read(key, data) &&
+       (data.size() == amb_channels * spkpos.size())) {
+      ++num_disk_hits;
+    } else {
+      decoder_t dec;
+      if(method == decoder_t::allrad)
+        dec.create_allrad(order, spkpos);
+      else
+        dec.create_pinv(order, spkpos);
+      dec.modify(m);
+      data.clear();
+      for(uint32_t acn = 0; acn < amb_channels; ++acn)
+        for(uint32_t ch = 0; ch < spkpos.size(); ++ch)
+          data.push_back(dec(acn, ch));
+      ++num_computed;
+      if(usediskcache)
+        diskcache.write(key, data);
+    }
+    return std::make_shared<const std::vector<float>>(data);
+  }
+  catch(...) {
+    // do not keep failed designs, the next request will retry:
+    std::lock_guard<std::mutex> lock(mtx);
+    entries.erase(key);
+    throw;
+  }
+}
+
 /*
  * This function is taken from Ambisonics Decoder Toolbox by A. Heller
  * (https://bitbucket.org/ambidecodertoolbox/adt/src/master/)
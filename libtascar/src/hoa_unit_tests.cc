@@ -20,6 +20,7 @@
 #include <gtest/gtest.h>
 
 #include "hoa.h"
+#include <filesystem>
 
 TEST(legendre_poly,coefficients)
 {
@@ -224,6 +225,151 @@ TEST(legendre_poly,inphase_gm)
   }
 }
 
+namespace {
+
+  /// Speaker layout of two rings and a top speaker, rotated by rot
+  std::vector<TASCAR::pos_t> ring_layout(uint32_t n, double rot)
+  {
+    std::vector<TASCAR::pos_t> layout;
+    for(uint32_t k = 0; k < n; ++k) {
+      TASCAR::pos_t p;
+      p.set_sphere(1.0, TASCAR_2PI * k / n + rot, 0.0);
+      layout.push_back(p);
+      p.set_sphere(1.0, TASCAR_2PI * (k + 0.5) / n + rot, 0.7);
+      layout.push_back(p);
+    }
+    layout.push_back(TASCAR::pos_t(0, 0, 1));
+    layout.push_back(TASCAR::pos_t(0.1, 0, -1));
+    return layout;
+  }
+
+} // namespace
+
+TEST(decoder_cache_t, cached_matrix)
+{
+  auto dir(std::filesystem::temp_directory_path() / "tascar_hoa_test");
+  std::filesystem::remove_all(dir);
+  TASCAR::config_forceoverwrite("tascar.cachedir", dir.string());
+  HOA::decoder_cache_t& cache(HOA::decoder_cache_t::get());
+  cache.clear();
+  auto layout(ring_layout(8, 0.1));
+  for(auto method : {HOA::decoder_t::pinv, HOA::decoder_t::allrad}) {
+    HOA::decoder_t ref;
+    if(method == HOA::decoder_t::pinv)
+      ref.create_pinv(3, layout);
+    else
+      ref.create_allrad(3, layout);
+    ref.modify(HOA::decoder_t::maxre);
+    size_t computed(cache.get_num_computed());
+    HOA::decoder_t dec;
+    dec.create(3, layout, method, HOA::decoder_t::maxre);
+    EXPECT_EQ(computed + 1u, cache.get_num_computed());
+    for(uint32_t acn = 0; acn < 16; ++acn)
+      for(uint32_t ch = 0; ch < layout.size(); ++ch)
+        ASSERT_EQ(ref(acn, ch), dec(acn, ch));
+    EXPECT_EQ(ref.to_string(), dec.to_string());
+    // same layout is taken from memory:
+    size_t hits(cache.get_num_memory_hits());
+    HOA::decoder_t dec2;
+    dec2.create(3, layout, method, HOA::decoder_t::maxre);
+    EXPECT_EQ(hits + 1u, cache.get_num_memory_hits());
+    // and from disk when not in memory:
+    cache.clear();
+    hits = cache.get_num_disk_hits();
+    HOA::decoder_t dec3;
+    dec3.create(3, layout, method, HOA::decoder_t::maxre);
+    EXPECT_EQ(hits + 1u, cache.get_num_disk_hits());
+    for(uint32_t acn = 0; acn < 16; ++acn)
+      for(uint32_t ch = 0; ch < layout.size(); ++ch)
+        ASSERT_EQ(ref(acn, ch), dec3(acn, ch));
+  }
+  // different modifier, order or layout is a different key:
+  auto key(HOA::decoder_cache_t::get_key(3, layout, HOA::decoder_t::allrad,
+                                         HOA::decoder_t::maxre));
+  EXPECT_NE(key, HOA::decoder_cache_t::get_key(3, layout,
+                                               HOA::decoder_t::allrad,
+                                               HOA::decoder_t::basic));
+  EXPECT_NE(key, HOA::decoder_cache_t::get_key(4, layout,
+                                               HOA::decoder_t::allrad,
+                                               HOA::decoder_t::maxre));
+  layout[0].x += 1e-6;
+  EXPECT_NE(key, HOA::decoder_cache_t::get_key(3, layout,
+                                               HOA::decoder_t::allrad,
+                                               HOA::decoder_t::maxre));
+  cache.clear();
+  std::filesystem::remove_all(dir);
+}
+
+TEST(decoder_cache_t, parallel_startup)
+{
+  // startup of six ALLRAD receivers with four different layouts:
+  auto dir(std::filesystem::temp_directory_path() / "tascar_hoa_test");
+  std::filesystem::remove_all(dir);
+  TASCAR::config_forceoverwrite("tascar.cachedir", dir.string());
+  HOA::decoder_cache_t& cache(HOA::decoder_cache_t::get());
+  cache.clear();
+  const uint32_t order(5);
+  std::vector<std::vector<TASCAR::pos_t>> layouts;
+  for(uint32_t k = 0; k < 6; ++k)
+    layouts.push_back(ring_layout(16, 0.1 * (k % 4)));
+  std::vector<HOA::decoder_t> refs(layouts.size());
+  for(size_t k = 0; k < layouts.size(); ++k) {
+    refs[k].create_allrad(order, layouts[k]);
+    refs[k].modify(HOA::decoder_t::maxre);
+  }
+  auto startup([&]() {
+    std::vector<HOA::decoder_t> decs(layouts.size());
+    for(size_t k = 0; k < layouts.size(); ++k)
+      decs[k].request(order, layouts[k], HOA::decoder_t::allrad,
+                      HOA::decoder_t::maxre);
+    for(auto& dec : decs)
+      dec.wait();
+    // matrices are bitwise identical to direct design:
+    for(size_t k = 0; k < layouts.size(); ++k)
+      EXPECT_EQ(refs[k].to_string(), decs[k].to_string());
+  });
+  // nothing cached, each layout is computed once:
+  size_t computed(cache.get_num_computed());
+  size_t memhits(cache.get_num_memory_hits());
+  size_t diskhits(cache.get_num_disk_hits());
+  startup();
+  EXPECT_EQ(computed + 4u, cache.get_num_computed());
+  EXPECT_EQ(memhits + 2u, cache.get_num_memory_hits());
+  EXPECT_EQ(diskhits, cache.get_num_disk_hits());
+  // from disk cache:
+  cache.clear();
+  startup();
+  EXPECT_EQ(computed + 4u, cache.get_num_computed());
+  EXPECT_EQ(memhits + 4u, cache.get_num_memory_hits());
+  EXPECT_EQ(diskhits + 4u, cache.get_num_disk_hits());
+  // from memory:
+  startup();
+  EXPECT_EQ(computed + 4u, cache.get_num_computed());
+  EXPECT_EQ(memhits + 10u, cache.get_num_memory_hits());
+  EXPECT_EQ(diskhits + 4u, cache.get_num_disk_hits());
+  // the number of worker threads is bounded:
+  EXPECT_LE(cache.get_num_workers(),
+            (size_t)std::max(1u, std::thread::hardware_concurrency()));
+  EXPECT_GE(cache.get_num_workers(), 1u);
+  cache.clear();
+  std::filesystem::remove_all(dir);
+}
+
+TEST(decoder_cache_t, failed_design)
+{
+  HOA::decoder_cache_t& cache(HOA::decoder_cache_t::get());
+  cache.clear();
+  std::vector<TASCAR::pos_t> empty;
+  size_t memhits(cache.get_num_memory_hits());
+  for(uint32_t k = 0; k < 2; ++k) {
+    auto f(cache.request(3, empty, HOA::decoder_t::allrad,
+                         HOA::decoder_t::maxre));
+    EXPECT_THROW(f.get(), TASCAR::ErrMsg);
+  }
+  // failed designs are not kept in memory:
+  EXPECT_EQ(memhits, cache.get_num_memory_hits());
+}
+
 // Local Variables:
 // compile-command: "make -C ../.. unit-tests"
 // coding: utf-8-unix
@@ -0,0 +1,321 @@
+/*
+ * This file is part of the TASCAR software, see <http://tascar.org/>
+ *
+ * Copyright (c) 2018 Giso Grimm
+ * Copyright (c) 2020 Giso Grimm
+ * Copyright (c) 2021 Giso Grimm
+ */
+/*
+ * TASCAR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, version 3 of the License.
+ *
+ * TASCAR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHATABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License, version 3 for more details.
+ *
+ * You should have received a copy of the GNU General Public License,
+ * Version 3 along with TASCAR. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "hoafdn.h"
+#include "defs.h"
+#include "errorhandling.h"
+#include "fft.h"
+#include <cmath>
+#include <iostream>
+#include <string.h>
+
+using namespace TASCAR;
+
+static const std::complex<float> i_f(0.0f, 1.0f);
+static const std::complex<double> i_d(0.0, 1.0);
+
+cmat3_t::cmat3_t(uint32_t d1, uint32_t d2, uint32_t d3)
+    : s1(d1), s2(d2), s3(d3), s23(s2 * s3), data(s1 * s2 * s3)
+{
+  clear();
+}
+
+cmat2_t::cmat2_t(uint32_t d1, uint32_t d2) : s1(d1), s2(d2), data(s1 * s2)
+{
+  clear();
+}
+
+cmat1_t::cmat1_t(uint32_t d1) : s1(d1), data(s1)
+{
+  clear();
+}
+
+hoa2d_reflectionfilter_t::hoa2d_reflectionfilter_t(uint32_t d1, uint32_t d2)
+    : B1(0), A2(0), sy(d1, d2), sapx(d1, d2), sapy(d1, d2)
+{
+  eta.resize(d1);
+  for(uint32_t k = 0; k < d1; ++k)
+    eta[k] = 0.87f * (float)k / (float)(d1 - 1);
+}
+
+void hoa2d_reflectionfilter_t::set_lp(float g, float c)
+{
+  sy.clear();
+  sapx.clear();
+  sapy.clear();
+  float c2(1.0f - c);
+  B1 = g * c2;
+  A2 = -c;
+}
+
+hoa2d_fdn_t::feedback_t TASCAR::hoa2d_fdn_feedback_type(const std::string& s)
+{
+  if(s == "dense")
+    return hoa2d_fdn_t::dense;
+  if(s == "householder")
+    return hoa2d_fdn_t::householder;
+  if(s == "hadamard")
+    return hoa2d_fdn_t::hadamard;
+  throw TASCAR::ErrMsg("Invalid feedback matrix type \"" + s +
+                       "\" (valid: dense, householder, hadamard).");
+}
+
+hoa2d_fdn_t::hoa2d_fdn_t(uint32_t fdnorder, uint32_t amborder,
+                         uint32_t maxdelay, bool logdelays, bool dumpmatrix_,
+                         feedback_t fb, uint32_t maxblock)
+    : logdelays_(logdelays), fdnorder_(fdnorder), amborder1(amborder + 1),
+      maxdelay_(maxdelay), feedback_(fb), maxblock_(std::max(1u, maxblock)),
+      delayline(fdnorder_, maxdelay_, amborder1),
+      feedbackmat(fdnorder_, fdnorder_, amborder1),
+      reflection(fdnorder, amborder1), prefilt(2, amborder1),
+      rotation(fdnorder, amborder1), dlout(fdnorder_, amborder1),
+      dlblock(fdnorder_, (fb == dense) ? 1u : maxblock_, amborder1),
+      delay(new uint32_t[fdnorder_]), pos(new uint32_t[fdnorder_]),
+      mindelay(2u), dumpmatrix(dumpmatrix_), inval(amborder1),
+      outval(amborder1)
+{
+  if((feedback_ == hadamard) && (fdnorder_ & (fdnorder_ - 1u)))
+    throw TASCAR::ErrMsg("The FDN order must be a power of two for Hadamard "
+                         "feedback matrices (fdnorder=" +
+                         std::to_string(fdnorder_) + ").");
+  memset(delay, 0, sizeof(uint32_t) * fdnorder_);
+  memset(pos, 0, sizeof(uint32_t) * fdnorder_);
+}
+
+hoa2d_fdn_t::~hoa2d_fdn_t()
+{
+  delete[] delay;
+  delete[] pos;
+}
+
+void hoa2d_fdn_t::apply_feedback(cmat2_t& x) const
+{
+  if(fdnorder_ < 2u)
+    return;
+  switch(feedback_) {
+  case dense:
+    break;
+  case householder: {
+    // A = I - 2/N 1 1^T:
+    const float scale(2.0f / (float)fdnorder_);
+    for(uint32_t o = 0; o < amborder1; ++o) {
+      std::complex<float> sum(0.0f);
+      for(uint32_t tap = 0; tap < fdnorder_; ++tap)
+        sum += x.elem(tap, o);
+      sum *= scale;
+      for(uint32_t tap = 0; tap < fdnorder_; ++tap)
+        x.elem(tap, o) -= sum;
+    }
+  } break;
+  case hadamard: {
+    // in-place fast Walsh-Hadamard transform, normalized to be unitary:
+    for(uint32_t h = 1; h < fdnorder_; h *= 2u)
+      for(uint32_t k = 0; k < fdnorder_; k += 2u * h)
+        for(uint32_t j = k; j < k + h; ++j)
+          for(uint32_t o = 0; o < amborder1; ++o) {
+            std::complex<float> a(x.elem(j, o));
+            std::complex<float> b(x.elem(j + h, o));
+            x.elem(j, o) = a + b;
+            x.elem(j + h, o) = a - b;
+          }
+    const float scale(1.0f / sqrtf((float)fdnorder_));
+    for(uint32_t tap = 0; tap < fdnorder_; ++tap)
+      for(uint32_t o = 0; o < amborder1; ++o)
+        x.elem(tap, o) *= scale;
+  } break;
+  }
+}
+
+void hoa2d_fdn_t::process(cmat2_t& in, cmat2_t& out, uint32_t n,
+                          bool b_prefilt)
+{
+  if(b_prefilt)
+    for(uint32_t t = 0; t < n; ++t)
+      for(uint32_t o = 0; o < amborder1; ++o) {
+        prefilt.filter(in.elem(t, o), 0, o);
+        prefilt.filter(in.elem(t, o), 1, o);
+      }
+  if(feedback_ == dense) {
+    for(uint32_t t = 0; t < n; ++t) {
+      for(uint32_t o = 0; o < amborder1; ++o)
+        inval.elem(o) = in.elem(t, o);
+      process(false);
+      for(uint32_t o = 0; o < amborder1; ++o)
+        out.elem(t, o) = outval.elem(o);
+    }
+    return;
+  }
+  const uint32_t blocklen(std::min(maxblock_, mindelay));
+  uint32_t t0(0);
+  while(t0 < n) {
+    uint32_t nsub(std::min(blocklen, n - t0));
+    process_subblock(in, out, t0, nsub);
+    t0 += nsub;
+  }
+}
+
+void hoa2d_fdn_t::process_subblock(cmat2_t& in, cmat2_t& out, uint32_t t0,
+                                   uint32_t n)
+{
+  // n does not exceed the shortest delay, thus all delay line outputs
+  // of this block were written before the block started. Read the
+  // whole block per path, apply reflection filters and rotation:
+  for(uint32_t tap = 0; tap < fdnorder_; ++tap) {
+    uint32_t p(pos[tap]);
+    for(uint32_t t = 0; t < n; ++t) {
+      for(uint32_t o = 0; o < amborder1; ++o) {
+        std::complex<float> tmp(delayline.elem(tap, p, o));
+        reflection.filter(tmp, tap, o);
+        tmp *= rotation.elem(tap, o);
+        dlblock.elem(tap, t, o) = tmp;
+      }
+      if(!p)
+        p = delay[tap];
+      if(p)
+        --p;
+    }
+  }
+  for(uint32_t t = 0; t < n; ++t) {
+    for(uint32_t o = 0; o < amborder1; ++o)
+      out.elem(t0 + t, o) = 0.0f;
+    for(uint32_t tap = 0; tap < fdnorder_; ++tap)
+      for(uint32_t o = 0; o < amborder1; ++o) {
+        out.elem(t0 + t, o) += dlblock.elem(tap, t, o);
+        dlout.elem(tap, o) = dlblock.elem(tap, t, o);
+      }
+    // apply structured feedback matrix:
+    apply_feedback(dlout);
+    // put feedback signal and input into delay line:
+    for(uint32_t tap = 0; tap < fdnorder_; ++tap) {
+      for(uint32_t o = 0; o < amborder1; ++o)
+        delayline.elem(tap, pos[tap], o) =
+            in.elem(t0 + t, o) + dlout.elem(tap, o);
+      // iterate delayline:
+      if(!pos[tap])
+        pos[tap] = delay[tap];
+      if(pos[tap])
+        --pos[tap];
+    }
+  }
+  for(uint32_t o = 0; o < amborder1; ++o)
+    outval.elem(o) = out.elem(t0 + n - 1, o);
+}
+
+/**
+   \brief Set parameters of FDN
+   \param az Average rotation in radians per reflection
+   \param daz Spread of rotation in radians per reflection
+   \param t Average/maximum delay in samples
+   \param dt Spread of delay in samples
+   \param g Gain
+   \param damping Damping
+ */
+void hoa2d_fdn_t::setpar(float az, float daz, float t, float dt, float g,
+                         float damping)
+{
+  // set reflection filters:
+  reflection.set_lp(g, damping);
+  prefilt.set_lp(g, damping);
+  // set delays:
+  delayline.clear();
+  mindelay = maxdelay_;
+  for(uint32_t tap = 0; tap < fdnorder_; ++tap) {
+    float t_(t);
+    if(logdelays_) {
+      if(fdnorder_ > 1)
+        t_ = dt * pow(t / dt, (float)tap / ((float)fdnorder_ - 1.0f));
+      ;
+    } else {
+      if(fdnorder_ > 1)
+        t_ = t - dt +
+             2.0f * dt * powf((float)tap * 1.0f / (float)fdnorder_, 0.5f);
+    }
+    uint32_t d((uint32_t)std::max(0.0f, t_));
+    delay[tap] = std::max(2u, std::min(maxdelay_ - 1u, d));
+    mindelay = std::min(mindelay, delay[tap]);
+  }
+  // set rotation:
+  for(uint32_t tap = 0; tap < fdnorder_; ++tap) {
+    float laz(az);
+    if(fdnorder_ > 1)
+      laz = az - daz + 2.0f * daz * (float)tap / ((float)fdnorder_ - 1.0f);
+    std::complex<float> caz(std::exp(i_f * laz));
+    rotation.elem(tap, 0) = 1.0;
+    for(uint32_t o = 1; o < amborder1; ++o) {
+      rotation.elem(tap, o) = rotation.elem(tap, o - 1) * caz;
+    }
+  }
+  // set feedback matrix:
+  feedbackmat.clear();
+  if(fdnorder_ > 1) {
+    if(feedback_ == dense) {
+      TASCAR::fft_t fft(fdnorder_);
+      TASCAR::spec_t eigenv(fdnorder_ / 2 + 1);
+      for(uint32_t k = 0; k < eigenv.n_; ++k)
+        eigenv[k] = std::exp(i_d * TASCAR_2PI *
+                             pow((double)k / (0.5 * fdnorder_), 2.0));
+      ;
+      fft.execute(eigenv);
+      for(uint32_t itap = 0; itap < fdnorder_; ++itap) {
+        for(uint32_t otap = 0; otap < fdnorder_; ++otap) {
+          feedbackmat.elem(itap, otap, 0) =
+              fft.w[(otap + fdnorder_ - itap) % fdnorder_];
+          for(uint32_t o = 1; o < amborder1; ++o)
+            feedbackmat.elem(itap, otap, o) =
+                feedbackmat.elem(itap, otap, o - 1);
+        }
+      }
+    } else if(dumpmatrix) {
+      // the structured matrix is never stored, only needed for display:
+      cmat2_t unit(fdnorder_, amborder1);
+      for(uint32_t otap = 0; otap < fdnorder_; ++otap) {
+        unit.clear();
+        for(uint32_t o = 0; o < amborder1; ++o)
+          unit.elem(otap, o) = 1.0f;
+        apply_feedback(unit);
+        for(uint32_t itap = 0; itap < fdnorder_; ++itap)
+          for(uint32_t o = 0; o < amborder1; ++o)
+            feedbackmat.elem(itap, otap, o) = unit.elem(itap, o);
+      }
+    }
+  } else {
+    for(uint32_t o = 0; o < amborder1; ++o)
+      feedbackmat.elem00x(o) = 1.0;
+  }
+  if(dumpmatrix) {
+    std::cout << "m=[..." << std::endl;
+    for(uint32_t itap = 0; itap < fdnorder_; ++itap) {
+      for(uint32_t otap = 0; otap < fdnorder_; ++otap)
+        std::cout << std::real(feedbackmat.elem(itap, otap, 0)) << "  ";
+      std::cout << ";..." << std::endl;
+    }
+    std::cout << "];" << std::endl;
+  }
+}
+
+/*
+ * Local Variables:
+ * mode: c++
+ * c-basic-offset: 2
+ * indent-tabs-mode: nil
+ * compile-command: "make -C .."
+ * End:
+ */
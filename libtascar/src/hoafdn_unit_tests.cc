@@ -0,0 +1,234 @@
+/*
+ * This file is part of the TASCAR software, see <http://tascar.org/>
+ *
+ * Copyright (c) 2026 agent
+ */
+/*
+ * TASCAR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, version 3 of the License.
+ *
+ * TASCAR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHATABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License, version 3 for more details.
+ *
+ * You should have received a copy of the GNU General Public License,
+ * Version 3 along with TASCAR. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "errorhandling.h"
+#include "hoafdn.h"
+#include <cmath>
+
+using namespace TASCAR;
+
+namespace {
+
+  const float fs = 16000.0f;
+  const float t_mean = 0.03f;
+  const float t_spread = 0.01f;
+  const float decay = 0.5f;
+  const float damping = 0.3f;
+
+  void setpar(hoa2d_fdn_t& fdn)
+  {
+    fdn.setpar(0.3f, 0.1f, fs * t_mean, fs * t_spread,
+               expf(-t_mean / decay), damping);
+  }
+
+  /**
+     Render impulse response, return energy per sample (summed across
+     orders).
+   */
+  std::vector<float> get_ir_energy(hoa2d_fdn_t& fdn, uint32_t amborder,
+                                   uint32_t len, uint32_t blocksize)
+  {
+    std::vector<float> energy;
+    cmat2_t in(blocksize, amborder + 1);
+    cmat2_t out(blocksize, amborder + 1);
+    for(uint32_t k = 0; k < len; k += blocksize) {
+      in.clear();
+      if(k == 0)
+        for(uint32_t o = 0; o < amborder + 1; ++o)
+          in.elem(0, o) = 1.0f;
+      fdn.process(in, out, blocksize, false);
+      for(uint32_t t = 0; t < blocksize; ++t) {
+        float e(0.0f);
+        for(uint32_t o = 0; o < amborder + 1; ++o)
+          e += std::norm(out.elem(t, o));
+        energy.push_back(e);
+      }
+    }
+    return energy;
+  }
+
+  /**
+     Estimate decay time from Schroeder integral, fitting the range
+     from -5 dB to -25 dB.
+   */
+  float get_t60(const std::vector<float>& energy)
+  {
+    std::vector<double> edc(energy.size());
+    double sum(0.0);
+    for(size_t k = energy.size(); k > 0; --k) {
+      sum += energy[k - 1];
+      edc[k - 1] = sum;
+    }
+    double t5(0.0);
+    double t25(0.0);
+    for(size_t k = 0; k < edc.size(); ++k) {
+      double l(10.0 * log10(edc[k] / edc[0]));
+      if((t5 == 0.0) && (l <= -5.0))
+        t5 = k / fs;
+      if((t25 == 0.0) && (l <= -25.0))
+        t25 = k / fs;
+    }
+    return (float)(3.0 * (t25 - t5));
+  }
+
+} // namespace
+
+TEST(hoa2d_fdn_t, feedback_type)
+{
+  EXPECT_EQ(hoa2d_fdn_t::dense, hoa2d_fdn_feedback_type("dense"));
+  EXPECT_EQ(hoa2d_fdn_t::householder, hoa2d_fdn_feedback_type("householder"));
+  EXPECT_EQ(hoa2d_fdn_t::hadamard, hoa2d_fdn_feedback_type("hadamard"));
+  EXPECT_THROW(hoa2d_fdn_feedback_type("circulant"), TASCAR::ErrMsg);
+  EXPECT_THROW(hoa2d_fdn_t(6, 1, 100, false, false, hoa2d_fdn_t::hadamard),
+               TASCAR::ErrMsg);
+}
+
+TEST(hoa2d_fdn_t, feedback_unitary)
+{
+  const uint32_t N(8);
+  const uint32_t O(3);
+  for(auto fb : {hoa2d_fdn_t::householder, hoa2d_fdn_t::hadamard}) {
+    hoa2d_fdn_t fdn(N, O - 1, 100, false, false, fb);
+    cmat2_t x(N, O);
+    float e_in(0.0f);
+    for(uint32_t tap = 0; tap < N; ++tap)
+      for(uint32_t o = 0; o < O; ++o) {
+        x.elem(tap, o) = std::complex<float>(sinf(1.3f * tap + o), 0.1f * o);
+        e_in += std::norm(x.elem(tap, o));
+      }
+    fdn.apply_feedback(x);
+    float e_out(0.0f);
+    for(uint32_t tap = 0; tap < N; ++tap)
+      for(uint32_t o = 0; o < O; ++o)
+        e_out += std::norm(x.elem(tap, o));
+    EXPECT_NEAR(e_in, e_out, 1e-4f * e_in);
+  }
+}
+
+TEST(hoa2d_fdn_t, block_equals_sample)
+{
+  // block processing of structured feedback must be identical to
+  // processing sample by sample:
+  const uint32_t N(8);
+  const uint32_t amborder(2);
+  for(auto fb : {hoa2d_fdn_t::householder, hoa2d_fdn_t::hadamard}) {
+    hoa2d_fdn_t fdn1(N, amborder, fs, false, false, fb, 1);
+    hoa2d_fdn_t fdn2(N, amborder, fs, false, false, fb, 256);
+    setpar(fdn1);
+    setpar(fdn2);
+    EXPECT_GE(fdn2.get_mindelay(), 256u);
+    auto e1(get_ir_energy(fdn1, amborder, 4096, 1));
+    auto e2(get_ir_energy(fdn2, amborder, 4096, 256));
+    ASSERT_EQ(e1.size(), e2.size());
+    for(size_t k = 0; k < e1.size(); ++k)
+      ASSERT_NEAR(e1[k], e2[k], 1e-5f * (1.0f + e1[k]));
+  }
+}
+
+TEST(hoa2d_fdn_t, energy_decay)
+{
+  // the structured feedback matrices are unitary, thus the energy
+  // decay is the same as for the dense circulant matrix:
+  const uint32_t N(16);
+  const uint32_t amborder(2);
+  const uint32_t len(fs);
+  hoa2d_fdn_t fdn_dense(N, amborder, fs, false, false, hoa2d_fdn_t::dense);
+  hoa2d_fdn_t fdn_hh(N, amborder, fs, false, false, hoa2d_fdn_t::householder,
+                     64);
+  hoa2d_fdn_t fdn_had(N, amborder, fs, false, false, hoa2d_fdn_t::hadamard,
+                      64);
+  setpar(fdn_dense);
+  setpar(fdn_hh);
+  setpar(fdn_had);
+  auto e_dense(get_ir_energy(fdn_dense, amborder, len, 64));
+  auto e_hh(get_ir_energy(fdn_hh, amborder, len, 64));
+  auto e_had(get_ir_energy(fdn_had, amborder, len, 64));
+  float t60_dense(get_t60(e_dense));
+  float t60_hh(get_t60(e_hh));
+  float t60_had(get_t60(e_had));
+  EXPECT_GT(t60_dense, 0.0f);
+  EXPECT_NEAR(t60_dense, t60_hh, 0.1f * t60_dense);
+  EXPECT_NEAR(t60_dense, t60_had, 0.1f * t60_dense);
+  // total energy, differences are caused by the coherent sum of the
+  // first reflections:
+  double sum_dense(0.0);
+  double sum_had(0.0);
+  for(size_t k = 0; k < e_dense.size(); ++k) {
+    sum_dense += e_dense[k];
+    sum_had += e_had[k];
+  }
+  EXPECT_NEAR(10.0 * log10(sum_dense), 10.0 * log10(sum_had), 3.0);
+}
+
+TEST(hoa2d_fdn_t, split_blocks)
+{
+  // processing a period in several shorter blocks must give the same
+  // output as processing it at once:
+  const uint32_t N(64);
+  const uint32_t amborder(3);
+  const uint32_t maxblock(256);
+  const uint32_t len(4 * maxblock);
+  hoa2d_fdn_t fdn1(N, amborder, fs, false, false, hoa2d_fdn_t::hadamard,
+                   maxblock);
+  hoa2d_fdn_t fdn2(N, amborder, fs, false, false, hoa2d_fdn_t::hadamard,
+                   maxblock);
+  setpar(fdn1);
+  setpar(fdn2);
+  cmat2_t in(maxblock, amborder + 1);
+  cmat2_t out1(maxblock, amborder + 1);
+  cmat2_t out2(maxblock, amborder + 1);
+  cmat2_t out(maxblock, amborder + 1);
+  const std::vector<uint32_t> split = {100u, 37u, 119u};
+  for(uint32_t k = 0; k < len; k += maxblock) {
+    in.clear();
+    if(k == 0)
+      for(uint32_t o = 0; o < amborder + 1; ++o)
+        in.elem(0, o) = 1.0f;
+    fdn1.process(in, out1, maxblock, false);
+    uint32_t t0(0);
+    for(auto n : split) {
+      cmat2_t subin(maxblock, amborder + 1);
+      for(uint32_t t = 0; t < n; ++t)
+        for(uint32_t o = 0; o < amborder + 1; ++o)
+          subin.elem(t, o) = in.elem(t0 + t, o);
+      fdn2.process(subin, out, n, false);
+      for(uint32_t t = 0; t < n; ++t)
+        for(uint32_t o = 0; o < amborder + 1; ++o)
+          out2.elem(t0 + t, o) = out.elem(t, o);
+      t0 += n;
+    }
+    ASSERT_EQ(maxblock, t0);
+    for(uint32_t t = 0; t < maxblock; ++t)
+      for(uint32_t o = 0; o < amborder + 1; ++o) {
+        ASSERT_NEAR(out1.elem(t, o).real(), out2.elem(t, o).real(), 1e-6f);
+        ASSERT_NEAR(out1.elem(t, o).imag(), out2.elem(t, o).imag(), 1e-6f);
+      }
+  }
+}
+
+/*
+ * Local Variables:
+ * mode: c++
+ * c-basic-offset: 2
+ * indent-tabs-mode: nil
+ * compile-command: "make -C .."
+ * End:
+ */
@@ -23,6 +23,7 @@
 // Author: Giso Grimm
 #include "irrender.h"
 #include "errorhandling.h"
+#include "irsynth.h"
 
 #include <string.h>
 #include <unistd.h>
@@ -30,7 +31,8 @@
 TASCAR::wav_render_t::wav_render_t(const std::string& tscname,
                                    const std::string& scene_, bool verbose)
     : session_core_t(tscname, LOAD_FILE, tscname), scene(scene_), pscene(NULL),
-      verbose_(verbose), t0(clock()), t1(clock()), t2(clock())
+      verbose_(verbose), sparse_ir(false), sparse_fragsize(64u), t0(clock()),
+      t1(clock()), t2(clock())
 {
   read_xml();
   std::string name;
@@ -67,6 +69,12 @@ void TASCAR::wav_render_t::add_scene(tsccfg::node_t sne)
   }
 }
 
+void TASCAR::wav_render_t::set_sparse_ir(bool sparse, uint32_t fragsize)
+{
+  sparse_ir = sparse;
+  sparse_fragsize = std::max(1u, fragsize);
+}
+
 void TASCAR::wav_render_t::set_ism_order_range(uint32_t ism_min,
                                                uint32_t ism_max)
 {
@@ -293,7 +301,17 @@ void TASCAR::wav_render_t::render_ir(uint32_t len, double fs,
       isnd != pscene->sounds.end(); ++isnd) {
     (*isnd)->maxdist = maxdist;
   }
-  chunk_cfg_t cf(fs, len);
+  bool sparse(sparse_ir);
+  if(sparse) {
+    std::string reason;
+    if(!ir_synthesizer_t::is_supported(*pscene, inputchannel, reason)) {
+      TASCAR::add_warning("Sparse impulse response synthesis is not "
+                          "possible, " +
+                          reason + ". Processing the complete signal chain.");
+      sparse = false;
+    }
+  }
+  chunk_cfg_t cf(fs, sparse ? std::min(len, sparse_fragsize) : len);
   // initialize scene:
   pscene->prepare(cf);
   pscene->post_prepare();
@@ -328,13 +346,26 @@ void TASCAR::wav_render_t::render_ir(uint32_t len, double fs,
   tp.session_time_samples = starttime * fs;
   tp.object_time_seconds = starttime;
   tp.object_time_samples = starttime * fs;
-  pscene->process(len, tp, a_in, a_out);
-  if(verbose_)
-    std::cerr << "rendering " << pscene->active_pointsources << " of "
-              << pscene->total_pointsources << " point sources.\n";
-  a_in[inputchannel][0] = 1.0f;
-  // process audio:
-  pscene->process(len, tp, a_in, a_out);
+  if(sparse) {
+    ir_synthesizer_t synth(*pscene);
+    t1 = clock();
+    synth.process(len, tp, inputchannel, a_out);
+    t2 = clock();
+    if(verbose_)
+      std::cerr << "synthesized " << synth.get_num_paths() << " of "
+                << pscene->total_pointsources << " sound paths ("
+                << synth.get_num_taps() << " samples).\n";
+  } else {
+    pscene->process(len, tp, a_in, a_out);
+    if(verbose_)
+      std::cerr << "rendering " << pscene->active_pointsources << " of "
+                << pscene->total_pointsources << " point sources.\n";
+    a_in[inputchannel][0] = 1.0f;
+    // process audio:
+    t1 = clock();
+    pscene->process(len, tp, a_in, a_out);
+    t2 = clock();
+  }
   // save audio:
   for(uint32_t kf = 0; kf < len; ++kf)
     for(uint32_t kc = 0; kc < nch_out; ++kc)
@@ -0,0 +1,166 @@
+/*
+ * This file is part of the TASCAR software, see <http://tascar.org/>
+ *
+ * Copyright (c) 2026 agent
+ */
+/*
+ * TASCAR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, version 3 of the License.
+ *
+ * TASCAR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHATABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License, version 3 for more details.
+ *
+ * You should have received a copy of the GNU General Public License,
+ * Version 3 along with TASCAR. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "irsynth.h"
+#include "errorhandling.h"
+#include <set>
+
+TASCAR::ir_synthesizer_t::ir_synthesizer_t(render_core_t& scene_,
+                                           float threshold_)
+    : scene(scene_), threshold(threshold_)
+{
+}
+
+bool TASCAR::ir_synthesizer_t::is_supported(const render_core_t& scene,
+                                            uint32_t inputchannel,
+                                            std::string& reason)
+{
+  if(!scene.diffuse_reverbs.empty()) {
+    reason = "the scene contains diffuse reverbs";
+    return false;
+  }
+  for(auto rec : scene.receivermod_objects)
+    if(rec->clusters > 0u) {
+      reason = "receiver \"" + rec->get_name() + "\" uses source clustering";
+      return false;
+    }
+  for(auto obj : scene.diff_snd_field_objects)
+    if((inputchannel >= obj->get_port_index()) &&
+       (inputchannel < obj->get_port_index() + 4u)) {
+      reason = "the input channel belongs to a diffuse sound field";
+      return false;
+    }
+  return true;
+}
+
+void TASCAR::ir_synthesizer_t::process(uint32_t len,
+                                       const TASCAR::transport_t& tp,
+                                       uint32_t inputchannel,
+                                       const std::vector<float*>& output)
+{
+  std::string reason;
+  if(!is_supported(scene, inputchannel, reason))
+    throw TASCAR::ErrMsg("Sparse impulse response synthesis is not possible, " +
+                         reason + ".");
+  if(!scene.world)
+    throw TASCAR::ErrMsg("The scene is not prepared.");
+  const uint32_t fragsize(scene.n_fragment);
+  // settle geometry, gains and panning weights with a silent period:
+  std::vector<wave_t> zeros_in(scene.num_input_ports(), wave_t(fragsize));
+  std::vector<wave_t> zeros_out(scene.num_output_ports(), wave_t(fragsize));
+  std::vector<float*> a_in;
+  for(auto& w : zeros_in)
+    a_in.push_back(w.d);
+  std::vector<float*> a_out;
+  for(auto& w : zeros_out)
+    a_out.push_back(w.d);
+  scene.process(fragsize, tp, a_in, a_out);
+  std::vector<path_t> paths;
+  for(auto graph : scene.world->receivergraphs) {
+    bool memoryless(graph->get_receiver()->is_memoryless());
+    for(auto model : graph->acoustic_model)
+      if(model->rendered) {
+        paths.push_back(path_t());
+        paths.back().model = model;
+        paths.back().memoryless = memoryless;
+      }
+  }
+  // filter the source signals up to the delay line of each path, as
+  // long as there is a signal:
+  for(uint32_t t0 = 0; t0 < len; t0 += fragsize) {
+    std::set<const Acousticmodel::source_t*> active_sources;
+    for(auto snd : scene.sounds) {
+      for(uint32_t ch = 0; ch < snd->n_channels; ++ch) {
+        snd->inchannels[ch].clear();
+        if((t0 == 0) && (snd->get_port_index() + ch == inputchannel))
+          snd->inchannels[ch].d[0] = 1.0f;
+      }
+      snd->process_plugins(tp);
+      snd->apply_gain();
+      for(auto& ch : snd->inchannels)
+        if(ch.maxabs() > 0.0f)
+          active_sources.insert(snd);
+    }
+    bool live(false);
+    for(auto& path : paths)
+      if(path.live || active_sources.count(path.model->src_)) {
+        const wave_t& audio(path.model->process_predelay());
+        path.input.resize(t0, 0.0f);
+        path.input.insert(path.input.end(), audio.d, audio.d + audio.n);
+        path.live = audio.maxabs() > threshold;
+        live |= path.live;
+      }
+    if(active_sources.empty() && (!live))
+      break;
+  }
+  num_paths = 0u;
+  num_taps = 0u;
+  for(auto& path : paths) {
+    path.model->get_path_response(path.input, threshold, len, path.offset,
+                                  path.h);
+    path.input = std::vector<float>();
+    if(!path.h.empty()) {
+      ++num_paths;
+      num_taps += path.h.size();
+    }
+  }
+  // render paths in receivers:
+  wave_t chunk(fragsize);
+  for(uint32_t t0 = 0; t0 < len; t0 += fragsize) {
+    const uint32_t t1(t0 + fragsize);
+    for(auto rec : scene.receivers)
+      rec->clear_output();
+    for(auto& path : paths) {
+      if(path.h.empty())
+        continue;
+      const uint32_t start(path.offset);
+      const uint32_t end(start + (uint32_t)path.h.size());
+      if((start >= t1) || (path.memoryless && (end <= t0)))
+        continue;
+      chunk.clear();
+      for(uint32_t t = std::max(t0, start); t < std::min(t1, end); ++t)
+        chunk.d[t - t0] = path.h[t - start];
+      // minimum level is applied to each period, as in
+      // acoustic_model_t::process():
+      const float minlevel(path.model->src_->minlevel);
+      if((minlevel > 0) && (chunk.rms() <= minlevel))
+        continue;
+      path.model->add_to_receiver(chunk);
+    }
+    for(auto rec : scene.receivers) {
+      rec->post_proc(tp);
+      rec->apply_gain();
+    }
+    for(auto rec : scene.receivermod_objects) {
+      float gain(rec->get_gain());
+      for(uint32_t ch = 0; ch < rec->n_channels; ++ch)
+        rec->outchannels[ch].copy_to(output[rec->get_port_index() + ch] + t0,
+                                     std::min(fragsize, len - t0), gain);
+    }
+  }
+}
+
+/*
+ * Local Variables:
+ * mode: c++
+ * c-basic-offset: 2
+ * indent-tabs-mode: nil
+ * compile-command: "make -C .."
+ * End:
+ */
@@ -26,7 +26,10 @@
 #include "jackclient.h"
 #include "defs.h"
 #include "errorhandling.h"
+#include "threadrole.h"
+#include "tictoctimer.h"
 #include "tscconfig.h"
+#include <errno.h>
 #include <jack/thread.h>
 #include <regex.h>
 #include <stdio.h>
@@ -35,6 +38,11 @@
 
 static std::string errmsg("");
 
+static void thread_init(void*)
+{
+  TASCAR::register_thread(TASCAR::thread_roles_t::audio);
+}
+
 jackc_portless_t::jackc_portless_t(const std::string& clientname)
     : srate(0), active(false), xruns(0), xrun_latency(0), shutdown(false)
 {
@@ -70,6 +78,7 @@ jackc_portless_t::jackc_portless_t(const std::string& clientname)
       err += "Client's protocol version does not match. ";
     throw TASCAR::ErrMsg(err);
   }
+  jack_set_thread_init_callback(jc, &thread_init, NULL);
   srate = jack_get_sample_rate(jc);
   fragsize = jack_get_buffer_size(jc);
   rtprio = jack_client_real_time_priority(jc);
@@ -292,6 +301,176 @@ void jackc_portless_t::connect(const std::string& src, const std::string& dest,
   }
 }
 
+jack_connection_planner_t::jack_connection_planner_t(jack_client_t* jc_)
+    : jc(jc_)
+{
+}
+
+void jack_connection_planner_t::update_graph()
+{
+  TASCAR::tictoc_t tictoc;
+  portnames.clear();
+  ports.clear();
+  const char** pp_ports(jack_get_ports(jc, NULL, JACK_DEFAULT_AUDIO_TYPE, 0));
+  if(pp_ports) {
+    for(const char** p = pp_ports; *p; ++p) {
+      jack_port_t* jp(jack_port_by_name(jc, *p));
+      if(!jp)
+        continue;
+      port_t& port(ports[*p]);
+      port.flags = jack_port_flags(jp);
+      port.mine = jack_port_is_mine(jc, jp);
+      const char** cons(jack_port_get_all_connections(jc, jp));
+      if(cons) {
+        for(const char** con = cons; *con; ++con)
+          port.connections.insert(*con);
+        jack_free(cons);
+      }
+      portnames.push_back(*p);
+    }
+    jack_free(pp_ports);
+  }
+  t_graph += tictoc.toc();
+}
+
+std::vector<std::string>
+jack_connection_planner_t::match(std::string pattern) const
+{
+  // same pattern rules as jack_get_ports(), see get_port_names_regexp():
+  if(pattern.size() && (pattern[0] != '^'))
+    pattern = "^" + pattern;
+  if(pattern.size() && (pattern[pattern.size() - 1] != '$'))
+    pattern = pattern + "$";
+  regex_t reg;
+  if(regcomp(&reg, pattern.c_str(), REG_EXTENDED | REG_NOSUB) != 0)
+    throw TASCAR::ErrMsg("Invalid regular expression \"" + pattern + "\".");
+  std::vector<std::string> matches;
+  for(auto& name : portnames)
+    if(regexec(&reg, name.c_str(), 0, NULL, 0) == 0)
+      matches.push_back(name);
+  regfree(&reg);
+  return matches;
+}
+
+bool jack_connection_planner_t::is_mine(const std::string& port) const
+{
+  auto it(ports.find(port));
+  return (it != ports.end()) && it->second.mine;
+}
+
+void jack_connection_planner_t::plan(const std::string& src,
+                                     const std::string& dest, bool btry)
+{
+  auto isrc(ports.find(src));
+  if((isrc != ports.end()) && isrc->second.connections.count(dest)) {
+    ++num_existing;
+    return;
+  }
+  planned.push_back({src, dest, btry});
+  ++num_planned;
+  // later entries see the planned connection as existing:
+  if(isrc != ports.end())
+    isrc->second.connections.insert(dest);
+  auto idest(ports.find(dest));
+  if(idest != ports.end())
+    idest->second.connections.insert(src);
+}
+
+void jack_connection_planner_t::add(const std::string& src,
+                                    const std::string& dest, bool btry,
+                                    bool allowoutputsource, bool connectmulti,
+                                    bool allowinputdest, bool noconnecttoself)
+{
+  TASCAR::tictoc_t tictoc;
+  resolve(src, dest, btry, allowoutputsource, connectmulti, allowinputdest,
+          noconnecttoself);
+  t_plan += tictoc.toc();
+}
+
+void jack_connection_planner_t::resolve(const std::string& src,
+                                        const std::string& dest, bool btry,
+                                        bool allowoutputsource,
+                                        bool connectmulti, bool allowinputdest,
+                                        bool noconnecttoself)
+{
+  if(connectmulti) {
+    std::vector<std::string> ports_src(match(src));
+    std::vector<std::string> ports_dest(match(dest));
+    if((ports_src.size() > 0) && (ports_dest.size() > 0)) {
+      for(uint32_t c = 0; c < std::max(ports_src.size(), ports_dest.size());
+          ++c)
+        resolve(ports_src[c % ports_src.size()],
+                ports_dest[c % ports_dest.size()], btry, allowoutputsource,
+                false, allowinputdest, noconnecttoself);
+    } else {
+      if(btry)
+        TASCAR::add_warning("No connection \"" + src + "\" to \"" + dest +
+                            "\" found.");
+      else
+        throw TASCAR::ErrMsg("No connection \"" + src + "\" to \"" + dest +
+                             "\" found.");
+    }
+  } else {
+    auto isrc(ports.find(src));
+    auto idest(ports.find(dest));
+    if(allowoutputsource && (isrc != ports.end()) &&
+       (isrc->second.flags & JackPortIsInput)) {
+      // copy, the connection list is modified by plan():
+      std::set<std::string> cons(isrc->second.connections);
+      for(auto& con : cons)
+        if((!noconnecttoself) || (!is_mine(con)))
+          plan(con, dest, btry);
+    } else if(allowinputdest && (idest != ports.end()) &&
+              (idest->second.flags & JackPortIsOutput)) {
+      std::set<std::string> cons(idest->second.connections);
+      for(auto& con : cons)
+        if((!noconnecttoself) || (!is_mine(con)))
+          plan(src, con, btry);
+    } else
+      plan(src, dest, btry);
+  }
+}
+
+size_t jack_connection_planner_t::apply()
+{
+  TASCAR::tictoc_t tictoc;
+  std::vector<connection_t> lplanned;
+  lplanned.swap(planned);
+  size_t num_new(0u);
+  for(auto& con : lplanned) {
+    int err(jack_connect(jc, con.src.c_str(), con.dest.c_str()));
+    if(err == 0) {
+      connected.push_back(con);
+      ++num_new;
+    } else if(err != EEXIST) {
+      errmsg = std::string("unable to connect port '") + con.src + "' to '" +
+               con.dest + "'.";
+      if(con.btry)
+        TASCAR::add_warning(errmsg);
+      else {
+        t_connect += tictoc.toc();
+        throw TASCAR::ErrMsg(errmsg.c_str());
+      }
+    }
+  }
+  t_connect += tictoc.toc();
+  return num_new;
+}
+
+void jack_connection_planner_t::disconnect()
+{
+  for(auto con = connected.rbegin(); con != connected.rend(); ++con) {
+    jack_disconnect(jc, con->src.c_str(), con->dest.c_str());
+    auto isrc(ports.find(con->src));
+    if(isrc != ports.end())
+      isrc->second.connections.erase(con->dest);
+    auto idest(ports.find(con->dest));
+    if(idest != ports.end())
+      idest->second.connections.erase(con->src);
+  }
+  connected.clear();
+}
+
 jackc_t::jackc_t(const std::string& clientname) : jackc_portless_t(clientname)
 {
   jack_set_process_callback(jc, process_, this);
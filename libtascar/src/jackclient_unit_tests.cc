@@ -0,0 +1,155 @@
+/*
+ * This file is part of the TASCAR software, see <http://tascar.org/>
+ *
+ * Copyright (c) 2026 agent
+ */
+/*
+ * TASCAR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, version 3 of the License.
+ *
+ * TASCAR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHATABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License, version 3 for more details.
+ *
+ * You should have received a copy of the GNU General Public License,
+ * Version 3 along with TASCAR. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include "errorhandling.h"
+#include "jackclient.h"
+#include <memory>
+
+namespace {
+
+  /**
+     Open a client with input and output ports, or return NULL if no
+     JACK server is running. The tests can use the dummy backend,
+     e.g., "jackd -d dummy".
+   */
+  std::unique_ptr<jackc_t> open_client(const std::string& name, uint32_t n)
+  {
+    std::unique_ptr<jackc_t> jc;
+    try {
+      jc.reset(new jackc_t(name));
+    }
+    catch(const TASCAR::ErrMsg&) {
+      return NULL;
+    }
+    for(uint32_t k = 0; k < n; ++k) {
+      jc->add_input_port("in_" + std::to_string(k));
+      jc->add_output_port("out_" + std::to_string(k));
+    }
+    jc->activate();
+    return jc;
+  }
+
+  size_t num_connections(jackc_t& jc, uint32_t n)
+  {
+    size_t cnt(0u);
+    for(uint32_t k = 0; k < n; ++k) {
+      std::string port(jc.get_client_name() + ":in_" + std::to_string(k));
+      cnt += jack_port_connected(jack_port_by_name(jc.jc, port.c_str()));
+    }
+    return cnt;
+  }
+
+} // namespace
+
+TEST(jack_connection_planner_t, connect)
+{
+  auto jc(open_client("tascar_planner_test", 8));
+  if(!jc)
+    GTEST_SKIP() << "No JACK server running";
+  std::string name(jc->get_client_name());
+  jack_connection_planner_t planner(jc->jc);
+  planner.update_graph();
+  planner.add(name + ":out_.*", name + ":in_.*", false, false, true);
+  EXPECT_EQ(8u, planner.get_num_planned());
+  EXPECT_EQ(8u, planner.apply());
+  EXPECT_EQ(8u, num_connections(*jc, 8));
+  jack_port_t* port(jack_port_by_name(jc->jc, (name + ":out_3").c_str()));
+  EXPECT_TRUE(jack_port_connected_to(port, (name + ":in_3").c_str()));
+  // existing connections are skipped:
+  jack_connection_planner_t planner2(jc->jc);
+  planner2.update_graph();
+  planner2.add(name + ":out_.*", name + ":in_.*", false, false, true);
+  EXPECT_EQ(0u, planner2.get_num_planned());
+  EXPECT_EQ(8u, planner2.get_num_existing());
+  // connections within one plan are not duplicated:
+  planner2.add(name + ":out_0", name + ":in_[4-7]", false, false, true);
+  planner2.add(name + ":out_0", name + ":in_4", false, false, true);
+  EXPECT_EQ(4u, planner2.get_num_planned());
+  EXPECT_EQ(9u, planner2.get_num_existing());
+  // input port as source connects its sources:
+  planner2.add(name + ":in_1", name + ":in_2", false, true);
+  EXPECT_EQ(5u, planner2.get_num_planned());
+  EXPECT_EQ(5u, planner2.apply());
+  EXPECT_EQ(13u, num_connections(*jc, 8));
+  port = jack_port_by_name(jc->jc, (name + ":out_1").c_str());
+  EXPECT_TRUE(jack_port_connected_to(port, (name + ":in_2").c_str()));
+  // only own connections are removed:
+  planner.disconnect();
+  EXPECT_EQ(5u, num_connections(*jc, 8));
+  planner2.disconnect();
+  EXPECT_EQ(0u, num_connections(*jc, 8));
+  // failures:
+  EXPECT_THROW(planner.add(name + ":nothing.*", name + ":in_0", false, false,
+                           true),
+               TASCAR::ErrMsg);
+  planner.add(name + ":nothing", name + ":in_0");
+  EXPECT_THROW(planner.apply(), TASCAR::ErrMsg);
+  planner.add(name + ":nothing", name + ":in_0", true);
+  EXPECT_EQ(0u, planner.apply());
+}
+
+TEST(jack_connection_planner_t, many_connections)
+{
+  // a session with many connect elements and a large speaker array:
+  const uint32_t n(64);
+  auto jc(open_client("tascar_planner_many", n));
+  if(!jc)
+    GTEST_SKIP() << "No JACK server running";
+  std::string name(jc->get_client_name());
+  jack_connection_planner_t planner(jc->jc);
+  planner.update_graph();
+  for(uint32_t k = 0; k < n; ++k)
+    planner.add(name + ":out_" + std::to_string(k),
+                name + ":in_" + std::to_string(k), false, true, true);
+  EXPECT_EQ(n, planner.get_num_planned());
+  EXPECT_EQ(n, planner.apply());
+  EXPECT_EQ(n, planner.get_num_connected());
+  // same result as direct connection:
+  EXPECT_EQ(n, num_connections(*jc, n));
+  for(uint32_t k = 0; k < n; ++k) {
+    jack_port_t* port(jack_port_by_name(
+        jc->jc, (name + ":out_" + std::to_string(k)).c_str()));
+    EXPECT_TRUE(jack_port_connected_to(
+        port, (name + ":in_" + std::to_string(k)).c_str()));
+  }
+  // all connections exist, no request to the JACK server:
+  jack_connection_planner_t planner2(jc->jc);
+  planner2.update_graph();
+  for(uint32_t k = 0; k < n; ++k)
+    planner2.add(name + ":out_" + std::to_string(k),
+                 name + ":in_" + std::to_string(k), false, true, true);
+  EXPECT_EQ(0u, planner2.get_num_planned());
+  EXPECT_EQ(n, planner2.get_num_existing());
+  EXPECT_EQ(0u, planner2.apply());
+  EXPECT_EQ(n, num_connections(*jc, n));
+  planner.disconnect();
+  EXPECT_EQ(0u, num_connections(*jc, n));
+}
+
+/*
+ * Local Variables:
+ * mode: c++
+ * c-basic-offset: 2
+ * indent-tabs-mode: nil
+ * compile-command: "make -C .."
+ * End:
+ */
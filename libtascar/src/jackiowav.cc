@@ -21,6 +21,7 @@
  */
 
 #include "jackiowav.h"
+#include "threadrole.h"
 #include <iostream>
 
 jackio_t::jackio_t(const std::string& ifname, const std::string& ofname,
@@ -343,6 +344,7 @@ jackrec_async_t::~jackrec_async_t()
 
 void jackrec_async_t::service()
 {
+  TASCAR::register_thread(TASCAR::thread_roles_t::disk);
   size_t rchunk(rlen * sizeof(float));
   while(run_service) {
     if(jack_ringbuffer_read_space(rb) >= rchunk) {
@@ -69,11 +69,18 @@ int TASCAR::scene_render_rt_t::process(jack_nframes_t nframes,
   return 0;
 }
 
-void TASCAR::scene_render_rt_t::start()
+void TASCAR::scene_render_rt_t::prepare_audio()
 {
+  if(audiostates_t::is_prepared())
+    return;
   chunk_cfg_t cf(get_srate(), get_fragsize());
-  // first prepare all nodes for audio processing:
   prepare(cf);
+}
+
+void TASCAR::scene_render_rt_t::start()
+{
+  // first prepare all nodes for audio processing:
+  prepare_audio();
   post_prepare();
   try {
     // create all ports:
@@ -44,25 +44,16 @@ TASCAR::maskplugin_t::maskplugin_t(const maskplugin_cfg_t& cfg)
     : maskplugin_base_t(cfg), lib(NULL), libdata(NULL)
 {
   get_attribute("type", plugintype, "", "mask plugin type");
-  std::string libname("tascar_mask_");
-#ifdef PLUGINPREFIX
-  libname = PLUGINPREFIX + libname;
-#endif
-  libname += plugintype + TASCAR::dynamic_lib_extension();
+  std::string libname(TASCAR::plugin_libname("tascar_mask_", plugintype));
   modname = plugintype;
   maskplugin_cfg_t lcfg(cfg);
   lcfg.modname = modname;
-  lib = TASCAR::dlopen((TASCAR::get_libdir() + libname).c_str(), RTLD_NOW);
+  std::string emsg;
+  lib = TASCAR::plugin_registry_t::get().open(libname, emsg);
   if(!lib)
     throw TASCAR::ErrMsg("Unable to open module \"" + plugintype +
-                         "\": " + dlerror());
-  try {
-    maskplugin_base_t_resolver(&libdata, lcfg, lib, libname);
-  }
-  catch(...) {
-    dlclose(lib);
-    throw;
-  }
+                         "\": " + emsg);
+  maskplugin_base_t_resolver(&libdata, lcfg, lib, libname);
 }
 
 float TASCAR::maskplugin_t::get_gain(const TASCAR::pos_t& pos)
@@ -89,7 +80,6 @@ void TASCAR::maskplugin_t::add_licenses(licensehandler_t* session)
 TASCAR::maskplugin_t::~maskplugin_t()
 {
   delete libdata;
-  dlclose(lib);
 }
 
 void TASCAR::maskplugin_t::validate_attributes(std::string& msg) const
@@ -0,0 +1,344 @@
+/*
+ * This file is part of the TASCAR software, see <http://tascar.org/>
+ *
+ * Copyright (c) 2026 agent
+ */
+/*
+ * TASCAR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, version 3 of the License.
+ *
+ * TASCAR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHATABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License, version 3 for more details.
+ *
+ * You should have received a copy of the GNU General Public License,
+ * Version 3 along with TASCAR. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mesh.h"
+#include "diskcache.h"
+#include <deque>
+#include <map>
+#include <set>
+#include <sstream>
+#include <tuple>
+
+using namespace TASCAR;
+
+namespace {
+
+  /**
+     Pool of unique vertices, vertices closer than the tolerance are
+     mapped to the same index. A grid with the tolerance as cell size
+     is used to find candidates.
+   */
+  class vertex_pool_t {
+  public:
+    vertex_pool_t(double tol_) : tol(std::max(tol_, 1e-9)) {}
+    uint32_t add(const pos_t& p)
+    {
+      int64_t cx((int64_t)floor(p.x / tol));
+      int64_t cy((int64_t)floor(p.y / tol));
+      int64_t cz((int64_t)floor(p.z / tol));
+      for(int64_t dx = -1; dx <= 1; ++dx)
+        for(int64_t dy = -1; dy <= 1; ++dy)
+          for(int64_t dz = -1; dz <= 1; ++dz) {
+            auto cell(grid.find(std::make_tuple(cx + dx, cy + dy, cz + dz)));
+            if(cell != grid.end())
+              for(auto idx : cell->second)
+                if(distance(verts[idx], p) <= tol)
+                  return idx;
+          }
+      uint32_t idx((uint32_t)verts.size());
+      verts.push_back(p);
+      grid[std::make_tuple(cx, cy, cz)].push_back(idx);
+      return idx;
+    }
+    std::vector<pos_t> verts;
+
+  private:
+    double tol;
+    std::map<std::tuple<int64_t, int64_t, int64_t>, std::vector<uint32_t>>
+        grid;
+  };
+
+  typedef std::pair<uint32_t, uint32_t> edge_t;
+
+  /// Newell's method, length of result is twice the area
+  pos_t get_rot(const std::vector<uint32_t>& poly,
+                const std::vector<pos_t>& verts)
+  {
+    pos_t rot;
+    uint32_t prev(poly.back());
+    for(auto k : poly) {
+      rot += cross_prod(verts[prev], verts[k]);
+      prev = k;
+    }
+    return rot;
+  }
+
+  pos_t get_rot(const std::vector<pos_t>& poly)
+  {
+    pos_t rot;
+    pos_t prev(poly.back());
+    for(auto& p : poly) {
+      rot += cross_prod(prev, p);
+      prev = p;
+    }
+    return rot;
+  }
+
+  /**
+     Merge two polygons with consistent orientation. Shared edges are
+     removed, the remaining edges need to form a single simple loop.
+   */
+  bool merge_polygons(const std::vector<uint32_t>& p1,
+                      const std::vector<uint32_t>& p2,
+                      std::vector<uint32_t>& result, std::vector<edge_t>& shared)
+  {
+    std::set<edge_t> edges;
+    for(size_t k = 0; k < p1.size(); ++k)
+      edges.insert(edge_t(p1[k], p1[(k + 1) % p1.size()]));
+    shared.clear();
+    std::vector<edge_t> remaining;
+    for(size_t k = 0; k < p2.size(); ++k) {
+      edge_t e(p2[k], p2[(k + 1) % p2.size()]);
+      auto it(edges.find(edge_t(e.second, e.first)));
+      if(it != edges.end()) {
+        shared.push_back(*it);
+        shared.push_back(e);
+        edges.erase(it);
+      } else
+        remaining.push_back(e);
+    }
+    if(shared.empty())
+      return false;
+    remaining.insert(remaining.end(), edges.begin(), edges.end());
+    std::map<uint32_t, uint32_t> next;
+    for(auto& e : remaining)
+      if(!next.insert(std::make_pair(e.first, e.second)).second)
+        // vertex is visited twice, not a simple polygon:
+        return false;
+    result.clear();
+    uint32_t start(remaining[0].first);
+    uint32_t v(start);
+    do {
+      result.push_back(v);
+      auto it(next.find(v));
+      if((it == next.end()) || (result.size() > remaining.size()))
+        return false;
+      v = it->second;
+    } while(v != start);
+    // more than one loop, i.e., a hole:
+    if(result.size() != remaining.size())
+      return false;
+    return result.size() >= 3;
+  }
+
+  /**
+     Remove vertices which are closer than the tolerance to the line
+     between their neighbours.
+   */
+  std::vector<pos_t> remove_straight_vertices(std::vector<pos_t> poly,
+                                              double tol)
+  {
+    bool changed(true);
+    while(changed && (poly.size() > 3)) {
+      changed = false;
+      for(size_t k = 0; (k < poly.size()) && (poly.size() > 3); ++k) {
+        const pos_t& prev(poly[(k + poly.size() - 1) % poly.size()]);
+        const pos_t& next(poly[(k + 1) % poly.size()]);
+        pos_t d(next - prev);
+        pos_t pk(poly[k] - prev);
+        double ld(d.norm());
+        if(ld == 0.0)
+          continue;
+        d /= ld;
+        double w(dot_prod(pk, d));
+        if((w <= 0.0) || (w >= ld))
+          continue;
+        if(cross_prod(pk, d).norm() <= tol) {
+          poly.erase(poly.begin() + k);
+          changed = true;
+        }
+      }
+    }
+    return poly;
+  }
+
+} // namespace
+
+mesh_t TASCAR::merge_coplanar_faces(const mesh_t& faces, double angle,
+                                    double dist)
+{
+  vertex_pool_t pool(dist);
+  std::vector<std::vector<uint32_t>> polys;
+  for(auto& face : faces) {
+    std::vector<uint32_t> poly;
+    for(auto& p : face) {
+      uint32_t idx(pool.add(p));
+      if(poly.empty() || (poly.back() != idx))
+        poly.push_back(idx);
+    }
+    while((poly.size() > 1) && (poly.back() == poly.front()))
+      poly.pop_back();
+    // skip degenerated faces:
+    if(poly.size() >= 3)
+      polys.push_back(poly);
+  }
+  const std::vector<pos_t>& verts(pool.verts);
+  std::vector<bool> alive(polys.size(), true);
+  std::vector<pos_t> normals;
+  for(auto& poly : polys)
+    normals.push_back(get_rot(poly, verts).normal());
+  std::map<edge_t, uint32_t> edge_owner;
+  for(uint32_t kp = 0; kp < polys.size(); ++kp)
+    for(size_t k = 0; k < polys[kp].size(); ++k)
+      edge_owner[edge_t(polys[kp][k], polys[kp][(k + 1) % polys[kp].size()])] =
+          kp;
+  const double cos_angle(cos(angle));
+  std::deque<uint32_t> queue;
+  for(uint32_t kp = 0; kp < polys.size(); ++kp)
+    queue.push_back(kp);
+  std::vector<uint32_t> merged;
+  std::vector<edge_t> shared;
+  while(!queue.empty()) {
+    uint32_t kp(queue.front());
+    queue.pop_front();
+    if(!alive[kp])
+      continue;
+    const std::vector<uint32_t>& poly(polys[kp]);
+    for(size_t k = 0; k < poly.size(); ++k) {
+      auto it(edge_owner.find(edge_t(poly[(k + 1) % poly.size()], poly[k])));
+      if(it == edge_owner.end())
+        continue;
+      uint32_t kn(it->second);
+      if((kn == kp) || !alive[kn])
+        continue;
+      if(dot_prod(normals[kp], normals[kn]) < cos_angle)
+        continue;
+      if(!merge_polygons(poly, polys[kn], merged, shared))
+        continue;
+      pos_t n(get_rot(merged, verts).normal());
+      bool planar(true);
+      for(auto v : merged)
+        if(fabs(dot_prod(n, verts[v] - verts[merged[0]])) > dist) {
+          planar = false;
+          break;
+        }
+      if(!planar)
+        continue;
+      for(auto& e : shared)
+        edge_owner.erase(e);
+      for(size_t ke = 0; ke < merged.size(); ++ke)
+        edge_owner[edge_t(merged[ke], merged[(ke + 1) % merged.size()])] = kp;
+      polys[kp] = merged;
+      normals[kp] = n;
+      alive[kn] = false;
+      queue.push_back(kp);
+      break;
+    }
+  }
+  mesh_t result;
+  for(uint32_t kp = 0; kp < polys.size(); ++kp)
+    if(alive[kp]) {
+      std::vector<pos_t> face;
+      for(auto v : polys[kp])
+        face.push_back(verts[v]);
+      result.push_back(remove_straight_vertices(face, dist));
+    }
+  return result;
+}
+
+mesh_t TASCAR::remove_small_faces(const mesh_t& faces, double minaperture)
+{
+  mesh_t result;
+  for(auto& face : faces) {
+    if(face.size() < 3)
+      continue;
+    double area(0.5 * get_rot(face).norm());
+    if(2.0 * sqrt(area / TASCAR_PI) >= minaperture)
+      result.push_back(face);
+  }
+  return result;
+}
+
+mesh_t TASCAR::preprocess_mesh(const mesh_t& faces,
+                               const mesh_preprocessing_cfg_t& cfg,
+                               bool usecache, bool* cachehit)
+{
+  if(cachehit)
+    *cachehit = false;
+  if(!cfg.merge && (cfg.minaperture <= 0.0))
+    return faces;
+  std::string key;
+  if(usecache) {
+    std::stringstream data;
+    data.precision(17);
+    for(auto& face : faces) {
+      for(auto& p : face)
+        data << p.x << " " << p.y << " " << p.z << " ";
+      data << "\n";
+    }
+    std::stringstream skey;
+    skey.precision(17);
+    skey << "mesh " << faces.size() << " " << std::hex
+         << diskcache_t::hash(data.str()) << std::dec << " " << cfg.merge
+         << " " << cfg.angle << " " << cfg.dist << " " << cfg.minaperture;
+    key = skey.str();
+    std::vector<float> cdata;
+    if(diskcache_t("mesh").read(key, cdata)) {
+      // format: number of vertices of each face, followed by vertices:
+      mesh_t result;
+      size_t k(0);
+      bool valid(true);
+      while(valid && (k < cdata.size())) {
+        size_t nverts((size_t)cdata[k++]);
+        if((nverts < 3) || (k + 3 * nverts > cdata.size())) {
+          valid = false;
+          break;
+        }
+        std::vector<pos_t> face;
+        for(size_t kv = 0; kv < nverts; ++kv) {
+          face.push_back(pos_t(cdata[k], cdata[k + 1], cdata[k + 2]));
+          k += 3;
+        }
+        result.push_back(face);
+      }
+      if(valid) {
+        if(cachehit)
+          *cachehit = true;
+        return result;
+      }
+    }
+  }
+  mesh_t result(faces);
+  if(cfg.merge)
+    result = merge_coplanar_faces(result, cfg.angle, cfg.dist);
+  if(cfg.minaperture > 0.0)
+    result = remove_small_faces(result, cfg.minaperture);
+  if(usecache) {
+    std::vector<float> cdata;
+    for(auto& face : result) {
+      cdata.push_back((float)face.size());
+      for(auto& p : face) {
+        cdata.push_back((float)p.x);
+        cdata.push_back((float)p.y);
+        cdata.push_back((float)p.z);
+      }
+    }
+    diskcache_t("mesh").write(key, cdata);
+  }
+  return result;
+}
+
+/*
+ * Local Variables:
+ * mode: c++
+ * c-basic-offset: 2
+ * indent-tabs-mode: nil
+ * compile-command: "make -C .."
+ * End:
+ */
@@ -0,0 +1,148 @@
+/*
+ * This file is part of the TASCAR software, see <http://tascar.org/>
+ *
+ * Copyright (c) 2026 agent
+ */
+/*
+ * TASCAR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, version 3 of the License.
+ *
+ * TASCAR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHATABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License, version 3 for more details.
+ *
+ * You should have received a copy of the GNU General Public License,
+ * Version 3 along with TASCAR. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "mesh.h"
+#include "tscconfig.h"
+#include <filesystem>
+
+using namespace TASCAR;
+
+namespace {
+
+  /// Square in the x-y plane, split into n x n squares of two triangles
+  mesh_t triangulated_square(uint32_t n, double size)
+  {
+    mesh_t mesh;
+    double d(size / n);
+    for(uint32_t kx = 0; kx < n; ++kx)
+      for(uint32_t ky = 0; ky < n; ++ky) {
+        pos_t p00(kx * d, ky * d, 0);
+        pos_t p10((kx + 1) * d, ky * d, 0);
+        pos_t p11((kx + 1) * d, (ky + 1) * d, 0);
+        pos_t p01(kx * d, (ky + 1) * d, 0);
+        mesh.push_back({p00, p10, p11});
+        mesh.push_back({p00, p11, p01});
+      }
+    return mesh;
+  }
+
+  double get_area(const mesh_t& mesh)
+  {
+    double area(0.0);
+    for(auto& face : mesh) {
+      ngon_t ngon;
+      ngon.nonrt_set(face);
+      area += ngon.get_area();
+    }
+    return area;
+  }
+
+} // namespace
+
+TEST(mesh, merge_coplanar_faces)
+{
+  mesh_t mesh(triangulated_square(10, 2.0));
+  EXPECT_EQ(200u, mesh.size());
+  mesh_t merged(merge_coplanar_faces(mesh, 0.01, 0.001));
+  ASSERT_EQ(1u, merged.size());
+  EXPECT_EQ(4u, merged[0].size());
+  EXPECT_NEAR(4.0, get_area(merged), 1e-9);
+  ngon_t ngon;
+  ngon.nonrt_set(merged[0]);
+  EXPECT_NEAR(1.0, ngon.get_normal().z, 1e-9);
+  // folded square, two planes:
+  for(auto& face : mesh)
+    for(auto& p : face)
+      if(p.x > 1.0)
+        p.z = p.x - 1.0;
+  merged = merge_coplanar_faces(mesh, 0.01, 0.001);
+  EXPECT_EQ(2u, merged.size());
+  // with large angle tolerance the distance tolerance prevents merging:
+  merged = merge_coplanar_faces(mesh, 1.0, 0.001);
+  EXPECT_EQ(2u, merged.size());
+  merged = merge_coplanar_faces(mesh, 1.0, 0.5);
+  EXPECT_EQ(1u, merged.size());
+}
+
+TEST(mesh, merge_no_holes)
+{
+  // square with a hole in the center:
+  mesh_t mesh(triangulated_square(3, 3.0));
+  mesh.erase(mesh.begin() + 8, mesh.begin() + 10);
+  mesh_t merged(merge_coplanar_faces(mesh, 0.01, 0.001));
+  EXPECT_LT(merged.size(), mesh.size());
+  EXPECT_GT(merged.size(), 1u);
+  EXPECT_NEAR(8.0, get_area(merged), 1e-9);
+  // faces with opposite orientation are not merged:
+  mesh = triangulated_square(1, 1.0);
+  std::reverse(mesh[1].begin(), mesh[1].end());
+  EXPECT_EQ(2u, merge_coplanar_faces(mesh, 0.01, 0.001).size());
+}
+
+TEST(mesh, remove_small_faces)
+{
+  mesh_t mesh(triangulated_square(4, 4.0));
+  // aperture of triangles is 2*sqrt(0.5/pi) = 0.798 m:
+  EXPECT_EQ(32u, remove_small_faces(mesh, 0.7).size());
+  EXPECT_EQ(0u, remove_small_faces(mesh, 0.9).size());
+}
+
+TEST(mesh, preprocess_mesh)
+{
+  auto dir(std::filesystem::temp_directory_path() / "tascar_mesh_test");
+  std::filesystem::remove_all(dir);
+  TASCAR::config_forceoverwrite("tascar.cachedir", dir.string());
+  mesh_t mesh(triangulated_square(10, 2.0));
+  mesh_preprocessing_cfg_t cfg;
+  bool cachehit(true);
+  EXPECT_EQ(200u, preprocess_mesh(mesh, cfg, true, &cachehit).size());
+  EXPECT_FALSE(cachehit);
+  cfg.merge = true;
+  cfg.angle = 0.01;
+  cfg.dist = 0.001;
+  mesh_t merged(preprocess_mesh(mesh, cfg, true, &cachehit));
+  EXPECT_FALSE(cachehit);
+  mesh_t cached(preprocess_mesh(mesh, cfg, true, &cachehit));
+  EXPECT_TRUE(cachehit);
+  ASSERT_EQ(merged.size(), cached.size());
+  ASSERT_EQ(merged[0].size(), cached[0].size());
+  for(size_t k = 0; k < merged[0].size(); ++k)
+    EXPECT_NEAR(0.0, distance(merged[0][k], cached[0][k]), 1e-6);
+  // different parameters or mesh are not taken from cache:
+  cfg.minaperture = 0.1;
+  preprocess_mesh(mesh, cfg, true, &cachehit);
+  EXPECT_FALSE(cachehit);
+  mesh[0][0].z = 0.0001;
+  preprocess_mesh(mesh, cfg, true, &cachehit);
+  EXPECT_FALSE(cachehit);
+  preprocess_mesh(mesh, cfg, false, &cachehit);
+  EXPECT_FALSE(cachehit);
+  std::filesystem::remove_all(dir);
+}
+
+/*
+ * Local Variables:
+ * mode: c++
+ * c-basic-offset: 2
+ * indent-tabs-mode: nil
+ * compile-command: "make -C .."
+ * End:
+ */
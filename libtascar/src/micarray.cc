@@ -0,0 +1,402 @@
+/*
+ * This file is part of the TASCAR software, see <http://tascar.org/>
+ *
+ * Copyright (c) 2021 FSchwark, Giso Grimm
+ */
+/*
+ * TASCAR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, version 3 of the License.
+ *
+ * TASCAR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHATABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License, version 3 for more details.
+ *
+ * You should have received a copy of the GNU General Public License,
+ * Version 3 along with TASCAR. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "micarray.h"
+#include "errorhandling.h"
+#include <algorithm>
+
+using namespace TASCAR;
+
+void micarray_filter_t::update_par(TASCAR::biquad_t& flt,
+                                   const TASCAR::pos_t& rel_pos,
+                                   double fs) const
+{
+  switch(filtertype) {
+    // filter design of parametric equalizer
+  case equalizer: {
+    double theta = acos(dot_prod(rel_pos.normal(), axis));
+    // gain (dB) variation
+    double gain = (cos(std::min(theta / theta_end, 1.0) * TASCAR_PI) + 1.0) *
+                      0.5 * (gain_st - gain_end) +
+                  gain_end;
+    // center frequency variation
+    double Omega = (cos(std::min(theta / theta_end, 1.0) * TASCAR_PI) + 1.0) *
+                       0.5 * (omega_st - omega_end) +
+                   omega_end;
+    // bilinear transformation
+    double t = 1.0 / tan(TASCAR_PI * Omega / fs);
+    double t_sq = t * t;
+    double Bc = t / Q;
+    if(gain < 0.0) {
+      double g = pow(10.0, (-gain / 20.0));
+      double inv_a0 = 1.0 / (t_sq + 1.0 + g * Bc);
+      flt.set_coefficients(
+          2.0 * (1.0 - t_sq) * inv_a0, (t_sq + 1.0 - g * Bc) * inv_a0,
+          (t_sq + 1.0 + Bc) * inv_a0, 2.0 * (1.0 - t_sq) * inv_a0,
+          (t_sq + 1.0 - Bc) * inv_a0);
+    } else {
+      double g = pow(10.0, (gain / 20.0));
+      double inv_a0 = 1.0 / (t_sq + 1.0 + Bc);
+      flt.set_coefficients(
+          2.0 * (1.0 - t_sq) * inv_a0, (t_sq + 1.0 - Bc) * inv_a0,
+          (t_sq + 1.0 + g * Bc) * inv_a0, 2.0 * (1.0 - t_sq) * inv_a0,
+          (t_sq + 1.0 - g * Bc) * inv_a0);
+    }
+    break;
+  }
+    // filterdesign of high-shelf filter
+  case highshelf: {
+    double theta = acos(dot_prod(rel_pos.normal(), axis));
+    double inv_a0 = 1.0 / (omega + fs);
+    if(theta > theta_st) {
+      double alpha = (alpha_st + alpha_m) * 0.5 +
+                     (alpha_st - alpha_m) * 0.5 *
+                         cos((theta - theta_st) /
+                             (beta * (TASCAR_PI - theta_st)) * TASCAR_PI);
+      flt.set_coefficients((omega - fs) * inv_a0, 0.0,
+                           (omega + alpha * fs) * inv_a0,
+                           (omega - alpha * fs) * inv_a0, 0.0);
+    } else
+      flt.set_coefficients((omega - fs) * inv_a0, 0.0,
+                           (omega + alpha_st * fs) * inv_a0,
+                           (omega - alpha_st * fs) * inv_a0, 0.0);
+    break;
+  }
+  }
+}
+
+double micarray_node_t::get_tau(const TASCAR::pos_t& rel_pos) const
+{
+  TASCAR::pos_t axis = position - parentposition;
+  double axislen(axis.norm());
+  // nodes at the position of their parent have no relative delay:
+  if(axislen == 0.0)
+    return 0.0;
+  TASCAR::pos_t pos(rel_pos);
+  pos -= parentposition;
+  double cos_theta = dot_prod(pos.normal(), axis.normal());
+  if(delaylinemodel == sphere) {
+    double theta = acos(cos_theta);
+    if(theta < TASCAR_PI2)
+      return -axislen * cos_theta;
+    return axislen * (theta - TASCAR_PI2);
+  }
+  return -axislen * cos_theta;
+}
+
+micarray_layout_t::micarray_layout_t(double c_) : c(c_) {}
+
+size_t micarray_layout_t::add_node(const micarray_node_t& node)
+{
+  if((node.parent >= (int32_t)nodes.size()) ||
+     ((node.parent < 0) && (!nodes.empty())))
+    throw TASCAR::ErrMsg("Invalid parent index " +
+                         std::to_string(node.parent) +
+                         " of microphone array node " +
+                         std::to_string(nodes.size()) + ".");
+  nodes.push_back(node);
+  return nodes.size() - 1u;
+}
+
+double micarray_layout_t::get_delay_comp() const
+{
+  // maximal possible delay due to sphere delay model:
+  double maxdist(0.0);
+  for(size_t k = 1; k < nodes.size(); ++k)
+    maxdist = std::max(maxdist, nodes[k].position.norm());
+  return maxdist * TASCAR_PI2 / c;
+}
+
+micarray_processor_t::micarray_processor_t(const micarray_layout_t& layout_,
+                                           double fs_, uint32_t fragsize)
+    : layout(layout_), fs(fs_), dt(1.0 / std::max(1.0, (double)fragsize)),
+      tau_origin(layout_.get_delay_comp() * layout_.c), tau(layout_.size(), 0.0),
+      target_tau(layout_.size(), 0.0)
+{
+  double delaycorr(layout.get_delay_comp());
+  for(const auto& node : layout.nodes)
+    maxdelay.push_back(
+        (uint32_t)(2.0 * delaycorr * fs + 2.0 * node.sincorder));
+}
+
+void micarray_processor_t::update_target_tau(const TASCAR::pos_t& rel_pos)
+{
+  for(size_t k = 0; k < layout.size(); ++k) {
+    const auto& node(layout.nodes[k]);
+    target_tau[k] =
+        node.get_tau(rel_pos) +
+        ((node.parent < 0) ? tau_origin : target_tau[node.parent]);
+  }
+}
+
+micarray_tree_processor_t::micarray_tree_processor_t(
+    const micarray_layout_t& layout_, double fs_, uint32_t fragsize)
+    : micarray_processor_t(layout_, fs_, fragsize)
+{
+  for(size_t k = 0; k < layout.size(); ++k) {
+    const auto& node(layout.nodes[k]);
+    sigbuf.push_back(TASCAR::wave_t(fragsize));
+    dline.push_back(new TASCAR::varidelay_t(maxdelay[k], fs, layout.c,
+                                            node.sincorder,
+                                            node.sincsampling));
+    filters.push_back(std::vector<TASCAR::biquad_t>(node.filters.size()));
+  }
+}
+
+micarray_tree_processor_t::~micarray_tree_processor_t()
+{
+  for(auto d : dline)
+    delete d;
+}
+
+void micarray_tree_processor_t::process(const TASCAR::wave_t& input,
+                                        const TASCAR::pos_t& rel_pos,
+                                        std::vector<TASCAR::wave_t>& output)
+{
+  update_target_tau(rel_pos);
+  for(size_t k = 0; k < layout.size(); ++k) {
+    const auto& node(layout.nodes[k]);
+    // copy signal of parent:
+    if(node.parent < 0)
+      sigbuf[k].copy(input);
+    else
+      sigbuf[k].copy(sigbuf[node.parent]);
+    // apply biquads:
+    for(size_t kflt = 0; kflt < filters[k].size(); ++kflt) {
+      node.filters[kflt].update_par(filters[k][kflt], rel_pos, fs);
+      filters[k][kflt].filter(sigbuf[k]);
+    }
+    // delayline:
+    double dtau((target_tau[k] - tau[k]) * dt);
+    uint32_t N(sigbuf[k].size());
+    for(uint32_t t = 0; t < N; ++t) {
+      output[k].d[t] += dline[k]->get_dist_push(tau[k], sigbuf[k].d[t]);
+      tau[k] += dtau;
+    }
+    tau[k] = target_tau[k];
+  }
+}
+
+micarray_flat_processor_t::micarray_flat_processor_t(
+    const micarray_layout_t& layout_, double fs_, uint32_t fragsize)
+    : micarray_processor_t(layout_, fs_, fragsize), nnodes(layout_.size()),
+      nstages(0u), dist2sample(fs_ / layout_.c), prebuf(fragsize),
+      buf(layout_.size() * fragsize, 0.0f)
+{
+  // shared history, long enough for the longest delay line and one
+  // chunk:
+  uint32_t len(fragsize + 1u);
+  for(auto d : maxdelay)
+    len = std::max(len, d + fragsize + 1u);
+  uint32_t size(1u);
+  while(size < len)
+    size <<= 1;
+  history.resize(size, 0.0f);
+  mask = size - 1u;
+  // sinc tables:
+  std::vector<std::pair<uint32_t, uint32_t>> sinccfg;
+  for(const auto& node : layout.nodes) {
+    std::pair<uint32_t, uint32_t> cfg(node.sincorder, node.sincsampling);
+    size_t k(0);
+    while((k < sinccfg.size()) && (sinccfg[k] != cfg))
+      ++k;
+    if(k == sinccfg.size())
+      sinccfg.push_back(cfg);
+    sincidx.push_back(k);
+  }
+  sinc.reserve(sinccfg.size());
+  uint32_t maxorder(0u);
+  for(const auto& cfg : sinccfg) {
+    sinc.emplace_back(cfg.first, cfg.second);
+    maxorder = std::max(maxorder, cfg.first);
+  }
+  weights.resize(2u * maxorder + 1u);
+  taps.resize(2u * maxorder + 1u);
+  // filters of the origin are common to all nodes and are applied
+  // before the delay, as in the tree:
+  if(nnodes)
+    prefilt.resize(layout.nodes[0].filters.size());
+  // filter cascade of all other nodes, from the origin to the node:
+  std::vector<std::vector<uint32_t>> path(nnodes);
+  for(uint32_t k = 1; k < nnodes; ++k) {
+    const auto& node(layout.nodes[k]);
+    path[k] = path[node.parent];
+    for(uint32_t kflt = 0; kflt < node.filters.size(); ++kflt) {
+      path[k].push_back(flt_src.size());
+      flt_src.push_back(std::pair<uint32_t, uint32_t>(k, kflt));
+    }
+    nstages = std::max(nstages, (uint32_t)(path[k].size()));
+  }
+  flt.resize(flt_src.size());
+  // sort nodes by number of filter stages, so that each stage of the
+  // filter bank operates on the first nodes only:
+  for(uint32_t k = 0; k < nnodes; ++k)
+    slot_node.push_back(k);
+  std::stable_sort(slot_node.begin(), slot_node.end(),
+                   [&path](uint32_t a, uint32_t b) {
+                     return path[a].size() > path[b].size();
+                   });
+  for(uint32_t s = 0; s < nstages; ++s) {
+    uint32_t cnt(0u);
+    while((cnt < nnodes) && (path[slot_node[cnt]].size() > s))
+      ++cnt;
+    stage_nodes.push_back(cnt);
+  }
+  stage_src.resize(nstages * nnodes, 0u);
+  for(uint32_t s = 0; s < nstages; ++s)
+    for(uint32_t j = 0; j < stage_nodes[s]; ++j)
+      stage_src[s * nnodes + j] = path[slot_node[j]][s];
+  a1.resize(nstages * nnodes, 0.0);
+  a2.resize(nstages * nnodes, 0.0);
+  b0.resize(nstages * nnodes, 1.0);
+  b1.resize(nstages * nnodes, 0.0);
+  b2.resize(nstages * nnodes, 0.0);
+  z1.resize(nstages * nnodes, 0.0);
+  z2.resize(nstages * nnodes, 0.0);
+}
+
+void micarray_flat_processor_t::process(const TASCAR::wave_t& input,
+                                        const TASCAR::pos_t& rel_pos,
+                                        std::vector<TASCAR::wave_t>& output)
+{
+  const uint32_t N(input.n);
+  if(N * nnodes > buf.size())
+    throw TASCAR::ErrMsg("Chunk size " + std::to_string(N) +
+                         " exceeds fragment size of micarray processor.");
+  update_target_tau(rel_pos);
+  // filters of origin:
+  const TASCAR::wave_t* sig(&input);
+  if(!prefilt.empty()) {
+    prebuf.copy(input);
+    for(size_t kflt = 0; kflt < prefilt.size(); ++kflt) {
+      layout.nodes[0].filters[kflt].update_par(prefilt[kflt], rel_pos, fs);
+      prefilt[kflt].filter(prebuf);
+    }
+    sig = &prebuf;
+  }
+  // add to shared history, sample t is at position pos+1+t:
+  for(uint32_t t = 0; t < N; ++t)
+    history[(pos + 1u + t) & mask] = sig->d[t];
+  // multi-tap read of delayed signals:
+  for(uint32_t j = 0; j < nnodes; ++j) {
+    const uint32_t k(slot_node[j]);
+    const TASCAR::sinctable_t& sinctab(sinc[sincidx[k]]);
+    const int32_t O(sinctab.O);
+    const uint32_t dmax(maxdelay[k]);
+    double dtau((target_tau[k] - tau[k]) * dt);
+    float* p_buf(buf.data() + j);
+    if(dtau == 0.0) {
+      // constant delay, compute interpolation weights only once:
+      float delay(dist2sample * (float)(tau[k]));
+      int32_t integerdelay(O ? roundf(delay) : delay);
+      float subsampledelay(delay - roundf(delay));
+      for(int32_t order = -O; order <= O; ++order) {
+        weights[order + O] = O ? sinctab((float)order - subsampledelay) : 1.0f;
+        taps[order + O] = std::min(
+            (uint32_t)(std::max(0, integerdelay + order)), dmax);
+      }
+      for(uint32_t t = 0; t < N; ++t) {
+        const uint32_t p(pos + 1u + t);
+        float rv(0.0f);
+        for(int32_t o = 0; o <= 2 * O; ++o)
+          rv += weights[o] * history[(p - taps[o]) & mask];
+        *p_buf = rv;
+        p_buf += nnodes;
+      }
+      continue;
+    }
+    for(uint32_t t = 0; t < N; ++t) {
+      const uint32_t p(pos + 1u + t);
+      float delay(dist2sample * (float)(tau[k]));
+      if(O) {
+        float integerdelay(roundf(delay));
+        float subsampledelay(delay - integerdelay);
+        float rv(0.0f);
+        for(int32_t order = -O; order <= O; ++order)
+          rv += sinctab((float)order - subsampledelay) *
+                history[(p - std::min((uint32_t)(std::max(
+                                          0, (int32_t)integerdelay + order)),
+                                      dmax)) &
+                        mask];
+        *p_buf = rv;
+      } else
+        *p_buf = history[(p - std::min((uint32_t)delay, dmax)) & mask];
+      p_buf += nnodes;
+      tau[k] += dtau;
+    }
+    tau[k] = target_tau[k];
+  }
+  pos += N;
+  if(nstages) {
+    // update filter coefficients, once per filter model:
+    for(size_t f = 0; f < flt.size(); ++f)
+      layout.nodes[flt_src[f].first]
+          .filters[flt_src[f].second]
+          .update_par(flt[f], rel_pos, fs);
+    for(uint32_t s = 0; s < nstages; ++s)
+      for(uint32_t j = 0; j < stage_nodes[s]; ++j) {
+        const size_t k(s * nnodes + j);
+        const TASCAR::biquad_t& f(flt[stage_src[k]]);
+        a1[k] = f.get_a1();
+        a2[k] = f.get_a2();
+        b0[k] = f.get_b0();
+        b1[k] = f.get_b1();
+        b2[k] = f.get_b2();
+      }
+    // biquad bank, transposed direct form II, all nodes in inner loop:
+    for(uint32_t s = 0; s < nstages; ++s) {
+      const uint32_t M(stage_nodes[s]);
+      const double* p_a1(a1.data() + s * nnodes);
+      const double* p_a2(a2.data() + s * nnodes);
+      const double* p_b0(b0.data() + s * nnodes);
+      const double* p_b1(b1.data() + s * nnodes);
+      const double* p_b2(b2.data() + s * nnodes);
+      double* p_z1(z1.data() + s * nnodes);
+      double* p_z2(z2.data() + s * nnodes);
+      for(uint32_t t = 0; t < N; ++t) {
+        float* p_buf(buf.data() + t * nnodes);
+        for(uint32_t j = 0; j < M; ++j) {
+          double in(p_buf[j]);
+          double out(p_z1[j] + p_b0[j] * in);
+          p_z1[j] = p_z2[j] + p_b1[j] * in - p_a1[j] * out;
+          p_z2[j] = p_b2[j] * in - p_a2[j] * out;
+          p_buf[j] = (float)out;
+        }
+      }
+    }
+  }
+  // add to output channels:
+  for(uint32_t j = 0; j < nnodes; ++j) {
+    const float* p_buf(buf.data() + j);
+    float* p_out(output[slot_node[j]].d);
+    for(uint32_t t = 0; t < N; ++t) {
+      p_out[t] += *p_buf;
+      p_buf += nnodes;
+    }
+  }
+}
+
+/*
+ * Local Variables:
+ * mode: c++
+ * c-basic-offset: 2
+ * indent-tabs-mode: nil
+ * compile-command: "make -C .."
+ * End:
+ */
@@ -0,0 +1,213 @@
+/*
+ * This file is part of the TASCAR software, see <http://tascar.org/>
+ *
+ * Copyright (c) 2026 agent
+ */
+/*
+ * TASCAR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, version 3 of the License.
+ *
+ * TASCAR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHATABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License, version 3 for more details.
+ *
+ * You should have received a copy of the GNU General Public License,
+ * Version 3 along with TASCAR. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "errorhandling.h"
+#include "micarray.h"
+
+using namespace TASCAR;
+
+namespace {
+
+  const double fs = 44100.0;
+  const uint32_t fragsize = 64;
+
+  micarray_filter_t highshelf(const pos_t& axis)
+  {
+    micarray_filter_t flt;
+    flt.filtertype = micarray_filter_t::highshelf;
+    flt.axis = axis.normal();
+    flt.theta_st = 0.0;
+    flt.beta = 0.89;
+    flt.omega = 3100.0;
+    flt.alpha_st = 2.0;
+    flt.alpha_m = 0.14;
+    return flt;
+  }
+
+  micarray_filter_t equalizer(const pos_t& axis)
+  {
+    micarray_filter_t flt;
+    flt.filtertype = micarray_filter_t::equalizer;
+    flt.axis = axis.normal();
+    flt.theta_end = 1.78;
+    flt.gain_st = -5.4;
+    flt.gain_end = -2.0;
+    flt.omega_st = 650.0;
+    flt.omega_end = 1300.0;
+    flt.Q = 2.3;
+    return flt;
+  }
+
+  /**
+     Head-like array: a sphere with a ring of capsules, each followed
+     by a second capsule at a small distance, with filters on both
+     levels.
+   */
+  micarray_layout_t create_layout(uint32_t ncaps, uint32_t sincorder)
+  {
+    micarray_layout_t layout;
+    micarray_node_t origin;
+    origin.sincorder = sincorder;
+    origin.filters.push_back(equalizer(pos_t(1, 0, 0)));
+    layout.add_node(origin);
+    for(uint32_t k = 0; k < ncaps; ++k) {
+      double az(TASCAR_2PI * k / ncaps);
+      micarray_node_t cap;
+      cap.parent = 0;
+      cap.position = pos_t(0.08 * cos(az), 0.08 * sin(az), 0.01 * (k & 1));
+      cap.delaylinemodel = micarray_node_t::sphere;
+      cap.sincorder = sincorder;
+      cap.filters.push_back(highshelf(cap.position));
+      if(k & 2)
+        cap.filters.push_back(equalizer(cap.position));
+      int32_t idx(layout.add_node(cap));
+      micarray_node_t sub;
+      sub.parent = idx;
+      sub.parentposition = cap.position;
+      sub.position = cap.position;
+      sub.position *= 1.15;
+      sub.sincorder = sincorder;
+      sub.filters.push_back(highshelf(sub.position));
+      layout.add_node(sub);
+    }
+    return layout;
+  }
+
+  /**
+     Render noise with a source moving on a circle, return output
+     signals.
+   */
+  std::vector<wave_t> render(micarray_processor_t& proc, size_t nch,
+                             uint32_t nblocks, double speed)
+  {
+    std::vector<wave_t> out;
+    for(size_t ch = 0; ch < nch; ++ch)
+      out.push_back(wave_t(fragsize * nblocks));
+    std::vector<wave_t> chunk(nch, wave_t(fragsize));
+    wave_t in(fragsize);
+    uint32_t seed(1);
+    for(uint32_t b = 0; b < nblocks; ++b) {
+      for(uint32_t t = 0; t < fragsize; ++t) {
+        seed = seed * 1664525u + 1013904223u;
+        in.d[t] = (float)seed / 4294967296.0f - 0.5f;
+      }
+      for(auto& c : chunk)
+        c.clear();
+      double az(0.3 + speed * b * fragsize / fs);
+      proc.process(in, pos_t(2.0 * cos(az), 2.0 * sin(az), 0.3), chunk);
+      for(size_t ch = 0; ch < nch; ++ch)
+        for(uint32_t t = 0; t < fragsize; ++t)
+          out[ch].d[b * fragsize + t] = chunk[ch].d[t];
+    }
+    return out;
+  }
+
+  /**
+     RMS of difference, ignoring the first blocks where the delays
+     are ramped up from zero.
+   */
+  float get_diff_rms(const wave_t& a, const wave_t& b, float& rms)
+  {
+    const uint32_t skip(8 * fragsize);
+    wave_t diff(a.n - skip);
+    wave_t ref(a.n - skip);
+    for(uint32_t t = 0; t < diff.n; ++t) {
+      ref.d[t] = a.d[t + skip];
+      diff.d[t] = a.d[t + skip] - b.d[t + skip];
+    }
+    rms = ref.rms();
+    return diff.rms();
+  }
+
+} // namespace
+
+TEST(micarray_layout_t, add_node)
+{
+  micarray_layout_t layout;
+  micarray_node_t node;
+  node.parent = 0;
+  EXPECT_THROW(layout.add_node(node), TASCAR::ErrMsg);
+  node.parent = -1;
+  EXPECT_EQ(0u, layout.add_node(node));
+  EXPECT_THROW(layout.add_node(node), TASCAR::ErrMsg);
+  node.parent = 0;
+  node.position = pos_t(0.1, 0, 0);
+  EXPECT_EQ(1u, layout.add_node(node));
+  EXPECT_NEAR(0.1 * TASCAR_PI2 / 340.0, layout.get_delay_comp(), 1e-9);
+}
+
+TEST(micarray_flat_processor_t, static_equals_tree)
+{
+  for(uint32_t sincorder : {0u, 5u}) {
+    micarray_layout_t layout(create_layout(8, sincorder));
+    micarray_tree_processor_t tree(layout, fs, fragsize);
+    micarray_flat_processor_t flat(layout, fs, fragsize);
+    auto out_tree(render(tree, layout.size(), 64, 0.0));
+    auto out_flat(render(flat, layout.size(), 64, 0.0));
+    for(size_t ch = 0; ch < layout.size(); ++ch) {
+      float rms(0.0f);
+      float diff(get_diff_rms(out_tree[ch], out_flat[ch], rms));
+      ASSERT_GT(rms, 0.01f);
+      EXPECT_LT(diff, 1e-5f * rms) << "channel " << ch;
+    }
+  }
+}
+
+TEST(micarray_flat_processor_t, moving_close_to_tree)
+{
+  // filters and delays are swapped, thus small differences are
+  // expected for moving sources:
+  micarray_layout_t layout(create_layout(8, 5));
+  micarray_tree_processor_t tree(layout, fs, fragsize);
+  micarray_flat_processor_t flat(layout, fs, fragsize);
+  auto out_tree(render(tree, layout.size(), 256, TASCAR_2PI));
+  auto out_flat(render(flat, layout.size(), 256, TASCAR_2PI));
+  for(size_t ch = 0; ch < layout.size(); ++ch) {
+    float rms(0.0f);
+    float diff(get_diff_rms(out_tree[ch], out_flat[ch], rms));
+    EXPECT_LT(20.0f * log10f(diff / rms), -40.0f) << "channel " << ch;
+  }
+}
+
+TEST(micarray_flat_processor_t, large_layout_equals_tree)
+{
+  // many nodes with different numbers of filter stages:
+  micarray_layout_t layout(create_layout(32, 5));
+  micarray_tree_processor_t tree(layout, fs, fragsize);
+  micarray_flat_processor_t flat(layout, fs, fragsize);
+  auto out_tree(render(tree, layout.size(), 64, 0.0));
+  auto out_flat(render(flat, layout.size(), 64, 0.0));
+  for(size_t ch = 0; ch < layout.size(); ++ch) {
+    float rms(0.0f);
+    float diff(get_diff_rms(out_tree[ch], out_flat[ch], rms));
+    ASSERT_GT(rms, 0.01f);
+    EXPECT_LT(diff, 1e-5f * rms) << "channel " << ch;
+  }
+}
+
+/*
+ * Local Variables:
+ * mode: c++
+ * c-basic-offset: 2
+ * indent-tabs-mode: nil
+ * compile-command: "make -C .."
+ * End:
+ */
@@ -26,15 +26,19 @@
 #include "osc_helper.h"
 #include "defs.h"
 #include "errorhandling.h"
+#include "threadrole.h"
 #include "tictoctimer.h"
 #include <fstream>
 #include <map>
 #include <math.h>
+#include <string.h>
 #include <unistd.h>
 
 using namespace TASCAR;
 
 static bool liblo_errflag;
+// true while messages are dispatched internally by the calling thread:
+static thread_local bool internal_dispatch = false;
 
 std::string str_get_null(void*)
 {
@@ -62,6 +66,12 @@ TASCAR::osc_server_t::data_element_t::data_element_t(const std::string& p,
   }
 }
 
+static int server_thread_init(lo_server_thread, void*)
+{
+  TASCAR::register_thread(TASCAR::thread_roles_t::network);
+  return 0;
+}
+
 void err_handler(int num, const char* msg, const char* where)
 {
   liblo_errflag = true;
@@ -569,6 +579,15 @@ int osc_tm_clear(const char*, const char*, lo_arg**, int argc, lo_message,
   return 1;
 }
 
+int osc_capture(const char* path, const char*, lo_arg**, int, lo_message msg,
+                void* user_data)
+{
+  if(user_data)
+    reinterpret_cast<osc_server_t*>(user_data)->capture(path, msg);
+  // continue with other handlers:
+  return 1;
+}
+
 int string2proto(const std::string& proto)
 {
   if(proto == "UDP")
@@ -587,6 +606,7 @@ osc_server_t::osc_server_t(const std::string& multicast,
 {
   initialized = false;
   isactive = false;
+  capturing = false;
   runscriptthread = true;
   cancelscript = false;
   scriptthread = std::thread(&osc_server_t::scriptthread_fun, this);
@@ -614,6 +634,9 @@ osc_server_t::osc_server_t(const std::string& multicast,
       throw ErrMsg("liblo error (srv_addr: \"" + multicast + "\" srv_port: \"" +
                    port + "\" " + proto + ").");
     }
+    lo_server_thread_set_callbacks(lost, &server_thread_init, NULL, NULL);
+    // capture handler has to be the first handler, to see all messages:
+    lo_server_thread_add_method(lost, NULL, NULL, osc_capture, this);
   }
   if(lost) {
     char* ctmp(lo_server_thread_get_url(lost));
@@ -638,7 +661,33 @@ int osc_server_t::dispatch_data(void* data, size_t size)
     return 0;
   // std::lock_guard<std::mutex> lk{mtxdispatch};
   lo_server srv(lo_server_thread_get_server(lost));
-  return lo_server_dispatch_data(srv, data, size);
+  bool prev(internal_dispatch);
+  internal_dispatch = true;
+  int r(lo_server_dispatch_data(srv, data, size));
+  internal_dispatch = prev;
+  return r;
+}
+
+void osc_server_t::set_capture_handler(
+    std::function<void(const char*, lo_message)> h)
+{
+  std::lock_guard<std::mutex> lk{mtxcapture};
+  capture_handler = h;
+  capturing = (bool)h;
+}
+
+void osc_server_t::capture(const char* path, lo_message msg)
+{
+  if(!capturing || internal_dispatch)
+    return;
+  // control of capture and replay is not recorded, a replay of these
+  // messages would restart or stop itself:
+  if((strncmp(path, "/capture/", 9) == 0) ||
+     (strncmp(path, "/replay/", 8) == 0))
+    return;
+  std::lock_guard<std::mutex> lk{mtxcapture};
+  if(capture_handler)
+    capture_handler(path, msg);
 }
 
 int osc_server_t::dispatch_data_message(const char* path, lo_message m)
@@ -725,6 +774,15 @@ void osc_server_t::add_float(const std::string& path, float* data,
       data_element_t(prefix + path, data, str_get_float, "float");
 }
 
+void osc_server_t::add_float_readonly(const std::string& path, float* data,
+                                      const std::string& comment)
+{
+  add_method(path + "/get", "ss", osc_get_float, data, true, false, "",
+             comment);
+  datamap[prefix + path] =
+      data_element_t(prefix + path, data, str_get_float, "float");
+}
+
 void osc_server_t::add_double(const std::string& path, double* data,
                               const std::string& range,
                               const std::string& comment)
@@ -1154,6 +1212,9 @@ void osc_server_t::read_script(const std::vector<std::string>& filenames)
 
 void osc_server_t::scriptthread_fun()
 {
+  // the script thread is created before the session configuration
+  // is read, thus register when the first script is executed:
+  bool registered(false);
   while(runscriptthread) {
     std::vector<std::string> scripts;
     {
@@ -1170,6 +1231,9 @@ void osc_server_t::scriptthread_fun()
       lock.unlock();
     }
     if(runscriptthread && scripts.size()) {
+      if(!registered)
+        TASCAR::register_thread(TASCAR::thread_roles_t::background);
+      registered = true;
       cancelscript = false;
       read_script(scripts);
       cancelscript = false;
@@ -0,0 +1,310 @@
+/*
+ * This file is part of the TASCAR software, see <http://tascar.org/>
+ *
+ * Copyright (c) 2026 agent
+ */
+/*
+ * TASCAR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, version 3 of the License.
+ *
+ * TASCAR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHATABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License, version 3 for more details.
+ *
+ * You should have received a copy of the GNU General Public License,
+ * Version 3 along with TASCAR. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "osc_sender.h"
+#include "errorhandling.h"
+#include "threadrole.h"
+#include "tscconfig.h"
+#include <string.h>
+
+using namespace TASCAR;
+
+/// Destination of OSC messages, accessed only with locked mutex
+class osc_sender_t::target_t {
+public:
+  target_t(const std::string& url, double maxrate, int ttl)
+      : url(url), ttl(ttl), addr(lo_address_new_from_url(url.c_str())),
+        min_interval((maxrate > 0.0) ? (1.0 / maxrate) : 0.0)
+  {
+    if(!addr)
+      throw TASCAR::ErrMsg("Unable to create OSC target address \"" + url +
+                           "\".");
+    lo_address_set_ttl(addr, ttl);
+  };
+  ~target_t() { lo_address_free(addr); };
+  std::string url;
+  int ttl;
+  lo_address addr;
+  double min_interval;
+  std::chrono::steady_clock::time_point last_sent;
+  std::vector<message_t*> messages;
+};
+
+osc_sender_t::message_t::message_t(target_t* target, const std::string& path,
+                                   const std::string& typespec, bool coalesce,
+                                   size_t queuelen)
+    : target(target), path(path), typespec(typespec), coalesce(coalesce)
+{
+  // one entry is always reserved for the next message:
+  queue.resize(std::max((size_t)1u, queuelen) + 1u);
+  for(auto& e : queue) {
+    e.num.resize(typespec.size(), 0.0);
+    e.str.resize(typespec.size());
+    for(auto& s : e.str)
+      s[0] = 0;
+  }
+  latest = queue[0];
+}
+
+void osc_sender_t::message_t::set_string(size_t k, const char* s)
+{
+  std::array<char, max_strlen>& dest(next().str[k]);
+  strncpy(dest.data(), s, max_strlen - 1u);
+  dest[max_strlen - 1u] = 0;
+}
+
+bool osc_sender_t::message_t::post()
+{
+  size_t w(wpos.load(std::memory_order_relaxed));
+  size_t wnext((w + 1u) % queue.size());
+  if(wnext == rpos.load(std::memory_order_acquire)) {
+    ++dropped;
+    return false;
+  }
+  queue[w].t = std::chrono::steady_clock::now();
+  // copy arguments, to allow for partial updates of next message:
+  queue[wnext].num = queue[w].num;
+  queue[wnext].str = queue[w].str;
+  wpos.store(wnext, std::memory_order_release);
+  return true;
+}
+
+lo_message osc_sender_t::message_t::create_lo_message(const entry_t& e) const
+{
+  lo_message msg(lo_message_new());
+  for(size_t k = 0; k < typespec.size(); ++k)
+    switch(typespec[k]) {
+    case 'f':
+      lo_message_add_float(msg, (float)e.num[k]);
+      break;
+    case 'd':
+      lo_message_add_double(msg, e.num[k]);
+      break;
+    case 'i':
+      lo_message_add_int32(msg, (int32_t)e.num[k]);
+      break;
+    case 's':
+      lo_message_add_string(msg, e.str[k].data());
+      break;
+    }
+  return msg;
+}
+
+osc_sender_t::osc_sender_t(double period) : period(period)
+{
+  if(period > 0.0)
+    thread = std::thread(&osc_sender_t::sendthread, this);
+}
+
+osc_sender_t::~osc_sender_t()
+{
+  run_thread = false;
+  if(thread.joinable())
+    thread.join();
+  for(auto msg : messages)
+    delete msg;
+  for(auto target : targets)
+    delete target;
+}
+
+osc_sender_t& osc_sender_t::get()
+{
+  static osc_sender_t sender(
+      TASCAR::config("tascar.osc.sendperiod", 0.002));
+  return sender;
+}
+
+osc_sender_t::message_t*
+osc_sender_t::add_message(const std::string& url, const std::string& path,
+                          const std::string& typespec, bool coalesce,
+                          double maxrate, int ttl, size_t queuelen)
+{
+  for(auto c : typespec)
+    if((c != 'f') && (c != 'd') && (c != 'i') && (c != 's'))
+      throw TASCAR::ErrMsg("Unsupported OSC type '" + std::string(1, c) +
+                           "' in message " + path + " (supported: f,d,i,s).");
+  std::lock_guard<std::mutex> lock(mtx);
+  target_t* target(NULL);
+  // the time to live is a property of the address, thus messages
+  // with a different ttl need their own target:
+  for(auto t : targets)
+    if((t->url == url) && (t->ttl == ttl))
+      target = t;
+  if(!target) {
+    target = new target_t(url, maxrate, ttl);
+    targets.push_back(target);
+  } else if(maxrate > 0.0)
+    target->min_interval = std::max(target->min_interval, 1.0 / maxrate);
+  message_t* msg(new message_t(target, path, typespec, coalesce, queuelen));
+  messages.push_back(msg);
+  target->messages.push_back(msg);
+  return msg;
+}
+
+void osc_sender_t::remove_message(message_t* msg)
+{
+  std::lock_guard<std::mutex> lock(mtx);
+  for(auto it = messages.begin(); it != messages.end(); ++it)
+    if(*it == msg) {
+      messages.erase(it);
+      auto& tmsgs(msg->target->messages);
+      for(auto tit = tmsgs.begin(); tit != tmsgs.end(); ++tit)
+        if(*tit == msg) {
+          tmsgs.erase(tit);
+          break;
+        }
+      num_dropped_removed += msg->dropped;
+      delete msg;
+      return;
+    }
+}
+
+size_t osc_sender_t::process()
+{
+  std::lock_guard<std::mutex> lock(mtx);
+  size_t cnt(0u);
+  auto now(std::chrono::steady_clock::now());
+  auto add_latency([&](const message_t::entry_t& e) {
+    double lat(std::chrono::duration<double>(now - e.t).count());
+    sum_latency.store(sum_latency.load() + lat);
+    if(lat > max_latency.load())
+      max_latency.store(lat);
+  });
+  for(auto target : targets) {
+    bool due((target->min_interval <= 0.0) ||
+             (std::chrono::duration<double>(now - target->last_sent).count() >=
+              target->min_interval));
+    lo_bundle bundle(NULL);
+    auto add_to_bundle([&](message_t* msg, const message_t::entry_t& e) {
+      if(!bundle)
+        bundle = lo_bundle_new(LO_TT_IMMEDIATE);
+      lo_bundle_add_message(bundle, msg->path.c_str(),
+                            msg->create_lo_message(e));
+      add_latency(e);
+      ++cnt;
+      ++num_sent;
+    });
+    // state messages: keep only latest message, also when not due:
+    for(auto msg : target->messages)
+      if(msg->coalesce) {
+        size_t r(msg->rpos.load(std::memory_order_relaxed));
+        size_t w(msg->wpos.load(std::memory_order_acquire));
+        for(; r != w; r = (r + 1u) % msg->queue.size()) {
+          if(msg->has_latest)
+            ++num_coalesced;
+          msg->latest.num = msg->queue[r].num;
+          msg->latest.str = msg->queue[r].str;
+          msg->latest.t = msg->queue[r].t;
+          msg->has_latest = true;
+        }
+        msg->rpos.store(r, std::memory_order_release);
+      }
+    if(due) {
+      // state messages of different slots with the same path replace
+      // each other, only the latest one is sent:
+      auto& tmsgs(target->messages);
+      for(size_t k = 0; k < tmsgs.size(); ++k)
+        if(tmsgs[k]->coalesce && tmsgs[k]->has_latest)
+          for(size_t ko = 0; ko < tmsgs.size(); ++ko) {
+            message_t* other(tmsgs[ko]);
+            if((ko != k) && other->coalesce && other->has_latest &&
+               (other->path == tmsgs[k]->path) &&
+               ((other->latest.t > tmsgs[k]->latest.t) ||
+                ((other->latest.t == tmsgs[k]->latest.t) && (ko > k)))) {
+              ++num_coalesced;
+              tmsgs[k]->has_latest = false;
+              break;
+            }
+          }
+      for(auto msg : tmsgs) {
+        if(msg->coalesce) {
+          if(msg->has_latest) {
+            add_to_bundle(msg, msg->latest);
+            msg->has_latest = false;
+          }
+        } else {
+          // event message: send all pending messages
+          size_t r(msg->rpos.load(std::memory_order_relaxed));
+          size_t w(msg->wpos.load(std::memory_order_acquire));
+          for(; r != w; r = (r + 1u) % msg->queue.size())
+            add_to_bundle(msg, msg->queue[r]);
+          msg->rpos.store(r, std::memory_order_release);
+        }
+      }
+    }
+    if(bundle) {
+      lo_send_bundle(target->addr, bundle);
+      lo_bundle_free_recursive(bundle);
+      target->last_sent = now;
+      ++num_bundles;
+    }
+  }
+  return cnt;
+}
+
+size_t osc_sender_t::get_num_dropped()
+{
+  std::lock_guard<std::mutex> lock(mtx);
+  size_t cnt(num_dropped_removed);
+  for(auto msg : messages)
+    cnt += msg->dropped;
+  return cnt;
+}
+
+double osc_sender_t::get_mean_latency() const
+{
+  if(num_sent == 0u)
+    return 0.0;
+  return sum_latency / (double)num_sent;
+}
+
+void osc_sender_t::reset_counters()
+{
+  std::lock_guard<std::mutex> lock(mtx);
+  num_sent = 0u;
+  num_coalesced = 0u;
+  num_bundles = 0u;
+  num_dropped_removed = 0u;
+  for(auto msg : messages)
+    msg->dropped = 0u;
+  max_latency = 0.0;
+  sum_latency = 0.0;
+}
+
+void osc_sender_t::sendthread()
+{
+  TASCAR::register_thread(TASCAR::thread_roles_t::network);
+  auto dt(std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+      std::chrono::duration<double>(period)));
+  auto t(std::chrono::steady_clock::now());
+  while(run_thread) {
+    t += dt;
+    std::this_thread::sleep_until(t);
+    process();
+  }
+}
+
+/*
+ * Local Variables:
+ * mode: c++
+ * c-basic-offset: 2
+ * indent-tabs-mode: nil
+ * compile-command: "make -C .."
+ * End:
+ */
@@ -0,0 +1,317 @@
+/*
+ * This file is part of the TASCAR software, see <http://tascar.org/>
+ *
+ * Copyright (c) 2026 agent
+ */
+/*
+ * TASCAR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, version 3 of the License.
+ *
+ * TASCAR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHATABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License, version 3 for more details.
+ *
+ * You should have received a copy of the GNU General Public License,
+ * Version 3 along with TASCAR. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "errorhandling.h"
+#include "osc_sender.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace TASCAR;
+
+namespace {
+
+  struct received_msg_t {
+    std::string path;
+    std::string types;
+    std::vector<double> num;
+    std::vector<std::string> str;
+  };
+
+  /// Local UDP sink which decodes OSC messages and bundles
+  class udp_sink_t {
+  public:
+    udp_sink_t()
+    {
+      fd = socket(AF_INET, SOCK_DGRAM, 0);
+      sockaddr_in addr;
+      memset(&addr, 0, sizeof(addr));
+      addr.sin_family = AF_INET;
+      addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+      addr.sin_port = 0;
+      bind(fd, (sockaddr*)&addr, sizeof(addr));
+      socklen_t len(sizeof(addr));
+      getsockname(fd, (sockaddr*)&addr, &len);
+      port = ntohs(addr.sin_port);
+      timeval tv = {0, 200000};
+      setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    }
+    ~udp_sink_t() { close(fd); }
+    std::string url() const
+    {
+      return "osc.udp://127.0.0.1:" + std::to_string(port) + "/";
+    }
+    /// Receive one packet, return false on timeout
+    bool receive(std::vector<received_msg_t>& msgs, bool& isbundle)
+    {
+      msgs.clear();
+      char buf[65536];
+      ssize_t len(recv(fd, buf, sizeof(buf), 0));
+      if(len <= 0)
+        return false;
+      isbundle = (strcmp(buf, "#bundle") == 0);
+      if(!isbundle) {
+        msgs.push_back(decode(buf, len));
+        return true;
+      }
+      size_t pos(16);
+      while(pos + 4 <= (size_t)len) {
+        size_t size(get32(buf + pos));
+        pos += 4;
+        msgs.push_back(decode(buf + pos, size));
+        pos += size;
+      }
+      return true;
+    }
+
+  private:
+    static uint32_t get32(const char* p)
+    {
+      uint32_t v;
+      memcpy(&v, p, 4);
+      return ntohl(v);
+    }
+    static std::string getstr(const char* p, size_t& pos)
+    {
+      std::string s(p + pos);
+      pos += (s.size() + 4u) & ~3u;
+      return s;
+    }
+    static received_msg_t decode(const char* p, size_t)
+    {
+      received_msg_t m;
+      size_t pos(0);
+      m.path = getstr(p, pos);
+      m.types = getstr(p, pos).substr(1);
+      for(auto c : m.types)
+        switch(c) {
+        case 'f': {
+          uint32_t u(get32(p + pos));
+          float f;
+          memcpy(&f, &u, 4);
+          m.num.push_back(f);
+          pos += 4;
+        } break;
+        case 'i':
+          m.num.push_back((int32_t)get32(p + pos));
+          pos += 4;
+          break;
+        case 'd': {
+          uint64_t u(((uint64_t)get32(p + pos) << 32) | get32(p + pos + 4));
+          double d;
+          memcpy(&d, &u, 8);
+          m.num.push_back(d);
+          pos += 8;
+        } break;
+        case 's':
+          m.str.push_back(getstr(p, pos));
+          break;
+        }
+      return m;
+    }
+    int fd;
+    uint16_t port;
+  };
+
+} // namespace
+
+TEST(osc_sender_t, coalesce)
+{
+  udp_sink_t sink;
+  osc_sender_t sender(0.0);
+  auto msg(sender.add_message(sink.url(), "/level", "ff"));
+  for(uint32_t k = 0; k < 10; ++k) {
+    msg->set_float(0, k);
+    msg->set_float(1, 2.0f * k);
+    EXPECT_TRUE(msg->post());
+  }
+  EXPECT_EQ(1u, sender.process());
+  std::vector<received_msg_t> rmsgs;
+  bool isbundle(false);
+  ASSERT_TRUE(sink.receive(rmsgs, isbundle));
+  EXPECT_TRUE(isbundle);
+  ASSERT_EQ(1u, rmsgs.size());
+  EXPECT_EQ("/level", rmsgs[0].path);
+  EXPECT_EQ("ff", rmsgs[0].types);
+  EXPECT_EQ(std::vector<double>({9.0, 18.0}), rmsgs[0].num);
+  EXPECT_EQ(9u, sender.get_num_coalesced());
+  EXPECT_EQ(1u, sender.get_num_sent());
+  EXPECT_EQ(0u, sender.get_num_dropped());
+  // nothing pending:
+  EXPECT_EQ(0u, sender.process());
+  EXPECT_FALSE(sink.receive(rmsgs, isbundle));
+}
+
+TEST(osc_sender_t, coalesce_same_path)
+{
+  udp_sink_t sink;
+  osc_sender_t sender(0.0);
+  auto msg1(sender.add_message(sink.url(), "/level", "f"));
+  auto msg2(sender.add_message(sink.url(), "/level", "f"));
+  auto other(sender.add_message(sink.url(), "/other", "f"));
+  msg2->set_float(0, 2.0f);
+  msg2->post();
+  msg1->set_float(0, 1.0f);
+  msg1->post();
+  other->set_float(0, 3.0f);
+  other->post();
+  // only the latest message of each path is sent:
+  EXPECT_EQ(2u, sender.process());
+  EXPECT_EQ(1u, sender.get_num_coalesced());
+  std::vector<received_msg_t> rmsgs;
+  bool isbundle(false);
+  ASSERT_TRUE(sink.receive(rmsgs, isbundle));
+  ASSERT_EQ(2u, rmsgs.size());
+  EXPECT_EQ("/level", rmsgs[0].path);
+  EXPECT_EQ(std::vector<double>({1.0}), rmsgs[0].num);
+  EXPECT_EQ("/other", rmsgs[1].path);
+  EXPECT_EQ(std::vector<double>({3.0}), rmsgs[1].num);
+}
+
+TEST(osc_sender_t, ttl)
+{
+  udp_sink_t sink;
+  osc_sender_t sender(0.0);
+  auto msg1(sender.add_message(sink.url(), "/a", "f", true, 0.0, 1));
+  auto msg2(sender.add_message(sink.url(), "/b", "f", true, 0.0, 1));
+  auto msg3(sender.add_message(sink.url(), "/c", "f", true, 0.0, 4));
+  msg1->post();
+  msg2->post();
+  msg3->post();
+  EXPECT_EQ(3u, sender.process());
+  // messages with a different ttl can not share a bundle:
+  EXPECT_EQ(2u, sender.get_num_bundles());
+  std::vector<received_msg_t> rmsgs;
+  bool isbundle(false);
+  ASSERT_TRUE(sink.receive(rmsgs, isbundle));
+  ASSERT_EQ(2u, rmsgs.size());
+  EXPECT_EQ("/a", rmsgs[0].path);
+  EXPECT_EQ("/b", rmsgs[1].path);
+  ASSERT_TRUE(sink.receive(rmsgs, isbundle));
+  ASSERT_EQ(1u, rmsgs.size());
+  EXPECT_EQ("/c", rmsgs[0].path);
+}
+
+TEST(osc_sender_t, events_and_bundles)
+{
+  udp_sink_t sink;
+  osc_sender_t sender(0.0);
+  auto ev(sender.add_message(sink.url(), "/onset", "sid", false));
+  auto st(sender.add_message(sink.url(), "/state", "f"));
+  for(int32_t k = 0; k < 5; ++k) {
+    ev->set_string(0, (k & 1) ? "L" : "R");
+    ev->set_int(1, k);
+    ev->set_double(2, 0.5 * k);
+    EXPECT_TRUE(ev->post());
+  }
+  st->set_float(0, 1.0f);
+  st->post();
+  EXPECT_EQ(6u, sender.process());
+  EXPECT_EQ(1u, sender.get_num_bundles());
+  std::vector<received_msg_t> rmsgs;
+  bool isbundle(false);
+  ASSERT_TRUE(sink.receive(rmsgs, isbundle));
+  ASSERT_EQ(6u, rmsgs.size());
+  for(int32_t k = 0; k < 5; ++k) {
+    EXPECT_EQ("/onset", rmsgs[k].path);
+    EXPECT_EQ("sid", rmsgs[k].types);
+    ASSERT_EQ(1u, rmsgs[k].str.size());
+    EXPECT_EQ((k & 1) ? "L" : "R", rmsgs[k].str[0]);
+    EXPECT_EQ(std::vector<double>({(double)k, 0.5 * k}), rmsgs[k].num);
+  }
+  EXPECT_EQ("/state", rmsgs[5].path);
+  EXPECT_THROW(sender.add_message(sink.url(), "/blob", "b"), TASCAR::ErrMsg);
+}
+
+TEST(osc_sender_t, overflow)
+{
+  udp_sink_t sink;
+  osc_sender_t sender(0.0);
+  auto ev(sender.add_message(sink.url(), "/onset", "i", false, 0.0, 1, 4));
+  size_t posted(0);
+  for(int32_t k = 0; k < 10; ++k) {
+    ev->set_int(0, k);
+    posted += ev->post();
+  }
+  EXPECT_EQ(4u, posted);
+  EXPECT_EQ(6u, sender.get_num_dropped());
+  EXPECT_EQ(4u, sender.process());
+  sender.remove_message(ev);
+  EXPECT_EQ(6u, sender.get_num_dropped());
+  sender.reset_counters();
+  EXPECT_EQ(0u, sender.get_num_dropped());
+}
+
+TEST(osc_sender_t, ratelimit)
+{
+  udp_sink_t sink;
+  osc_sender_t sender(0.0);
+  auto msg(sender.add_message(sink.url(), "/pos", "fff", true, 10.0));
+  msg->set_float(0, 1.0f);
+  msg->post();
+  EXPECT_EQ(1u, sender.process());
+  msg->set_float(0, 2.0f);
+  msg->post();
+  msg->set_float(0, 3.0f);
+  msg->post();
+  // rate limit prevents sending, latest value is kept:
+  EXPECT_EQ(0u, sender.process());
+  usleep(120000);
+  EXPECT_EQ(1u, sender.process());
+  std::vector<received_msg_t> rmsgs;
+  bool isbundle(false);
+  ASSERT_TRUE(sink.receive(rmsgs, isbundle));
+  ASSERT_TRUE(sink.receive(rmsgs, isbundle));
+  ASSERT_EQ(1u, rmsgs.size());
+  // arguments which are not set keep their previous value:
+  EXPECT_EQ(std::vector<double>({3.0, 0.0, 0.0}), rmsgs[0].num);
+  EXPECT_EQ(1u, sender.get_num_coalesced());
+}
+
+TEST(osc_sender_t, thread)
+{
+  udp_sink_t sink;
+  osc_sender_t sender(0.001);
+  auto msg(sender.add_message(sink.url(), "/level", "f"));
+  std::vector<received_msg_t> rmsgs;
+  bool isbundle(false);
+  for(uint32_t k = 0; k < 10; ++k) {
+    msg->set_float(0, k);
+    msg->post();
+    ASSERT_TRUE(sink.receive(rmsgs, isbundle));
+    ASSERT_EQ(1u, rmsgs.size());
+    EXPECT_EQ((double)k, rmsgs[0].num[0]);
+  }
+  EXPECT_EQ(10u, sender.get_num_sent());
+  EXPECT_GT(sender.get_max_latency(), 0.0);
+  EXPECT_LT(sender.get_mean_latency(), 0.1);
+}
+
+/*
+ * Local Variables:
+ * mode: c++
+ * c-basic-offset: 2
+ * indent-tabs-mode: nil
+ * compile-command: "make -C .."
+ * End:
+ */
@@ -0,0 +1,147 @@
+/*
+ * This file is part of the TASCAR software, see <http://tascar.org/>
+ *
+ * Copyright (c) 2026 agent
+ */
+/*
+ * TASCAR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, version 3 of the License.
+ *
+ * TASCAR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHATABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License, version 3 for more details.
+ *
+ * You should have received a copy of the GNU General Public License,
+ * Version 3 along with TASCAR. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "osclog.h"
+#include "errorhandling.h"
+#include "tscconfig.h"
+#include <string.h>
+
+using namespace TASCAR;
+
+osc_log_writer_t::osc_log_writer_t(const std::string& fname, uint32_t srate,
+                                   uint32_t fragsize)
+{
+  header.srate = srate;
+  header.fragsize = fragsize;
+  fh = fopen(fname.c_str(), "wb");
+  if(!fh)
+    throw TASCAR::ErrMsg("Unable to create OSC log file \"" + fname + "\".");
+  if(fwrite(&header, sizeof(header), 1, fh) != 1) {
+    fclose(fh);
+    throw TASCAR::ErrMsg("Unable to write OSC log file \"" + fname + "\".");
+  }
+}
+
+osc_log_writer_t::~osc_log_writer_t()
+{
+  // rewrite header, which contains the anchor frame:
+  if(fseek(fh, 0, SEEK_SET) == 0)
+    if(fwrite(&header, sizeof(header), 1, fh) != 1)
+      TASCAR::add_warning("Unable to write header of OSC log file.");
+  fclose(fh);
+}
+
+void osc_log_writer_t::add(uint64_t frame, const void* data, uint32_t size)
+{
+  std::lock_guard<std::mutex> lock(mtx);
+  if((fwrite(&frame, sizeof(frame), 1, fh) != 1) ||
+     (fwrite(&size, sizeof(size), 1, fh) != 1) ||
+     (fwrite(data, 1, size, fh) != size))
+    return;
+  ++nmsg;
+  nbytes += sizeof(frame) + sizeof(size) + size;
+}
+
+void osc_log_writer_t::add(uint64_t frame, const char* path, lo_message msg)
+{
+  size_t len(lo_message_length(msg, path));
+  std::vector<char> data(len);
+  if(!lo_message_serialise(msg, path, data.data(), &len))
+    return;
+  add(frame, data.data(), (uint32_t)len);
+}
+
+void osc_log_writer_t::set_anchor(uint64_t frame)
+{
+  std::lock_guard<std::mutex> lock(mtx);
+  header.anchor = frame;
+}
+
+osc_log_reader_t::osc_log_reader_t(const std::string& fname)
+{
+  FILE* fh(fopen(fname.c_str(), "rb"));
+  if(!fh)
+    throw TASCAR::ErrMsg("Unable to open OSC log file \"" + fname + "\".");
+  osc_log_header_t ref;
+  if((fread(&header, sizeof(header), 1, fh) != 1) ||
+     (memcmp(header.magic, ref.magic, sizeof(ref.magic)) != 0) ||
+     (header.version != ref.version)) {
+    fclose(fh);
+    throw TASCAR::ErrMsg("Invalid OSC log file \"" + fname + "\".");
+  }
+  fseek(fh, 0, SEEK_END);
+  long len(ftell(fh));
+  fseek(fh, sizeof(header), SEEK_SET);
+  if(len > (long)sizeof(header))
+    data.resize(len - sizeof(header));
+  size_t nread(fread(data.data(), 1, data.size(), fh));
+  fclose(fh);
+  data.resize(nread);
+  // index records, ignore truncated last record:
+  size_t pos(0u);
+  const size_t recheader(sizeof(uint64_t) + sizeof(uint32_t));
+  while(pos + recheader <= data.size()) {
+    msg_t msg;
+    memcpy(&msg.frame, &(data[pos]), sizeof(uint64_t));
+    memcpy(&msg.size, &(data[pos + sizeof(uint64_t)]), sizeof(uint32_t));
+    msg.offset = pos + recheader;
+    if(msg.offset + msg.size > data.size())
+      break;
+    if(msgs.size() && (msg.frame < msgs.back().frame))
+      throw TASCAR::ErrMsg("Time stamps in OSC log file \"" + fname +
+                           "\" are not in ascending order.");
+    msgs.push_back(msg);
+    pos = msg.offset + msg.size;
+  }
+}
+
+std::string osc_log_reader_t::get_path(size_t k) const
+{
+  // the OSC path is the first null-terminated string of a message:
+  const char* p(&(data[msgs[k].offset]));
+  return std::string(p, strnlen(p, msgs[k].size));
+}
+
+osc_log_player_t::osc_log_player_t(const std::string& fname, bool sync)
+    : log(fname), sync(sync)
+{
+  if(sync)
+    frame = log.get_header().anchor;
+}
+
+void osc_log_player_t::next_period(uint32_t nframes, bool rolling,
+                                   size_t& first, size_t& last)
+{
+  first = next;
+  while((next < log.size()) && (log.get_frame(next) < frame))
+    ++next;
+  last = next;
+  if(rolling || (!sync))
+    frame += nframes;
+}
+
+/*
+ * Local Variables:
+ * mode: c++
+ * c-basic-offset: 2
+ * indent-tabs-mode: nil
+ * compile-command: "make -C .."
+ * End:
+ */
@@ -0,0 +1,184 @@
+/*
+ * This file is part of the TASCAR software, see <http://tascar.org/>
+ *
+ * Copyright (c) 2026 agent
+ */
+/*
+ * TASCAR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, version 3 of the License.
+ *
+ * TASCAR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHATABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License, version 3 for more details.
+ *
+ * You should have received a copy of the GNU General Public License,
+ * Version 3 along with TASCAR. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include "errorhandling.h"
+#include "osclog.h"
+#include <string.h>
+#include <unistd.h>
+
+namespace {
+
+  /// Serialized OSC message without arguments
+  std::vector<char> osc_message(const std::string& path)
+  {
+    // path and type tag string, null-terminated and padded to four bytes:
+    std::vector<char> data((path.size() + 4) & ~3u, 0);
+    memcpy(data.data(), path.c_str(), path.size());
+    data.push_back(',');
+    data.resize(data.size() + 3, 0);
+    return data;
+  }
+
+} // namespace
+
+TEST(osc_log_t, write_read)
+{
+  const std::string fname("osclog_unit_test.bin");
+  {
+    TASCAR::osc_log_writer_t log(fname, 48000, 256);
+    auto msg(osc_message("/scene/src/pos"));
+    log.add(0, msg.data(), msg.size());
+    msg = osc_message("/transport/start");
+    log.add(100, msg.data(), msg.size());
+    log.set_anchor(512);
+    msg = osc_message("/a");
+    log.add(1000, msg.data(), msg.size());
+    EXPECT_EQ(3u, log.get_num_messages());
+    EXPECT_EQ(3u * 12u + 20u + 24u + 8u, log.get_num_bytes());
+  }
+  TASCAR::osc_log_reader_t log(fname);
+  EXPECT_EQ(48000u, log.get_header().srate);
+  EXPECT_EQ(256u, log.get_header().fragsize);
+  EXPECT_EQ(512u, log.get_header().anchor);
+  ASSERT_EQ(3u, log.size());
+  EXPECT_EQ(0u, log.get_frame(0));
+  EXPECT_EQ(100u, log.get_frame(1));
+  EXPECT_EQ(1000u, log.get_frame(2));
+  EXPECT_EQ("/scene/src/pos", log.get_path(0));
+  EXPECT_EQ("/transport/start", log.get_path(1));
+  EXPECT_EQ("/a", log.get_path(2));
+  EXPECT_EQ(8u, log.get_size(2));
+  EXPECT_EQ(0, memcmp(osc_message("/a").data(), log.get_data(2), 8));
+  remove(fname.c_str());
+}
+
+TEST(osc_log_t, truncated)
+{
+  // a log which was not closed properly may contain an incomplete
+  // last record, which is ignored:
+  const std::string fname("osclog_unit_test_trunc.bin");
+  {
+    TASCAR::osc_log_writer_t log(fname, 44100, 64);
+    auto msg(osc_message("/abc"));
+    log.add(10, msg.data(), msg.size());
+    log.add(20, msg.data(), msg.size());
+  }
+  FILE* fh(fopen(fname.c_str(), "r+b"));
+  ASSERT_TRUE(fh != NULL);
+  fseek(fh, 0, SEEK_END);
+  long len(ftell(fh));
+  fclose(fh);
+  ASSERT_EQ(0, truncate(fname.c_str(), len - 3));
+  TASCAR::osc_log_reader_t log(fname);
+  ASSERT_EQ(1u, log.size());
+  EXPECT_EQ(10u, log.get_frame(0));
+  EXPECT_EQ("/abc", log.get_path(0));
+  remove(fname.c_str());
+}
+
+TEST(osc_log_t, invalid)
+{
+  EXPECT_THROW(TASCAR::osc_log_reader_t("nonexisting_osclog.bin"),
+               TASCAR::ErrMsg);
+  const std::string fname("osclog_unit_test_invalid.bin");
+  FILE* fh(fopen(fname.c_str(), "wb"));
+  ASSERT_TRUE(fh != NULL);
+  fprintf(fh, "this is not an OSC log file, but a text file.\n");
+  fclose(fh);
+  EXPECT_THROW(TASCAR::osc_log_reader_t log(fname), TASCAR::ErrMsg);
+  remove(fname.c_str());
+}
+
+TEST(osc_log_player_t, period_timing)
+{
+  // replay a log and check that each message arrives in the period
+  // after the one in which it was recorded:
+  const std::string fname("osclog_unit_test_player.bin");
+  const uint32_t nframes(256);
+  const std::vector<uint64_t> frames = {0,   1,    255,  256, 257,
+                                        511, 1000, 1023, 1024};
+  {
+    TASCAR::osc_log_writer_t log(fname, 48000, nframes);
+    auto msg(osc_message("/a"));
+    for(auto f : frames)
+      log.add(f, msg.data(), msg.size());
+  }
+  TASCAR::osc_log_player_t player(fname, false);
+  std::vector<uint64_t> period(frames.size(), 0u);
+  size_t ndispatched(0u);
+  for(uint64_t p = 0; p < 10; ++p) {
+    size_t first(0u);
+    size_t last(0u);
+    // transport state is ignored without sync:
+    player.next_period(nframes, false, first, last);
+    EXPECT_EQ(ndispatched, first);
+    for(size_t k = first; k < last; ++k)
+      period[k] = p;
+    ndispatched = last;
+    EXPECT_EQ(frames.size() - ndispatched, player.get_remaining());
+  }
+  ASSERT_EQ(frames.size(), ndispatched);
+  for(size_t k = 0; k < frames.size(); ++k)
+    EXPECT_EQ(frames[k] / nframes + 1u, period[k]) << "frame " << frames[k];
+  remove(fname.c_str());
+}
+
+TEST(osc_log_player_t, sync)
+{
+  const std::string fname("osclog_unit_test_player_sync.bin");
+  {
+    TASCAR::osc_log_writer_t log(fname, 48000, 256);
+    auto msg(osc_message("/a"));
+    log.add(0, msg.data(), msg.size());
+    log.add(300, msg.data(), msg.size());
+    log.set_anchor(512);
+    log.add(600, msg.data(), msg.size());
+  }
+  TASCAR::osc_log_player_t player(fname, true);
+  size_t first(0u);
+  size_t last(0u);
+  // messages recorded before the transport started are due first:
+  player.next_period(256, false, first, last);
+  EXPECT_EQ(0u, first);
+  EXPECT_EQ(2u, last);
+  // replay time holds while the transport is stopped:
+  player.next_period(256, false, first, last);
+  EXPECT_EQ(first, last);
+  player.next_period(256, true, first, last);
+  EXPECT_EQ(first, last);
+  EXPECT_EQ(1u, player.get_remaining());
+  // recorded frame 600 is in the period after the anchor:
+  player.next_period(256, true, first, last);
+  EXPECT_EQ(2u, first);
+  EXPECT_EQ(3u, last);
+  EXPECT_EQ(0u, player.get_remaining());
+  remove(fname.c_str());
+}
+
+/*
+ * Local Variables:
+ * mode: c++
+ * c-basic-offset: 2
+ * indent-tabs-mode: nil
+ * compile-command: "make -C .."
+ * End:
+ */
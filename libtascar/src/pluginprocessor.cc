@@ -20,6 +20,7 @@
  */
 
 #include "pluginprocessor.h"
+#include "tascar_os.h"
 
 using namespace TASCAR;
 
@@ -39,6 +40,21 @@ plugin_processor_t::plugin_processor_t(tsccfg::node_t xmlsrc,
     lo_message_add_double(msg, 0.0);
   }
   oscmsgargv = lo_message_get_argv(msg);
+  // plugins share an analysis service until a plugin modifies the
+  // audio signal:
+  TASCAR::analysis_service_t* srv(NULL);
+  for(auto p : plugins) {
+    if(srv)
+      analysis_update.push_back(NULL);
+    else {
+      srv = new TASCAR::analysis_service_t();
+      analysis.push_back(srv);
+      analysis_update.push_back(srv);
+    }
+    p->set_analysis_service(srv);
+    if(p->modifies_audio())
+      srv = NULL;
+  }
   if(use_profiler) {
     std::cout << "<osc path=\"" << profilingpath << "\" size=\""
               << plugins.size() << "\"/>" << std::endl;
@@ -52,13 +68,23 @@ plugin_processor_t::plugin_processor_t(tsccfg::node_t xmlsrc,
 void plugin_processor_t::configure()
 {
   try {
-    for(auto p : plugins)
+    for(auto a : analysis)
+      a->prepare(cfg());
+    heap_bytes.clear();
+    for(auto p : plugins) {
+      size_t heap_before(TASCAR::get_heap_bytes());
       p->prepare(cfg());
+      size_t heap_after(TASCAR::get_heap_bytes());
+      heap_bytes.push_back(heap_after - std::min(heap_before, heap_after));
+    }
   }
   catch(...) {
     for(auto p : plugins)
       if(p->is_prepared())
         p->release();
+    for(auto a : analysis)
+      if(a->is_prepared())
+        a->release();
     throw;
   }
 }
@@ -76,18 +102,34 @@ void plugin_processor_t::add_licenses(licensehandler_t* lh)
     p->add_licenses(lh);
 }
 
+std::vector<std::pair<std::string, size_t>>
+plugin_processor_t::get_memory_usage() const
+{
+  std::vector<std::pair<std::string, size_t>> usage;
+  for(size_t k = 0; k < plugins.size(); ++k)
+    usage.push_back(std::make_pair(plugins[k]->get_modname(),
+                                   (k < heap_bytes.size()) ? heap_bytes[k]
+                                                           : 0u));
+  return usage;
+}
+
 void plugin_processor_t::release()
 {
   audiostates_t::release();
   for(auto p : plugins)
     if(p->is_prepared())
       p->release();
+  for(auto a : analysis)
+    if(a->is_prepared())
+      a->release();
 }
 
 plugin_processor_t::~plugin_processor_t()
 {
   for(auto p : plugins)
     delete p;
+  for(auto a : analysis)
+    delete a;
   lo_message_free(msg);
 }
 
@@ -107,6 +149,8 @@ void plugin_processor_t::process_plugins(std::vector<wave_t>& s,
   if(use_profiler)
     tictoc.tic();
   for(auto p : plugins) {
+    if(analysis_update[k])
+      analysis_update[k]->update(s);
     p->ap_process(s, pos, o, tp);
     if(use_profiler) {
       auto t = tictoc.toc();
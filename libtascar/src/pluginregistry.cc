@@ -0,0 +1,207 @@
+/*
+ * This file is part of the TASCAR software, see <http://tascar.org/>
+ *
+ * Copyright (c) 2026 agent
+ */
+/*
+ * TASCAR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, version 3 of the License.
+ *
+ * TASCAR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHATABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License, version 3 for more details.
+ *
+ * You should have received a copy of the GNU General Public License,
+ * Version 3 along with TASCAR. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "pluginregistry.h"
+#include "errorhandling.h"
+#include "tascar_os.h"
+#include "tascarver.h"
+#include "threadrole.h"
+#include <atomic>
+#include <dlfcn.h>
+#include <set>
+#include <thread>
+
+using namespace TASCAR;
+
+plugin_registry_t& plugin_registry_t::get()
+{
+  static plugin_registry_t registry;
+  return registry;
+}
+
+void* plugin_registry_t::open(const std::string& libname, std::string& errmsg)
+{
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    auto it(libs.find(libname));
+    if(it != libs.end()) {
+      ++cache_hits;
+      return it->second;
+    }
+    ++cache_misses;
+  }
+  // library search and loading is done without lock, to allow for
+  // parallel preloading:
+  void* lib(TASCAR::dlopen((TASCAR::get_libdir() + libname).c_str(), RTLD_NOW));
+  if(!lib) {
+    const char* err(dlerror());
+    errmsg = err ? err : "unknown error";
+    return NULL;
+  }
+  std::lock_guard<std::mutex> lock(mtx);
+  auto ins(libs.insert(std::make_pair(libname, lib)));
+  if(!ins.second)
+    // the library was opened by another thread in the meantime:
+    dlclose(lib);
+  return ins.first->second;
+}
+
+void* plugin_registry_t::get_factory(void* lib, const std::string& libname,
+                                     const std::string& baseclass)
+{
+  auto key(std::make_pair(lib, baseclass));
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    auto it(factories.find(key));
+    if(it != factories.end())
+      return it->second;
+  }
+  typedef const char* (*tascar_version_t)();
+  tascar_version_t tscver(
+      (tascar_version_t)dlsym(lib, (baseclass + "_tascar_version").c_str()));
+  if(!tscver)
+    throw TASCAR::ErrMsg(
+        "Unable to resolve tascar version function\n(module: " + libname +
+        ").");
+  std::string cl_tscver(TASCARVER);
+  std::string pl_tscver(tscver());
+  if(cl_tscver != pl_tscver)
+    throw TASCAR::ErrMsg("Invalid plugin version " + pl_tscver +
+                         ".\n(module: " + libname + ", expected version " +
+                         cl_tscver + ").");
+  void* factory(dlsym(lib, (baseclass + "_factory").c_str()));
+  if(!factory)
+    throw TASCAR::ErrMsg("Unable to resolve factory of " + baseclass +
+                         "\n(module: " + libname + ").");
+  std::lock_guard<std::mutex> lock(mtx);
+  factories[key] = factory;
+  return factory;
+}
+
+size_t plugin_registry_t::preload(const std::vector<std::string>& libnames,
+                                  uint32_t numthreads)
+{
+  std::vector<std::string> names;
+  for(auto& libname : std::set<std::string>(libnames.begin(), libnames.end()))
+    if(!is_loaded(libname))
+      names.push_back(libname);
+  std::atomic<size_t> next(0u);
+  std::atomic<size_t> failed(0u);
+  auto worker([&]() {
+    size_t k;
+    std::string errmsg;
+    while((k = next++) < names.size())
+      if(!open(names[k], errmsg))
+        ++failed;
+  });
+  numthreads = std::max(1u, std::min(numthreads, (uint32_t)names.size()));
+  std::vector<std::thread> threads;
+  for(uint32_t k = 1; k < numthreads; ++k)
+    threads.emplace_back([&worker]() {
+      TASCAR::register_thread(TASCAR::thread_roles_t::background);
+      worker();
+    });
+  worker();
+  for(auto& th : threads)
+    th.join();
+  return failed;
+}
+
+bool plugin_registry_t::is_loaded(const std::string& libname)
+{
+  std::lock_guard<std::mutex> lock(mtx);
+  return libs.find(libname) != libs.end();
+}
+
+size_t plugin_registry_t::get_num_libraries()
+{
+  std::lock_guard<std::mutex> lock(mtx);
+  return libs.size();
+}
+
+size_t plugin_registry_t::get_num_cache_hits()
+{
+  std::lock_guard<std::mutex> lock(mtx);
+  return cache_hits;
+}
+
+size_t plugin_registry_t::get_num_cache_misses()
+{
+  std::lock_guard<std::mutex> lock(mtx);
+  return cache_misses;
+}
+
+std::string TASCAR::plugin_libname(const std::string& prefix,
+                                   const std::string& type)
+{
+  std::string libname(prefix);
+#ifdef PLUGINPREFIX
+  libname = PLUGINPREFIX + libname;
+#endif
+  return libname + type + TASCAR::dynamic_lib_extension();
+}
+
+namespace {
+
+  void add_plugin_libnames(tsccfg::node_t e, const std::string& parentname,
+                           std::set<std::string>& libnames)
+  {
+    std::string name(tsccfg::node_get_name(e));
+    auto get_type([&](const std::string& def) {
+      std::string type(tsccfg::node_get_attribute_value(e, "type"));
+      if(type.empty())
+        type = def;
+      return TASCAR::env_expand(type);
+    });
+    if(parentname == "plugins") {
+      if(name == "plugin")
+        name = get_type("");
+      libnames.insert(plugin_libname("tascar_ap_", name));
+    } else if(parentname == "modules") {
+      if(name != "include")
+        libnames.insert(plugin_libname("tascar_", name));
+    } else if(name == "receiver")
+      libnames.insert(plugin_libname("tascarreceiver_", get_type("omni")));
+    else if(name == "reverb")
+      libnames.insert(plugin_libname("tascarreceiver_", get_type("simplefdn")));
+    else if(name == "sound")
+      libnames.insert(plugin_libname("tascarsource_", get_type("omni")));
+    else if(name == "maskplugin")
+      libnames.insert(plugin_libname("tascar_mask_", get_type("")));
+    for(auto& sne : tsccfg::node_get_children(e))
+      add_plugin_libnames(sne, tsccfg::node_get_name(e), libnames);
+  }
+
+} // namespace
+
+std::vector<std::string> TASCAR::get_plugin_libnames(tsccfg::node_t e)
+{
+  std::set<std::string> libnames;
+  add_plugin_libnames(e, "", libnames);
+  return std::vector<std::string>(libnames.begin(), libnames.end());
+}
+
+/*
+ * Local Variables:
+ * mode: c++
+ * c-basic-offset: 2
+ * indent-tabs-mode: nil
+ * compile-command: "make -C .."
+ * End:
+ */
@@ -0,0 +1,111 @@
+/*
+ * This file is part of the TASCAR software, see <http://tascar.org/>
+ *
+ * Copyright (c) 2026 agent
+ */
+/*
+ * TASCAR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, version 3 of the License.
+ *
+ * TASCAR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHATABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License, version 3 for more details.
+ *
+ * You should have received a copy of the GNU General Public License,
+ * Version 3 along with TASCAR. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "pluginregistry.h"
+#include "tascar_os.h"
+
+TEST(plugin_registry_t, open_failure)
+{
+  std::string errmsg;
+  auto& registry(TASCAR::plugin_registry_t::get());
+  std::string libname(
+      TASCAR::plugin_libname("tascar_ap_", "doesnotexist_unittest"));
+  size_t hits(registry.get_num_cache_hits());
+  size_t misses(registry.get_num_cache_misses());
+  EXPECT_EQ(NULL, registry.open(libname, errmsg));
+  EXPECT_FALSE(errmsg.empty());
+  EXPECT_FALSE(registry.is_loaded(libname));
+  // failures are not cached:
+  EXPECT_EQ(NULL, registry.open(libname, errmsg));
+  EXPECT_EQ(hits, registry.get_num_cache_hits());
+  EXPECT_EQ(misses + 2u, registry.get_num_cache_misses());
+  EXPECT_EQ(2u, registry.preload({libname, libname, libname + "2"}, 4));
+  EXPECT_FALSE(registry.is_loaded(libname));
+}
+
+TEST(plugin_registry_t, plugin_libname)
+{
+  std::string libname(TASCAR::plugin_libname("tascarreceiver_", "omni"));
+  EXPECT_NE(std::string::npos, libname.find("tascarreceiver_omni"));
+  std::string ext(TASCAR::dynamic_lib_extension());
+  EXPECT_EQ(ext, libname.substr(libname.size() - ext.size()));
+}
+
+TEST(plugin_registry_t, get_plugin_libnames)
+{
+  TASCAR::xml_doc_t doc(
+      "<session><scene><source><sound><plugins><sndfile/>"
+      "<plugin type=\"identity\"/></plugins></sound>"
+      "<sound type=\"cardioidmod\"/></source>"
+      "<receiver type=\"hoa2d\"/><receiver/></scene>"
+      "<modules><route><plugins><identity/></plugins></route></modules>"
+      "</session>",
+      TASCAR::xml_doc_t::LOAD_STRING);
+  auto libnames(TASCAR::get_plugin_libnames(doc.root()));
+  std::vector<std::string> expected;
+  expected.push_back(TASCAR::plugin_libname("tascar_ap_", "sndfile"));
+  expected.push_back(TASCAR::plugin_libname("tascar_ap_", "identity"));
+  expected.push_back(TASCAR::plugin_libname("tascarsource_", "omni"));
+  expected.push_back(TASCAR::plugin_libname("tascarsource_", "cardioidmod"));
+  expected.push_back(TASCAR::plugin_libname("tascarreceiver_", "hoa2d"));
+  expected.push_back(TASCAR::plugin_libname("tascarreceiver_", "omni"));
+  expected.push_back(TASCAR::plugin_libname("tascar_", "route"));
+  std::sort(expected.begin(), expected.end());
+  EXPECT_EQ(expected, libnames);
+}
+
+TEST(plugin_registry_t, cache_hits)
+{
+  // resolve the factory of many instances of the same audio plugin,
+  // as it happens when a session with many "ap" plugins is loaded:
+  const uint32_t numinstances(500);
+  std::string libname(TASCAR::plugin_libname("tascar_ap_", "identity"));
+  auto& registry(TASCAR::plugin_registry_t::get());
+  std::string errmsg;
+  void* lib(registry.open(libname, errmsg));
+  if(!lib)
+    GTEST_SKIP() << "audio plugins not available: " << errmsg;
+  EXPECT_TRUE(registry.is_loaded(libname));
+  size_t hits(registry.get_num_cache_hits());
+  size_t misses(registry.get_num_cache_misses());
+  size_t numlibs(registry.get_num_libraries());
+  void* factory(registry.get_factory(lib, libname, "audioplugin_base_t"));
+  EXPECT_TRUE(factory != NULL);
+  for(uint32_t k = 0; k < numinstances; ++k) {
+    void* ilib(registry.open(libname, errmsg));
+    ASSERT_EQ(lib, ilib);
+    EXPECT_EQ(factory,
+              registry.get_factory(ilib, libname, "audioplugin_base_t"));
+  }
+  // the library is opened only once:
+  EXPECT_EQ(hits + numinstances, registry.get_num_cache_hits());
+  EXPECT_EQ(misses, registry.get_num_cache_misses());
+  EXPECT_EQ(numlibs, registry.get_num_libraries());
+}
+
+/*
+ * Local Variables:
+ * mode: c++
+ * c-basic-offset: 2
+ * indent-tabs-mode: nil
+ * compile-command: "make -C .."
+ * End:
+ */
@@ -0,0 +1,181 @@
+/*
+ * This file is part of the TASCAR software, see <http://tascar.org/>
+ *
+ * Copyright (c) 2026 agent
+ */
+/*
+ * TASCAR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, version 3 of the License.
+ *
+ * TASCAR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHATABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License, version 3 for more details.
+ *
+ * You should have received a copy of the GNU General Public License,
+ * Version 3 along with TASCAR. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "posepredictor.h"
+#include <algorithm>
+
+using namespace TASCAR;
+
+namespace {
+
+  pos_t scaled(pos_t v, double s)
+  {
+    v *= s;
+    return v;
+  }
+
+  /// Rotation vector (axis times angle) of a unit quaternion
+  pos_t rotvec(quaternion_t q)
+  {
+    // use shortest rotation:
+    if(q.w < 0.0f)
+      q *= -1.0f;
+    pos_t v(q.x, q.y, q.z);
+    double s(v.norm());
+    if(s < 1e-9)
+      return scaled(v, 2.0);
+    return scaled(v, 2.0 * atan2(s, (double)q.w) / s);
+  }
+
+  /// Unit quaternion of a rotation vector
+  quaternion_t from_rotvec(const pos_t& r)
+  {
+    double angle(r.norm());
+    quaternion_t q(1.0f, 0.0f, 0.0f, 0.0f);
+    if(angle > 1e-9)
+      q.set_rotation((float)angle, scaled(r, 1.0 / angle));
+    return q;
+  }
+
+  /// Rotation from q1 to q2, in body coordinates of q1
+  pos_t relative_rotvec(const quaternion_t& q1, const quaternion_t& q2)
+  {
+    return rotvec(q1.conjugate() * q2);
+  }
+
+  quaternion_t normalized(const quaternion_t& q)
+  {
+    float n(sqrtf(q.norm()));
+    if(n > 0.0f)
+      return q.scale(1.0f / n);
+    return quaternion_t(1.0f, 0.0f, 0.0f, 0.0f);
+  }
+
+} // namespace
+
+pose_predictor_t::pose_predictor_t()
+{
+  reset();
+}
+
+void pose_predictor_t::reset()
+{
+  has_orientation = false;
+  has_gyr = false;
+  t_cur = 0.0;
+  q_cur = quaternion_t(1.0f, 0.0f, 0.0f, 0.0f);
+  omega = pos_t();
+  interval = 0.0;
+  err2_pred = 0.0;
+  err2_unpred = 0.0;
+  gain_num = 0.0;
+  gain_den = 0.0;
+  pending.clear();
+}
+
+double pose_predictor_t::get_gain() const
+{
+  if((adaptation <= 0.0) || (gain_den <= 0.0))
+    return 1.0;
+  return std::min(1.0, std::max(0.0, gain_num / gain_den));
+}
+
+void pose_predictor_t::add_angular_velocity(double t, const pos_t& omega_)
+{
+  omega = omega_;
+  t_gyr = t;
+  has_gyr = true;
+}
+
+void pose_predictor_t::evaluate(double t, const quaternion_t& q)
+{
+  const pos_t r_step(relative_rotvec(q_cur, q));
+  while(!pending.empty() && (pending.front().t <= t)) {
+    const pending_t& p(pending.front());
+    // measured orientation at target time, interpolated between the
+    // two surrounding samples:
+    double w(1.0);
+    if(t > t_cur)
+      w = std::max(0.0, (p.t - t_cur) / (t - t_cur));
+    quaternion_t q_true(q_cur * from_rotvec(scaled(r_step, w)));
+    double e_pred(relative_rotvec(p.qpred, q_true).norm());
+    double e_unpred(relative_rotvec(p.q0, q_true).norm());
+    err2_pred += errorsmoothing * (e_pred * e_pred - err2_pred);
+    err2_unpred += errorsmoothing * (e_unpred * e_unpred - err2_unpred);
+    // least squares fit of the velocity gain, weighted by the
+    // magnitude of the predicted rotation:
+    if(adaptation > 0.0) {
+      pos_t r_true(relative_rotvec(p.q0, q_true));
+      gain_num += adaptation * (dot_prod(r_true, p.r) - gain_num);
+      gain_den += adaptation * (dot_prod(p.r, p.r) - gain_den);
+    }
+    pending.pop_front();
+  }
+}
+
+void pose_predictor_t::add_orientation(double t, const quaternion_t& q_)
+{
+  quaternion_t q(normalized(q_));
+  if(has_orientation && (t > t_cur)) {
+    double dt(t - t_cur);
+    evaluate(t, q);
+    if(interval > 0.0)
+      interval += 0.05 * (dt - interval);
+    else
+      interval = dt;
+    if(!(has_gyr && (t - t_gyr < gyrtimeout))) {
+      // finite difference estimate of angular velocity:
+      pos_t omega_fd(scaled(relative_rotvec(q_cur, q), 1.0 / dt));
+      omega += scaled(omega_fd - omega, velocitysmoothing);
+    }
+  } else if(has_orientation)
+    // time is not increasing, e.g., after a reset of the time base:
+    pending.clear();
+  q_cur = q;
+  t_cur = t;
+  has_orientation = true;
+  double h(std::min(horizon, maxhorizon));
+  if(h > 0.0) {
+    pending_t p;
+    p.t = t + h;
+    p.q0 = q;
+    p.r = scaled(omega, h);
+    p.qpred = predict(h);
+    pending.push_back(p);
+    // limit memory in case of very high sampling rates:
+    while(pending.size() > 4096u)
+      pending.pop_front();
+  }
+}
+
+quaternion_t pose_predictor_t::predict(double h) const
+{
+  h = std::max(0.0, std::min(h, maxhorizon));
+  return q_cur * from_rotvec(scaled(omega, h * get_gain()));
+}
+
+/*
+ * Local Variables:
+ * mode: c++
+ * c-basic-offset: 2
+ * indent-tabs-mode: nil
+ * compile-command: "make -C .."
+ * End:
+ */
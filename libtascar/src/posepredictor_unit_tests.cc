@@ -0,0 +1,204 @@
+/*
+ * This file is part of the TASCAR software, see <http://tascar.org/>
+ *
+ * Copyright (c) 2026 agent
+ */
+/*
+ * TASCAR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, version 3 of the License.
+ *
+ * TASCAR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHATABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License, version 3 for more details.
+ *
+ * You should have received a copy of the GNU General Public License,
+ * Version 3 along with TASCAR. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include "posepredictor.h"
+#include <random>
+
+namespace {
+
+  /// Angle between two orientations in rad
+  double angle_between(const TASCAR::quaternion_t& q1,
+                       const TASCAR::quaternion_t& q2)
+  {
+    TASCAR::quaternion_t d(q1.conjugate() * q2);
+    return 2.0 * atan2(sqrt(d.x * d.x + d.y * d.y + d.z * d.z), fabs(d.w));
+  }
+
+  TASCAR::quaternion_t yaw_pitch(double yaw, double pitch)
+  {
+    TASCAR::quaternion_t q;
+    q.set_euler_zyx(TASCAR::zyx_euler_t(yaw, pitch, 0.0));
+    return q;
+  }
+
+  /// Synthetic head movement, mixture of slow turns and nodding
+  TASCAR::quaternion_t head_movement(double t)
+  {
+    return yaw_pitch(0.8 * sin(TASCAR_2PI * 0.4 * t) +
+                         0.3 * sin(TASCAR_2PI * 1.1 * t + 1.0),
+                     0.2 * sin(TASCAR_2PI * 0.7 * t + 0.5));
+  }
+
+  /// Time lag in seconds which minimizes the error to the true movement
+  double estimate_lag(const std::vector<TASCAR::quaternion_t>& out,
+                      double t_offset, double fs)
+  {
+    double best_lag(0.0);
+    double best_err(-1.0);
+    for(int32_t d = -30; d < 60; ++d) {
+      double err(0.0);
+      for(size_t k = 200; k < out.size(); ++k) {
+        double e(angle_between(out[k],
+                               head_movement(k / fs + t_offset - d / fs)));
+        err += e * e;
+      }
+      if((best_err < 0.0) || (err < best_err)) {
+        best_err = err;
+        best_lag = d / fs;
+      }
+    }
+    return best_lag;
+  }
+
+} // namespace
+
+TEST(pose_predictor_t, constant_rotation)
+{
+  TASCAR::pose_predictor_t pred;
+  pred.adaptation = 0.0;
+  const double omega(1.0);
+  TASCAR::quaternion_t q;
+  for(uint32_t k = 0; k < 1000; ++k) {
+    double t(0.01 * k);
+    q.set_rotation(omega * t, TASCAR::pos_t(0, 0, 1));
+    pred.add_orientation(t, q);
+  }
+  EXPECT_NEAR(0.01, pred.get_interval(), 1e-6);
+  EXPECT_NEAR(omega, pred.get_angular_velocity().z, 1e-4);
+  TASCAR::quaternion_t qexp;
+  qexp.set_rotation(omega * (9.99 + 0.1), TASCAR::pos_t(0, 0, 1));
+  EXPECT_NEAR(0.0, angle_between(qexp, pred.predict(0.1)), 1e-4);
+  // prediction of the constant rotation is exact, lag error is the
+  // rotation within the horizon:
+  EXPECT_NEAR(0.0, pred.get_error(), 1e-3);
+  EXPECT_NEAR(omega * pred.horizon, pred.get_error_unpredicted(), 2e-3);
+  // horizon is limited:
+  qexp.set_rotation(omega * (9.99 + pred.maxhorizon), TASCAR::pos_t(0, 0, 1));
+  EXPECT_NEAR(0.0, angle_between(qexp, pred.predict(10.0)), 1e-4);
+}
+
+TEST(pose_predictor_t, gyroscope)
+{
+  TASCAR::pose_predictor_t pred;
+  pred.adaptation = 0.0;
+  TASCAR::quaternion_t q(1, 0, 0, 0);
+  // head is pitched down, gyroscope measures rotation around the
+  // body y-axis:
+  q.set_rotation(0.5, TASCAR::pos_t(0, 1, 0));
+  pred.add_angular_velocity(0.0, TASCAR::pos_t(0, 2.0, 0));
+  pred.add_orientation(0.0, q);
+  pred.add_orientation(0.01, q);
+  EXPECT_NEAR(2.0, pred.get_angular_velocity().y, 1e-9);
+  TASCAR::quaternion_t qexp;
+  qexp.set_rotation(0.5 + 2.0 * 0.05, TASCAR::pos_t(0, 1, 0));
+  EXPECT_NEAR(0.0, angle_between(qexp, pred.predict(0.05)), 1e-5);
+  // outdated gyroscope data is replaced by finite differences:
+  pred.add_orientation(1.0, q);
+  EXPECT_NEAR(1.0, pred.get_angular_velocity().y, 1e-6);
+  pred.reset();
+  EXPECT_EQ(0.0, pred.get_angular_velocity().y);
+  EXPECT_EQ(1.0f, pred.get_orientation().w);
+  EXPECT_EQ(0.0, pred.get_error());
+}
+
+TEST(pose_predictor_t, adaptive_gain)
+{
+  // random orientations do not contain any predictable movement, the
+  // velocity gain must go down:
+  TASCAR::pose_predictor_t pred;
+  pred.adaptation = 0.05;
+  std::mt19937 gen(1);
+  std::normal_distribution<double> dist(0.0, 0.1);
+  for(uint32_t k = 0; k < 1000; ++k)
+    pred.add_orientation(0.01 * k, yaw_pitch(dist(gen), dist(gen)));
+  EXPECT_LT(pred.get_gain(), 0.2);
+  // a constant rotation restores unity gain:
+  TASCAR::quaternion_t q;
+  for(uint32_t k = 1000; k < 3000; ++k) {
+    q.set_rotation(0.01 * k, TASCAR::pos_t(0, 0, 1));
+    pred.add_orientation(0.01 * k, q);
+  }
+  EXPECT_GT(pred.get_gain(), 0.95);
+}
+
+TEST(pose_predictor_t, replay)
+{
+  // offline replay of a head tracker recording: 100 Hz orientation
+  // data with sensor noise, smoothed by a first order low pass filter
+  // as in the ovheadtracker module, followed by a transport and
+  // rendering latency
+  const double fs(100.0);
+  const double smooth(0.1);
+  const double latency(0.02);
+  std::mt19937 gen(1);
+  std::normal_distribution<double> noise(0.0, 0.003);
+  TASCAR::pose_predictor_t pred;
+  // group delay of the low pass filter plus latency:
+  pred.horizon = (1.0 - smooth) / smooth / fs + latency;
+  TASCAR::quaternion_t qstate;
+  std::vector<TASCAR::quaternion_t> out_smooth;
+  std::vector<TASCAR::quaternion_t> out_pred;
+  double err_smooth(0.0);
+  double err_pred(0.0);
+  const size_t N(3000);
+  for(size_t k = 0; k < N; ++k) {
+    double t(k / fs);
+    TASCAR::quaternion_t q(head_movement(t));
+    q.rmul(yaw_pitch(noise(gen), noise(gen)));
+    if(k == 0)
+      qstate = q;
+    else {
+      qstate = qstate.scale(1.0 - smooth);
+      qstate += q.scale(smooth);
+    }
+    q = qstate.scale(1.0 / sqrt(qstate.norm()));
+    pred.add_orientation(t, q);
+    out_smooth.push_back(q);
+    out_pred.push_back(pred.predict());
+    if(k >= 200) {
+      // the orientation is applied after the latency:
+      TASCAR::quaternion_t qtrue(head_movement(t + latency));
+      double e(angle_between(qtrue, out_smooth.back()));
+      err_smooth += e * e;
+      e = angle_between(qtrue, out_pred.back());
+      err_pred += e * e;
+    }
+  }
+  err_smooth = sqrt(err_smooth / (N - 200));
+  err_pred = sqrt(err_pred / (N - 200));
+  double lag_smooth(estimate_lag(out_smooth, latency, fs));
+  double lag_pred(estimate_lag(out_pred, latency, fs));
+  EXPECT_LT(err_pred, 0.5 * err_smooth);
+  EXPECT_LT(fabs(lag_pred), 0.5 * lag_smooth);
+  EXPECT_GT(lag_smooth, 0.08);
+  // online error estimates agree with the offline evaluation:
+  EXPECT_LT(pred.get_error(), pred.get_error_unpredicted());
+}
+
+/*
+ * Local Variables:
+ * mode: c++
+ * c-basic-offset: 2
+ * indent-tabs-mode: nil
+ * compile-command: "make -C .."
+ * End:
+ */
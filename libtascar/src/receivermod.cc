@@ -34,22 +34,13 @@ TASCAR::receivermod_t::receivermod_t(tsccfg::node_t cfg)
 {
   get_attribute("type", receivertype, "", "receiver type");
   receivertype = env_expand(receivertype);
-  std::string libname("tascarreceiver_");
-#ifdef PLUGINPREFIX
-  libname = PLUGINPREFIX + libname;
-#endif
-  libname += receivertype + TASCAR::dynamic_lib_extension();
-  lib = TASCAR::dlopen((TASCAR::get_libdir() + libname).c_str(), RTLD_NOW);
+  std::string libname(TASCAR::plugin_libname("tascarreceiver_", receivertype));
+  std::string emsg;
+  lib = TASCAR::plugin_registry_t::get().open(libname, emsg);
   if(!lib)
     throw TASCAR::ErrMsg("Unable to open receiver module \"" + receivertype +
-                         "\": " + dlerror());
-  try {
-    receivermod_base_t_resolver(&libdata, cfg, lib, libname);
-  }
-  catch(...) {
-    dlclose(lib);
-    throw;
-  }
+                         "\": " + emsg);
+  receivermod_base_t_resolver(&libdata, cfg, lib, libname);
 }
 
 void TASCAR::receivermod_t::add_pointsource(const pos_t& prel, double width,
@@ -88,6 +79,11 @@ float TASCAR::receivermod_t::get_delay_comp() const
   return libdata->get_delay_comp();
 }
 
+bool TASCAR::receivermod_t::is_memoryless() const
+{
+  return libdata->is_memoryless();
+}
+
 void TASCAR::receivermod_t::add_variables(TASCAR::osc_server_t* srv)
 {
   return libdata->add_variables(srv);
@@ -127,7 +123,6 @@ TASCAR::receivermod_t::create_diffuse_state_data(double srate,
 TASCAR::receivermod_t::~receivermod_t()
 {
   delete libdata;
-  dlclose(lib);
 }
 
 TASCAR::receivermod_base_t::receivermod_base_t(tsccfg::node_t xmlsrc)
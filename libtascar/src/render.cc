@@ -21,6 +21,8 @@
  */
 
 #include "render.h"
+#include <map>
+#include <sstream>
 #include <string.h>
 #include <unistd.h>
 
@@ -32,6 +34,9 @@ TASCAR::render_profiler_t::render_profiler_t()
   t_acoustics = 0.0;
   t_postproc = 0.0;
   t_copy = 0.0;
+  geometry_hitrate = 0.0;
+  minor_faults = 0.0;
+  major_faults = 0.0;
   set_tau(1.0, 1.0);
 }
 
@@ -56,12 +61,18 @@ void TASCAR::render_profiler_t::update(const render_profiler_t& src)
   t_acoustics *= A1;
   t_postproc *= A1;
   t_copy *= A1;
+  geometry_hitrate *= A1;
+  minor_faults *= A1;
+  major_faults *= A1;
   t_init += B0 * src.t_init;
   t_geo += B0 * src.t_geo;
   t_preproc += B0 * src.t_preproc;
   t_acoustics += B0 * src.t_acoustics;
   t_postproc += B0 * src.t_postproc;
   t_copy += B0 * src.t_copy;
+  geometry_hitrate += B0 * src.geometry_hitrate;
+  minor_faults += B0 * src.minor_faults;
+  major_faults += B0 * src.major_faults;
 }
 
 void TASCAR::render_profiler_t::set_tau(double t, double fs)
@@ -187,14 +198,32 @@ void TASCAR::render_core_t::configure()
       diffuse_sound_fields.push_back((*it)->get_source());
     }
     // create the world, before first process callback is called:
+    size_t heap_before(TASCAR::get_heap_bytes());
     world = new Acousticmodel::world_t(c, f_sample, n_fragment, sources,
                                        diffuse_sound_fields, reflectors,
                                        obstacles, receivers, pmasks, ismorder);
+    size_t heap_after(TASCAR::get_heap_bytes());
+    world_heap_bytes = heap_after - std::min(heap_before, heap_after);
     total_pointsources = world->get_total_pointsource();
     total_diffuse_sound_fields = world->get_total_diffuse_sound_field();
     ambbuf = new TASCAR::amb1wave_t(n_fragment);
     loadaverage.set_tau(1.0, f_fragment);
+    page_faults_valid = false;
     is_prepared = true;
+    {
+      std::string report(create_memory_report());
+      std::lock_guard<std::mutex> lock(mtx_memory_report);
+      memory_report = report;
+    }
+    {
+      // the render thread publishes the snapshot without allocation:
+      size_t num_models(0u);
+      for(auto graph : world->receivergraphs)
+        num_models += graph->acoustic_model.size();
+      std::lock_guard<std::mutex> lock(mtx_acmodel_snapshot);
+      acmodel_snapshot.clear();
+      acmodel_snapshot.reserve(num_models);
+    }
     pthread_mutex_unlock(&mtx_world);
   }
   catch(...) {
@@ -213,9 +242,107 @@ void TASCAR::render_core_t::release()
   world = NULL;
   is_prepared = false;
   delete ambbuf;
+  {
+    std::lock_guard<std::mutex> lock(mtx_memory_report);
+    memory_report.clear();
+  }
+  {
+    std::lock_guard<std::mutex> lock(mtx_acmodel_snapshot);
+    acmodel_snapshot.clear();
+  }
   pthread_mutex_unlock(&mtx_world);
 }
 
+void TASCAR::render_core_t::get_acousticmodel_snapshot(
+    std::vector<acousticmodel_snapshot_t>& snapshot)
+{
+  std::lock_guard<std::mutex> lock(mtx_acmodel_snapshot);
+  snapshot = acmodel_snapshot;
+  acmodel_snapshot_requested = true;
+}
+
+void TASCAR::render_core_t::publish_acousticmodel_snapshot()
+{
+  if(!(acmodel_snapshot_requested && world))
+    return;
+  // the reader holds the lock only while copying; skip this period
+  // instead of waiting:
+  if(!mtx_acmodel_snapshot.try_lock())
+    return;
+  acmodel_snapshot.clear();
+  for(auto rcgraph : world->receivergraphs)
+    for(auto am : rcgraph->acoustic_model)
+      if(am->receiver_->volumetric.is_null() && am->src_->active &&
+         am->receiver_->active && (am->src_->ismmin <= am->ismorder) &&
+         (am->src_->ismmax >= am->ismorder) &&
+         (am->receiver_->ismmin <= am->ismorder) &&
+         (am->receiver_->ismmax >= am->ismorder) &&
+         (acmodel_snapshot.size() < acmodel_snapshot.capacity())) {
+        acousticmodel_snapshot_t snap;
+        snap.position = am->position;
+        snap.receiver_position = am->receiver_->position;
+        snap.gain = std::min(1.0f, std::max(0.0f, am->get_gain()));
+        snap.ismorder = am->ismorder;
+        acmodel_snapshot.push_back(snap);
+      }
+  acmodel_snapshot_requested = false;
+  mtx_acmodel_snapshot.unlock();
+}
+
+std::string TASCAR::render_core_t::get_memory_report()
+{
+  std::lock_guard<std::mutex> lock(mtx_memory_report);
+  if(memory_report.empty())
+    return "<memory scene=\"" + name + "\"/>\n";
+  return memory_report;
+}
+
+std::string TASCAR::render_core_t::create_memory_report()
+{
+  std::stringstream s;
+  std::map<const Acousticmodel::receiver_t*, std::string> receivernames;
+  for(auto r : receivermod_objects)
+    receivernames[r] = r->get_name();
+  for(auto r : diffuse_reverbs)
+    receivernames[r] = r->get_name();
+  std::map<const Acousticmodel::source_t*, size_t> srcbytes;
+  std::map<const Acousticmodel::source_t*, size_t> srcmodels;
+  size_t arena(0u);
+  for(auto graph : world->receivergraphs) {
+    arena += graph->get_arena_bytes();
+    for(auto model : graph->acoustic_model) {
+      srcbytes[model->src_] += model->get_delayline_bytes();
+      ++srcmodels[model->src_];
+    }
+  }
+  s << "<memory scene=\"" << name << "\" world=\"" << world_heap_bytes
+    << "\" arena=\"" << arena << "\" delaylines=\""
+    << world->get_delayline_bytes() << "\">\n";
+  for(auto graph : world->receivergraphs)
+    s << "  <receiver name=\"" << receivernames[graph->get_receiver()]
+      << "\" bytes=\"" << graph->heap_bytes << "\" arena=\""
+      << graph->get_arena_bytes() << "\" models=\""
+      << graph->get_total_pointsource() +
+             graph->get_total_diffuse_sound_field()
+      << "\"/>\n";
+  for(auto snd : sounds)
+    s << "  <source name=\"" << snd->get_fullname() << "\" delaylines=\""
+      << srcbytes[snd] << "\" models=\"" << srcmodels[snd] << "\"/>\n";
+  auto add_plugins([&](const std::string& parent,
+                       const plugin_processor_t& plugins) {
+    for(auto& usage : plugins.get_memory_usage())
+      s << "  <plugin parent=\"" << parent << "\" type=\"" << usage.first
+        << "\" bytes=\"" << usage.second << "\"/>\n";
+  });
+  for(auto snd : sounds)
+    add_plugins(snd->get_fullname(), snd->plugins);
+  for(auto r : receivermod_objects)
+    add_plugins(r->get_name(),
+                static_cast<Acousticmodel::receiver_t*>(r)->plugins);
+  s << "</memory>\n";
+  return s.str();
+}
+
 double gettime()
 {
   struct timeval tv;
@@ -310,6 +437,7 @@ void TASCAR::render_core_t::process(uint32_t nframes,
       world->process(tp);
       active_pointsources = world->get_active_pointsource();
       active_diffuse_sound_fields = world->get_active_diffuse_sound_field();
+      load_cycle.geometry_hitrate = world->get_geometry_cache_hitrate();
     } else {
       active_pointsources = 0;
       active_diffuse_sound_fields = 0;
@@ -335,8 +463,22 @@ void TASCAR::render_core_t::process(uint32_t nframes,
     for(uint32_t ch = 0; ch < outBuffer.size(); ch++)
       for(uint32_t k = 0; k < nframes; k++)
         make_friendly_number_limited(outBuffer[ch][k]);
+    // page faults since previous period, getrusage is a system call
+    // and thus only used when needed:
+    load_cycle.minor_faults = 0.0;
+    load_cycle.major_faults = 0.0;
+    if(sample_page_faults) {
+      TASCAR::page_faults_t pf(TASCAR::get_page_faults());
+      if(page_faults_valid) {
+        load_cycle.minor_faults = (double)(pf.minor - page_faults.minor);
+        load_cycle.major_faults = (double)(pf.major - page_faults.major);
+      }
+      page_faults = pf;
+      page_faults_valid = true;
+    }
     load_cycle.normalize(t_fragment);
     loadaverage.update(load_cycle);
+    publish_acousticmodel_snapshot();
     pthread_mutex_unlock(&mtx_world);
   }
 }
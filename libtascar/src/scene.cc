@@ -24,15 +24,18 @@
 #include "amb33defs.h"
 #include "errorhandling.h"
 #include "filterclass.h"
+#include "mesh.h"
 #include "tascar_os.h"
 #include <algorithm>
 #include <fstream>
 #include <libgen.h>
 #include <locale.h>
+#include <mutex>
 #include <set>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <tuple>
 #include <unistd.h>
 
 using namespace TASCAR;
@@ -632,25 +635,44 @@ void scene_t::configure()
         throw TASCAR::ErrMsg("Material \"" + mat + "\" is not defined.");
     for(auto mat : used_materials)
       materials[mat].update_coeff(f_sample);
-    for(auto r : face_objects)
+    for(auto r : face_objects) {
+      r->multiband_design = NULL;
       if(!r->material.empty()) {
         r->reflectivity = materials[r->material].reflectivity;
         r->damping = materials[r->material].damping;
+        if(r->multiband)
+          r->multiband_design = materials[r->material].design;
       }
-    for(auto r : facegroups)
+    }
+    for(auto r : facegroups) {
+      const TASCAR::reflectionfilter_design_t* design(NULL);
       if(!r->material.empty()) {
         r->reflectivity = materials[r->material].reflectivity;
         r->damping = materials[r->material].damping;
+        if(r->multiband)
+          design = materials[r->material].design;
       }
-    // prepare all objects:
+      r->multiband_design = design;
+      for(auto rr : r->reflectors)
+        rr->multiband_design = design;
+    }
+    // prepare all objects which are derived from audiostates. The
+    // objects are independent of each other, thus their plugins can
+    // be prepared in parallel:
+    TASCAR::task_pool_t pool;
     for(auto it = all_objects.begin(); it != all_objects.end(); ++it) {
-      // prepare all objects which are derived from audiostates:
       audiostates_t* p_as(dynamic_cast<audiostates_t*>(*it));
       if(p_as) {
         chunk_cfg_t cf(cfg());
-        p_as->prepare(cf);
+        pool.add((*it)->get_name(), [p_as, cf]() {
+          chunk_cfg_t lcf(cf);
+          p_as->prepare(lcf);
+        });
       }
     }
+    prepare_timing.clear();
+    pool.run();
+    prepare_timing = pool.get_timings();
   }
   catch(...) {
     for(auto it = all_objects.begin(); it != all_objects.end(); ++it) {
@@ -857,7 +879,11 @@ face_object_t::~face_object_t() {}
 void face_object_t::geometry_update(double t)
 {
   dynobject_t::geometry_update(t);
-  apply_rot_loc(get_location(), get_orientation());
+  // transform vertices only if the object moved:
+  if(get_transform_version() != applied_transform_version) {
+    apply_rot_loc(get_location(), get_orientation());
+    applied_transform_version = get_transform_version();
+  }
 }
 
 audio_port_t::audio_port_t(tsccfg::node_t xmlsrc, bool is_input_)
@@ -965,60 +991,73 @@ face_group_t::face_group_t(tsccfg::node_t xmlsrc) : object_t(xmlsrc)
       "File name of raw file containing list of polygon surfaces");
   dynobject_t::GET_ATTRIBUTE(shoebox, "m",
                              "Generate a shoebox room of these dimensions");
+  dynobject_t::GET_ATTRIBUTE_BOOL(mergefaces,
+                                  "Merge adjacent coplanar faces at load time");
+  dynobject_t::GET_ATTRIBUTE(mergeangle, "deg",
+                             "Angle tolerance for merging of faces");
+  dynobject_t::GET_ATTRIBUTE(mergedist, "m",
+                             "Distance tolerance for merging of faces");
+  dynobject_t::GET_ATTRIBUTE(minfacefreq, "Hz",
+                             "Remove faces with an aperture smaller than the "
+                             "wavelength at this frequency, or 0 to keep all "
+                             "faces");
+  dynobject_t::GET_ATTRIBUTE(
+      lodorder, "",
+      "Use the full mesh up to this reflection order, and a mesh with reduced "
+      "level of detail for higher orders, or 0 to use the full mesh only");
+  dynobject_t::GET_ATTRIBUTE(lodangle, "deg",
+                             "Angle tolerance for merging of faces of reduced "
+                             "mesh");
+  dynobject_t::GET_ATTRIBUTE(loddist, "m",
+                             "Distance tolerance for merging of faces of "
+                             "reduced mesh");
+  dynobject_t::GET_ATTRIBUTE(lodminfacefreq, "Hz",
+                             "Minimal face size of reduced mesh, as "
+                             "wavelength at this frequency");
+  dynobject_t::GET_ATTRIBUTE_BOOL(
+      meshcache, "Store results of mesh preprocessing in disk cache");
+  TASCAR::mesh_t faces;
   if(!shoebox.is_null()) {
     TASCAR::pos_t sb(shoebox);
     sb *= 0.5;
     std::vector<TASCAR::pos_t> verts;
     verts.resize(4);
-    TASCAR::Acousticmodel::reflector_t* p_reflector(NULL);
     // face1:
     verts[0] = TASCAR::pos_t(sb.x, -sb.y, -sb.z);
     verts[1] = TASCAR::pos_t(sb.x, -sb.y, sb.z);
     verts[2] = TASCAR::pos_t(sb.x, sb.y, sb.z);
     verts[3] = TASCAR::pos_t(sb.x, sb.y, -sb.z);
-    p_reflector = new TASCAR::Acousticmodel::reflector_t();
-    p_reflector->nonrt_set(verts);
-    reflectors.push_back(p_reflector);
+    faces.push_back(verts);
     // face2:
     verts[0] = TASCAR::pos_t(-sb.x, -sb.y, -sb.z);
     verts[1] = TASCAR::pos_t(-sb.x, sb.y, -sb.z);
     verts[2] = TASCAR::pos_t(-sb.x, sb.y, sb.z);
     verts[3] = TASCAR::pos_t(-sb.x, -sb.y, sb.z);
-    p_reflector = new TASCAR::Acousticmodel::reflector_t();
-    p_reflector->nonrt_set(verts);
-    reflectors.push_back(p_reflector);
+    faces.push_back(verts);
     // face3:
     verts[0] = TASCAR::pos_t(-sb.x, -sb.y, -sb.z);
     verts[1] = TASCAR::pos_t(-sb.x, -sb.y, sb.z);
     verts[2] = TASCAR::pos_t(sb.x, -sb.y, sb.z);
     verts[3] = TASCAR::pos_t(sb.x, -sb.y, -sb.z);
-    p_reflector = new TASCAR::Acousticmodel::reflector_t();
-    p_reflector->nonrt_set(verts);
-    reflectors.push_back(p_reflector);
+    faces.push_back(verts);
     // face4:
     verts[0] = TASCAR::pos_t(-sb.x, sb.y, -sb.z);
     verts[1] = TASCAR::pos_t(sb.x, sb.y, -sb.z);
     verts[2] = TASCAR::pos_t(sb.x, sb.y, sb.z);
     verts[3] = TASCAR::pos_t(-sb.x, sb.y, sb.z);
-    p_reflector = new TASCAR::Acousticmodel::reflector_t();
-    p_reflector->nonrt_set(verts);
-    reflectors.push_back(p_reflector);
+    faces.push_back(verts);
     // face5:
     verts[0] = TASCAR::pos_t(-sb.x, -sb.y, sb.z);
     verts[1] = TASCAR::pos_t(-sb.x, sb.y, sb.z);
     verts[2] = TASCAR::pos_t(sb.x, sb.y, sb.z);
     verts[3] = TASCAR::pos_t(sb.x, -sb.y, sb.z);
-    p_reflector = new TASCAR::Acousticmodel::reflector_t();
-    p_reflector->nonrt_set(verts);
-    reflectors.push_back(p_reflector);
+    faces.push_back(verts);
     // face6:
     verts[0] = TASCAR::pos_t(-sb.x, -sb.y, -sb.z);
     verts[1] = TASCAR::pos_t(sb.x, -sb.y, -sb.z);
     verts[2] = TASCAR::pos_t(sb.x, sb.y, -sb.z);
     verts[3] = TASCAR::pos_t(-sb.x, sb.y, -sb.z);
-    p_reflector = new TASCAR::Acousticmodel::reflector_t();
-    p_reflector->nonrt_set(verts);
-    reflectors.push_back(p_reflector);
+    faces.push_back(verts);
   }
   dynobject_t::GET_ATTRIBUTE(shoeboxwalls, "m",
                              "generate shoebox room without floor and ceiling");
@@ -1027,39 +1066,30 @@ face_group_t::face_group_t(tsccfg::node_t xmlsrc) : object_t(xmlsrc)
     sb *= 0.5;
     std::vector<TASCAR::pos_t> verts;
     verts.resize(4);
-    TASCAR::Acousticmodel::reflector_t* p_reflector(NULL);
     // face1:
     verts[0] = TASCAR::pos_t(sb.x, -sb.y, -sb.z);
     verts[1] = TASCAR::pos_t(sb.x, -sb.y, sb.z);
     verts[2] = TASCAR::pos_t(sb.x, sb.y, sb.z);
     verts[3] = TASCAR::pos_t(sb.x, sb.y, -sb.z);
-    p_reflector = new TASCAR::Acousticmodel::reflector_t();
-    p_reflector->nonrt_set(verts);
-    reflectors.push_back(p_reflector);
+    faces.push_back(verts);
     // face2:
     verts[0] = TASCAR::pos_t(-sb.x, -sb.y, -sb.z);
     verts[1] = TASCAR::pos_t(-sb.x, sb.y, -sb.z);
     verts[2] = TASCAR::pos_t(-sb.x, sb.y, sb.z);
     verts[3] = TASCAR::pos_t(-sb.x, -sb.y, sb.z);
-    p_reflector = new TASCAR::Acousticmodel::reflector_t();
-    p_reflector->nonrt_set(verts);
-    reflectors.push_back(p_reflector);
+    faces.push_back(verts);
     // face3:
     verts[0] = TASCAR::pos_t(-sb.x, -sb.y, -sb.z);
     verts[1] = TASCAR::pos_t(-sb.x, -sb.y, sb.z);
     verts[2] = TASCAR::pos_t(sb.x, -sb.y, sb.z);
     verts[3] = TASCAR::pos_t(sb.x, -sb.y, -sb.z);
-    p_reflector = new TASCAR::Acousticmodel::reflector_t();
-    p_reflector->nonrt_set(verts);
-    reflectors.push_back(p_reflector);
+    faces.push_back(verts);
     // face4:
     verts[0] = TASCAR::pos_t(-sb.x, sb.y, -sb.z);
     verts[1] = TASCAR::pos_t(sb.x, sb.y, -sb.z);
     verts[2] = TASCAR::pos_t(sb.x, sb.y, sb.z);
     verts[3] = TASCAR::pos_t(-sb.x, sb.y, sb.z);
-    p_reflector = new TASCAR::Acousticmodel::reflector_t();
-    p_reflector->nonrt_set(verts);
-    reflectors.push_back(p_reflector);
+    faces.push_back(verts);
   }
   if(!importraw.empty()) {
     std::ifstream rawmesh(TASCAR::env_expand(importraw).c_str());
@@ -1069,22 +1099,55 @@ face_group_t::face_group_t(tsccfg::node_t xmlsrc) : object_t(xmlsrc)
     while(!rawmesh.eof()) {
       std::string meshline;
       getline(rawmesh, meshline, '\n');
-      if(!meshline.empty()) {
-        TASCAR::Acousticmodel::reflector_t* p_reflector(
-            new TASCAR::Acousticmodel::reflector_t());
-        p_reflector->nonrt_set(TASCAR::str2vecpos(meshline));
-        reflectors.push_back(p_reflector);
-      }
+      if(!meshline.empty())
+        faces.push_back(TASCAR::str2vecpos(meshline));
     }
   }
   std::stringstream txtmesh(tsccfg::node_get_text(xmlsrc, "faces"));
   while(!txtmesh.eof()) {
     std::string meshline;
     getline(txtmesh, meshline, '\n');
-    if(!meshline.empty()) {
+    if(!meshline.empty())
+      faces.push_back(TASCAR::str2vecpos(meshline));
+  }
+  num_raw_faces = (uint32_t)faces.size();
+  // mesh preprocessing, wavelengths are calculated with a speed of
+  // sound of 340 m/s:
+  TASCAR::mesh_preprocessing_cfg_t cfg;
+  cfg.merge = mergefaces;
+  cfg.angle = DEG2RAD * mergeangle;
+  cfg.dist = mergedist;
+  if(minfacefreq > 0.0)
+    cfg.minaperture = 340.0 / minfacefreq;
+  TASCAR::mesh_t mesh(TASCAR::preprocess_mesh(faces, cfg, meshcache));
+  for(const auto& face : mesh) {
+    TASCAR::Acousticmodel::reflector_t* p_reflector(
+        new TASCAR::Acousticmodel::reflector_t());
+    p_reflector->nonrt_set(face);
+    // faces of a group move only together, coplanarity is kept:
+    p_reflector->rigid_body = this;
+    if(lodorder > 0)
+      p_reflector->maxorder = lodorder;
+    reflectors.push_back(p_reflector);
+  }
+  if(lodorder > 0) {
+    // reduced level of detail for higher reflection orders:
+    cfg.merge = true;
+    cfg.angle = DEG2RAD * lodangle;
+    cfg.dist = loddist;
+    cfg.minaperture = 0.0;
+    if(lodminfacefreq > 0.0)
+      cfg.minaperture = 340.0 / lodminfacefreq;
+    TASCAR::mesh_t lodmesh(TASCAR::preprocess_mesh(mesh, cfg, meshcache));
+    num_lod_faces = (uint32_t)lodmesh.size();
+    for(const auto& face : lodmesh) {
       TASCAR::Acousticmodel::reflector_t* p_reflector(
           new TASCAR::Acousticmodel::reflector_t());
-      p_reflector->nonrt_set(TASCAR::str2vecpos(meshline));
+      p_reflector->nonrt_set(face);
+      p_reflector->rigid_body = this;
+      p_reflector->minorder = lodorder + 1;
+      p_reflector->coplanar_angle = DEG2RAD * lodangle;
+      p_reflector->coplanar_dist = loddist;
       reflectors.push_back(p_reflector);
     }
   }
@@ -1101,10 +1164,14 @@ face_group_t::~face_group_t()
 void face_group_t::geometry_update(double t)
 {
   dynobject_t::geometry_update(t);
+  // transform vertices only if the object moved:
+  bool moved(get_transform_version() != applied_transform_version);
+  applied_transform_version = get_transform_version();
   for(std::vector<TASCAR::Acousticmodel::reflector_t*>::iterator it =
           reflectors.begin();
       it != reflectors.end(); ++it) {
-    (*it)->apply_rot_loc(c6dof.position, c6dof.orientation);
+    if(moved)
+      (*it)->apply_rot_loc(c6dof.position, c6dof.orientation);
     (*it)->reflectivity = reflectivity;
     (*it)->damping = damping;
     (*it)->edgereflection = edgereflection;
@@ -1177,10 +1244,14 @@ obstacle_group_t::~obstacle_group_t()
 void obstacle_group_t::geometry_update(double t)
 {
   dynobject_t::geometry_update(t);
+  // transform vertices only if the object moved:
+  bool moved(get_transform_version() != applied_transform_version);
+  applied_transform_version = get_transform_version();
   for(std::vector<TASCAR::Acousticmodel::obstacle_t*>::iterator it =
           obstacles.begin();
       it != obstacles.end(); ++it) {
-    (*it)->apply_rot_loc(c6dof.position, c6dof.orientation);
+    if(moved)
+      (*it)->apply_rot_loc(c6dof.position, c6dof.orientation);
     (*it)->transmission = transmission;
   }
 }
@@ -1482,7 +1553,26 @@ material_t::~material_t() {}
 
 void material_t::update_coeff(float fs)
 {
-  TASCAR::alpha2rflt(reflectivity, damping, alpha, f, fs, 1000);
+  // the low-pass fit is an iterative optimization, thus results are
+  // cached for each set of coefficients and sampling rate:
+  static std::mutex mtx;
+  static std::map<std::tuple<std::vector<float>, std::vector<float>, float>,
+                  std::pair<float, float>>
+      cache;
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    auto key(std::make_tuple(f, alpha, fs));
+    auto it(cache.find(key));
+    if(it != cache.end()) {
+      reflectivity = it->second.first;
+      damping = it->second.second;
+    } else {
+      TASCAR::alpha2rflt(reflectivity, damping, alpha, f, fs, 1000);
+      cache[key] = std::pair<float, float>(reflectivity, damping);
+    }
+  }
+  design = TASCAR::get_reflectionfilter_design(f, TASCAR::alpha2gain(alpha),
+                                               fs);
 }
 
 /*
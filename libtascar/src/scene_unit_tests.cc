@@ -46,6 +46,235 @@ TEST(obstacle_group_doc_t, constructor)
   }
 }
 
+namespace {
+
+  TASCAR::pos_t scaled(TASCAR::pos_t p, double s)
+  {
+    p *= s;
+    return p;
+  }
+
+  /// Faces of a shoebox room, each wall split into triangles of 1 m
+  std::string triangulated_shoebox(uint32_t lx, uint32_t ly, uint32_t lz)
+  {
+    std::stringstream faces;
+    auto add_wall([&](const TASCAR::pos_t& p0, const TASCAR::pos_t& du,
+                      const TASCAR::pos_t& dv, uint32_t nu, uint32_t nv) {
+      for(uint32_t ku = 0; ku < nu; ++ku)
+        for(uint32_t kv = 0; kv < nv; ++kv) {
+          TASCAR::pos_t p00(p0 + scaled(du, ku) + scaled(dv, kv));
+          TASCAR::pos_t p10(p00 + du);
+          TASCAR::pos_t p11(p00 + du + dv);
+          TASCAR::pos_t p01(p00 + dv);
+          faces << p00.print_cart(" ") << " " << p11.print_cart(" ") << " "
+                << p10.print_cart(" ") << "\n";
+          faces << p00.print_cart(" ") << " " << p01.print_cart(" ") << " "
+                << p11.print_cart(" ") << "\n";
+        }
+    });
+    TASCAR::pos_t ex(1, 0, 0);
+    TASCAR::pos_t ey(0, 1, 0);
+    TASCAR::pos_t ez(0, 0, 1);
+    // face normals point into the room:
+    add_wall(TASCAR::pos_t(0, 0, 0), ey, ex, ly, lx);
+    add_wall(TASCAR::pos_t(0, 0, lz), ex, ey, lx, ly);
+    add_wall(TASCAR::pos_t(0, 0, 0), ex, ez, lx, lz);
+    add_wall(TASCAR::pos_t(0, ly, 0), ez, ex, lz, lx);
+    add_wall(TASCAR::pos_t(0, 0, 0), ez, ey, lz, ly);
+    add_wall(TASCAR::pos_t(lx, 0, 0), ey, ez, ly, lz);
+    return faces.str();
+  }
+
+  /**
+     Number of image sources, generated in the same way as in
+     TASCAR::Acousticmodel::receiver_graph_t.
+   */
+  size_t get_render_cost(
+      const std::vector<TASCAR::Acousticmodel::reflector_t*>& reflectors,
+      uint32_t ismorder)
+  {
+    struct image_t {
+      const TASCAR::Acousticmodel::reflector_t* reflector;
+    };
+    std::vector<image_t> images;
+    size_t start(0);
+    for(uint32_t order = 1; order <= ismorder; ++order) {
+      size_t end(images.size());
+      for(size_t k = (order == 1) ? 0 : start; k < ((order == 1) ? 1 : end);
+          ++k)
+        for(auto r : reflectors)
+          if(r->is_used_at_order(order) &&
+             ((order == 1) || ((images[k].reflector != r) &&
+                               !r->is_always_coplanar(
+                                   *(images[k].reflector)))))
+            images.push_back({r});
+      start = end;
+    }
+    return images.size();
+  }
+
+} // namespace
+
+TEST(face_group_t, mesh_preprocessing)
+{
+  std::string faces(triangulated_shoebox(6, 4, 3));
+  TASCAR::xml_doc_t doc("<facegroup name=\"room\"><faces>" + faces +
+                            "</faces></facegroup>",
+                        TASCAR::xml_doc_t::LOAD_STRING);
+  TASCAR::Scene::face_group_t raw(doc.root());
+  EXPECT_EQ(216u, raw.num_raw_faces);
+  EXPECT_EQ(216u, raw.reflectors.size());
+  TASCAR::xml_doc_t doc2("<facegroup name=\"room\" mergefaces=\"true\" "
+                         "meshcache=\"false\"><faces>" +
+                             faces + "</faces></facegroup>",
+                         TASCAR::xml_doc_t::LOAD_STRING);
+  TASCAR::Scene::face_group_t merged(doc2.root());
+  EXPECT_EQ(216u, merged.num_raw_faces);
+  ASSERT_EQ(6u, merged.reflectors.size());
+  double area(0.0);
+  for(auto r : merged.reflectors) {
+    EXPECT_EQ(4u, r->get_verts().size());
+    area += r->get_area();
+  }
+  EXPECT_NEAR(2.0 * (6 * 4 + 6 * 3 + 4 * 3), area, 1e-9);
+  // second order image sources; reflections at two faces of the same
+  // wall are skipped:
+  EXPECT_EQ(216u + 216u * 215u -
+                (2u * 48u * 47u + 2u * 36u * 35u + 2u * 24u * 23u),
+            get_render_cost(raw.reflectors, 2));
+  EXPECT_EQ(6u + 6u * 5u, get_render_cost(merged.reflectors, 2));
+}
+
+TEST(face_group_t, level_of_detail)
+{
+  // cylindrical wall with 3 degree segments, and a small box:
+  std::stringstream faces;
+  const uint32_t nseg(40);
+  for(uint32_t k = 0; k < nseg; ++k) {
+    double a1(DEG2RAD * 3.0 * k);
+    double a2(DEG2RAD * 3.0 * (k + 1));
+    faces << 5.0 * cos(a1) << " " << 5.0 * sin(a1) << " 0 " << 5.0 * cos(a1)
+          << " " << 5.0 * sin(a1) << " 3 " << 5.0 * cos(a2) << " "
+          << 5.0 * sin(a2) << " 3 " << 5.0 * cos(a2) << " " << 5.0 * sin(a2)
+          << " 0\n";
+  }
+  faces << "1 1 0 1.1 1 0 1.1 1.1 0 1 1.1 0\n";
+  TASCAR::xml_doc_t doc("<facegroup name=\"wall\" mergefaces=\"true\" "
+                        "minfacefreq=\"1000\" lodorder=\"1\" "
+                        "meshcache=\"false\"><faces>" +
+                            faces.str() + "</faces></facegroup>",
+                        TASCAR::xml_doc_t::LOAD_STRING);
+  TASCAR::Scene::face_group_t fg(doc.root());
+  EXPECT_EQ(nseg + 1u, fg.num_raw_faces);
+  EXPECT_GT(fg.num_lod_faces, 1u);
+  EXPECT_LT(fg.num_lod_faces, nseg / 4u);
+  ASSERT_EQ(nseg + fg.num_lod_faces, fg.reflectors.size());
+  uint32_t n1(0);
+  uint32_t n2(0);
+  for(auto r : fg.reflectors) {
+    n1 += r->is_used_at_order(1);
+    n2 += r->is_used_at_order(2);
+    EXPECT_NE(r->is_used_at_order(1), r->is_used_at_order(3));
+  }
+  EXPECT_EQ(nseg, n1);
+  EXPECT_EQ(fg.num_lod_faces, n2);
+  // a segment is not followed by the coplanar faces of the reduced
+  // mesh which replace it:
+  uint32_t ncoplanar(0);
+  for(uint32_t k = 0; k < nseg; ++k) {
+    uint32_t n(0);
+    for(uint32_t l = nseg; l < fg.reflectors.size(); ++l)
+      n += fg.reflectors[l]->is_always_coplanar(*(fg.reflectors[k]));
+    EXPECT_GE(n, 1u) << "segment " << k;
+    ncoplanar += n;
+  }
+  const uint32_t nsecond(nseg * fg.num_lod_faces - ncoplanar);
+  EXPECT_EQ(nseg + nsecond + nsecond * (fg.num_lod_faces - 1u),
+            get_render_cost(fg.reflectors, 3));
+}
+
+TEST(reflector_t, is_coplanar)
+{
+  TASCAR::Acousticmodel::reflector_t r1;
+  r1.nonrt_set({TASCAR::pos_t(0, 0, 0), TASCAR::pos_t(0, 1, 0),
+                TASCAR::pos_t(0, 1, 1), TASCAR::pos_t(0, 0, 1)});
+  // same plane, different area:
+  TASCAR::Acousticmodel::reflector_t r2;
+  r2.nonrt_set({TASCAR::pos_t(0, 2, 0), TASCAR::pos_t(0, 3, 0),
+                TASCAR::pos_t(0, 3, 1)});
+  EXPECT_TRUE(r1.is_coplanar(r2));
+  EXPECT_TRUE(r2.is_coplanar(r1));
+  // opposite normal:
+  TASCAR::Acousticmodel::reflector_t r3;
+  r3.nonrt_set({TASCAR::pos_t(0, 3, 1), TASCAR::pos_t(0, 3, 0),
+                TASCAR::pos_t(0, 2, 0)});
+  EXPECT_FALSE(r1.is_coplanar(r3));
+  // slightly tilted and shifted:
+  TASCAR::Acousticmodel::reflector_t r4;
+  r4.nonrt_set({TASCAR::pos_t(0.05, 0, 0), TASCAR::pos_t(0.05, 1, 0),
+                TASCAR::pos_t(0.07, 1, 1)});
+  EXPECT_FALSE(r1.is_coplanar(r4));
+  r4.coplanar_angle = DEG2RAD * 5.0;
+  r4.coplanar_dist = 0.1;
+  EXPECT_TRUE(r1.is_coplanar(r4));
+  EXPECT_TRUE(r4.is_coplanar(r1));
+  // reflectors which may move independently are never pruned:
+  EXPECT_FALSE(r1.is_always_coplanar(r2));
+  int body(0);
+  r1.rigid_body = &body;
+  EXPECT_FALSE(r1.is_always_coplanar(r2));
+  r2.rigid_body = &body;
+  EXPECT_TRUE(r1.is_always_coplanar(r2));
+  EXPECT_FALSE(r1.is_always_coplanar(r3));
+}
+
+TEST(material_t, update_coeff)
+{
+  TASCAR::Scene::material_t mat(
+      "carpet", {125.0f, 250.0f, 500.0f, 1000.0f, 2000.0f, 4000.0f},
+      {0.02f, 0.06f, 0.14f, 0.37f, 0.60f, 0.65f});
+  EXPECT_EQ(NULL, mat.design);
+  mat.update_coeff(44100.0f);
+  ASSERT_NE(nullptr, mat.design);
+  float reflectivity(mat.reflectivity);
+  float damping(mat.damping);
+  // second material with same coefficients shares the results:
+  TASCAR::Scene::material_t mat2(mat.name, mat.f, mat.alpha);
+  mat2.update_coeff(44100.0f);
+  EXPECT_EQ(mat.design, mat2.design);
+  EXPECT_EQ(reflectivity, mat2.reflectivity);
+  EXPECT_EQ(damping, mat2.damping);
+  mat2.update_coeff(48000.0f);
+  EXPECT_NE(mat.design, mat2.design);
+}
+
+TEST(reflectionfilter_design_t, combined_orders)
+{
+  // one multiband filter per image source path replaces one low-pass
+  // filter per reflection; its size is independent of the order:
+  TASCAR::Scene::material_t mat(
+      "carpet", {125.0f, 250.0f, 500.0f, 1000.0f, 2000.0f, 4000.0f},
+      {0.02f, 0.06f, 0.14f, 0.37f, 0.60f, 0.65f});
+  mat.update_coeff(44100.0f);
+  ASSERT_NE(nullptr, mat.design);
+  const TASCAR::reflectionfilter_design_t* design(NULL);
+  for(uint32_t order = 1; order <= 3; ++order) {
+    design = TASCAR::combine_reflectionfilter_design(design, mat.design);
+    EXPECT_TRUE(design->is_parallel()) << "order " << order;
+    EXPECT_EQ(mat.design->get_num_sections(), design->get_num_sections())
+        << "order " << order;
+    // the shelving filters are fitted to the band gains, deviations
+    // grow with the range of the gains:
+    for(auto f : mat.f) {
+      float g(mat.design->get_response(f));
+      EXPECT_NEAR(20.0f * log10f(powf(g, (float)order)),
+                  20.0f * log10f(design->get_response(f)),
+                  (order > 2) ? 2.5f : 0.2f)
+          << "order " << order << ", " << f << " Hz";
+    }
+  }
+}
+
 // Local Variables:
 // compile-command: "make -C ../.. unit-tests"
 // coding: utf-8-unix
@@ -21,7 +21,12 @@
 #include "defs.h"
 #include "errorhandling.h"
 #include "termsetbaud.h"
+#include "threadrole.h"
+#include <algorithm>
+#include <chrono>
+#include <errno.h>
 #include <fcntl.h>
+#include <poll.h>
 #include <string.h>
 #include <sys/ioctl.h>
 #include <unistd.h>
@@ -135,6 +140,8 @@ int serialport_t::open(const char* dev, int speed, int parity, int stopbits,
 #endif
   if(fd < 0)
     throw TASCAR::ErrMsg(std::string("Unable to open device ") + dev);
+  // discard data which was read from a previously opened device:
+  rpos = rlen = 0u;
   set_interface_attribs(speed, parity, stopbits, xbaud);
   set_blocking(1);
   return fd;
@@ -205,24 +212,218 @@ void serialport_t::set_blocking(int should_block)
 void serialport_t::close()
 {
   ::close(fd);
+  rpos = rlen = 0u;
 }
 
 std::string serialport_t::readline(uint32_t maxlen, char delim)
 {
   std::string r;
   while(isopen() && maxlen) {
-    maxlen--;
-    char c(0);
-    if(::read(fd, &c, 1) == 1) {
-      if(c != delim)
-        r += c;
-      else
-        return r;
+    if(rpos == rlen) {
+      // read all available data at once, instead of one system call
+      // per character:
+      ssize_t n(::read(fd, rbuf, sizeof(rbuf)));
+      rpos = 0u;
+      rlen = (n > 0) ? (size_t)n : 0u;
+      if(!rlen) {
+        maxlen--;
+        continue;
+      }
     }
+    maxlen--;
+    char c(rbuf[rpos++]);
+    if(c != delim)
+      r += c;
+    else
+      return r;
   }
   return r;
 }
 
+serial_framer_t::serial_framer_t(char delim_, size_t maxlen_)
+    : binary(false), delim(delim_), maxlen(std::max((size_t)1u, maxlen_)),
+      packetlen(0u)
+{
+}
+
+serial_framer_t::serial_framer_t(const std::string& sync_, size_t packetlen_)
+    : binary(true), delim(0), maxlen(0u), sync(sync_),
+      packetlen(std::max(std::max((size_t)1u, packetlen_), sync_.size()))
+{
+}
+
+void serial_framer_t::feed(const char* data, size_t len,
+                           std::vector<std::string>& frames)
+{
+  if(!binary) {
+    const char* end(data + len);
+    while(data < end) {
+      const char* pdelim((const char*)memchr(data, delim, end - data));
+      const char* stop(pdelim ? pdelim : end);
+      buf.append(data, stop - data);
+      while(buf.size() >= maxlen) {
+        frames.push_back(buf.substr(0, maxlen));
+        buf.erase(0, maxlen);
+      }
+      if(pdelim) {
+        frames.push_back(buf);
+        buf.clear();
+      }
+      data = stop + 1;
+    }
+    return;
+  }
+  buf.append(data, len);
+  size_t pos(0u);
+  while(true) {
+    size_t start(sync.empty() ? pos : buf.find(sync, pos));
+    if(start == std::string::npos) {
+      // keep a possibly incomplete start sequence:
+      pos = std::max(pos, buf.size() - std::min(buf.size(), sync.size() - 1u));
+      break;
+    }
+    if(buf.size() - start < packetlen) {
+      pos = start;
+      break;
+    }
+    frames.push_back(buf.substr(start, packetlen));
+    pos = start + packetlen;
+  }
+  buf.erase(0, pos);
+}
+
+serial_dispatcher_t& serial_dispatcher_t::get()
+{
+  static serial_dispatcher_t dispatcher;
+  return dispatcher;
+}
+
+serial_dispatcher_t::serial_dispatcher_t()
+{
+  if(pipe(wakeup_pipe) != 0)
+    throw TASCAR::ErrMsg(std::string("Unable to create pipe: ") +
+                         strerror(errno));
+  fcntl(wakeup_pipe[1], F_SETFL, fcntl(wakeup_pipe[1], F_GETFL) | O_NONBLOCK);
+}
+
+serial_dispatcher_t::~serial_dispatcher_t()
+{
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    run_service = false;
+  }
+  wakeup();
+  if(thread.joinable())
+    thread.join();
+  ::close(wakeup_pipe[0]);
+  ::close(wakeup_pipe[1]);
+}
+
+void serial_dispatcher_t::wakeup()
+{
+  char c(0);
+  // the pipe can only be full if the thread is already woken up:
+  ssize_t r(::write(wakeup_pipe[1], &c, 1));
+  (void)r;
+}
+
+void serial_dispatcher_t::add(int fd, const serial_framer_t& framer,
+                              callback_t cb, jack_client_t* jc)
+{
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    device_t& dev(devices[fd]);
+    dev.framer = framer;
+    dev.cb = cb;
+    dev.jc = jc;
+    dev.active = true;
+    if(!thread.joinable())
+      thread = std::thread(&serial_dispatcher_t::service, this);
+  }
+  wakeup();
+}
+
+void serial_dispatcher_t::remove(int fd)
+{
+  // the dispatch thread may wait in poll() for the device, thus wake
+  // it up before waiting for the lock:
+  wakeup();
+  std::lock_guard<std::mutex> lock(mtx);
+  devices.erase(fd);
+}
+
+bool serial_dispatcher_t::is_active(int fd)
+{
+  std::lock_guard<std::mutex> lock(mtx);
+  auto dev(devices.find(fd));
+  return (dev != devices.end()) && dev->second.active;
+}
+
+size_t serial_dispatcher_t::get_num_devices()
+{
+  std::lock_guard<std::mutex> lock(mtx);
+  return devices.size();
+}
+
+void serial_dispatcher_t::service()
+{
+  TASCAR::register_thread(TASCAR::thread_roles_t::background);
+  std::vector<struct pollfd> fds;
+  std::vector<std::string> frames;
+  char buf[4096];
+  serial_frame_t frame;
+  while(true) {
+    fds.clear();
+    fds.push_back({wakeup_pipe[0], POLLIN, 0});
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      if(!run_service)
+        return;
+      for(auto& dev : devices)
+        if(dev.second.active)
+          fds.push_back({dev.first, POLLIN, 0});
+    }
+    if(::poll(fds.data(), fds.size(), -1) < 0)
+      continue;
+    if(fds[0].revents & POLLIN)
+      if(::read(wakeup_pipe[0], buf, sizeof(buf)) < 0)
+        continue;
+    std::lock_guard<std::mutex> lock(mtx);
+    for(size_t k = 1; k < fds.size(); ++k) {
+      if(!fds[k].revents)
+        continue;
+      auto dev(devices.find(fds[k].fd));
+      if(dev == devices.end())
+        continue;
+      ssize_t n(0);
+      if(fds[k].revents & POLLIN) {
+        n = ::read(fds[k].fd, buf, sizeof(buf));
+        // errno is valid only directly after a failed read:
+        if((n < 0) && ((errno == EAGAIN) || (errno == EINTR)))
+          continue;
+      }
+      if(n <= 0) {
+        // end of file, read error, or POLLHUP, POLLERR or POLLNVAL
+        // without data: stop polling, the owner may reopen the device
+        dev->second.active = false;
+        continue;
+      }
+      // arrival time, taken after the read, since data may arrive
+      // between poll() and read():
+      frame.time = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now().time_since_epoch())
+                       .count();
+      frame.frametime = dev->second.jc ? jack_frame_time(dev->second.jc) : 0u;
+      frames.clear();
+      dev->second.framer.feed(buf, (size_t)n, frames);
+      for(auto& f : frames) {
+        frame.data.swap(f);
+        dev->second.cb(frame);
+      }
+    }
+  }
+}
+
 /*
  * Local Variables:
  * mode: c++
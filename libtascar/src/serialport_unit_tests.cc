@@ -0,0 +1,210 @@
+/*
+ * This file is part of the TASCAR software, see <http://tascar.org/>
+ *
+ * Copyright (c) 2026 agent
+ */
+/*
+ * TASCAR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, version 3 of the License.
+ *
+ * TASCAR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHATABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License, version 3 for more details.
+ *
+ * You should have received a copy of the GNU General Public License,
+ * Version 3 along with TASCAR. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <gtest/gtest.h>
+
+// serial ports are not available on Windows:
+#ifndef _WIN32
+
+#include "serialport.h"
+#include <atomic>
+#include <chrono>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+namespace {
+
+  /// Pseudo terminal, the slave side is used as serial device
+  class pty_t {
+  public:
+    pty_t()
+    {
+      master = posix_openpt(O_RDWR | O_NOCTTY);
+      if((master >= 0) && (grantpt(master) == 0) && (unlockpt(master) == 0))
+        slavename = ptsname(master);
+    };
+    ~pty_t()
+    {
+      if(master >= 0)
+        close(master);
+    };
+    void write(const std::string& s)
+    {
+      size_t pos(0);
+      while(pos < s.size()) {
+        ssize_t n(::write(master, s.data() + pos, s.size() - pos));
+        if(n <= 0)
+          return;
+        pos += n;
+      }
+    };
+    int master = -1;
+    std::string slavename;
+  };
+
+  double now()
+  {
+    return std::chrono::duration<double>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+
+} // namespace
+
+TEST(serial_framer_t, lines)
+{
+  TASCAR::serial_framer_t framer('\n', 8);
+  std::vector<std::string> frames;
+  framer.feed("A1 2", 4, frames);
+  EXPECT_EQ(0u, frames.size());
+  framer.feed(" 3\nB\n\nC", 7, frames);
+  ASSERT_EQ(3u, frames.size());
+  EXPECT_EQ("A1 2 3", frames[0]);
+  EXPECT_EQ("B", frames[1]);
+  EXPECT_EQ("", frames[2]);
+  frames.clear();
+  // long lines are split:
+  framer.feed("123456789\n", 10, frames);
+  ASSERT_EQ(2u, frames.size());
+  EXPECT_EQ("C1234567", frames[0]);
+  EXPECT_EQ("89", frames[1]);
+}
+
+TEST(serial_framer_t, packets)
+{
+  TASCAR::serial_framer_t framer(std::string("\xff\xfe"), 5);
+  std::vector<std::string> frames;
+  // garbage before start sequence, start sequence split across reads:
+  framer.feed("xy\xff", 3, frames);
+  EXPECT_EQ(0u, frames.size());
+  framer.feed("\xfe"
+              "abc\xff\xfe"
+              "de",
+              8, frames);
+  ASSERT_EQ(1u, frames.size());
+  EXPECT_EQ(std::string("\xff\xfe"
+                        "abc"),
+            frames[0]);
+  framer.feed("f\xff\xfe\xff\xfe\n", 6, frames);
+  ASSERT_EQ(3u, frames.size());
+  EXPECT_EQ(std::string("\xff\xfe"
+                        "def"),
+            frames[1]);
+  // start sequence may be part of the payload:
+  EXPECT_EQ(std::string("\xff\xfe\xff\xfe\n"), frames[2]);
+}
+
+TEST(serialport_t, readline)
+{
+  pty_t pty;
+  ASSERT_FALSE(pty.slavename.empty());
+  TASCAR::serialport_t dev;
+  dev.open(pty.slavename.c_str(), B115200);
+  pty.write("abc\ndef\ng");
+  EXPECT_EQ("abc", dev.readline(100, '\n'));
+  EXPECT_EQ("def", dev.readline(100, '\n'));
+  pty.write("hi\n");
+  EXPECT_EQ("ghi", dev.readline(100, '\n'));
+  // buffered data is discarded when the device is closed:
+  pty.write("jkl\nmno\n");
+  EXPECT_EQ("jkl", dev.readline(100, '\n'));
+  dev.close();
+  pty_t pty2;
+  ASSERT_FALSE(pty2.slavename.empty());
+  dev.open(pty2.slavename.c_str(), B115200);
+  pty2.write("pqr\n");
+  EXPECT_EQ("pqr", dev.readline(100, '\n'));
+  dev.close();
+}
+
+TEST(serial_dispatcher_t, loopback)
+{
+  // two devices with 10000 lines each, e.g., 10 seconds of IMU data:
+  const uint32_t nlines(10000);
+  pty_t pty[2];
+  TASCAR::serialport_t dev[2];
+  TASCAR::serial_dispatcher_t dispatcher;
+  std::atomic<uint32_t> received[2] = {0u, 0u};
+  std::atomic<uint32_t> errors(0u);
+  for(uint32_t k = 0; k < 2; ++k) {
+    ASSERT_FALSE(pty[k].slavename.empty());
+    dev[k].open(pty[k].slavename.c_str(), B115200);
+    dispatcher.add(dev[k].get_fd(), TASCAR::serial_framer_t('\n'),
+                   [&, k](const TASCAR::serial_frame_t& frame) {
+                     // each line contains a sequence number and the
+                     // time of sending:
+                     uint32_t seq(0);
+                     double t(0.0);
+                     if((sscanf(frame.data.c_str(), "A%u %lf", &seq, &t) !=
+                         2) ||
+                        (seq != received[k]))
+                       ++errors;
+                     // arrival time is not before sending time:
+                     if(frame.time < t)
+                       ++errors;
+                     ++received[k];
+                   });
+  }
+  EXPECT_EQ(2u, dispatcher.get_num_devices());
+  double t0(now());
+  char line[64];
+  for(uint32_t n = 0; n < nlines; ++n)
+    for(uint32_t k = 0; k < 2; ++k) {
+      snprintf(line, sizeof(line), "A%u %1.9f 0.1 0.2 0.3\n", n, now());
+      pty[k].write(line);
+    }
+  while(((received[0] < nlines) || (received[1] < nlines)) &&
+        (now() - t0 < 10.0))
+    usleep(1000);
+  EXPECT_EQ(nlines, received[0]);
+  EXPECT_EQ(nlines, received[1]);
+  EXPECT_EQ(0u, errors);
+  // hangup is detected:
+  EXPECT_TRUE(dispatcher.is_active(dev[1].get_fd()));
+  close(pty[1].master);
+  pty[1].master = -1;
+  t0 = now();
+  while(dispatcher.is_active(dev[1].get_fd()) && (now() - t0 < 2.0))
+    usleep(1000);
+  EXPECT_FALSE(dispatcher.is_active(dev[1].get_fd()));
+  EXPECT_TRUE(dispatcher.is_active(dev[0].get_fd()));
+  // no callbacks after removal:
+  dispatcher.remove(dev[0].get_fd());
+  uint32_t cnt(received[0]);
+  pty[0].write("A0 0\n");
+  usleep(10000);
+  EXPECT_EQ(cnt, received[0]);
+  dispatcher.remove(dev[1].get_fd());
+  EXPECT_EQ(0u, dispatcher.get_num_devices());
+  dev[0].close();
+  dev[1].close();
+}
+
+#endif
+
+/*
+ * Local Variables:
+ * mode: c++
+ * c-basic-offset: 2
+ * indent-tabs-mode: nil
+ * compile-command: "make -C .."
+ * End:
+ */
@@ -21,6 +21,7 @@
 #include "serviceclass.h"
 #include "defs.h"
 #include "errorhandling.h"
+#include "threadrole.h"
 #include <string.h>
 
 TASCAR::service_t::service_t()
@@ -35,6 +36,7 @@ TASCAR::service_t::~service_t()
 
 void* TASCAR::service_t::service(void* h)
 {
+  TASCAR::register_thread(TASCAR::thread_roles_t::background);
   ((service_t*)h)->service();
   return NULL;
 }
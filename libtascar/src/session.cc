@@ -22,6 +22,7 @@
 
 #include "session.h"
 #include "tascar_os.h"
+#include "threadrole.h"
 #include <chrono>
 #include <dlfcn.h>
 #include <libgen.h>
@@ -32,6 +33,9 @@
 #include <thread>
 #include <unistd.h>
 
+// set while the audio thread dispatches replayed OSC messages:
+static thread_local bool replay_dispatch = false;
+
 /**
    \defgroup moddev Module development
 
@@ -182,22 +186,16 @@ TASCAR::module_t::module_t(const TASCAR::module_cfg_t& cfg)
     : module_base_t(cfg), lib(NULL), libdata(NULL)
 {
   name = tsccfg::node_get_name(e);
-  std::string libname("tascar_");
-#ifdef PLUGINPREFIX
-  libname = PLUGINPREFIX + libname;
-#endif
-  libname += name + TASCAR::dynamic_lib_extension();
-  lib = TASCAR::dlopen((TASCAR::get_libdir() + libname).c_str(), RTLD_NOW);
+  GET_ATTRIBUTE_BOOL(parallelprepare,
+                     "Prepare module in parallel with neighbouring modules "
+                     "which have this attribute set. Use only for modules "
+                     "which do not depend on preceding modules.");
+  std::string libname(TASCAR::plugin_libname("tascar_", name));
+  std::string emsg;
+  lib = TASCAR::plugin_registry_t::get().open(libname, emsg);
   if(!lib)
-    throw TASCAR::ErrMsg("Unable to open module \"" + name +
-                         "\": " + dlerror());
-  try {
-    module_base_t_resolver(&libdata, cfg, lib, libname);
-  }
-  catch(...) {
-    dlclose(lib);
-    throw;
-  }
+    throw TASCAR::ErrMsg("Unable to open module \"" + name + "\": " + emsg);
+  module_base_t_resolver(&libdata, cfg, lib, libname);
 }
 
 void TASCAR::module_t::update(uint32_t frame, bool running)
@@ -238,7 +236,6 @@ void TASCAR::module_t::validate_attributes(std::string& msg) const
 TASCAR::module_t::~module_t()
 {
   delete libdata;
-  dlclose(lib);
 }
 
 TASCAR::module_cfg_t::module_cfg_t(tsccfg::node_t xmlsrc_,
@@ -407,7 +404,7 @@ TASCAR::session_t::session_t()
       jackc_transport_t(jacknamer(name, "session.")),
       osc_server_t(srv_addr, srv_port, srv_proto,
                    TASCAR::config("tascar.osc.list", 0)),
-      period_time(1.0 / (double)srate), started_(false)
+      period_time(1.0 / (double)srate), started_(false), connplanner(jc)
 {
   assert_jackpar("sampling rate", requiresrate, srate, false, " Hz");
   assert_jackpar("fragment size", requirefragsize, fragsize, false);
@@ -447,7 +444,7 @@ TASCAR::session_t::session_t(const std::string& filename_or_data, load_type_t t,
       session_oscvars_t(root()), jackc_transport_t(jacknamer(name, "session.")),
       osc_server_t(srv_addr, srv_port, srv_proto,
                    TASCAR::config("tascar.osc.list", 0)),
-      period_time(1.0 / (double)srate), started_(false)
+      period_time(1.0 / (double)srate), started_(false), connplanner(jc)
 {
   assert_jackpar("sampling rate", requiresrate, srate, false, " Hz");
   assert_jackpar("fragment size", requirefragsize, fragsize, false);
@@ -493,6 +490,12 @@ void TASCAR::session_t::read_xml()
     GET_ATTRIBUTE_BOOL(scriptcancel,
                        "Cancel current OSC script when a new one is loaded "
                        "(true), or append (false).");
+    GET_ATTRIBUTE_BOOL(disconnectonstop,
+                       "Remove the connections of the session when the "
+                       "session is stopped.");
+    GET_ATTRIBUTE_BOOL(rtmemory,
+                       "Lock all memory pages while the session is running, "
+                       "to avoid page faults in the audio threads.");
   }
   catch(...) {
     if(lock_vars()) {
@@ -564,6 +567,7 @@ bool TASCAR::session_t::trylock_vars()
 
 TASCAR::session_t::~session_t()
 {
+  stop_capture();
   osc_server_t::deactivate();
   jackc_transport_t::deactivate();
   unload_modules();
@@ -589,7 +593,12 @@ void TASCAR::session_t::add_scene(tsccfg::node_t src)
   if(!src)
     src = root.add_child("scene");
   try {
+    TASCAR::tictoc_t tload;
     newscene = new TASCAR::scene_render_rt_t(src);
+    TASCAR::task_timing_t tm;
+    tm.name = newscene->name;
+    tm.duration = tload.toc();
+    scene_load_timing.push_back(tm);
     if(namelist.find(newscene->name) != namelist.end())
       throw TASCAR::ErrMsg("A scene of name \"" + newscene->name +
                            "\" already exists in the session.");
@@ -694,66 +703,296 @@ void TASCAR::session_t::add_module(tsccfg::node_t src)
 {
   if(!src)
     src = root.add_child("module");
+  TASCAR::tictoc_t tload;
   modules.push_back(new TASCAR::module_t(TASCAR::module_cfg_t(src, this)));
+  TASCAR::task_timing_t tm;
+  tm.name = modules.back()->modulename();
+  tm.duration = tload.toc();
+  module_load_timing.push_back(tm);
   lo_message_add_double(profilermsg, 0.0);
 }
 
 void TASCAR::session_t::start()
 {
+  // with a limited memlock, future pages are not locked, since
+  // allocations fail once the limit is reached:
+  bool memlock_unlimited(TASCAR::get_memlock_limit() == UINT64_MAX);
+  if(rtmemory && !memory_locked && memlock_unlimited) {
+    // lock before configuration, so that render buffers are faulted
+    // in when they are allocated:
+    std::string errmsg;
+    memory_locked = TASCAR::lock_memory(errmsg);
+    if(!memory_locked)
+      TASCAR::add_warning("Unable to lock memory (" + errmsg + ").");
+  }
+  for(auto scene : scenes)
+    scene->sample_page_faults = use_profiler || rtmemory;
   started_ = true;
+  TASCAR::tictoc_t tprepare;
+  // prepare the scenes in parallel, then create ports and OSC
+  // variables in the order of the session file:
+  TASCAR::task_pool_t scenepool;
+  startup_threads = scenepool.get_num_threads();
+  for(auto scene : scenes)
+    scenepool.add(scene->name, [scene]() { scene->prepare_audio(); });
+  try {
+    scenepool.run();
+  }
+  catch(...) {
+    for(auto scene : scenes)
+      if(scene->audiostates_t::is_prepared())
+        scene->release();
+    started_ = false;
+    throw;
+  }
+  scene_timing = scenepool.get_timings();
+  size_t num_started(0u);
   try {
     for(auto scene : scenes) {
       scene->start();
+      ++num_started;
       scene->add_child_methods(this);
     }
   }
   catch(...) {
+    // stop the scenes which were started, then release the scenes
+    // which were prepared but not started:
+    for(size_t k = 0u; k < num_started; ++k)
+      scenes[k]->stop();
+    for(auto scene : scenes)
+      if(scene->audiostates_t::is_prepared())
+        scene->release();
     started_ = false;
     throw;
   }
-  auto last_prepared(modules.begin());
+  // prepare the modules in the order of the session file. Consecutive
+  // modules with the "parallelprepare" attribute are prepared in
+  // parallel:
+  module_timing.clear();
   try {
-    for(std::vector<TASCAR::module_t*>::iterator imod = modules.begin();
-        imod != modules.end(); ++imod) {
-      chunk_cfg_t cf(srate, fragsize);
-      last_prepared = imod;
-      (*imod)->prepare(cf);
+    size_t k(0u);
+    while(k < modules.size()) {
+      std::vector<TASCAR::module_t*> batch(1u, modules[k]);
+      ++k;
+      while((k < modules.size()) && batch.back()->parallelprepare &&
+            modules[k]->parallelprepare) {
+        batch.push_back(modules[k]);
+        ++k;
+      }
+      TASCAR::task_pool_t modpool(batch.size() > 1u ? 0u : 1u);
+      for(auto mod : batch)
+        modpool.add(mod->modulename(), [this, mod]() {
+          chunk_cfg_t cf(srate, fragsize);
+          mod->prepare(cf);
+        });
+      modpool.run();
+      module_timing.insert(module_timing.end(),
+                           modpool.get_timings().begin(),
+                           modpool.get_timings().end());
     }
-    last_prepared = modules.end();
   }
   catch(...) {
-    for(auto it = modules.begin(); it != last_prepared; ++it)
-      (*it)->release();
+    for(auto mod : modules)
+      if(mod->is_prepared())
+        mod->release();
+    for(auto scene : scenes)
+      scene->stop();
     started_ = false;
     throw;
   }
+  startup_prepare_time = tprepare.toc();
   for(auto& mod : modules)
     mod->post_prepare();
-  for(std::vector<TASCAR::connection_t*>::iterator icon = connections.begin();
-      icon != connections.end(); ++icon) {
-    connect((*icon)->src, (*icon)->dest, !(*icon)->failonerror, true, true);
+  // resolve all connections on one snapshot of the port graph, and
+  // create only the missing connections:
+  connplanner.update_graph();
+  for(auto con : connections)
+    connplanner.add(con->src, con->dest, !con->failonerror, true, true);
+  for(auto scene : scenes) {
+    connplanner.add(get_client_name() + ":sync_out",
+                    scene->get_client_name() + ":sync_in", true);
+    scene->add_licenses(this);
   }
-  for(std::vector<TASCAR::scene_render_rt_t*>::iterator ipl = scenes.begin();
-      ipl != scenes.end(); ++ipl) {
-    try {
-      connect(get_client_name() + ":sync_out",
-              (*ipl)->get_client_name() + ":sync_in");
-    }
-    catch(const std::exception& e) {
-      add_warning(e.what());
-    }
-    (*ipl)->add_licenses(this);
+  connplanner.apply();
+  if(rtmemory && !memory_locked && !memlock_unlimited) {
+    // lock the pages of the configured session only:
+    std::string errmsg;
+    memory_locked = TASCAR::lock_memory(errmsg, false);
+    std::string limit(
+        std::to_string(TASCAR::get_memlock_limit() / 1024u) + " kB");
+    if(memory_locked)
+      TASCAR::add_warning(
+          "The memlock limit is " + limit +
+          ", only memory allocated until session start is locked. Set the "
+          "memlock limit of the user to \"unlimited\" to lock all memory.");
+    else
+      TASCAR::add_warning("Unable to lock memory (" + errmsg +
+                          "). The memlock limit is " + limit + ".");
   }
+  if(use_profiler) {
+    std::cout << "<memory locked=\"" << memory_locked << "\"/>" << std::endl;
+    std::cout << "<connections planned=\"" << connplanner.get_num_planned()
+              << "\" existing=\"" << connplanner.get_num_existing()
+              << "\" graph=\"" << connplanner.get_graph_time()
+              << "\" plan=\"" << connplanner.get_plan_time()
+              << "\" connect=\"" << connplanner.get_connect_time() << "\"/>"
+              << std::endl;
+    for(auto scene : scenes)
+      if(scene->world)
+        std::cout << "<delaylines scene=\"" << scene->name << "\" bytes=\""
+                  << scene->world->get_delayline_bytes()
+                  << "\" sinctables=\"" << TASCAR::sinctable_t::get_num_tables()
+                  << "\"/>" << std::endl;
+  }
+  if(use_profiler)
+    std::cout << startup_report() << std::flush;
+  if(TASCAR::thread_roles_t::get().is_configured())
+    std::cout << TASCAR::thread_roles_t::get().report() << std::flush;
   if(generate_documentation)
     generate_osc_documentation_files();
   if(initoscscript.size())
     read_script_async(initoscscript);
 }
 
-int TASCAR::session_t::process(jack_nframes_t, const std::vector<float*>&,
+std::string TASCAR::session_t::startup_report() const
+{
+  std::stringstream s;
+  double load(0.0);
+  for(const auto& tm : scene_load_timing)
+    load += tm.duration;
+  for(const auto& tm : module_load_timing)
+    load += tm.duration;
+  double prepare(0.0);
+  for(const auto& tm : scene_timing)
+    prepare += tm.duration;
+  for(const auto& tm : module_timing)
+    prepare += tm.duration;
+  s << "<startup threads=\"" << startup_threads << "\" load=\"" << load
+    << "\" prepare=\"" << startup_prepare_time << "\" preparesum=\""
+    << prepare << "\">\n";
+  for(const auto& tm : scene_load_timing)
+    s << "  <load type=\"scene\" name=\"" << tm.name << "\" time=\""
+      << tm.duration << "\"/>\n";
+  for(const auto& tm : module_load_timing)
+    s << "  <load type=\"module\" name=\"" << tm.name << "\" time=\""
+      << tm.duration << "\"/>\n";
+  for(size_t k = 0; k < scene_timing.size(); ++k) {
+    const auto& tm(scene_timing[k]);
+    s << "  <prepare type=\"scene\" name=\"" << tm.name << "\" time=\""
+      << tm.duration << "\" start=\"" << tm.start << "\" worker=\""
+      << tm.worker << "\"/>\n";
+    if(k < scenes.size())
+      for(const auto& otm : scenes[k]->prepare_timing)
+        s << "  <prepare type=\"object\" scene=\"" << tm.name
+          << "\" name=\"" << otm.name << "\" time=\"" << otm.duration
+          << "\" start=\"" << otm.start << "\" worker=\"" << otm.worker
+          << "\"/>\n";
+  }
+  for(const auto& tm : module_timing)
+    s << "  <prepare type=\"module\" name=\"" << tm.name << "\" time=\""
+      << tm.duration << "\" start=\"" << tm.start << "\" worker=\""
+      << tm.worker << "\"/>\n";
+  s << "</startup>\n";
+  return s.str();
+}
+
+void TASCAR::session_t::start_capture(const std::string& fname)
+{
+  stop_capture();
+  capturelog.reset(new TASCAR::osc_log_writer_t(fname, srate, fragsize));
+  capture_anchored = false;
+  capture_start = jack_frame_time(jc);
+  capture_active = true;
+  set_capture_handler([this](const char* path, lo_message msg) {
+    jack_nframes_t frame(jack_frame_time(jc) - capture_start);
+    capturelog->add(frame, path, msg);
+  });
+}
+
+void TASCAR::session_t::stop_capture()
+{
+  set_capture_handler(nullptr);
+  capture_active = false;
+  if(capturelog) {
+    if(capture_anchored)
+      capturelog->set_anchor(capture_anchor);
+    capturelog.reset();
+  }
+}
+
+size_t TASCAR::session_t::get_capture_size() const
+{
+  if(capturelog)
+    return capturelog->get_num_messages();
+  return 0u;
+}
+
+void TASCAR::session_t::start_replay(const std::string& fname, bool sync)
+{
+  std::unique_ptr<TASCAR::osc_log_player_t> log(
+      new TASCAR::osc_log_player_t(fname, sync));
+  if((int)(log->log.get_header().srate) != srate)
+    TASCAR::add_warning("OSC log file \"" + fname + "\" was recorded at " +
+                        std::to_string(log->log.get_header().srate) +
+                        " Hz, replay timing will differ.");
+  std::lock_guard<std::mutex> lock(mtxreplay);
+  wait_for_replay();
+  replaylog.swap(log);
+}
+
+void TASCAR::session_t::stop_replay()
+{
+  std::lock_guard<std::mutex> lock(mtxreplay);
+  wait_for_replay();
+  replaylog.reset();
+}
+
+void TASCAR::session_t::wait_for_replay()
+{
+  // the audio thread does not start a new dispatch while mtxreplay
+  // is locked by the caller:
+  while(replay_busy)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+}
+
+size_t TASCAR::session_t::get_replay_remaining()
+{
+  std::lock_guard<std::mutex> lock(mtxreplay);
+  if(replaylog)
+    return replaylog->get_remaining();
+  return 0u;
+}
+
+int TASCAR::session_t::process(jack_nframes_t nframes,
+                               const std::vector<float*>&,
                                const std::vector<float*>&, uint32_t tp_frame,
                                bool tp_rolling)
 {
+  if(capture_active && (!capture_anchored) && tp_rolling) {
+    capture_anchor = (jack_nframes_t)(jack_last_frame_time(jc) - capture_start);
+    capture_anchored = true;
+  }
+  if(mtxreplay.try_lock()) {
+    size_t first(0u);
+    size_t last(0u);
+    TASCAR::osc_log_player_t* player(replaylog.get());
+    if(player) {
+      // select messages which were received before the beginning
+      // of this period:
+      player->next_period(nframes, tp_rolling, first, last);
+      replay_busy = (first < last);
+    }
+    mtxreplay.unlock();
+    // dispatch without holding the lock, handlers may start or stop
+    // a replay:
+    if(replay_busy) {
+      replay_dispatch = true;
+      for(size_t k = first; k < last; ++k)
+        dispatch_data(player->log.get_data(k), player->log.get_size(k));
+      replay_dispatch = false;
+      replay_busy = false;
+    }
+  }
   double t(period_time * (double)tp_frame);
   uint32_t next_tp_frame(tp_frame);
   if(tp_rolling) {
@@ -791,6 +1030,12 @@ void TASCAR::session_t::stop()
   started_ = false;
   for(auto& scene : scenes)
     scene->stop();
+  if(disconnectonstop)
+    connplanner.disconnect();
+  if(memory_locked) {
+    TASCAR::unlock_memory();
+    memory_locked = false;
+  }
 }
 
 void TASCAR::session_t::run(bool& b_quit, bool use_stdin)
@@ -1147,6 +1392,70 @@ namespace OSCSession {
     return 0;
   }
 
+  int _osc_send_memory_report(const char*, const char* types, lo_arg** argv,
+                              int argc, lo_message, void* user_data)
+  {
+    if(user_data && (argc == 2) && (types[0] == 's') && (types[1] == 's')) {
+      TASCAR::session_t* srv(reinterpret_cast<TASCAR::session_t*>(user_data));
+      srv->send_memory_report(&(argv[0]->s), &(argv[1]->s));
+    }
+    return 0;
+  }
+
+  int _capture_start(const char*, const char* types, lo_arg** argv, int argc,
+                     lo_message, void* user_data)
+  {
+    if(replay_dispatch)
+      return 0;
+    if(user_data && (argc == 1) && (types[0] == 's')) {
+      TASCAR::session_t* srv(reinterpret_cast<TASCAR::session_t*>(user_data));
+      try {
+        srv->start_capture(&(argv[0]->s));
+      }
+      catch(const std::exception& e) {
+        TASCAR::add_warning(e.what());
+      }
+    }
+    return 0;
+  }
+
+  int _capture_stop(const char*, const char*, lo_arg**, int argc, lo_message,
+                    void* user_data)
+  {
+    if(replay_dispatch)
+      return 0;
+    if(user_data && (argc == 0))
+      reinterpret_cast<TASCAR::session_t*>(user_data)->stop_capture();
+    return 0;
+  }
+
+  int _replay_start(const char*, const char* types, lo_arg** argv, int argc,
+                    lo_message, void* user_data)
+  {
+    if(replay_dispatch)
+      return 0;
+    if(user_data && (argc == 2) && (types[0] == 's') && (types[1] == 'i')) {
+      TASCAR::session_t* srv(reinterpret_cast<TASCAR::session_t*>(user_data));
+      try {
+        srv->start_replay(&(argv[0]->s), argv[1]->i);
+      }
+      catch(const std::exception& e) {
+        TASCAR::add_warning(e.what());
+      }
+    }
+    return 0;
+  }
+
+  int _replay_stop(const char*, const char*, lo_arg**, int argc, lo_message,
+                   void* user_data)
+  {
+    if(replay_dispatch)
+      return 0;
+    if(user_data && (argc == 0))
+      reinterpret_cast<TASCAR::session_t*>(user_data)->stop_replay();
+    return 0;
+  }
+
   int _runscript(const char*, const char* types, lo_arg** argv, int argc,
                  lo_message, void* user_data)
   {
@@ -1166,6 +1475,24 @@ void TASCAR::session_t::add_transport_methods()
                            true, false, "",
                            "Send session file XML code to an OSC server. First "
                            "parameter is the URL, the second is the path.");
+  osc_server_t::add_method(
+      "/sendmemoryreportto", "ss", OSCSession::_osc_send_memory_report, this,
+      true, false, "",
+      "Send memory report of the scenes to an OSC server. First parameter is "
+      "the URL, the second is the path.");
+  osc_server_t::add_method(
+      "/capture/start", "s", OSCSession::_capture_start, this, true, false, "",
+      "Record all OSC messages received from the network with their frame "
+      "time to the given binary log file.");
+  osc_server_t::add_method("/capture/stop", "", OSCSession::_capture_stop,
+                           this, true, false, "",
+                           "Stop recording of OSC messages.");
+  osc_server_t::add_method(
+      "/replay/start", "si", OSCSession::_replay_start, this, true, false, "",
+      "Replay OSC messages from a binary log file. If the second parameter is "
+      "non-zero, the replay is synchronized to the transport.");
+  osc_server_t::add_method("/replay/stop", "", OSCSession::_replay_stop, this,
+                           true, false, "", "Stop replay of OSC messages.");
   osc_server_t::add_method("/transport/locate", "f", OSCSession::_locate, this,
                            true, false, "",
                            "Locate the transport to the given second.");
@@ -1203,6 +1530,27 @@ void TASCAR::session_t::send_xml(const std::string& url,
   lo_address_free(target);
 }
 
+std::string TASCAR::session_t::memory_report()
+{
+  std::string report;
+  for(auto scene : scenes)
+    report += scene->get_memory_report();
+  report += "<heap bytes=\"" + std::to_string(TASCAR::get_heap_bytes()) +
+            "\"/>\n";
+  return report;
+}
+
+void TASCAR::session_t::send_memory_report(const std::string& url,
+                                           const std::string& path)
+{
+  lo_address target = lo_address_new_from_url(url.c_str());
+  if(!target)
+    return;
+  std::string report = memory_report();
+  lo_send(target, path.c_str(), "s", report.c_str());
+  lo_address_free(target);
+}
+
 void TASCAR::session_t::validate_attributes(std::string& msg) const
 {
   root.validate_attributes(msg);
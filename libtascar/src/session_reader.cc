@@ -22,7 +22,9 @@
 
 #include "session_reader.h"
 #include "errorhandling.h"
+#include "pluginregistry.h"
 #include "tascar_os.h"
+#include "threadrole.h"
 #include <libgen.h>
 #include <stdlib.h>
 #include <string.h>
@@ -139,6 +141,18 @@ void TASCAR::tsc_reader_t::read_xml()
   root.GET_ATTRIBUTE(profilingpath, "",
                      "OSC path to dispatch module profiling information to");
   use_profiler = profilingpath.size() > 0;
+  // configure thread roles before any component creates threads:
+  TASCAR::thread_roles_t::get().clear();
+  for(auto& sne : root.get_children())
+    if(tsccfg::node_get_name(sne) == "threadrole")
+      TASCAR::thread_roles_t::get().read_xml(sne);
+  root.GET_ATTRIBUTE_BOOL(preloadplugins,
+                          "Open all plugin libraries of the session in "
+                          "parallel before creating the session components");
+  if(preloadplugins)
+    TASCAR::plugin_registry_t::get().preload(
+        TASCAR::get_plugin_libnames(root.e),
+        (uint32_t)TASCAR::config("tascar.plugins.preloadthreads", 4.0));
   for(auto& sne : root.get_children()) {
     if(tsccfg::node_get_name(sne) == "scene")
       add_scene(sne);
@@ -172,6 +186,7 @@ void TASCAR::tsc_reader_t::read_xml()
 
     } else if((tsccfg::node_get_name(sne) != "include") &&
               (tsccfg::node_get_name(sne) != "mainwindow") &&
+              (tsccfg::node_get_name(sne) != "threadrole") &&
               (tsccfg::node_get_name(sne) != "description"))
       add_warning("Invalid element: " + tsccfg::node_get_name(sne), sne);
     if(tsccfg::node_get_name(sne) == "module")
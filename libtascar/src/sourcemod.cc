@@ -34,22 +34,13 @@ sourcemod_t::sourcemod_t(tsccfg::node_t cfg)
   get_attribute("type", sourcetype, "",
                 "source directivity type, e.g., omni, cardioid");
   sourcetype = env_expand(sourcetype);
-  std::string libname("tascarsource_");
-#ifdef PLUGINPREFIX
-  libname = PLUGINPREFIX + libname;
-#endif
-  libname += sourcetype + TASCAR::dynamic_lib_extension();
-  lib = TASCAR::dlopen((TASCAR::get_libdir() + libname).c_str(), RTLD_NOW);
+  std::string libname(TASCAR::plugin_libname("tascarsource_", sourcetype));
+  std::string emsg;
+  lib = TASCAR::plugin_registry_t::get().open(libname, emsg);
   if(!lib)
     throw TASCAR::ErrMsg("Unable to open source module \"" + sourcetype +
-                         "\": " + dlerror());
-  try {
-    sourcemod_base_t_resolver(&libdata, cfg, lib, libname);
-  }
-  catch(...) {
-    dlclose(lib);
-    throw;
-  }
+                         "\": " + emsg);
+  sourcemod_base_t_resolver(&libdata, cfg, lib, libname);
 }
 
 bool sourcemod_t::read_source(pos_t& prel, const std::vector<wave_t>& input,
@@ -125,7 +116,6 @@ bool sourcemod_base_t::read_source(TASCAR::pos_t&,
 sourcemod_t::~sourcemod_t()
 {
   delete libdata;
-  dlclose(lib);
 }
 
 sourcemod_base_t::sourcemod_base_t(tsccfg::node_t xmlsrc)
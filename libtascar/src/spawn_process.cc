@@ -19,6 +19,7 @@
 
 #include "spawn_process.h"
 #include "tascar_os.h"
+#include "threadrole.h"
 #include "tscconfig.h"
 #include <iostream>
 #include <signal.h>
@@ -54,6 +55,7 @@ TASCAR::spawn_process_t::spawn_process_t(const std::string& command,
 
 void TASCAR::spawn_process_t::launcher()
 {
+  TASCAR::register_thread(TASCAR::thread_roles_t::background);
   bool first = true;
   while(runservice && (first || relaunch_)) {
     first = false;
@@ -18,6 +18,7 @@
  * 02110-1301, USA.
  */
 #include "tascar_os.h"
+#include <errno.h>
 #include <iomanip>
 #include <sstream>
 #include <string.h>
@@ -27,6 +28,11 @@
 #include <windows.h>
 #else
 #include <fnmatch.h>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+#include <sys/mman.h>
+#include <sys/resource.h>
 #endif
 #include "tscconfig.h"
 #include <dlfcn.h>
@@ -218,6 +224,84 @@ namespace TASCAR {
     return lib;
   }
 
+  page_faults_t get_page_faults()
+  {
+    page_faults_t pf;
+#ifndef _WIN32
+    struct rusage ru;
+#ifdef RUSAGE_THREAD
+    int who(RUSAGE_THREAD);
+#else
+    int who(RUSAGE_SELF);
+#endif
+    if(getrusage(who, &ru) == 0) {
+      pf.minor = ru.ru_minflt;
+      pf.major = ru.ru_majflt;
+    }
+#endif
+    return pf;
+  }
+
+  size_t get_heap_bytes()
+  {
+#if defined(__GLIBC__) && ((__GLIBC__ > 2) || (__GLIBC_MINOR__ >= 33))
+    struct mallinfo2 mi(mallinfo2());
+    return mi.uordblks + mi.hblkhd;
+#elif defined(__GLIBC__)
+    struct mallinfo mi(mallinfo());
+    return (size_t)(unsigned int)mi.uordblks + (size_t)(unsigned int)mi.hblkhd;
+#else
+    return 0u;
+#endif
+  }
+
+  bool lock_memory(std::string& errmsg, bool lockfuture)
+  {
+#ifndef _WIN32
+    if(mlockall(lockfuture ? (MCL_CURRENT | MCL_FUTURE) : MCL_CURRENT) == 0)
+      return true;
+    errmsg = strerror(errno);
+#else
+    (void)lockfuture;
+    errmsg = "Memory locking is not supported on this platform";
+#endif
+    return false;
+  }
+
+  void unlock_memory()
+  {
+#ifndef _WIN32
+    munlockall();
+#endif
+  }
+
+  uint64_t get_memlock_limit()
+  {
+#ifndef _WIN32
+    struct rlimit rl;
+    if((getrlimit(RLIMIT_MEMLOCK, &rl) == 0) && (rl.rlim_cur != RLIM_INFINITY))
+      return rl.rlim_cur;
+#endif
+    return UINT64_MAX;
+  }
+
+  bool advise_hugepages(void* data, size_t len)
+  {
+#ifdef MADV_HUGEPAGE
+    const size_t hugepagesize(2u * 1024u * 1024u);
+    uintptr_t begin(((uintptr_t)data + hugepagesize - 1u) &
+                    ~(uintptr_t)(hugepagesize - 1u));
+    uintptr_t end(((uintptr_t)data + len) & ~(uintptr_t)(hugepagesize - 1u));
+    if(end <= begin)
+      return false;
+    return madvise((void*)begin, end - begin, MADV_HUGEPAGE) == 0;
+#else
+    (void)data;
+    (void)len;
+    return false;
+#endif
+  }
+
 } // namespace TASCAR
 
 /*
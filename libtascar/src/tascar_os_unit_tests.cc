@@ -23,6 +23,8 @@
 #include "tascar_os.h"
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 
 TEST(tascar_os, strptime)
@@ -204,6 +206,78 @@ TEST(tascar_os, systemshell)
   EXPECT_TRUE(tascarfexists("test_proc_shell_ended"));
 }
 
+#ifndef _WIN32
+TEST(tascar_os, page_faults)
+{
+  const size_t len(16u * 1024u * 1024u);
+  char* data((char*)malloc(len));
+  ASSERT_TRUE(data != NULL);
+  TASCAR::page_faults_t pf0(TASCAR::get_page_faults());
+  // first touch of the buffer causes page faults:
+  memset(data, 0, len);
+  TASCAR::page_faults_t pf1(TASCAR::get_page_faults());
+  EXPECT_GT(pf1.minor, pf0.minor);
+  // second access does not:
+  memset(data, 1, len);
+  TASCAR::page_faults_t pf2(TASCAR::get_page_faults());
+  EXPECT_LT(pf2.minor - pf1.minor, 8u);
+  EXPECT_EQ(1, data[0]);
+  EXPECT_EQ(1, data[len / 2]);
+  EXPECT_EQ(1, data[len - 1]);
+  free(data);
+  // huge pages require at least one aligned huge page:
+  char small[1024];
+  EXPECT_FALSE(TASCAR::advise_hugepages(small, sizeof(small)));
+}
+
+TEST(tascar_os, lock_memory)
+{
+  std::string errmsg;
+  if(!TASCAR::lock_memory(errmsg)) {
+    EXPECT_FALSE(errmsg.empty());
+    GTEST_SKIP() << "Memory locking not permitted: " << errmsg;
+  }
+  // new allocations are faulted in when they are mapped:
+  const size_t len(16u * 1024u * 1024u);
+  char* data((char*)malloc(len));
+  ASSERT_TRUE(data != NULL);
+  TASCAR::page_faults_t pf0(TASCAR::get_page_faults());
+  memset(data, 0, len);
+  TASCAR::page_faults_t pf1(TASCAR::get_page_faults());
+  EXPECT_LT(pf1.minor - pf0.minor, 8u);
+  free(data);
+  TASCAR::unlock_memory();
+  // locking of current pages only:
+  ASSERT_TRUE(TASCAR::lock_memory(errmsg, false));
+  TASCAR::unlock_memory();
+}
+#endif
+
+#ifdef __GLIBC__
+// keep allocations from being optimized away:
+char* volatile heap_sink(NULL);
+
+TEST(tascar_os, heap_bytes)
+{
+  size_t h0(TASCAR::get_heap_bytes());
+  EXPECT_GT(h0, 0u);
+  // small allocations and memory mapped chunks are both counted:
+  std::vector<char*> small;
+  for(size_t k = 0; k < 100; ++k)
+    small.push_back(new char[1000]);
+  size_t h1(TASCAR::get_heap_bytes());
+  EXPECT_GE(h1 - h0, 100000u);
+  char* large(new char[16u * 1024u * 1024u]);
+  heap_sink = large;
+  size_t h2(TASCAR::get_heap_bytes());
+  EXPECT_GE(h2 - h1, 16u * 1024u * 1024u);
+  delete[] large;
+  for(auto p : small)
+    delete[] p;
+  EXPECT_LT(TASCAR::get_heap_bytes(), h1);
+}
+#endif
+
 // Local Variables:
 // compile-command: "make -C ../.. unit-tests"
 // coding: utf-8-unix
@@ -0,0 +1,105 @@
+/*
+ * This file is part of the TASCAR software, see <http://tascar.org/>
+ *
+ * Copyright (c) 2026 agent
+ */
+/*
+ * TASCAR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, version 3 of the License.
+ *
+ * TASCAR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHATABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License, version 3 for more details.
+ *
+ * You should have received a copy of the GNU General Public License,
+ * Version 3 along with TASCAR. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "taskpool.h"
+#include "threadrole.h"
+#include "tscconfig.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <thread>
+
+using namespace TASCAR;
+
+task_pool_t::task_pool_t(size_t numthreads_) : numthreads(numthreads_)
+{
+  if(numthreads == 0u) {
+    double hw(std::thread::hardware_concurrency());
+    numthreads = (size_t)std::max(
+        1.0, TASCAR::config("tascar.startup.threads", std::max(1.0, hw)));
+  }
+}
+
+void task_pool_t::add(const std::string& name, std::function<void()> fn)
+{
+  tasks.push_back({name, fn});
+}
+
+void task_pool_t::run()
+{
+  const size_t n(tasks.size());
+  if(n == 0u)
+    return;
+  const size_t offset(timings.size());
+  timings.resize(offset + n);
+  std::vector<std::exception_ptr> errors(n);
+  std::atomic_size_t next(0u);
+  const auto t0(std::chrono::steady_clock::now());
+  auto worker = [&](size_t idx) {
+    size_t k(0u);
+    while((k = next++) < n) {
+      task_timing_t& tm(timings[offset + k]);
+      tm.name = tasks[k].name;
+      tm.worker = idx;
+      const auto t1(std::chrono::steady_clock::now());
+      try {
+        tasks[k].fn();
+      }
+      catch(...) {
+        errors[k] = std::current_exception();
+      }
+      const auto t2(std::chrono::steady_clock::now());
+      tm.start = std::chrono::duration<double>(t1 - t0).count();
+      tm.duration = std::chrono::duration<double>(t2 - t1).count();
+    }
+  };
+  const size_t nthreads(std::min(numthreads, n));
+  if(nthreads < 2u) {
+    // no need for threads, execute in the calling thread:
+    worker(0u);
+  } else {
+    std::vector<std::thread> threads;
+    for(size_t k = 1u; k < nthreads; ++k)
+      threads.emplace_back([&worker, k]() {
+        TASCAR::register_thread(TASCAR::thread_roles_t::background);
+        worker(k);
+      });
+    worker(0u);
+    for(auto& th : threads)
+      th.join();
+  }
+  walltime += std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                            t0)
+                  .count();
+  tasks.clear();
+  for(auto& err : errors)
+    if(err)
+      std::rethrow_exception(err);
+}
+
+/*
+ * Local Variables:
+ * mode: c++
+ * c-basic-offset: 2
+ * indent-tabs-mode: nil
+ * compile-command: "make -C .."
+ * End:
+ */
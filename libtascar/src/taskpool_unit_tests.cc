@@ -0,0 +1,120 @@
+/*
+ * This file is part of the TASCAR software, see <http://tascar.org/>
+ *
+ * Copyright (c) 2026 agent
+ */
+/*
+ * TASCAR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, version 3 of the License.
+ *
+ * TASCAR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHATABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License, version 3 for more details.
+ *
+ * You should have received a copy of the GNU General Public License,
+ * Version 3 along with TASCAR. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include "errorhandling.h"
+#include "taskpool.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+TEST(task_pool_t, run)
+{
+  TASCAR::task_pool_t pool(4);
+  EXPECT_EQ(4u, pool.get_num_threads());
+  std::vector<int> result(100, 0);
+  for(size_t k = 0; k < result.size(); ++k)
+    pool.add(std::to_string(k), [&result, k]() { result[k] = (int)k; });
+  pool.run();
+  for(size_t k = 0; k < result.size(); ++k)
+    EXPECT_EQ((int)k, result[k]);
+  // timings are in the order of the tasks:
+  ASSERT_EQ(100u, pool.get_timings().size());
+  EXPECT_EQ("0", pool.get_timings()[0].name);
+  EXPECT_EQ("99", pool.get_timings()[99].name);
+  for(const auto& tm : pool.get_timings())
+    EXPECT_LT(tm.worker, 4u);
+  // the task list is cleared after run:
+  pool.run();
+  EXPECT_EQ(100u, pool.get_timings().size());
+}
+
+TEST(task_pool_t, sequential)
+{
+  // a single worker executes the tasks in the calling thread:
+  TASCAR::task_pool_t pool(1);
+  std::thread::id caller(std::this_thread::get_id());
+  std::vector<size_t> order;
+  for(size_t k = 0; k < 10; ++k)
+    pool.add("", [&order, caller, k]() {
+      EXPECT_EQ(caller, std::this_thread::get_id());
+      order.push_back(k);
+    });
+  pool.run();
+  ASSERT_EQ(10u, order.size());
+  for(size_t k = 0; k < order.size(); ++k)
+    EXPECT_EQ(k, order[k]);
+}
+
+TEST(task_pool_t, exception)
+{
+  TASCAR::task_pool_t pool(4);
+  std::atomic_size_t cnt(0u);
+  for(size_t k = 0; k < 20; ++k)
+    pool.add("", [&cnt, k]() {
+      ++cnt;
+      if((k == 7) || (k == 12))
+        throw TASCAR::ErrMsg("task " + std::to_string(k));
+    });
+  try {
+    pool.run();
+    FAIL() << "no exception thrown";
+  }
+  catch(const std::exception& e) {
+    // first failing task in order of adding:
+    EXPECT_NE(std::string::npos, std::string(e.what()).find("task 7"));
+  }
+  // all other tasks were executed:
+  EXPECT_EQ(20u, cnt);
+}
+
+TEST(task_pool_t, parallel)
+{
+  // each task waits until four tasks are active at the same time:
+  TASCAR::task_pool_t pool(4);
+  std::atomic_size_t active(0u);
+  std::atomic_size_t maxactive(0u);
+  for(size_t k = 0; k < 8; ++k)
+    pool.add("", [&active, &maxactive]() {
+      size_t a(++active);
+      size_t m(maxactive);
+      while((a > m) && !maxactive.compare_exchange_weak(m, a))
+        ;
+      for(size_t k = 0; (k < 2000u) && (maxactive < 4u); ++k)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      --active;
+    });
+  pool.run();
+  EXPECT_EQ(4u, maxactive);
+  std::vector<bool> used(4, false);
+  for(const auto& tm : pool.get_timings())
+    used[tm.worker] = true;
+  EXPECT_EQ(std::vector<bool>(4, true), used);
+}
+
+/*
+ * Local Variables:
+ * mode: c++
+ * c-basic-offset: 2
+ * indent-tabs-mode: nil
+ * compile-command: "make -C .."
+ * End:
+ */
@@ -0,0 +1,236 @@
+/*
+ * This file is part of the TASCAR software, see <http://tascar.org/>
+ *
+ * Copyright (c) 2026 agent
+ */
+/*
+ * TASCAR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, version 3 of the License.
+ *
+ * TASCAR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHATABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License, version 3 for more details.
+ *
+ * You should have received a copy of the GNU General Public License,
+ * Version 3 along with TASCAR. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "threadrole.h"
+#include "errorhandling.h"
+#include <errno.h>
+#include <sstream>
+#include <string.h>
+#ifndef _WIN32
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+using namespace TASCAR;
+
+namespace {
+
+  const char* role_names[thread_roles_t::num_roles] = {
+      "audio", "disk", "network", "gui", "background"};
+
+  /// Apply configuration to calling thread, return error message
+  std::string apply(const thread_roles_t::cfg_t& cfg)
+  {
+    std::string err;
+#ifdef __linux__
+    if(cfg.cpus.size()) {
+      cpu_set_t cpuset;
+      CPU_ZERO(&cpuset);
+      for(auto cpu : cfg.cpus)
+        if((cpu >= 0) && (cpu < CPU_SETSIZE))
+          CPU_SET(cpu, &cpuset);
+      int r(pthread_setaffinity_np(pthread_self(), sizeof(cpuset), &cpuset));
+      if(r != 0)
+        err += std::string("affinity: ") + strerror(r) + " ";
+    }
+#else
+    if(cfg.cpus.size())
+      err += "affinity: not supported on this platform ";
+#endif
+#ifndef _WIN32
+    if(cfg.policy != thread_roles_t::keep) {
+      struct sched_param param;
+      memset(&param, 0, sizeof(param));
+      int policy(SCHED_OTHER);
+      if(cfg.policy == thread_roles_t::fifo) {
+        policy = SCHED_FIFO;
+        param.sched_priority = cfg.priority;
+      }
+      int r(pthread_setschedparam(pthread_self(), policy, &param));
+      if(r != 0)
+        err += std::string("scheduler: ") + strerror(r) + " ";
+    }
+#ifdef __linux__
+    if(cfg.policy == thread_roles_t::other) {
+      // on Linux, the nice value is a per-thread attribute:
+      if(setpriority(PRIO_PROCESS, (id_t)syscall(SYS_gettid), cfg.nice) != 0)
+        err += std::string("nice: ") + strerror(errno) + " ";
+    }
+#endif
+#else
+    if(cfg.policy != thread_roles_t::keep)
+      err += "scheduler: not supported on this platform ";
+#endif
+    return err;
+  }
+
+} // namespace
+
+thread_roles_t& thread_roles_t::get()
+{
+  static thread_roles_t roles;
+  return roles;
+}
+
+void thread_roles_t::configure(role_t role, const cfg_t& cfg_)
+{
+  std::lock_guard<std::mutex> lock(mtx);
+  cfg[role] = cfg_;
+  configured[role] = true;
+}
+
+void thread_roles_t::read_xml(tsccfg::node_t e)
+{
+  TASCAR::xml_element_t xml(e);
+  std::string name;
+  xml.GET_ATTRIBUTE(name, "",
+                    "Thread role, one of audio, disk, network, gui, "
+                    "background");
+  role_t role(get_role(name));
+  cfg_t c;
+  xml.GET_ATTRIBUTE(c.cpus, "",
+                    "CPU cores of affinity mask, or empty for no restriction");
+  std::string scheduler("keep");
+  xml.GET_ATTRIBUTE(scheduler, "",
+                    "Scheduling policy: keep (unchanged), other (SCHED_OTHER "
+                    "with nice value) or fifo (SCHED_FIFO with priority)");
+  if(scheduler == "other")
+    c.policy = other;
+  else if(scheduler == "fifo")
+    c.policy = fifo;
+  else if(scheduler != "keep")
+    throw TASCAR::ErrMsg("Invalid scheduler \"" + scheduler +
+                         "\" (expected keep, other or fifo).");
+  xml.GET_ATTRIBUTE(c.priority, "", "Real-time priority, used with fifo");
+  xml.GET_ATTRIBUTE(c.nice, "", "Nice value, used with other");
+  configure(role, c);
+}
+
+void thread_roles_t::clear()
+{
+  std::lock_guard<std::mutex> lock(mtx);
+  for(size_t k = 0; k < num_roles; ++k) {
+    cfg[k] = cfg_t();
+    configured[k] = false;
+    numthreads[k] = 0u;
+    numfailed[k] = 0u;
+    lasterror[k].clear();
+  }
+}
+
+bool thread_roles_t::is_configured()
+{
+  std::lock_guard<std::mutex> lock(mtx);
+  for(size_t k = 0; k < num_roles; ++k)
+    if(configured[k])
+      return true;
+  return false;
+}
+
+bool thread_roles_t::register_thread(role_t role)
+{
+  cfg_t c;
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    ++numthreads[role];
+    if(!configured[role])
+      return true;
+    c = cfg[role];
+  }
+  std::string err(apply(c));
+  if(err.empty())
+    return true;
+  std::lock_guard<std::mutex> lock(mtx);
+  ++numfailed[role];
+  lasterror[role] = err;
+  return false;
+}
+
+size_t thread_roles_t::get_num_threads(role_t role)
+{
+  std::lock_guard<std::mutex> lock(mtx);
+  return numthreads[role];
+}
+
+size_t thread_roles_t::get_num_failed(role_t role)
+{
+  std::lock_guard<std::mutex> lock(mtx);
+  return numfailed[role];
+}
+
+std::string thread_roles_t::report()
+{
+  const char* policy_names[3] = {"keep", "other", "fifo"};
+  std::lock_guard<std::mutex> lock(mtx);
+  std::stringstream s;
+  for(size_t k = 0; k < num_roles; ++k) {
+    s << "<threadrole name=\"" << role_names[k] << "\"";
+    if(configured[k]) {
+      s << " cpus=\"";
+      for(size_t c = 0; c < cfg[k].cpus.size(); ++c)
+        s << (c ? " " : "") << cfg[k].cpus[c];
+      s << "\" scheduler=\"" << policy_names[cfg[k].policy] << "\"";
+      if(cfg[k].policy == fifo)
+        s << " priority=\"" << cfg[k].priority << "\"";
+      if(cfg[k].policy == other)
+        s << " nice=\"" << cfg[k].nice << "\"";
+    }
+    s << " threads=\"" << numthreads[k] << "\"";
+    if(numfailed[k])
+      s << " failed=\"" << numfailed[k] << "\" error=\"" << lasterror[k]
+        << "\"";
+    s << "/>\n";
+  }
+  return s.str();
+}
+
+thread_roles_t::role_t thread_roles_t::get_role(const std::string& name)
+{
+  for(size_t k = 0; k < num_roles; ++k)
+    if(name == role_names[k])
+      return (role_t)k;
+  throw TASCAR::ErrMsg("Invalid thread role \"" + name +
+                       "\" (expected audio, disk, network, gui or "
+                       "background).");
+}
+
+std::string thread_roles_t::get_name(role_t role)
+{
+  return role_names[role];
+}
+
+void TASCAR::register_thread(thread_roles_t::role_t role)
+{
+  thread_roles_t::get().register_thread(role);
+}
+
+/*
+ * Local Variables:
+ * mode: c++
+ * c-basic-offset: 2
+ * indent-tabs-mode: nil
+ * compile-command: "make -C .."
+ * End:
+ */
@@ -0,0 +1,113 @@
+/*
+ * This file is part of the TASCAR software, see <http://tascar.org/>
+ *
+ * Copyright (c) 2026 agent
+ */
+/*
+ * TASCAR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, version 3 of the License.
+ *
+ * TASCAR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHATABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License, version 3 for more details.
+ *
+ * You should have received a copy of the GNU General Public License,
+ * Version 3 along with TASCAR. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "errorhandling.h"
+#include "threadrole.h"
+#include <thread>
+#ifdef __linux__
+#include <pthread.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace TASCAR;
+
+TEST(thread_roles_t, names)
+{
+  for(size_t k = 0; k < thread_roles_t::num_roles; ++k) {
+    thread_roles_t::role_t role((thread_roles_t::role_t)k);
+    EXPECT_EQ(role, thread_roles_t::get_role(thread_roles_t::get_name(role)));
+  }
+  EXPECT_EQ("disk", thread_roles_t::get_name(thread_roles_t::disk));
+  EXPECT_THROW(thread_roles_t::get_role("render"), TASCAR::ErrMsg);
+}
+
+TEST(thread_roles_t, unconfigured)
+{
+  thread_roles_t& roles(thread_roles_t::get());
+  roles.clear();
+  EXPECT_FALSE(roles.is_configured());
+  std::thread th([]() { register_thread(thread_roles_t::network); });
+  th.join();
+  EXPECT_EQ(1u, roles.get_num_threads(thread_roles_t::network));
+  EXPECT_EQ(0u, roles.get_num_failed(thread_roles_t::network));
+  EXPECT_EQ(0u, roles.get_num_threads(thread_roles_t::disk));
+  std::string report(roles.report());
+  EXPECT_NE(std::string::npos,
+            report.find("<threadrole name=\"network\" threads=\"1\"/>"));
+}
+
+#ifdef __linux__
+TEST(thread_roles_t, affinity_and_nice)
+{
+  thread_roles_t& roles(thread_roles_t::get());
+  roles.clear();
+  thread_roles_t::cfg_t cfg;
+  cfg.cpus = {0};
+  cfg.policy = thread_roles_t::other;
+  cfg.nice = 5;
+  roles.configure(thread_roles_t::disk, cfg);
+  EXPECT_TRUE(roles.is_configured());
+  bool ok(false);
+  int ncpus(0);
+  bool cpu0(false);
+  int nice(0);
+  std::thread th([&]() {
+    ok = roles.register_thread(thread_roles_t::disk);
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    pthread_getaffinity_np(pthread_self(), sizeof(cpuset), &cpuset);
+    ncpus = CPU_COUNT(&cpuset);
+    cpu0 = CPU_ISSET(0, &cpuset);
+    nice = getpriority(PRIO_PROCESS, (id_t)syscall(SYS_gettid));
+  });
+  th.join();
+  EXPECT_TRUE(ok);
+  EXPECT_EQ(1, ncpus);
+  EXPECT_TRUE(cpu0);
+  EXPECT_EQ(5, nice);
+  EXPECT_EQ(1u, roles.get_num_threads(thread_roles_t::disk));
+  EXPECT_EQ(0u, roles.get_num_failed(thread_roles_t::disk));
+  std::string report(roles.report());
+  EXPECT_NE(std::string::npos,
+            report.find("<threadrole name=\"disk\" cpus=\"0\" "
+                        "scheduler=\"other\" nice=\"5\" threads=\"1\"/>"));
+  // invalid CPU cores are reported as failure:
+  cfg.cpus = {CPU_SETSIZE + 1};
+  cfg.policy = thread_roles_t::keep;
+  roles.configure(thread_roles_t::background, cfg);
+  std::thread th2([]() { register_thread(thread_roles_t::background); });
+  th2.join();
+  EXPECT_EQ(1u, roles.get_num_failed(thread_roles_t::background));
+  EXPECT_NE(std::string::npos, roles.report().find("failed=\"1\""));
+  roles.clear();
+}
+#endif
+
+/*
+ * Local Variables:
+ * mode: c++
+ * c-basic-offset: 2
+ * indent-tabs-mode: nil
+ * compile-command: "make -C .."
+ * End:
+ */
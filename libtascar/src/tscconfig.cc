@@ -22,6 +22,7 @@
 #include <atomic>
 #include <fstream>
 #include <functional>
+#include <mutex>
 #include <set>
 #include <sstream>
 #include <stdio.h>
@@ -93,6 +94,7 @@ namespace TASCAR {
 
   static std::map<std::string, cfg_node_desc_t> attribute_list;
   static std::vector<std::string> warnings;
+  static std::mutex warnings_mtx;
   static globalconfig_t config_;
   static std::atomic_size_t maxid(0);
 } // namespace TASCAR
@@ -813,6 +815,8 @@ void TASCAR::add_warning(std::string msg, const tsccfg::node_t& e)
 
 void TASCAR::add_warning(std::string msg)
 {
+  // warnings may be issued by parallel configuration tasks:
+  std::lock_guard<std::mutex> lock(warnings_mtx);
   warnings.push_back(msg);
   std::cerr << "Warning: " << msg << std::endl;
 }
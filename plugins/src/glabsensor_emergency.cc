@@ -19,6 +19,7 @@
  */
 
 #include "glabsensorplugin.h"
+#include "threadrole.h"
 #include <sys/time.h>
 #include <thread>
 
@@ -85,6 +86,7 @@ emergencybutton_t::~emergencybutton_t()
 
 void emergencybutton_t::service()
 {
+  TASCAR::register_thread(TASCAR::thread_roles_t::background);
   ltime = gettime() + startlock;
   while(run_service) {
     usleep(1000);
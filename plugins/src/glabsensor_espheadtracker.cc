@@ -19,6 +19,7 @@
  */
 
 #include "glabsensorplugin.h"
+#include "threadrole.h"
 #include <lsl_cpp.h>
 #include <mutex>
 #include <sys/time.h>
@@ -195,6 +196,7 @@ void espheadtracker_t::set_acceleration(lo_message msg, lo_arg** argv)
 
 void espheadtracker_t::service()
 {
+  TASCAR::register_thread(TASCAR::thread_roles_t::background);
   while(run_service) {
     usleep(1000);
     double ct(gettime());
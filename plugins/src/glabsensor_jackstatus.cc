@@ -20,6 +20,7 @@
 
 #include "glabsensorplugin.h"
 #include "jackclient.h"
+#include "threadrole.h"
 #include <jack/thread.h>
 #include <sys/time.h>
 #include <thread>
@@ -83,6 +84,7 @@ jackstatus_t::~jackstatus_t() throw()
 
 void jackstatus_t::service()
 {
+  TASCAR::register_thread(TASCAR::thread_roles_t::background);
   if(prio > 5) {
     struct sched_param sp;
     memset(&sp, 0, sizeof(sp));
@@ -21,6 +21,7 @@
 #include "alsamidicc.h"
 #include "errorhandling.h"
 #include "glabsensorplugin.h"
+#include "threadrole.h"
 #include <lsl_cpp.h>
 #include <thread>
 
@@ -110,6 +111,7 @@ midicc_t::~midicc_t()
 
 void midicc_t::send_service()
 {
+  TASCAR::register_thread(TASCAR::thread_roles_t::background);
   while(run_service) {
     // wait for 10 ms:
     for(uint32_t k = 0; k < 10; ++k)
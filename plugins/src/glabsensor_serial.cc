@@ -24,7 +24,10 @@
 #include <termios.h>
 #include "errorhandling.h"
 #include "serialport.h"
+#include <limits>
 #include <lsl_cpp.h>
+#include <stdlib.h>
+#include <unistd.h>
 
 using namespace TASCAR;
 
@@ -34,6 +37,7 @@ public:
   virtual ~gls_serial_t() throw();
 private:
   virtual void service();
+  void process_frame( const serial_frame_t& frame );
   std::string device;
   uint32_t baudrate;
   uint32_t charsize;
@@ -108,32 +112,44 @@ gls_serial_t::~gls_serial_t() throw()
 
 void gls_serial_t::service()
 {
-  bool b_open(false);
-  while( (!b_open) && run_service ){
+  while( run_service ){
     try{
       dev->open(device.c_str(),baud,0);
-      b_open = true;
     }
     catch( const std::exception& e ){
       add_critical( e.what() );
       sleep(1);
+      continue;
     }
+    // lines are read and time stamped on arrival by the shared
+    // dispatcher thread:
+    int fd(dev->get_fd());
+    serial_dispatcher_t::get().add(fd, serial_framer_t('\n', 1000),
+                                   [this](const serial_frame_t& frame) {
+                                     process_frame(frame);
+                                   });
+    while( run_service && serial_dispatcher_t::get().is_active(fd) )
+      usleep(100000);
+    serial_dispatcher_t::get().remove(fd);
+    dev->close();
   }
-  while( b_open && run_service ){
-    if( dev && dev->isopen() ){
-      std::stringstream resp(dev->readline(1000,'\n'));
-      for( uint32_t ch=0;ch<channels;++ch){
-        x[ch] = std::numeric_limits<float>::infinity();
-        resp >> x[ch];
-        x[ch] = (x[ch] - offset)*scale;
-      }
-      timeoutcnt = 0;
-      outlet->push_sample(x);
-      alive();
-    }
+}
+
+void gls_serial_t::process_frame( const serial_frame_t& frame )
+{
+  const char* p(frame.data.c_str());
+  for( uint32_t ch=0;ch<channels;++ch){
+    char* end(NULL);
+    double v(strtod(p, &end));
+    if( end == p )
+      x[ch] = std::numeric_limits<float>::infinity();
+    else
+      x[ch] = (v - offset)*scale;
+    p = end;
   }
-  if( b_open )
-    dev->close();
+  timeoutcnt = 0;
+  outlet->push_sample(x, frame.time);
+  alive();
 }
 
 REGISTER_SENSORPLUGIN(gls_serial_t);
@@ -25,6 +25,7 @@
 #include "glabsensorplugin.h"
 #include "linuxtrack.c"
 #include "linuxtrack.h"
+#include "threadrole.h"
 #include <algorithm>
 #include <complex>
 #include <fstream>
@@ -988,6 +989,7 @@ trackir_tracker_t::~trackir_tracker_t()
 
 void trackir_tracker_t::service()
 {
+  TASCAR::register_thread(TASCAR::thread_roles_t::background);
   int err(-1);
   while((err < 0) && run_service) {
     err = linuxtrack_init(NULL);
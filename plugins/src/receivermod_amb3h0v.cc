@@ -46,6 +46,7 @@ public:
   void configure();
   receivermod_base_t::data_t* create_state_data(double srate,
                                                 uint32_t fragsize) const;
+  bool is_memoryless() const { return true; };
 };
 
 amb3h0v_t::data_t::data_t(uint32_t chunksize)
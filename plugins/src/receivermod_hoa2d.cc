@@ -21,6 +21,7 @@
  */
 
 #include "errorhandling.h"
+#include "fft.h"
 #include "scene.h"
 #include <fftw3.h>
 #include <string.h>
@@ -60,6 +61,10 @@ public:
                                receivermod_base_t::data_t*);
   receivermod_base_t::data_t* create_state_data(double srate,
                                                 uint32_t fragsize) const;
+  bool is_memoryless() const 
+  {
+    return shape == TASCAR::fsplit_t::none;
+  };
   // initialize decoder and allocate buffers:
   virtual void configure();
   virtual void release();
@@ -190,9 +195,12 @@ void hoa2d_t::configure()
   s_encoded.clear();
   s_decoded = new float[n_fragment * n_mainchannels];
   int ichannels(n_mainchannels);
-  dec = fftwf_plan_many_dft_c2r(
-      1, &ichannels, n_fragment, (fftwf_complex*)s_encoded.b, NULL, 1, nbins,
-      s_decoded, NULL, 1, n_mainchannels, FFTW_ESTIMATE);
+  {
+    std::lock_guard<std::mutex> lock(TASCAR::fftw_planner_mutex());
+    dec = fftwf_plan_many_dft_c2r(
+        1, &ichannels, n_fragment, (fftwf_complex*)s_encoded.b, NULL, 1, nbins,
+        s_decoded, NULL, 1, n_mainchannels, FFTW_ESTIMATE);
+  }
   for(uint32_t k = 0; k < n_fragment * nbins; ++k)
     s_encoded[k] = 0.0f;
   // memset(s_encoded,0,sizeof(std::complex<float>)*n_fragment*nbins);
@@ -210,7 +218,10 @@ void hoa2d_t::configure()
 void hoa2d_t::release()
 {
   TASCAR::receivermod_base_speaker_t::release();
-  fftwf_destroy_plan(dec);
+  {
+    std::lock_guard<std::mutex> lock(TASCAR::fftw_planner_mutex());
+    fftwf_destroy_plan(dec);
+  }
   delete[] s_decoded;
 }
 
@@ -44,6 +44,7 @@ public:
   void postproc(std::vector<TASCAR::wave_t>& output);
   receivermod_base_t::data_t* create_state_data(double srate,
                                                 uint32_t fragsize) const;
+  bool is_memoryless() const { return true; };
   int32_t order;
   std::string method;
   std::string dectype;
@@ -53,16 +54,9 @@ public:
   HOA::decoder_t decode;
   std::vector<TASCAR::wave_t> amb_sig;
   double decwarnthreshold;
+  bool decoder_ready = false;
 };
 
-void hoa3d_dec_t::configure()
-{
-  DEBUG(channels);
-  DEBUG(spkpos.size());
-  TASCAR::receivermod_base_speaker_t::configure();
-  amb_sig = std::vector<TASCAR::wave_t>(channels, TASCAR::wave_t(n_fragment));
-}
-
 hoa3d_dec_t::data_t::data_t(uint32_t channels)
 {
   B = std::vector<float>(channels, 0.0f);
@@ -87,24 +81,41 @@ hoa3d_dec_t::hoa3d_dec_t(tsccfg::node_t xmlsrc)
     throw TASCAR::ErrMsg("Negative order is not possible.");
   encode.set_order(order);
   channels = (order + 1) * (order + 1);
+  HOA::decoder_t::method_t imethod(HOA::decoder_t::pinv);
   if(method == "pinv")
-    decode.create_pinv(order, spkpos.get_positions());
+    imethod = HOA::decoder_t::pinv;
   else if(method == "allrad")
-    decode.create_allrad(order, spkpos.get_positions());
+    imethod = HOA::decoder_t::allrad;
   else
     throw TASCAR::ErrMsg("Invalid decoder generation method \"" + method +
                          "\".");
+  HOA::decoder_t::modifier_t imodifier(HOA::decoder_t::basic);
   if(dectype == "basic")
-    decode.modify(HOA::decoder_t::basic);
+    imodifier = HOA::decoder_t::basic;
   else if(dectype == "maxre")
-    decode.modify(HOA::decoder_t::maxre);
+    imodifier = HOA::decoder_t::maxre;
   else if(dectype == "inphase")
-    decode.modify(HOA::decoder_t::inphase);
+    imodifier = HOA::decoder_t::inphase;
   else
     throw TASCAR::ErrMsg("Invalid decoder type \"" + dectype + "\".");
+  // the decoder matrix is computed in the background, in parallel to
+  // other receivers, or taken from the decoder cache:
+  decode.request(order, spkpos.get_positions(), imethod, imodifier);
   typeidattr.push_back("order");
   typeidattr.push_back("method");
   typeidattr.push_back("dectype");
+}
+
+void hoa3d_dec_t::configure()
+{
+  DEBUG(channels);
+  DEBUG(spkpos.size());
+  TASCAR::receivermod_base_speaker_t::configure();
+  amb_sig = std::vector<TASCAR::wave_t>(channels, TASCAR::wave_t(n_fragment));
+  if(decoder_ready)
+    return;
+  decode.wait();
+  decoder_ready = true;
   float r;
   if((r = decode.maxabs() / decode.rms()) > decwarnthreshold) {
     TASCAR::add_warning("The maximum-to-rms ratio of the decoder matrix is " +
@@ -130,6 +141,13 @@ void hoa3d_dec_t::add_pointsource(const TASCAR::pos_t& prel, double,
   data_t* state(dynamic_cast<data_t*>(sd));
   if(!state)
     throw TASCAR::ErrMsg("Invalid data type.");
+  if(state->unchanged) {
+    // encoding weights of previous call are still valid:
+    for(uint32_t t = 0; t < chunk.size(); ++t)
+      for(uint32_t index = 0; index < channels; ++index)
+        amb_sig[index][t] += state->B[index] * chunk[t];
+    return;
+  }
   float az = prel.azim();
   float el = prel.elev();
   encode(az, el, state->newB);
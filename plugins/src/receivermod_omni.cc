@@ -37,6 +37,7 @@ public:
   {
     return NULL;
   };
+  bool is_memoryless() const { return true; };
 };
 
 omni_t::omni_t(tsccfg::node_t xmlsrc) : TASCAR::receivermod_base_t(xmlsrc) {}
@@ -23,9 +23,12 @@
 #include "receivermod.h"
 
 //#include "fft.h"
+#include "diskcache.h"
 #include "fdn.h"
 #include "optim.h"
+#include <iomanip>
 #include <limits>
+#include <sstream>
 
 class simplefdn_vars_t : public TASCAR::receivermod_base_t {
 public:
@@ -55,6 +58,8 @@ public:
   TASCAR::biquadf_t lowcut_z;
   bool use_lowcut = false;
   bool truncate_forward = false;
+  bool fastfit = true;
+  bool cache = true;
 };
 
 simplefdn_vars_t::simplefdn_vars_t(tsccfg::node_t xmlsrc)
@@ -97,6 +102,10 @@ simplefdn_vars_t::simplefdn_vars_t(tsccfg::node_t xmlsrc)
         "\". Possible values are original, mean or schroeder.");
   GET_ATTRIBUTE(lowcut, "Hz", "low cut off frequency, or zero for no low cut");
   GET_ATTRIBUTE_BOOL(truncate_forward, "Truncate delays of feed forward path");
+  GET_ATTRIBUTE_BOOL(fastfit, "Use analytic T60 estimate in T60 optimization, "
+                              "verify with impulse response");
+  GET_ATTRIBUTE_BOOL(cache, "Store results of T60 optimization in cache "
+                            "directory and re-use them");
 }
 
 simplefdn_vars_t::~simplefdn_vars_t() {}
@@ -144,8 +153,18 @@ public:
      @retval t60 T60 in seconds
   */
   void get_t60(const std::vector<float>& cf, std::vector<float>& t60);
+  /**
+     @brief Get analytic estimate of T60 at octave bands, with correction
+     factors from last impulse response measurement
+     @param cf list of center frequencies in Hz
+     @retval t60 T60 in seconds
+  */
+  void get_t60_estimate(const std::vector<float>& cf, std::vector<float>& t60);
   float t60err(const std::vector<float>& param);
   float slopeerr(const std::vector<float>& param);
+  void optim_t60();
+  void fit_t60();
+  std::string get_cache_key() const;
 
 private:
   TASCAR::fdn_t* feedback_delay_network = NULL;
@@ -157,6 +176,10 @@ private:
   float distcorr = 1.0f;
   TASCAR::wave_t* ir_bb = NULL;
   TASCAR::wave_t* ir_band = NULL;
+  // use analytic T60 estimate in optimization:
+  bool use_estimate = false;
+  // ratio between measured and estimated T60:
+  std::vector<float> t60corr;
 };
 
 int simplefdn_t::osc_fixcirculantmat(const char*, const char* types,
@@ -213,7 +236,10 @@ float simplefdn_t::t60err(const std::vector<float>& param)
   t60 = 0.0f;
   update_par();
   std::vector<float> xt60;
-  get_t60(vcf, xt60);
+  if(use_estimate)
+    get_t60_estimate(vcf, xt60);
+  else
+    get_t60(vcf, xt60);
   float t60max = 0.0f;
   float t60max_ref = 0.0f;
   for(size_t k = 0; k < std::min(xt60.size(), vt60.size()); ++k) {
@@ -232,7 +258,10 @@ float simplefdn_t::slopeerr(const std::vector<float>& param)
   damping = std::max(0.0f, std::min(0.999f, param[0]));
   update_par();
   std::vector<float> xt60;
-  get_t60(vcf, xt60);
+  if(use_estimate)
+    get_t60_estimate(vcf, xt60);
+  else
+    get_t60(vcf, xt60);
   float slope = 0.0f;
   for(size_t k = 1; k < std::min(xt60.size(), vt60.size()); ++k)
     slope += (xt60[k] - xt60[0]) / (logf(vcf[k]) - logf(vcf[0]));
@@ -288,41 +317,27 @@ void simplefdn_t::configure()
   ir_bb = new TASCAR::wave_t((uint32_t)irlen);
   ir_band = new TASCAR::wave_t((uint32_t)irlen);
   if(vcf.size() > 0) {
-    // optimize damping and absorption to match given T60
-    // first optimize absorption
-    t60 = 0.0f;
-    damping = 0.2f;
-    absorption =
-        0.161f * volumetric.boxvolumef() / (vt60[0] * volumetric.boxareaf());
-    float eps = 1.0f;
-    float lasterr = 10000.0f;
-    std::vector<float> param = {absorption};
-    for(size_t it = 0; it < numiter; ++it) {
-      float err = downhill_iterate(eps, param, t60err_, this, {1e-3f});
-      param[0] = fabs(param[0]);
-      if((err < 0.00005) || (fabsf(lasterr / err - 1.0f) < 1e-9f))
-        it = numiter;
-      lasterr = err;
-    }
-    absorption = fabsf(param[0]);
-    param = {(float)damping};
-    lasterr = 10000.0f;
-    for(size_t it = 0; it < numiter; ++it) {
-      float err = downhill_iterate(eps, param, slopeerr_, this, {2e-3f});
-      param[0] = std::min(0.99f, fabs(param[0]));
-      if(err > 4.0f * lasterr)
-        eps *= 0.5f;
-      if((err < 0.00005f) || (fabsf(lasterr / err - 1.0f) < 1e-9f))
-        it = numiter;
-      lasterr = err;
+    // optimize damping and absorption to match given T60, or take
+    // them from cache:
+    TASCAR::diskcache_t dcache("simplefdn");
+    std::string key(get_cache_key());
+    std::vector<float> cached;
+    bool from_cache(cache && dcache.read(key, cached) && (cached.size() == 2));
+    if(from_cache) {
+      absorption = cached[0];
+      damping = cached[1];
+    } else {
+      fit_t60();
+      if(cache)
+        dcache.write(key, {absorption, (float)damping});
     }
-    damping = param[0];
     t60 = 0.0f;
     update_par();
     std::vector<float> xt60;
     get_t60(vcf, xt60);
-    std::cout << "Optimization of T60:\n  absorption=\"" << absorption
-              << "\" damping=\"" << damping << "\" t60=\"0\"\n";
+    std::cout << "Optimization of T60" << (from_cache ? " (cached)" : "")
+              << ":\n  absorption=\"" << absorption << "\" damping=\""
+              << damping << "\" t60=\"0\"\n";
     for(size_t k = 0; k < vcf.size(); ++k) {
       std::cout << "  " << vcf[k] << " Hz: " << xt60[k] << " s\n";
     }
@@ -332,6 +347,101 @@ void simplefdn_t::configure()
   update_par();
 }
 
+/**
+   @brief Optimize absorption and damping to match T60 at given
+   frequencies
+ */
+void simplefdn_t::optim_t60()
+{
+  // first optimize absorption
+  t60 = 0.0f;
+  damping = 0.2f;
+  absorption =
+      0.161f * volumetric.boxvolumef() / (vt60[0] * volumetric.boxareaf());
+  float eps = 1.0f;
+  float lasterr = 10000.0f;
+  std::vector<float> param = {absorption};
+  for(size_t it = 0; it < numiter; ++it) {
+    float err = downhill_iterate(eps, param, t60err_, this, {1e-3f});
+    param[0] = fabs(param[0]);
+    if((err < 0.00005) || (fabsf(lasterr / err - 1.0f) < 1e-9f))
+      it = numiter;
+    lasterr = err;
+  }
+  absorption = fabsf(param[0]);
+  param = {(float)damping};
+  lasterr = 10000.0f;
+  for(size_t it = 0; it < numiter; ++it) {
+    float err = downhill_iterate(eps, param, slopeerr_, this, {2e-3f});
+    param[0] = std::min(0.99f, fabs(param[0]));
+    if(err > 4.0f * lasterr)
+      eps *= 0.5f;
+    if((err < 0.00005f) || (fabsf(lasterr / err - 1.0f) < 1e-9f))
+      it = numiter;
+    lasterr = err;
+  }
+  damping = param[0];
+}
+
+/**
+   @brief Fit absorption and damping to target T60
+
+   With fastfit, the optimization uses the analytic T60 estimate of
+   the FDN. The result is verified with a measurement of the impulse
+   response, and the ratio between measured and estimated T60 is used
+   to correct the estimate in further optimization passes.
+ */
+void simplefdn_t::fit_t60()
+{
+  if(!fastfit) {
+    optim_t60();
+    return;
+  }
+  t60corr = std::vector<float>(vcf.size(), 1.0f);
+  use_estimate = true;
+  for(uint32_t pass = 0; pass < 4; ++pass) {
+    optim_t60();
+    t60 = 0.0f;
+    update_par();
+    std::vector<float> xt60;
+    std::vector<float> est;
+    get_t60(vcf, xt60);
+    get_t60_estimate(vcf, est);
+    bool converged(true);
+    for(size_t k = 0; k < std::min(xt60.size(), est.size()); ++k)
+      if((xt60[k] > 0.0f) && (est[k] > 0.0f)) {
+        float ratio(xt60[k] / est[k]);
+        if(fabsf(ratio - 1.0f) > 0.02f)
+          converged = false;
+        t60corr[k] *= ratio;
+      }
+    if(converged)
+      break;
+  }
+  use_estimate = false;
+}
+
+std::string simplefdn_t::get_cache_key() const
+{
+  std::stringstream key;
+  // increment the format version whenever the fit or the stored values
+  // change:
+  key << std::setprecision(9) << "simplefdn v2 fs=" << f_sample << " c=" << c
+      << " dim=" << volumetric.x << "," << volumetric.y << "," << volumetric.z
+      << " fdnorder=" << fdnorder << " forwardstages=" << forwardstages
+      << " logdelays=" << logdelays << " gainmethod=" << (int)gm
+      << " prefilt=" << prefilt << " fixcirculantmat=" << fixcirculantmat
+      << " truncate_forward=" << truncate_forward << " w=" << w
+      << " dw=" << dw << " numiter=" << numiter << " fastfit=" << fastfit
+      << " lowcut=" << lowcut << " vcf=";
+  for(auto f : vcf)
+    key << f << ",";
+  key << " vt60=";
+  for(auto t : vt60)
+    key << t << ",";
+  return key.str();
+}
+
 void simplefdn_t::release()
 {
   TASCAR::receivermod_base_t::release();
@@ -527,6 +637,20 @@ void simplefdn_t::get_t60(const std::vector<float>& cf, std::vector<float>& t60)
   }
 }
 
+void simplefdn_t::get_t60_estimate(const std::vector<float>& cf,
+                                   std::vector<float>& t60)
+{
+  t60.clear();
+  if(feedback_delay_network)
+    for(size_t k = 0; k < cf.size(); ++k) {
+      float t(feedback_delay_network->get_t60_estimate(cf[k], (float)f_sample,
+                                                       1.0f));
+      if(k < t60corr.size())
+        t *= t60corr[k];
+      t60.push_back(t);
+    }
+}
+
 void simplefdn_t::get_ir(TASCAR::wave_t& ir)
 {
   if(feedback_delay_network) {
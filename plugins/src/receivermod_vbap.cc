@@ -67,6 +67,7 @@ public:
                        receivermod_base_t::data_t*);
   receivermod_base_t::data_t* create_state_data(double srate,
                                                 uint32_t fragsize) const;
+  bool is_memoryless() const { return true; };
   std::vector<simplex_t> simplices;
 };
 
@@ -21,15 +21,7 @@
 
 #include "audioplugin.h"
 #include "errorhandling.h"
-#include "filterclass.h"
-#include <atomic>
-#include <chrono>
-#include <condition_variable>
-#include <lo/lo.h>
-#include <mutex>
-#include <thread>
-
-using namespace std::chrono_literals;
+#include "osc_sender.h"
 
 enum levelmode_t { dbspl, rms, max };
 
@@ -40,6 +32,7 @@ public:
                   const TASCAR::zyx_euler_t&, const TASCAR::transport_t& tp);
   void configure();
   void release();
+  bool modifies_audio() const { return false; };
   ~level2osc_t();
 
 private:
@@ -52,19 +45,10 @@ private:
   float bandwidth = 1; // in octaves
   // derived variables:
   levelmode_t imode = dbspl;
-  lo_address lo_addr;
   uint32_t skipcnt = 0;
-  lo_message msg;
-  lo_arg** oscmsgargv;
-  std::thread thread;
-  std::atomic_bool run_thread = true;
-  void sendthread();
-  std::mutex mtx;
-  std::condition_variable cond;
-  std::atomic_bool has_data = false;
-  std::vector<TASCAR::wave_t> filterbankout;
-  std::vector<TASCAR::bandpass_t> bp1;
-  std::vector<TASCAR::bandpass_t> bp2;
+  TASCAR::osc_sender_t::message_t* msg = NULL;
+  // handles of band-pass filtered signals in analysis service:
+  std::vector<size_t> bands;
   size_t n_bands;
 };
 
@@ -75,7 +59,8 @@ level2osc_t::level2osc_t(const TASCAR::audioplugin_cfg_t& cfg)
   GET_ATTRIBUTE(skip, "", "Skip frames");
   GET_ATTRIBUTE(url, "", "Target URL");
   GET_ATTRIBUTE(path, "", "Target path");
-  GET_ATTRIBUTE_BOOL(threaded, "Use additional thread for sending data");
+  GET_ATTRIBUTE_BOOL(threaded, "Unused, data is always sent by the OSC "
+                               "sender thread");
   std::string mode("dbspl");
   GET_ATTRIBUTE(mode, "", "Level mode [dbspl|rms|max]");
   if(mode == "dbspl")
@@ -93,61 +78,32 @@ level2osc_t::level2osc_t(const TASCAR::audioplugin_cfg_t& cfg)
   GET_ATTRIBUTE(bandwidth, "octaves", "band width");
   if(!(bandwidth > 0.0f))
     throw TASCAR::ErrMsg("Invalid bandwidth, needs to be a positive number.");
-  lo_addr = lo_address_new_from_url(url.c_str());
-  if(threaded)
-    thread = std::thread(&level2osc_t::sendthread, this);
-}
-
-void level2osc_t::sendthread()
-{
-  std::unique_lock<std::mutex> lk(mtx);
-  while(run_thread) {
-    cond.wait_for(lk, 100ms);
-    if(has_data) {
-      lo_send_message(lo_addr, path.c_str(), msg);
-      has_data = false;
-    }
-  }
 }
 
 void level2osc_t::configure()
 {
   audioplugin_base_t::configure();
-  msg = lo_message_new();
-  // time:
-  lo_message_add_float(msg, 0);
-  // levels:
-  for(uint32_t k = 0; k < n_channels * n_bands; ++k)
-    lo_message_add_float(msg, 0);
-  oscmsgargv = lo_message_get_argv(msg);
-  filterbankout.resize(n_channels * n_bands);
-  for(auto& w : filterbankout)
-    w.resize(n_fragment);
-  bp1.resize(n_channels * n_bands);
-  bp2.resize(n_channels * n_bands);
+  // time and levels:
+  msg = TASCAR::osc_sender_t::get().add_message(
+      url, path, std::string(n_channels * n_bands + 1u, 'f'));
+  bands.resize(n_channels * n_bands);
   float f_inc = pow(2.0, 0.5 * bandwidth);
   for(size_t k = 0; k < n_bands; ++k) {
     float fc = f[k];
-    for(size_t c = 0; c < n_channels; ++c) {
-      bp1[k + n_bands * c].set_range(fc / f_inc, fc * f_inc, f_sample);
-      bp2[k + n_bands * c].set_range(fc / f_inc, fc * f_inc, f_sample);
-    }
+    for(size_t c = 0; c < n_channels; ++c)
+      bands[k + n_bands * c] = get_analysis_service().subscribe_band(
+          c, fc / f_inc, fc * f_inc, 2);
   }
 }
 
 void level2osc_t::release()
 {
-  lo_message_free(msg);
+  TASCAR::osc_sender_t::get().remove_message(msg);
+  msg = NULL;
   audioplugin_base_t::release();
 }
 
-level2osc_t::~level2osc_t()
-{
-  run_thread = false;
-  if(threaded)
-    thread.join();
-  lo_address_free(lo_addr);
-}
+level2osc_t::~level2osc_t() {}
 
 void level2osc_t::ap_process(std::vector<TASCAR::wave_t>& chunk,
                              const TASCAR::pos_t&, const TASCAR::zyx_euler_t&,
@@ -158,42 +114,27 @@ void level2osc_t::ap_process(std::vector<TASCAR::wave_t>& chunk,
         "Programming error (invalid channel number, expected " +
         TASCAR::to_string(n_channels) + ", got " +
         std::to_string(chunk.size()) + ").");
-  // update filters:
-  for(size_t k = 0; k < n_bands; ++k) {
-    for(size_t c = 0; c < n_channels; ++c) {
-      filterbankout[k + n_bands * c].copy(chunk[c]);
-      bp1[k + n_bands * c].filter(filterbankout[k + n_bands * c]);
-      bp2[k + n_bands * c].filter(filterbankout[k + n_bands * c]);
-    }
-  }
+  const TASCAR::analysis_service_t& analysis(get_analysis_service());
   if(tp.rolling || sendwhilestopped) {
     if(skipcnt) {
       skipcnt--;
     } else {
-      // data will be sent in extra thread:
-      if(mtx.try_lock()) {
-        // pack data:
-        oscmsgargv[0]->f = tp.object_time_seconds;
-        for(uint32_t ch = 0; ch < n_channels * n_bands; ++ch) {
-          switch(imode) {
-          case dbspl:
-            oscmsgargv[ch + 1]->f = filterbankout[ch].spldb();
-            break;
-          case rms:
-            oscmsgargv[ch + 1]->f = filterbankout[ch].rms();
-            break;
-          case max:
-            oscmsgargv[ch + 1]->f = filterbankout[ch].maxabs();
-            break;
-          }
+      msg->set_float(0, tp.object_time_seconds);
+      for(uint32_t ch = 0; ch < n_channels * n_bands; ++ch) {
+        switch(imode) {
+        case dbspl:
+          msg->set_float(ch + 1, analysis.get_band(bands[ch]).spldb());
+          break;
+        case rms:
+          msg->set_float(ch + 1, analysis.get_band(bands[ch]).rms());
+          break;
+        case max:
+          msg->set_float(ch + 1, analysis.get_band(bands[ch]).maxabs());
+          break;
         }
-        has_data = true;
-        mtx.unlock();
-        if(threaded)
-          cond.notify_one();
-        else
-          lo_send_message(lo_addr, path.c_str(), msg);
       }
+      // data will be sent by the OSC sender thread:
+      msg->post();
       skipcnt = skip;
     }
   }
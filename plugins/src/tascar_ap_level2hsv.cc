@@ -20,6 +20,7 @@
 #include "audioplugin.h"
 #include "errorhandling.h"
 #include "levelmeter.h"
+#include "threadrole.h"
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
@@ -130,6 +131,7 @@ void level2hsv_t::add_variables(TASCAR::osc_server_t* srv)
 
 void level2hsv_t::sendthread()
 {
+  TASCAR::register_thread(TASCAR::thread_roles_t::network);
   std::unique_lock<std::mutex> lk(mtx);
   while(run_thread) {
     cond.wait_for(lk, 100ms);
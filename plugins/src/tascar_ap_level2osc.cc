@@ -23,14 +23,7 @@
 #include "audioplugin.h"
 #include "errorhandling.h"
 #include "levelmeter.h"
-#include <atomic>
-#include <chrono>
-#include <condition_variable>
-#include <lo/lo.h>
-#include <mutex>
-#include <thread>
-
-using namespace std::chrono_literals;
+#include "osc_sender.h"
 
 enum levelmode_t { dbspl, rms, max };
 
@@ -42,6 +35,7 @@ public:
   void add_variables(TASCAR::osc_server_t* srv);
   void configure();
   void release();
+  bool modifies_audio() const { return false; };
   ~level2osc_t();
 
 private:
@@ -55,28 +49,15 @@ private:
   std::string path = "/level";
   // derived variables:
   levelmode_t imode = dbspl;
-  lo_address lo_addr;
   uint32_t skipcnt = 0;
-  lo_message msg;
-  lo_arg** oscmsgargv;
-  std::thread thread;
-  std::atomic_bool run_thread;
-  std::atomic_bool is_prepared;
-  void sendthread();
-  std::mutex mtx;
-  std::mutex mtxmsg;
-  std::condition_variable cond;
-  std::atomic_bool has_data = false;
+  TASCAR::osc_sender_t::message_t* msg = NULL;
   std::vector<TASCAR::levelmeter_t> sigcopy;
-  double currenttime = 0;
   double firstpar = -1;
 };
 
 level2osc_t::level2osc_t(const TASCAR::audioplugin_cfg_t& cfg)
     : audioplugin_base_t(cfg)
 {
-  run_thread = true;
-  is_prepared = false;
   weights.push_back(TASCAR::levelmeter::Z);
   GET_ATTRIBUTE_BOOL(sendwhilestopped, "Send also when transport is stopped");
   GET_ATTRIBUTE(skip, "", "Skip frames");
@@ -89,7 +70,8 @@ level2osc_t::level2osc_t(const TASCAR::audioplugin_cfg_t& cfg)
         "Frequency range requires exactly two entries (min max)");
   GET_ATTRIBUTE(url, "", "Target URL");
   GET_ATTRIBUTE(path, "", "Target path");
-  GET_ATTRIBUTE_BOOL(threaded, "Use additional thread for sending data");
+  GET_ATTRIBUTE_BOOL(threaded, "Unused, data is always sent by the OSC "
+                               "sender thread");
   GET_ATTRIBUTE(tau, "s", "Leq duration, or 0 to use block size");
   GET_ATTRIBUTE(firstpar, "",
                 "First parameter, or -1 to use current session time.");
@@ -103,9 +85,6 @@ level2osc_t::level2osc_t(const TASCAR::audioplugin_cfg_t& cfg)
     imode = max;
   else
     throw TASCAR::ErrMsg("Invalid level mode: " + mode);
-  lo_addr = lo_address_new_from_url(url.c_str());
-  if(threaded)
-    thread = std::thread(&level2osc_t::sendthread, this);
 }
 
 void level2osc_t::add_variables(TASCAR::osc_server_t* srv)
@@ -116,79 +95,33 @@ void level2osc_t::add_variables(TASCAR::osc_server_t* srv)
   srv->unset_variable_owner();
 }
 
-void level2osc_t::sendthread()
-{
-  std::unique_lock<std::mutex> lk(mtx);
-  while(run_thread) {
-    cond.wait_for(lk, 100ms);
-    if(has_data) {
-      std::lock_guard<std::mutex> lock(mtxmsg);
-      if(is_prepared) {
-        // pack data:
-        if(firstpar == -1)
-          oscmsgargv[0]->f = currenttime;
-        else
-          oscmsgargv[0]->f = firstpar;
-        for(size_t ch = 0; ch < sigcopy.size(); ++ch) {
-          switch(imode) {
-          case dbspl:
-            oscmsgargv[ch + 1]->f = sigcopy[ch].spldb();
-            break;
-          case rms:
-            oscmsgargv[ch + 1]->f = sigcopy[ch].rms();
-            break;
-          case max:
-            oscmsgargv[ch + 1]->f = sigcopy[ch].maxabs();
-            break;
-          }
-        }
-        lo_send_message(lo_addr, path.c_str(), msg);
-      }
-      has_data = false;
-    }
-  }
-}
-
 void level2osc_t::configure()
 {
   audioplugin_base_t::configure();
-  std::lock_guard<std::mutex> lock(mtxmsg);
   sigcopy.clear();
-  msg = lo_message_new();
-  // time:
-  lo_message_add_float(msg, 0);
   float tau_ = tau;
   if(tau_ == 0)
     tau_ = t_fragment;
-  // levels:
   for(size_t kweight = 0; kweight < weights.size(); ++kweight)
     for(uint32_t k = 0; k < n_channels; ++k) {
-      lo_message_add_float(msg, 0);
       sigcopy.push_back(TASCAR::levelmeter_t(f_sample, tau_, weights[kweight]));
-      // sigcopy.back().set_weight(weights[kweight]);
       if(weights[kweight] == TASCAR::levelmeter::bandpass)
         sigcopy.back().bp.set_range(frange[0], frange[1]);
     }
-  oscmsgargv = lo_message_get_argv(msg);
-  is_prepared = true;
+  // time and levels:
+  msg = TASCAR::osc_sender_t::get().add_message(
+      url, path, std::string(sigcopy.size() + 1u, 'f'));
 }
 
 void level2osc_t::release()
 {
-  std::lock_guard<std::mutex> lock(mtxmsg);
-  is_prepared = false;
-  lo_message_free(msg);
+  TASCAR::osc_sender_t::get().remove_message(msg);
+  msg = NULL;
   sigcopy.clear();
   audioplugin_base_t::release();
 }
 
-level2osc_t::~level2osc_t()
-{
-  run_thread = false;
-  if(threaded)
-    thread.join();
-  lo_address_free(lo_addr);
-}
+level2osc_t::~level2osc_t() {}
 
 void level2osc_t::ap_process(std::vector<TASCAR::wave_t>& chunk,
                              const TASCAR::pos_t&, const TASCAR::zyx_euler_t&,
@@ -206,16 +139,25 @@ void level2osc_t::ap_process(std::vector<TASCAR::wave_t>& chunk,
     if(skipcnt) {
       skipcnt--;
     } else {
-      // data will be sent in extra thread:
-      if(mtx.try_lock()) {
-        currenttime = tp.object_time_seconds;
-        has_data = true;
-        mtx.unlock();
-        if(threaded)
-          cond.notify_one();
-        else
-          lo_send_message(lo_addr, path.c_str(), msg);
+      if(firstpar == -1)
+        msg->set_float(0, tp.object_time_seconds);
+      else
+        msg->set_float(0, firstpar);
+      for(size_t ch = 0; ch < sigcopy.size(); ++ch) {
+        switch(imode) {
+        case dbspl:
+          msg->set_float(ch + 1, sigcopy[ch].spldb());
+          break;
+        case rms:
+          msg->set_float(ch + 1, sigcopy[ch].rms());
+          break;
+        case max:
+          msg->set_float(ch + 1, sigcopy[ch].maxabs());
+          break;
+        }
       }
+      // data will be sent by the OSC sender thread:
+      msg->post();
       skipcnt = skip;
     }
   }
@@ -28,6 +28,7 @@
 #include "audioplugin.h"
 #include "errorhandling.h"
 #include "stft.h"
+#include "threadrole.h"
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
@@ -46,6 +47,7 @@ public:
   void configure();
   void release();
   void add_variables(TASCAR::osc_server_t* srv);
+  bool modifies_audio() const { return false; };
   ~lipsync_t();
 
 private:
@@ -62,7 +64,7 @@ private:
   // internal variables:
   lo_address lo_addr;
   std::string path_;
-  TASCAR::stft_t* stft = NULL;
+  const TASCAR::stft_t* stft = NULL;
   double* sSmoothedMag = NULL;
   double* sLogMag = NULL;
   uint32_t* formantEdges = NULL;
@@ -177,6 +179,7 @@ lipsync_t::lipsync_t(const TASCAR::audioplugin_cfg_t& cfg)
 
 void lipsync_t::sendthread()
 {
+  TASCAR::register_thread(TASCAR::thread_roles_t::network);
   std::unique_lock<std::mutex> lk(mtx);
   while(run_thread) {
     cond.wait_for(lk, 100ms);
@@ -207,9 +210,10 @@ void lipsync_t::add_variables(TASCAR::osc_server_t* srv)
 void lipsync_t::configure()
 {
   audioplugin_base_t::configure();
-  // allocate FFT buffers:
-  stft = new TASCAR::stft_t(2 * n_fragment, 2 * n_fragment, n_fragment,
-                            TASCAR::stft_t::WND_BLACKMAN, 0);
+  // FFT buffers are shared with other analysis plugins:
+  TASCAR::analysis_service_t& analysis(get_analysis_service());
+  stft = &analysis.get_stft(analysis.subscribe_stft(
+      0, 2 * n_fragment, 2 * n_fragment, TASCAR::stft_t::WND_BLACKMAN, 0));
   uint32_t num_bins(stft->s.n_);
   // allocate buffer for processed smoothed log values:
   sSmoothedMag = new double[num_bins];
@@ -234,7 +238,7 @@ void lipsync_t::configure()
 void lipsync_t::release()
 {
   audioplugin_base_t::release();
-  delete stft;
+  stft = NULL;
   delete[] sSmoothedMag;
   delete[] sLogMag;
 }
@@ -261,7 +265,6 @@ void lipsync_t::ap_process(std::vector<TASCAR::wave_t>& chunk,
   // Conversion to dB
   if(!chunk.size())
     return;
-  stft->process(chunk[0]);
   double vmin(1e20);
   double vmax(-1e20);
   uint32_t num_bins(stft->s.n_);
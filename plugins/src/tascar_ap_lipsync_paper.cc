@@ -28,6 +28,7 @@
 #include "audioplugin.h"
 #include "errorhandling.h"
 #include "stft.h"
+#include "threadrole.h"
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
@@ -177,6 +178,7 @@ lipsync_t::lipsync_t(const TASCAR::audioplugin_cfg_t& cfg)
 
 void lipsync_t::sendthread()
 {
+  TASCAR::register_thread(TASCAR::thread_roles_t::network);
   std::unique_lock<std::mutex> lk(mtx);
   while(run_thread) {
     cond.wait_for(lk, 100ms);
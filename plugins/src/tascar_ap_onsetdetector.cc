@@ -21,7 +21,7 @@
  */
 
 #include "audioplugin.h"
-#include <lo/lo.h>
+#include "osc_sender.h"
 
 class onsetdetector_t : public TASCAR::audioplugin_base_t {
 public:
@@ -29,10 +29,11 @@ public:
   void ap_process(std::vector<TASCAR::wave_t>& chunk, const TASCAR::pos_t& pos,
                   const TASCAR::zyx_euler_t&, const TASCAR::transport_t& tp);
   void configure();
+  bool modifies_audio() const { return false; };
   ~onsetdetector_t();
 
 private:
-  lo_address lo_addr;
+  TASCAR::osc_sender_t::message_t* msg = NULL;
   double tau;
   double taumin;
   double threshold;
@@ -66,7 +67,9 @@ onsetdetector_t::onsetdetector_t(const TASCAR::audioplugin_cfg_t& cfg)
   GET_ATTRIBUTE(path, "", "Destination OSC path");
   if(url.empty())
     url = "osc.udp://localhost:9999/";
-  lo_addr = lo_address_new_from_url(url.c_str());
+  // onsets are events, do not coalesce:
+  msg = TASCAR::osc_sender_t::get().add_message(url, path, "ssffff", false);
+  msg->set_string(0, "/hitAt");
 }
 
 void onsetdetector_t::configure()
@@ -78,7 +81,7 @@ void onsetdetector_t::configure()
 
 onsetdetector_t::~onsetdetector_t()
 {
-  lo_address_free(lo_addr);
+  TASCAR::osc_sender_t::get().remove_message(msg);
 }
 
 void onsetdetector_t::ap_process(std::vector<TASCAR::wave_t>& chunk,
@@ -111,8 +114,12 @@ void onsetdetector_t::ap_process(std::vector<TASCAR::wave_t>& chunk,
           b_autoside = true;
         }
       }
-      lo_send(lo_addr, path.c_str(), "ssffff", "/hitAt", this_side, pos.x,
-              pos.y, pos.z, sqrt(ons));
+      msg->set_string(1, this_side);
+      msg->set_float(2, pos.x);
+      msg->set_float(3, pos.y);
+      msg->set_float(4, pos.z);
+      msg->set_float(5, sqrt(ons));
+      msg->post();
       time_since_last = 0;
     }
   }
@@ -22,7 +22,6 @@
 #include "audioplugin.h"
 #include "delayline.h"
 #include "errorhandling.h"
-#include "filterclass.h"
 #include <lsl_cpp.h>
 
 class periodogram_t : public TASCAR::audioplugin_base_t {
@@ -33,6 +32,7 @@ public:
   void configure();
   void release();
   void add_variables(TASCAR::osc_server_t* srv);
+  bool modifies_audio() const { return false; };
   ~periodogram_t();
 
 private:
@@ -49,7 +49,7 @@ private:
   uint32_t nbands;
   uint32_t nperiods;
   //
-  std::vector<TASCAR::bandpass_t*> bp;
+  std::vector<size_t> bands;
   std::vector<TASCAR::static_delay_t> delays;
   std::vector<double> out;
   std::vector<double> out_send;
@@ -94,12 +94,10 @@ void periodogram_t::configure()
   for(auto it = periods.begin(); it != periods.end(); ++it)
     for(uint32_t band = 0; band < nbands; ++band)
       delays.emplace_back(*it * f_sample);
-  for(auto it = bp.begin(); it != bp.end(); ++it)
-    delete *it;
-  bp.clear();
-  for(uint32_t ch = 0; ch < nbands; ++ch) {
-    bp.push_back(new TASCAR::bandpass_t(fmin[ch], fmax[ch], f_sample));
-  }
+  bands.clear();
+  for(uint32_t ch = 0; ch < nbands; ++ch)
+    bands.push_back(
+        get_analysis_service().subscribe_band(0, fmin[ch], fmax[ch]));
   out = std::vector<double>(nperiods * nbands, 0.0f);
   env = std::vector<double>(nbands, 0.0f);
   out_send = std::vector<double>(nperiods * nbands, 0.0f);
@@ -109,9 +107,7 @@ void periodogram_t::configure()
 
 void periodogram_t::release()
 {
-  for(auto it = bp.begin(); it != bp.end(); ++it)
-    delete *it;
-  bp.clear();
+  bands.clear();
   delete lsl_outlet;
 }
 
@@ -124,9 +120,11 @@ void periodogram_t::ap_process(std::vector<TASCAR::wave_t>& chunk,
   uint32_t N(chunk[0].size());
   lpc1 = exp(-1.0 / (tau * f_sample));
   lpc11 = 1.0 - lpc1;
+  const TASCAR::analysis_service_t& analysis(get_analysis_service());
   for(uint32_t band = 0; band < nbands; ++band) {
+    const TASCAR::wave_t& bandsig(analysis.get_band(bands[band]));
     for(uint32_t k = 0; k < N; ++k) {
-      float v2(bp[band]->filter(chunk[0][k]));
+      float v2(bandsig[k]);
       if(envelope) {
         v2 *= v2;
         env[band] = lpc1 * env[band] + lpc11 * v2;
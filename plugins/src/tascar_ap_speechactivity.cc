@@ -21,7 +21,7 @@
 
 #include "audioplugin.h"
 #include "errorhandling.h"
-#include <lo/lo.h>
+#include "osc_sender.h"
 #include <lsl_cpp.h>
 
 class speechactivity_t : public TASCAR::audioplugin_base_t {
@@ -31,10 +31,11 @@ public:
                   const TASCAR::zyx_euler_t&, const TASCAR::transport_t& tp);
   void configure();
   void release();
+  bool modifies_audio() const { return false; };
   ~speechactivity_t();
 
 private:
-  lo_address lo_addr;
+  std::vector<TASCAR::osc_sender_t::message_t*> msgs;
   lsl::stream_outlet* lsl_outlet;
   double tauenv;
   double tauonset;
@@ -48,6 +49,7 @@ private:
   std::vector<double> dactive;
   std::vector<int32_t> onset;
   std::vector<int32_t> oldonset;
+  std::vector<size_t> levels;
 };
 
 speechactivity_t::speechactivity_t(const TASCAR::audioplugin_cfg_t& cfg)
@@ -68,7 +70,10 @@ speechactivity_t::speechactivity_t(const TASCAR::audioplugin_cfg_t& cfg)
 void speechactivity_t::configure()
 {
   audioplugin_base_t::configure();
-  lo_addr = lo_address_new_from_url(url.c_str());
+  msgs.clear();
+  for(uint32_t ch = 0; ch < n_channels; ++ch)
+    msgs.push_back(TASCAR::osc_sender_t::get().add_message(
+        url, path + std::to_string(ch), "i", !transitionsonly));
   lsl_outlet = new lsl::stream_outlet(
       lsl::stream_info(get_fullname(), "level", n_channels, f_fragment,
                        lsl::cf_int32, tsccfg::node_get_path(e)));
@@ -78,13 +83,18 @@ void speechactivity_t::configure()
   dactive = std::vector<double>(n_channels, 0);
   onset = std::vector<int32_t>(n_channels, 0);
   oldonset = std::vector<int32_t>(n_channels, 0);
+  levels.clear();
+  for(uint32_t ch = 0; ch < n_channels; ++ch)
+    levels.push_back(get_analysis_service().subscribe_level(ch));
 }
 
 void speechactivity_t::release()
 {
   audioplugin_base_t::release();
   delete lsl_outlet;
-  lo_address_free(lo_addr);
+  for(auto msg : msgs)
+    TASCAR::osc_sender_t::get().remove_message(msg);
+  msgs.clear();
 }
 
 speechactivity_t::~speechactivity_t() {}
@@ -98,10 +108,12 @@ void speechactivity_t::ap_process(std::vector<TASCAR::wave_t>& chunk,
   const double lpc1(exp(-TASCAR_2PI / (tauenv * f_fragment)));
   const double lpc2(pow(2.0, -1.0 / (tauonset * f_fragment)));
   const float v2threshold(threshold * threshold);
+  const TASCAR::analysis_service_t& analysis(get_analysis_service());
   bool transition(false);
   for(uint32_t ch = 0; ch < chunk.size(); ++ch) {
     // first get signal intensity:
-    intensity[ch] = (1.0 - lpc1) * chunk[ch].ms() + lpc1 * intensity[ch];
+    intensity[ch] =
+        (1.0 - lpc1) * analysis.get_ms(levels[ch]) + lpc1 * intensity[ch];
     // speech activity is given if the intensity is above the given
     // threshold:
     active[ch] = (intensity[ch] > v2threshold);
@@ -116,10 +128,8 @@ void speechactivity_t::ap_process(std::vector<TASCAR::wave_t>& chunk,
   }
   if((!transitionsonly) || transition) {
     for(uint32_t ch = 0; ch < chunk.size(); ++ch) {
-      char ctmp[1024];
-      ctmp[1023] = 0;
-      snprintf(ctmp, 1023, "%s%d", path.c_str(), ch);
-      lo_send(lo_addr, ctmp, "i", onset[ch]);
+      msgs[ch]->set_int(0, onset[ch]);
+      msgs[ch]->post();
     }
     lsl_outlet->push_sample(onset);
   }
@@ -28,6 +28,7 @@
 
 #include "datalogging_glade.h"
 #include "session.h"
+#include "threadrole.h"
 #include <cmath>
 #include <fstream>
 #include <gtkmm.h>
@@ -1212,6 +1213,7 @@ void datalogging_t::release()
 #ifdef HAS_LSL
 void lslvar_t::poll_lsl_data()
 {
+  TASCAR::register_thread(TASCAR::thread_roles_t::network);
   while(run_lsl_poll_service) {
     poll_data();
     std::this_thread::sleep_for(std::chrono::microseconds(1000));
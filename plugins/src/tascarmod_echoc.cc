@@ -22,6 +22,7 @@
 #include "mutex"
 #include "ola.h"
 #include "session.h"
+#include "threadrole.h"
 
 class echoc_var_t : public TASCAR::module_base_t {
 public:
@@ -172,6 +173,7 @@ void echoc_mod_t::configure()
 
 void echoc_mod_t::port_service()
 {
+  TASCAR::register_thread(TASCAR::thread_roles_t::background);
   size_t pcnt = 100;
   while(run_port_service) {
     usleep(10000);
@@ -78,16 +78,11 @@ sensorplugin_t::sensorplugin_t(const sensorplugin_cfg_t& cfg)
   if(gethostname(chostname, 1024) == 0)
     lcfg.hostname = chostname;
   lcfg.modname = modname;
-  lib = dlopen(libname.c_str(), RTLD_NOW);
+  std::string emsg;
+  lib = TASCAR::plugin_registry_t::get().open(libname, emsg);
   if(!lib)
-    throw ErrMsg("Unable to open module \"" + plugintype + "\": " + dlerror());
-  try {
-    sensorplugin_base_t_resolver(&libdata, lcfg, lib, libname);
-  }
-  catch(...) {
-    dlclose(lib);
-    throw;
-  }
+    throw ErrMsg("Unable to open module \"" + plugintype + "\": " + emsg);
+  sensorplugin_base_t_resolver(&libdata, lcfg, lib, libname);
   labstate.set_size_request(20, -1);
   labname.set_size_request(-1, 20);
   vbox.pack_end(libdata->get_gtkframe(), Gtk::PACK_EXPAND_WIDGET);
@@ -153,7 +148,6 @@ bool sensorplugin_t::test_alive()
 sensorplugin_t::~sensorplugin_t()
 {
   delete libdata;
-  dlclose(lib);
 }
 
 void error_message(const std::string& msg)
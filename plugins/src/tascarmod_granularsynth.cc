@@ -24,6 +24,7 @@
 #include "levelmeter.h"
 #include "ola.h"
 #include "session.h"
+#include "threadrole.h"
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
@@ -424,6 +425,7 @@ int granularsynth_t::inner_process(jack_nframes_t n,
 
 void granularsynth_t::sendthread()
 {
+  TASCAR::register_thread(TASCAR::thread_roles_t::network);
   std::unique_lock<std::mutex> lk(mtx);
   while(run_thread) {
     cond.wait_for(lk, 100ms);
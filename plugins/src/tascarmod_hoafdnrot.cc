@@ -19,7 +19,7 @@
  * Version 3 along with TASCAR. If not, see <http://www.gnu.org/licenses/>.
  */
 
-#include "fft.h"
+#include "hoafdn.h"
 #include "jackclient.h"
 #include "session.h"
 #include <cmath>
@@ -28,327 +28,6 @@
 #include <string.h>
 
 const std::complex<float> i_f(0.0f, 1.0f);
-const std::complex<double> i_d(0.0, 1.0);
-
-class cmat3_t {
-public:
-  cmat3_t(uint32_t d1, uint32_t d2, uint32_t d3);
-  ~cmat3_t();
-  inline std::complex<float>& elem(uint32_t p1, uint32_t p2, uint32_t p3)
-  {
-    return data[p1 * s23 + p2 * s3 + p3];
-  };
-  inline const std::complex<float>& elem(uint32_t p1, uint32_t p2,
-                                         uint32_t p3) const
-  {
-    return data[p1 * s23 + p2 * s3 + p3];
-  };
-  inline std::complex<float>& elem000() { return data[0]; };
-  inline const std::complex<float>& elem000() const { return data[0]; };
-  inline std::complex<float>& elem00x(uint32_t p3) { return data[p3]; };
-  inline const std::complex<float>& elem00x(uint32_t p3) const
-  {
-    return data[p3];
-  };
-  inline void clear()
-  {
-    data.clear();
-    // memset(data,0,sizeof(std::complex<float>)*s1*s2*s3);
-  };
-
-protected:
-  uint32_t s1;
-  uint32_t s2;
-  uint32_t s3;
-  uint32_t s23;
-  TASCAR::spec_t data;
-};
-
-class cmat2_t {
-public:
-  cmat2_t(uint32_t d1, uint32_t d2);
-  ~cmat2_t();
-  inline std::complex<float>& elem(uint32_t p1, uint32_t p2)
-  {
-    return data[p1 * s2 + p2];
-  };
-  inline const std::complex<float>& elem(uint32_t p1, uint32_t p2) const
-  {
-    return data[p1 * s2 + p2];
-  };
-  inline std::complex<float>& elem00() { return data[0]; };
-  inline const std::complex<float>& elem00() const { return data[0]; };
-  inline std::complex<float>& elem0x(uint32_t p2) { return data[p2]; };
-  inline const std::complex<float>& elem0x(uint32_t p2) const
-  {
-    return data[p2];
-  };
-  inline void clear()
-  {
-    data.clear();
-    // memset(data,0,sizeof(std::complex<float>)*s1*s2);
-  };
-
-protected:
-  uint32_t s1;
-  uint32_t s2;
-  TASCAR::spec_t data;
-};
-
-class cmat1_t {
-public:
-  cmat1_t(uint32_t d1);
-  ~cmat1_t();
-  inline std::complex<float>& elem(uint32_t p1) { return data[p1]; };
-  inline const std::complex<float>& elem(uint32_t p1) const
-  {
-    return data[p1];
-  };
-  inline std::complex<float>& elem0() { return data[0]; };
-  inline const std::complex<float>& elem0() const { return data[0]; };
-  inline void clear() { data.clear(); };
-
-protected:
-  uint32_t s1;
-  TASCAR::spec_t data;
-};
-
-cmat3_t::cmat3_t(uint32_t d1, uint32_t d2, uint32_t d3)
-    : s1(d1), s2(d2), s3(d3), s23(s2 * s3), data(s1 * s2 * s3)
-{
-  clear();
-}
-
-cmat3_t::~cmat3_t() {}
-
-cmat2_t::cmat2_t(uint32_t d1, uint32_t d2) : s1(d1), s2(d2), data(s1 * s2)
-{
-  clear();
-}
-
-cmat2_t::~cmat2_t() {}
-
-cmat1_t::cmat1_t(uint32_t d1) : s1(d1), data(s1)
-{
-  clear();
-}
-
-cmat1_t::~cmat1_t() {}
-
-// y[n] = -g x[n] + x[n-1] + g y[n-1]
-class reflectionfilter_t {
-public:
-  reflectionfilter_t(uint32_t d1, uint32_t d2);
-  inline void filter(std::complex<float>& x, uint32_t p1, uint32_t p2)
-  {
-    x = B1 * x - A2 * sy.elem(p1, p2);
-    sy.elem(p1, p2) = x;
-    // all pass section:
-    std::complex<float> tmp(eta[p1] * x + sapx.elem(p1, p2));
-    sapx.elem(p1, p2) = x;
-    x = tmp - eta[p1] * sapy.elem(p1, p2);
-    sapy.elem(p1, p2) = x;
-  };
-  void set_lp(float g, float c);
-
-protected:
-  float B1;
-  float A2;
-  std::vector<float> eta;
-  cmat2_t sy;
-  cmat2_t sapx;
-  cmat2_t sapy;
-};
-
-reflectionfilter_t::reflectionfilter_t(uint32_t d1, uint32_t d2)
-    : B1(0), A2(0), sy(d1, d2), sapx(d1, d2), sapy(d1, d2)
-{
-  eta.resize(d1);
-  for(uint32_t k = 0; k < d1; ++k)
-    eta[k] = 0.87f * (float)k / (float)(d1 - 1);
-}
-
-void reflectionfilter_t::set_lp(float g, float c)
-{
-  sy.clear();
-  sapx.clear();
-  sapy.clear();
-  float c2(1.0f - c);
-  B1 = g * c2;
-  A2 = -c;
-}
-
-class fdn_t {
-public:
-  fdn_t(uint32_t fdnorder, uint32_t amborder, uint32_t maxdelay, bool logdelays,
-        bool dumpmatrix_);
-  ~fdn_t();
-  inline void process(bool b_prefilt);
-  void setpar(float az, float daz, float t, float dt, float g, float damping);
-  void set_logdelays(bool ld) { logdelays_ = ld; };
-
-private:
-  bool logdelays_;
-  uint32_t fdnorder_;
-  uint32_t amborder1;
-  uint32_t maxdelay_;
-  // delayline:
-  cmat3_t delayline;
-  // feedback matrix:
-  cmat3_t feedbackmat;
-  // reflection filter:
-  reflectionfilter_t reflection;
-  reflectionfilter_t prefilt;
-  // rotation:
-  cmat2_t rotation;
-  // delayline output for reflection filters:
-  cmat2_t dlout;
-  // delays:
-  uint32_t* delay;
-  // delayline pointer:
-  uint32_t* pos;
-  // show feedback matrix on console:
-  bool dumpmatrix;
-
-public:
-  // input HOA sample:
-  cmat1_t inval;
-  // output HOA sample:
-  cmat1_t outval;
-};
-
-fdn_t::fdn_t(uint32_t fdnorder, uint32_t amborder, uint32_t maxdelay,
-             bool logdelays, bool dumpmatrix_)
-    : logdelays_(logdelays), fdnorder_(fdnorder), amborder1(amborder + 1),
-      maxdelay_(maxdelay), delayline(fdnorder_, maxdelay_, amborder1),
-      feedbackmat(fdnorder_, fdnorder_, amborder1),
-      reflection(fdnorder, amborder1), prefilt(2, amborder1),
-      rotation(fdnorder, amborder1), dlout(fdnorder_, amborder1),
-      delay(new uint32_t[fdnorder_]), pos(new uint32_t[fdnorder_]),
-      dumpmatrix(dumpmatrix_), inval(amborder1), outval(amborder1)
-{
-  // DEBUG(fdnorder);
-  memset(delay, 0, sizeof(uint32_t) * fdnorder_);
-  memset(pos, 0, sizeof(uint32_t) * fdnorder_);
-}
-
-fdn_t::~fdn_t()
-{
-  delete[] delay;
-  delete[] pos;
-}
-
-void fdn_t::process(bool b_prefilt)
-{
-  if(b_prefilt) {
-    for(uint32_t o = 0; o < amborder1; ++o) {
-      prefilt.filter(inval.elem(o), 0, o);
-      prefilt.filter(inval.elem(o), 1, o);
-    }
-  }
-  outval.clear();
-  // get output values from delayline, apply reflection filters and rotation:
-  for(uint32_t tap = 0; tap < fdnorder_; ++tap)
-    for(uint32_t o = 0; o < amborder1; ++o) {
-      std::complex<float> tmp(delayline.elem(tap, pos[tap], o));
-      reflection.filter(tmp, tap, o);
-      tmp *= rotation.elem(tap, o);
-      dlout.elem(tap, o) = tmp;
-      outval.elem(o) += tmp;
-    }
-  // put rotated+attenuated value to delayline, add input:
-  for(uint32_t tap = 0; tap < fdnorder_; ++tap) {
-    // first put input into delayline:
-    for(uint32_t o = 0; o < amborder1; ++o)
-      delayline.elem(tap, pos[tap], o) = inval.elem(o);
-    // now add feedback signal:
-    for(uint32_t otap = 0; otap < fdnorder_; ++otap)
-      for(uint32_t o = 0; o < amborder1; ++o)
-        delayline.elem(tap, pos[tap], o) +=
-            dlout.elem(otap, o) * feedbackmat.elem(tap, otap, o);
-    // iterate delayline:
-    if(!pos[tap])
-      pos[tap] = delay[tap];
-    if(pos[tap])
-      --pos[tap];
-  }
-}
-
-/**
-   \brief Set parameters of FDN
-   \param az Average rotation in radians per reflection
-   \param daz Spread of rotation in radians per reflection
-   \param t Average/maximum delay in samples
-   \param dt Spread of delay in samples
-   \param g Gain
-   \param damping Damping
- */
-void fdn_t::setpar(float az, float daz, float t, float dt, float g,
-                   float damping)
-{
-  // set reflection filters:
-  reflection.set_lp(g, damping);
-  prefilt.set_lp(g, damping);
-  // reflection.set( g );
-  // set delays:
-  delayline.clear();
-  for(uint32_t tap = 0; tap < fdnorder_; ++tap) {
-    float t_(t);
-    if(logdelays_) {
-      if(fdnorder_ > 1)
-        t_ = dt * pow(t / dt, (float)tap / ((float)fdnorder_ - 1.0f));
-      ;
-    } else {
-      if(fdnorder_ > 1)
-        t_ = t - dt +
-             2.0f * dt * powf((float)tap * 1.0f / (float)fdnorder_, 0.5f);
-    }
-    uint32_t d((uint32_t)std::max(0.0f, t_));
-    delay[tap] = std::max(2u, std::min(maxdelay_ - 1u, d));
-  }
-  // set rotation:
-  for(uint32_t tap = 0; tap < fdnorder_; ++tap) {
-    float laz(az);
-    if(fdnorder_ > 1)
-      laz = az - daz + 2.0f * daz * (float)tap / ((float)fdnorder_ - 1.0f);
-    std::complex<float> caz(std::exp(i_f * laz));
-    rotation.elem(tap, 0) = 1.0;
-    for(uint32_t o = 1; o < amborder1; ++o) {
-      rotation.elem(tap, o) = rotation.elem(tap, o - 1) * caz;
-    }
-  }
-  // set feedback matrix:
-  feedbackmat.clear();
-  if(fdnorder_ > 1) {
-    TASCAR::fft_t fft(fdnorder_);
-    TASCAR::spec_t eigenv(fdnorder_ / 2 + 1);
-    for(uint32_t k = 0; k < eigenv.n_; ++k)
-      eigenv[k] =
-          std::exp(i_d * TASCAR_2PI * pow((double)k / (0.5 * fdnorder_), 2.0));
-    ;
-    fft.execute(eigenv);
-    for(uint32_t itap = 0; itap < fdnorder_; ++itap) {
-      for(uint32_t otap = 0; otap < fdnorder_; ++otap) {
-        feedbackmat.elem(itap, otap, 0) =
-            fft.w[(otap + fdnorder_ - itap) % fdnorder_];
-        for(uint32_t o = 1; o < amborder1; ++o)
-          feedbackmat.elem(itap, otap, o) = feedbackmat.elem(itap, otap, o - 1);
-      }
-    }
-  } else {
-    for(uint32_t o = 0; o < amborder1; ++o)
-      feedbackmat.elem00x(o) = 1.0;
-  }
-  if(dumpmatrix) {
-    std::cout << "m=[..." << std::endl;
-    for(uint32_t itap = 0; itap < fdnorder_; ++itap) {
-      for(uint32_t otap = 0; otap < fdnorder_; ++otap)
-        std::cout << std::real(feedbackmat.elem(itap, otap, 0)) << "  ";
-      std::cout << ";..." << std::endl;
-    }
-    std::cout << "];" << std::endl;
-  }
-}
 
 class hoafdnrot_vars_t : public TASCAR::module_base_t {
 public:
@@ -370,6 +49,7 @@ protected:
   bool prefilt = false;
   bool logdelays = false;
   bool dumpmatrix = false;
+  std::string feedback = "dense";
 };
 
 hoafdnrot_vars_t::hoafdnrot_vars_t(const TASCAR::module_cfg_t& cfg)
@@ -390,6 +70,9 @@ hoafdnrot_vars_t::hoafdnrot_vars_t(const TASCAR::module_cfg_t& cfg)
   GET_ATTRIBUTE_BOOL(logdelays,
                      "Use logarithmic delay distribution between dt and t");
   GET_ATTRIBUTE_BOOL(dumpmatrix, "Dump feedback matrix on console");
+  GET_ATTRIBUTE(feedback, "",
+                "Feedback matrix type, dense (circulant), householder or "
+                "hadamard (requires power of two FDN order)");
 }
 
 hoafdnrot_vars_t::~hoafdnrot_vars_t() {}
@@ -411,14 +94,18 @@ public:
 
 private:
   uint32_t channels;
-  fdn_t* fdn;
+  TASCAR::hoa2d_fdn_t* fdn;
+  TASCAR::hoa2d_fdn_t::feedback_t fbtype;
+  TASCAR::cmat2_t* inblock;
+  TASCAR::cmat2_t* outblock;
   uint32_t o1;
   pthread_mutex_t mtx;
 };
 
 hoafdnrot_t::hoafdnrot_t(const TASCAR::module_cfg_t& cfg)
     : hoafdnrot_vars_t(cfg), jackc_t(id), channels(amborder * 2 + 1), fdn(NULL),
-      o1(amborder + 1)
+      fbtype(TASCAR::hoa2d_fdn_feedback_type(feedback)), inblock(NULL),
+      outblock(NULL), o1(amborder + 1)
 {
   pthread_mutex_init(&mtx, NULL);
   for(uint32_t c = 0; c < channels; ++c) {
@@ -470,8 +157,14 @@ void hoafdnrot_t::configure()
   module_base_t::configure();
   if(fdn)
     delete fdn;
-  fdn =
-      new fdn_t(fdnorder, amborder, (uint32_t)f_sample, logdelays, dumpmatrix);
+  if(inblock)
+    delete inblock;
+  if(outblock)
+    delete outblock;
+  fdn = new TASCAR::hoa2d_fdn_t(fdnorder, amborder, (uint32_t)f_sample,
+                                logdelays, dumpmatrix, fbtype, n_fragment);
+  inblock = new TASCAR::cmat2_t(n_fragment, o1);
+  outblock = new TASCAR::cmat2_t(n_fragment, o1);
   set_par(w, dw, t, dt, decay, damping);
 }
 
@@ -479,6 +172,8 @@ hoafdnrot_t::~hoafdnrot_t()
 {
   deactivate();
   delete fdn;
+  delete inblock;
+  delete outblock;
   pthread_mutex_destroy(&mtx);
 }
 
@@ -524,17 +219,40 @@ int hoafdnrot_t::process(jack_nframes_t n, const std::vector<float*>& sIn,
       for(uint32_t c = 0; c < channels; ++c)
         for(uint32_t t = 0; t < n; t++)
           sOut[c][t] = dry * sIn[c][t];
-      for(uint32_t t = 0; t < n; t++) {
-        fdn->inval.elem0() = sIn[0][t];
-        for(uint32_t o = 1; o < o1; ++o)
-          // ACN!
-          fdn->inval.elem(o) = sIn[2 * o][t] + sIn[2 * o - 1][t] * i_f;
-        fdn->process(prefilt);
-        sOut[0][t] += wet * fdn->outval.elem0().real();
-        for(uint32_t o = 1; o < o1; ++o) {
-          // ACN!
-          sOut[2 * o][t] += wet * fdn->outval.elem(o).real();
-          sOut[2 * o - 1][t] += wet * fdn->outval.elem(o).imag();
+      if(fbtype == TASCAR::hoa2d_fdn_t::dense) {
+        for(uint32_t t = 0; t < n; t++) {
+          fdn->inval.elem0() = sIn[0][t];
+          for(uint32_t o = 1; o < o1; ++o)
+            // ACN!
+            fdn->inval.elem(o) = sIn[2 * o][t] + sIn[2 * o - 1][t] * i_f;
+          fdn->process(prefilt);
+          sOut[0][t] += wet * fdn->outval.elem0().real();
+          for(uint32_t o = 1; o < o1; ++o) {
+            // ACN!
+            sOut[2 * o][t] += wet * fdn->outval.elem(o).real();
+            sOut[2 * o - 1][t] += wet * fdn->outval.elem(o).imag();
+          }
+        }
+      } else {
+        // process in chunks of the block size of the FDN:
+        for(uint32_t t0 = 0; t0 < n; t0 += n_fragment) {
+          const uint32_t nb(std::min(n - t0, n_fragment));
+          for(uint32_t t = 0; t < nb; t++) {
+            inblock->elem(t, 0) = sIn[0][t0 + t];
+            for(uint32_t o = 1; o < o1; ++o)
+              // ACN!
+              inblock->elem(t, o) =
+                  sIn[2 * o][t0 + t] + sIn[2 * o - 1][t0 + t] * i_f;
+          }
+          fdn->process(*inblock, *outblock, nb, prefilt);
+          for(uint32_t t = 0; t < nb; t++) {
+            sOut[0][t0 + t] += wet * outblock->elem(t, 0).real();
+            for(uint32_t o = 1; o < o1; ++o) {
+              // ACN!
+              sOut[2 * o][t0 + t] += wet * outblock->elem(t, o).real();
+              sOut[2 * o - 1][t0 + t] += wet * outblock->elem(t, o).imag();
+            }
+          }
         }
       }
     }
@@ -20,6 +20,7 @@
  * Version 3 along with TASCAR. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "osc_sender.h"
 #include "session.h"
 #include <lsl_cpp.h>
 
@@ -35,14 +36,12 @@ private:
   std::vector<std::string> pattern;
   std::vector<std::string> noisepattern;
   uint32_t ttl;
-  lo_address target;
+  double maxrate = 0.0;
   std::vector<TASCAR::Scene::audio_port_t*> ports;
   std::vector<TASCAR::Scene::audio_port_t*> noiseports;
   std::vector<TASCAR::Scene::route_t*> routes;
   std::vector<TASCAR::Scene::route_t*> noiseroutes;
-  std::vector<lo_message> vmsg;
-  std::vector<lo_arg**> vargv;
-  std::vector<std::string> vpath;
+  std::vector<TASCAR::osc_sender_t::message_t*> vmsg;
   std::vector<lsl::stream_outlet*> voutlet;
   bool calcsnr = false;
 };
@@ -55,10 +54,8 @@ levels2osc_t::levels2osc_t(const TASCAR::module_cfg_t& cfg)
   GET_ATTRIBUTE(noisepattern, "",
                 "Source port names for noise signals, to calculate SNR");
   GET_ATTRIBUTE(ttl, "", "Time to live of OSC multicast messages");
-  target = lo_address_new_from_url(url.c_str());
-  if(!target)
-    throw TASCAR::ErrMsg("Unable to create target adress \"" + url + "\".");
-  lo_address_set_ttl(target, ttl);
+  GET_ATTRIBUTE(maxrate, "Hz",
+                "Maximum message rate, or zero to send in every cycle");
 }
 
 void levels2osc_t::configure()
@@ -103,25 +100,23 @@ void levels2osc_t::configure()
             noiseroutes[kr]->get_name() + " has " +
             std::to_string(noiseroutes[kr]->metercnt()) + ".");
       }
+  auto& sender(TASCAR::osc_sender_t::get());
   if(calcsnr) {
     for(size_t kr = 0; kr < routes.size(); ++kr) {
-      vmsg.push_back(lo_message_new());
-      for(uint32_t k = 0; k < routes[kr]->metercnt(); ++k)
-        lo_message_add_float(vmsg.back(), 0);
-      vargv.push_back(lo_message_get_argv(vmsg.back()));
-      vpath.push_back(std::string("/snr/") + routes[kr]->get_name() + "_" +
-                      noiseroutes[kr]->get_name());
+      vmsg.push_back(sender.add_message(
+          url,
+          std::string("/snr/") + routes[kr]->get_name() + "_" +
+              noiseroutes[kr]->get_name(),
+          std::string(routes[kr]->metercnt(), 'f'), true, maxrate, ttl));
       voutlet.push_back(new lsl::stream_outlet(lsl::stream_info(
           routes[kr]->get_name() + "_" + noiseroutes[kr]->get_name(), "snr",
           routes[kr]->metercnt(), f_fragment)));
     }
   } else {
     for(auto it = routes.begin(); it != routes.end(); ++it) {
-      vmsg.push_back(lo_message_new());
-      for(uint32_t k = 0; k < (*it)->metercnt(); ++k)
-        lo_message_add_float(vmsg.back(), 0);
-      vargv.push_back(lo_message_get_argv(vmsg.back()));
-      vpath.push_back(std::string("/level/") + (*it)->get_name());
+      vmsg.push_back(sender.add_message(
+          url, std::string("/level/") + (*it)->get_name(),
+          std::string((*it)->metercnt(), 'f'), true, maxrate, ttl));
       voutlet.push_back(new lsl::stream_outlet(lsl::stream_info(
           (*it)->get_name(), "level", (*it)->metercnt(), f_fragment)));
     }
@@ -131,10 +126,9 @@ void levels2osc_t::configure()
 levels2osc_t::~levels2osc_t()
 {
   for(uint32_t k = 0; k < vmsg.size(); ++k)
-    lo_message_free(vmsg[k]);
+    TASCAR::osc_sender_t::get().remove_message(vmsg[k]);
   for(uint32_t k = 0; k < voutlet.size(); ++k)
     delete voutlet[k];
-  lo_address_free(target);
 }
 
 void levels2osc_t::update(uint32_t, bool)
@@ -148,8 +142,8 @@ void levels2osc_t::update(uint32_t, bool)
       voutlet[kr]->push_sample(leveldata);
       uint32_t n(leveldata.size());
       for(uint32_t km = 0; km < n; ++km)
-        vargv[kr][km]->f = leveldata[km];
-      lo_send_message(target, vpath[kr].c_str(), vmsg[kr]);
+        vmsg[kr]->set_float(km, leveldata[km]);
+      vmsg[kr]->post();
     }
   } else {
     uint32_t k = 0;
@@ -158,8 +152,8 @@ void levels2osc_t::update(uint32_t, bool)
       voutlet[k]->push_sample(leveldata);
       uint32_t n(leveldata.size());
       for(uint32_t km = 0; km < n; ++km)
-        vargv[k][km]->f = leveldata[km];
-      lo_send_message(target, vpath[k].c_str(), vmsg[k]);
+        vmsg[k]->set_float(km, leveldata[km]);
+      vmsg[k]->post();
       ++k;
     }
   }
@@ -25,6 +25,8 @@
 
 #include "dmxdriver.h"
 
+#include <Eigen/Core>
+#include <chrono>
 #include <cmath>
 #include <unistd.h>
 
@@ -199,6 +201,7 @@ public:
 
 private:
   void read_calib(size_t k, tsccfg::node_t src);
+  void update_weights(uint32_t kobj, const TASCAR::pos_t& pobj);
   TASCAR::session_t* session;
   // config variables:
   std::string name;
@@ -209,6 +212,7 @@ private:
   float master;
   std::string method;
   bool mixmax;
+  float tolerance;
   // derived params:
   TASCAR::named_object_t parent_;
   std::vector<TASCAR::named_object_t> objects_;
@@ -227,6 +231,18 @@ private:
   std::vector<std::string> labels;
   bool usecalib;
   bool sendsquared;
+  // cached geometric weights of objects (rows) and fixtures (columns):
+  Eigen::MatrixXf weights;
+  // DMX values of objects (rows) and channels (columns):
+  Eigen::MatrixXf objdmx;
+  // parameters used for the weights of each object:
+  struct weight_param_t {
+    TASCAR::pos_t pos;
+    method_t method = nearest;
+    float w = 0.0f;
+    bool valid = false;
+  };
+  std::vector<weight_param_t> weight_params;
 };
 
 void lightscene_t::validate_attributes(std::string& msg) const
@@ -238,7 +254,8 @@ void lightscene_t::validate_attributes(std::string& msg) const
 lightscene_t::lightscene_t(const TASCAR::module_cfg_t& cfg)
     : xml_element_t(cfg.xmlsrc), session(cfg.session), name("lightscene"),
       fixtures(e, false, "fixture"), channels(3), master(1), mixmax(false),
-      parent_(NULL, "", NULL), usecalib(true), sendsquared(false)
+      tolerance(0.001f), parent_(NULL, "", NULL), usecalib(true),
+      sendsquared(false)
 {
   GET_ATTRIBUTE(name, "", "Scene name");
   GET_ATTRIBUTE(objects, "", "Pattern of objects to track");
@@ -250,6 +267,9 @@ lightscene_t::lightscene_t(const TASCAR::module_cfg_t& cfg)
   GET_ATTRIBUTE_BOOL(sendsquared,
                      "Send squared values for smoother intensity fades");
   GET_ATTRIBUTE_BOOL_(mixmax);
+  GET_ATTRIBUTE(tolerance, "",
+                "Change of object direction (distance of unit vectors) "
+                "above which fixture weights are recomputed");
   std::string method;
   method_t method_(nearest);
   GET_ATTRIBUTE_(method);
@@ -317,6 +337,9 @@ lightscene_t::lightscene_t(const TASCAR::module_cfg_t& cfg)
     }
   }
   objval.resize(objects_.size());
+  weights = Eigen::MatrixXf::Zero(objects_.size(), fixtures.size());
+  objdmx = Eigen::MatrixXf::Zero(objects_.size(), channels);
+  weight_params.resize(objects_.size());
   //
   uint32_t i(0);
   for(uint32_t k = 0; k < objects_.size(); ++k) {
@@ -350,6 +373,72 @@ void lightscene_t::read_calib(size_t k, tsccfg::node_t src)
   }
 }
 
+void lightscene_t::update_weights(uint32_t kobj, const TASCAR::pos_t& pobj)
+{
+  switch(objval[kobj].method) {
+  case nearest: {
+    double dmax(-1);
+    uint32_t kmax(0);
+    for(uint32_t kfix = 0; kfix < fixtures.size(); ++kfix) {
+      double caz(dot_prod(pobj, fixtures[kfix].unitvector));
+      if(caz > dmax) {
+        kmax = kfix;
+        dmax = caz;
+      }
+    }
+    weights.row(kobj).setZero();
+    weights(kobj, kmax) = 1.0f;
+  } break;
+  case raisedcosine: {
+    for(uint32_t kfix = 0; kfix < fixtures.size(); ++kfix) {
+      float caz(dot_prod(pobj, fixtures[kfix].unitvector));
+      float w(powf(0.5f * (caz + 1.0f), 2.0f / objval[kobj].w));
+      weights(kobj, kfix) = w;
+    }
+  } break;
+  case truncated: {
+    for(uint32_t kfix = 0; kfix < fixtures.size(); ++kfix) {
+      float caz(dot_prod(pobj, fixtures[kfix].unitvector));
+      float w(2.0f * std::max(0.0f, powf(0.5f * (caz + 1.0f),
+                                         2.0f / objval[kobj].w) -
+                                        0.5f));
+      weights(kobj, kfix) = w;
+    }
+  } break;
+  case sawleft: {
+    for(uint32_t kfix = 0; kfix < fixtures.size(); ++kfix) {
+      float az(objval[kobj].w *
+               std::arg((pobj.x + i * pobj.y) *
+                        (fixtures[kfix].unitvector.x -
+                         i * fixtures[kfix].unitvector.y)));
+      float w(0);
+      if(az >= 0)
+        w = 1.0f - std::min(1.0f, az);
+      weights(kobj, kfix) = w;
+    }
+  } break;
+  case sawright: {
+    for(uint32_t kfix = 0; kfix < fixtures.size(); ++kfix) {
+      float az(-objval[kobj].w *
+               std::arg((pobj.x + i * pobj.y) *
+                        (fixtures[kfix].unitvector.x -
+                         i * fixtures[kfix].unitvector.y)));
+      float w(0);
+      if(az >= 0)
+        w = 1.0f - std::min(1.0f, az);
+      weights(kobj, kfix) = w;
+    }
+  } break;
+  case rect: {
+    for(uint32_t kfix = 0; kfix < fixtures.size(); ++kfix) {
+      float caz(dot_prod(pobj, fixtures[kfix].unitvector));
+      float w(powf(0.5f * (caz + 1.0f), 2.0f / objval[kobj].w) > 0.5);
+      weights(kobj, kfix) = w;
+    }
+  } break;
+  }
+}
+
 void lightscene_t::update(uint32_t, bool, double t_fragment)
 {
   for(std::vector<lobj_t>::iterator it = objval.begin(); it != objval.end();
@@ -369,80 +458,24 @@ void lightscene_t::update(uint32_t, bool, double t_fragment)
       pobj -= self_pos;
       pobj /= self_rot;
       pobj.normalize();
-      switch(objval[kobj].method) {
-      case nearest: {
-        // do panning / copy data
-        double dmax(-1);
-        double kmax(0);
-        for(uint32_t kfix = 0; kfix < fixtures.size(); ++kfix) {
-          double caz(dot_prod(pobj, fixtures[kfix].unitvector));
-          if(caz > dmax) {
-            kmax = kfix;
-            dmax = caz;
-          }
-        }
-        for(uint32_t c = 0; c < channels; ++c)
-          tmpdmxdata[channels * kmax + c] += objval[kobj].dmx[c];
-      } break;
-      case raisedcosine: {
-        // do panning / copy data
-        for(uint32_t kfix = 0; kfix < fixtures.size(); ++kfix) {
-          float caz(dot_prod(pobj, fixtures[kfix].unitvector));
-          float w(powf(0.5f * (caz + 1.0f), 2.0f / objval[kobj].w));
-          for(uint32_t c = 0; c < channels; ++c)
-            tmpdmxdata[channels * kfix + c] += w * objval[kobj].dmx[c];
-        }
-      } break;
-      case truncated: {
-        // do panning / copy data
-        for(uint32_t kfix = 0; kfix < fixtures.size(); ++kfix) {
-          float caz(dot_prod(pobj, fixtures[kfix].unitvector));
-          float w(2.0f * std::max(0.0f, powf(0.5f * (caz + 1.0f),
-                                             2.0f / objval[kobj].w) -
-                                            0.5f));
-          for(uint32_t c = 0; c < channels; ++c)
-            tmpdmxdata[channels * kfix + c] += w * objval[kobj].dmx[c];
-        }
-      } break;
-      case sawleft: {
-        // do panning / copy data
-        for(uint32_t kfix = 0; kfix < fixtures.size(); ++kfix) {
-          float az(objval[kobj].w *
-                   std::arg((pobj.x + i * pobj.y) *
-                            (fixtures[kfix].unitvector.x -
-                             i * fixtures[kfix].unitvector.y)));
-          float w(0);
-          if(az >= 0)
-            w = 1.0f - std::min(1.0f, az);
-          for(uint32_t c = 0; c < channels; ++c)
-            tmpdmxdata[channels * kfix + c] += w * objval[kobj].dmx[c];
-        }
-      } break;
-      case sawright: {
-        // do panning / copy data
-        for(uint32_t kfix = 0; kfix < fixtures.size(); ++kfix) {
-          float az(-objval[kobj].w *
-                   std::arg((pobj.x + i * pobj.y) *
-                            (fixtures[kfix].unitvector.x -
-                             i * fixtures[kfix].unitvector.y)));
-          float w(0);
-          if(az >= 0)
-            w = 1.0f - std::min(1.0f, az);
-          for(uint32_t c = 0; c < channels; ++c)
-            tmpdmxdata[channels * kfix + c] += w * objval[kobj].dmx[c];
-        }
-      } break;
-      case rect: {
-        // do panning / copy data
-        for(uint32_t kfix = 0; kfix < fixtures.size(); ++kfix) {
-          float caz(dot_prod(pobj, fixtures[kfix].unitvector));
-          float w(powf(0.5f * (caz + 1.0f), 2.0f / objval[kobj].w) > 0.5);
-          for(uint32_t c = 0; c < channels; ++c)
-            tmpdmxdata[channels * kfix + c] += w * objval[kobj].dmx[c];
-        }
-      } break;
+      // recompute weights only if object moved or parameters changed:
+      weight_param_t& par(weight_params[kobj]);
+      if((!par.valid) || (par.method != objval[kobj].method) ||
+         (par.w != objval[kobj].w) || (distance(par.pos, pobj) > tolerance)) {
+        update_weights(kobj, pobj);
+        par.pos = pobj;
+        par.method = objval[kobj].method;
+        par.w = objval[kobj].w;
+        par.valid = true;
       }
+      for(uint32_t c = 0; c < channels; ++c)
+        objdmx(kobj, c) = objval[kobj].dmx[c];
     }
+    // colour mix of all objects and fixtures, tmpdmxdata is a channels x
+    // fixtures matrix:
+    Eigen::Map<Eigen::MatrixXf> mix(tmpdmxdata.data(), channels,
+                                    fixtures.size());
+    mix.noalias() = objdmx.transpose().lazyProduct(weights);
   }
   for(uint32_t kfix = 0; kfix < fixtures.size(); ++kfix) {
     if(mixmax) {
@@ -538,9 +571,12 @@ private:
   std::string driver;
   double fps;
   uint32_t universe;
+  std::string sendmode = "full";
+  double keepalive = 1.0;
   // derived params:
   std::vector<lightscene_t*> lightscenes;
   DMX::driver_t* driver_;
+  DMX::delta_sender_t* sender = NULL;
   // optional raw OSC receiver:
   TASCAR::osc_server_t* rawsrv = NULL;
   std::string rawsrvhost;
@@ -563,6 +599,13 @@ lightctl_t::lightctl_t(const TASCAR::module_cfg_t& cfg)
   GET_ATTRIBUTE(fps, "Hz", "Frames per second");
   GET_ATTRIBUTE(universe, "", "DMX universe");
   // GET_ATTRIBUTE_(priority);
+  GET_ATTRIBUTE(sendmode, "``full'', ``universe'' or ``slots''",
+                "DMX transmission mode: full universe in every frame, or "
+                "only changed universes or slots");
+  GET_ATTRIBUTE(keepalive, "s",
+                "Maximum interval between transmissions of unchanged "
+                "universes");
+  DMX::delta_sender_t::mode_t mode(DMX::delta_sender_t::get_mode(sendmode));
   GET_ATTRIBUTE(driver, "``artnetdmx'', ``opendmxusb'', or ``osc''",
                 "Driver name");
   if(driver == "artnetdmx") {
@@ -607,6 +650,7 @@ lightctl_t::lightctl_t(const TASCAR::module_cfg_t& cfg)
         "Unknown DMX driver type \"" + driver +
         "\" (must be \"artnetdmx\", \"osc\" or \"opendmxusb\").");
   }
+  sender = new DMX::delta_sender_t(driver_, mode, keepalive);
   GET_ATTRIBUTE(hue_warp_x, "", "Hue warping x offset");
   GET_ATTRIBUTE(hue_warp_y, "", "Hue warping y offset");
   GET_ATTRIBUTE_DEG(hue_warp_rot, "Hue warping rotation");
@@ -669,6 +713,7 @@ lightctl_t::~lightctl_t()
   usleep(100000);
   for(auto it = lightscenes.begin(); it != lightscenes.end(); ++it)
     delete(*it);
+  delete sender;
   if(driver_)
     delete driver_;
   if(rawsrvallocated)
@@ -693,8 +738,10 @@ void lightctl_t::service()
       for(uint32_t k = 0; k < scene->dmxaddr.size(); ++k)
         localdata[scene->dmxaddr[k]] =
             std::min((uint16_t)255, scene->dmxdata[k]);
-    if(driver_)
-      driver_->send(universe, localdata);
+    sender->send(universe, localdata,
+                 std::chrono::duration<double>(
+                     std::chrono::steady_clock::now().time_since_epoch())
+                     .count());
     usleep(waitusec);
   }
   for(uint32_t k = 0; k < localdata.size(); ++k)
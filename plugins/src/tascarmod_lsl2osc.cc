@@ -18,6 +18,7 @@
  */
 
 #include "session.h"
+#include "threadrole.h"
 #include <lsl_cpp.h>
 #include <mutex>
 #include <thread>
@@ -37,6 +38,7 @@ private:
 
 void lsl2osc_t::scanthread(const std::string& name)
 {
+  TASCAR::register_thread(TASCAR::thread_roles_t::network);
   try {
     std::string oscpath = prefix + "/" + name;
     while(runthreads) {
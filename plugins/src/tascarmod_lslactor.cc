@@ -19,6 +19,7 @@
  */
 
 #include "session.h"
+#include "threadrole.h"
 #include <lsl_cpp.h>
 #include <thread>
 
@@ -68,6 +69,7 @@ lslactor_t::lslactor_t(const TASCAR::module_cfg_t& cfg)
 
 void lslactor_t::service()
 {
+  TASCAR::register_thread(TASCAR::thread_roles_t::network);
   inlet = NULL;
   while((!inlet) && run_service) {
     std::vector<lsl::stream_info> results(lsl::resolve_stream(predicate, 1, 1));
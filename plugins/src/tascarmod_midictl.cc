@@ -22,6 +22,7 @@
 
 #include "alsamidicc.h"
 #include "session.h"
+#include "threadrole.h"
 #include <thread>
 
 class midictl_vars_t : public TASCAR::module_base_t {
@@ -138,6 +139,7 @@ midictl_t::~midictl_t()
 
 void midictl_t::send_service()
 {
+  TASCAR::register_thread(TASCAR::thread_roles_t::background);
   while(run_service) {
     // wait for 100 ms:
     for(uint32_t k = 0; k < 100; ++k)
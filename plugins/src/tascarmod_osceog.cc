@@ -19,6 +19,7 @@
  */
 
 #include "session.h"
+#include "threadrole.h"
 #include <atomic>
 #include <chrono>
 #include <thread>
@@ -127,6 +128,7 @@ osceog_t::~osceog_t()
 
 void osceog_t::connectservice()
 {
+  TASCAR::register_thread(TASCAR::thread_roles_t::network);
   size_t cnt = 0;
   while(run_service) {
     if(tictoc.toc() > 1) {
@@ -19,6 +19,7 @@
  */
 
 #include "session.h"
+#include "threadrole.h"
 #include <atomic>
 #include <chrono>
 #include <thread>
@@ -313,6 +314,7 @@ oscheadtracker_t::~oscheadtracker_t()
 
 void oscheadtracker_t::connectservice()
 {
+  TASCAR::register_thread(TASCAR::thread_roles_t::network);
   size_t cnt = 0;
   while(run_service) {
     if(tictoc.toc() > 1) {
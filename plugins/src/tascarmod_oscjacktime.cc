@@ -19,6 +19,7 @@
  */
 
 #include "session.h"
+#include "threadrole.h"
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
@@ -104,6 +105,7 @@ void oscjacktime_t::update(uint32_t tp_frame, bool)
 
 void oscjacktime_t::sendthread()
 {
+  TASCAR::register_thread(TASCAR::thread_roles_t::network);
   std::unique_lock<std::mutex> lk(mtx);
   while(run_thread) {
     cond.wait_for(lk, 100ms);
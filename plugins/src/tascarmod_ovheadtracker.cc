@@ -18,6 +18,7 @@
  * Version 3 along with TASCAR. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "posepredictor.h"
 #include "serviceclass.h"
 #include "session.h"
 #include <atomic>
@@ -77,6 +78,16 @@ private:
   bool send_only_quaternion = false;
   double autoref = 0.00001;
   double smooth = 0.1;
+  // extrapolate orientation to compensate for latency:
+  bool predict = false;
+  // prediction horizon in seconds, or negative for estimated latency:
+  double predicthorizon = -1.0;
+  // adaptation coefficient of prediction gain:
+  double predictadapt = 0.01;
+  // use gyroscope data for prediction:
+  bool usegyr = false;
+  // latency between sensor and TASCAR in seconds:
+  double transportlatency = 0.01;
   // run-time variables:
   lo_address target = NULL;
   lo_address rottarget = NULL;
@@ -100,6 +111,9 @@ private:
   std::vector<std::string> vpath;
   TASCAR::quaternion_t qstate;
   TASCAR::tictoc_t tictoc;
+  TASCAR::pose_predictor_t predictor;
+  // latency of audio processing in seconds:
+  double blocklatency = 0.0;
 };
 
 void ovheadtracker_t::configure()
@@ -133,6 +147,8 @@ void ovheadtracker_t::configure()
   }
   first_sample_autoref = true;
   first_sample_smooth = true;
+  // one period for processing and one for playback:
+  blocklatency = 2.0 / f_fragment;
   srv_level = std::thread(&ovheadtracker_t::service_level, this);
 }
 
@@ -188,6 +204,18 @@ ovheadtracker_t::ovheadtracker_t(const TASCAR::module_cfg_t& cfg)
   GET_ATTRIBUTE(tilturl, "", "OSC target URL for tilt");
   GET_ATTRIBUTE(tiltpath, "", "OSC path for tilt");
   GET_ATTRIBUTE(tiltmap, "", "tilt mapping, [in1 out1 in2 out2]");
+  GET_ATTRIBUTE_BOOL(predict,
+                     "Extrapolate orientation to compensate for latency");
+  GET_ATTRIBUTE(predicthorizon, "s",
+                "Prediction horizon, or negative to use the estimated latency "
+                "of smoothing, transport and audio processing");
+  GET_ATTRIBUTE(predictadapt, "",
+                "Adaptation coefficient of prediction gain, or zero for no "
+                "adaptive damping");
+  GET_ATTRIBUTE_BOOL(usegyr, "Use gyroscope data for prediction");
+  GET_ATTRIBUTE(transportlatency, "s",
+                "Latency between sensor and TASCAR, used for estimating the "
+                "prediction horizon");
   if(tiltmap.size() != 4)
     throw TASCAR::ErrMsg("Tilt map needs exactly four entries.");
   if(tiltmap[2] == tiltmap[0])
@@ -226,6 +254,10 @@ void ovheadtracker_t::add_variables(TASCAR::osc_server_t* srv)
                   "from average direction, or zero for no auto-referencing");
   srv->add_double(p + "/smooth", &smooth, "[0,1[",
                   "Filter coefficient for smoothing quaternions");
+  srv->add_bool(p + "/predict", &predict,
+                "Extrapolate orientation to compensate for latency");
+  srv->add_double(p + "/predicthorizon", &predicthorizon, "",
+                  "Prediction horizon in s, or negative for estimated latency");
   srv->add_bool(p + "/apply_loc", &apply_loc,
                 "Apply translation based on accelerometer (not implemented)");
   srv->add_bool(p + "/apply_rot", &apply_rot,
@@ -320,6 +352,7 @@ void ovheadtracker_t::service()
       first_sample_autoref = true;
       first_sample_smooth = true;
       bool firstgyrsmooth = true;
+      predictor.reset();
       while(run_service) {
         std::string l(dev.readline(1024, 10));
         if(l.size()) {
@@ -402,6 +435,26 @@ void ovheadtracker_t::service()
               qhp.set_euler_zyx(rotgyr);
               q.rmul(qhp);
             }
+            if(predict) {
+              double t(tictoc.toc());
+              predictor.adaptation = predictadapt;
+              if(predicthorizon >= 0.0)
+                predictor.horizon = predicthorizon;
+              else {
+                // group delay of smoothing filter plus latencies:
+                predictor.horizon = transportlatency + blocklatency;
+                if(smooth > 0.0)
+                  predictor.horizon +=
+                      predictor.get_interval() * (1.0 - smooth) / smooth;
+              }
+              predictor.add_orientation(t, q);
+              q = predictor.predict();
+              if(target && (!send_only_quaternion))
+                lo_send(target, (p + "/prederror").c_str(), "fff",
+                        RAD2DEG * predictor.get_error(),
+                        RAD2DEG * predictor.get_error_unpredicted(),
+                        predictor.get_gain());
+            }
             if(!autoref_zonly) {
               q.lmul(qref);
             } else {
@@ -454,6 +507,11 @@ void ovheadtracker_t::service()
             rotgyr.z = DEG2RAD * data[2];
             rotgyr.y = DEG2RAD * data[1];
             rotgyr.x = DEG2RAD * data[0];
+            if(predict && usegyr)
+              predictor.add_angular_velocity(
+                  tictoc.toc(), TASCAR::pos_t(DEG2RAD * data[0],
+                                              DEG2RAD * data[1],
+                                              DEG2RAD * data[2]));
             if(smooth > 0) {
               if(firstgyrsmooth) {
                 rotgyrmean = rotgyr;
@@ -20,14 +20,10 @@
  * Version 3 along with TASCAR. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "osc_sender.h"
 #include "session.h"
-#include <atomic>
-#include <chrono>
-#include <condition_variable>
-#include <mutex>
-#include <thread>
 
-using namespace std::chrono_literals;
+#define NUM_MODES 13
 
 class pos2osc_t : public TASCAR::module_base_t {
 public:
@@ -55,17 +51,14 @@ private:
   bool sendsounds;
   bool addparentname;
   float oscale = 1.0f;
-  lo_address target;
   std::vector<TASCAR::named_object_t> objects;
   bool bypass = false;
   std::string orientationname = "/headGaze";
   bool threaded = true;
-  std::thread thread;
-  std::atomic_bool run_thread = true;
-  void sendthread();
-  std::mutex mtx;
-  std::condition_variable cond;
-  std::atomic_bool has_data = false;
+  // message slots for each mode and object, the mode can be changed
+  // at run time:
+  std::vector<std::vector<TASCAR::osc_sender_t::message_t*>>
+      msgs[NUM_MODES];
 };
 
 pos2osc_t::pos2osc_t(const TASCAR::module_cfg_t& cfg)
@@ -96,14 +89,10 @@ pos2osc_t::pos2osc_t(const TASCAR::module_cfg_t& cfg)
   GET_ATTRIBUTE(skip, "", "Skip frames to reduce network traffic");
   GET_ATTRIBUTE(oscale, "", "Scaling factor for orientations");
   GET_ATTRIBUTE(orientationname, "", "Name for orientation variables");
-  GET_ATTRIBUTE_BOOL(threaded, "Use additional thread for sending data to "
-                               "avoid blocking of real-time audio thread");
+  GET_ATTRIBUTE_BOOL(threaded, "Unused, data is always sent by the OSC "
+                               "sender thread");
   if(url.empty())
     url = "osc.udp://localhost:9999/";
-  target = lo_address_new_from_url(url.c_str());
-  if(!target)
-    throw TASCAR::ErrMsg("Unable to create target adress \"" + url + "\".");
-  lo_address_set_ttl(target, ttl);
   objects = session->find_objects(pattern);
   if(!objects.size())
     throw TASCAR::ErrMsg("No target objects found (target pattern: \"" +
@@ -125,24 +114,61 @@ pos2osc_t::pos2osc_t(const TASCAR::module_cfg_t& cfg)
     trigger = false;
 }
 
-pos2osc_t::~pos2osc_t()
-{
-  lo_address_free(target);
-}
+pos2osc_t::~pos2osc_t() {}
 
 void pos2osc_t::configure()
 {
   TASCAR::module_base_t::configure();
-  run_thread = true;
-  if(threaded)
-    thread = std::thread(&pos2osc_t::sendthread, this);
+  auto& sender(TASCAR::osc_sender_t::get());
+  // all messages are sent, also if they share the path:
+  auto add = [&](uint32_t m, const std::string& path,
+                 const std::string& typespec,
+                 const std::string& name = "") {
+    auto msg(sender.add_message(url, path, typespec, false, 0.0, ttl, 8u));
+    if(!name.empty())
+      msg->set_string(0, name.c_str());
+    msgs[m].back().push_back(msg);
+  };
+  for(auto& obj : objects) {
+    for(auto& m : msgs)
+      m.emplace_back();
+    std::string objname(obj.obj->get_name());
+    std::string opath("/" + objname);
+    if(avatar.size())
+      opath = "/" + avatar;
+    add(0, obj.name + "/pos", "fff");
+    add(0, obj.name + "/rot", "fff");
+    add(1, obj.name + "/pos", "ffffff");
+    add(2, "/tascarpos", "sffffff", obj.name);
+    add(3, "/tascarpos", "sffffff", objname);
+    TASCAR::Scene::src_object_t* src(
+        dynamic_cast<TASCAR::Scene::src_object_t*>(obj.obj));
+    if(sendsounds && src)
+      for(const auto& isnd : src->sound) {
+        if(addparentname)
+          add(3, "/tascarpos", "sffffff", objname + "." + isnd->get_name());
+        else
+          add(3, "/tascarpos", "sffffff", isnd->get_name());
+      }
+    add(4, "/" + avatar, "sffff", "/lookAt");
+    add(4, "/" + avatar, "sfff", "/lookAt");
+    add(5, "/" + avatar, "f");
+    for(uint32_t m : {6, 7, 9, 10})
+      add(m, opath, "sfff", orientationname);
+    add(8, opath, "fff");
+    add(11, "/" + avatar + "/" + objname, "ffffff");
+    add(12, "/" + avatar, "f");
+  }
 }
 
 void pos2osc_t::release()
 {
-  run_thread = false;
-  if(threaded)
-    thread.join();
+  for(auto& m : msgs) {
+    for(auto& objmsgs : m)
+      for(auto msg : objmsgs)
+        TASCAR::osc_sender_t::get().remove_message(msg);
+    m.clear();
+  }
   TASCAR::module_base_t::release();
 }
 
@@ -150,42 +176,32 @@ void pos2osc_t::update(uint32_t, bool tp_rolling)
 {
   if(bypass)
     return;
-  if(trigger && ((!triggered && (tp_rolling || (!transport))) || triggered)) {
-    if(threaded) {
-      if(mtx.try_lock()) {
-        has_data = true;
-        mtx.unlock();
-      }
-      cond.notify_one();
-    } else {
-      update_local();
-    }
-  }
+  if(trigger && ((!triggered && (tp_rolling || (!transport))) || triggered))
+    update_local();
   if(triggered)
     trigger = false;
 }
 
-void pos2osc_t::sendthread()
+/// Set float arguments, starting at argument k0, and send message
+static void post_floats(TASCAR::osc_sender_t::message_t* msg, size_t k0,
+                        std::initializer_list<float> vals)
 {
-  std::unique_lock<std::mutex> lk(mtx);
-  while(run_thread) {
-    cond.wait_for(lk, 100ms);
-    if(has_data) {
-      update_local();
-      has_data = false;
-    }
-  }
+  for(auto v : vals)
+    msg->set_float(k0++, v);
+  msg->post();
 }
 
 void pos2osc_t::update_local()
 {
+  if(mode >= NUM_MODES)
+    return;
   if(skipcnt)
     skipcnt--;
   else {
     skipcnt = skip;
-    // for(std::vector<TASCAR::named_object_t>::iterator it = obj.begin();
-    // it != obj.end(); ++it) {
-    for(auto& obj : objects) {
+    for(size_t kobj = 0; kobj < objects.size(); ++kobj) {
+      auto& obj(objects[kobj]);
+      const auto& omsgs(msgs[mode][kobj]);
       if(obj.scene->mtx_geometry.try_lock()) {
         // copy position from parent object:
         TASCAR::pos_t p(obj.obj->c6dof.position);
@@ -193,127 +209,98 @@ void pos2osc_t::update_local()
         if(ignoreorientation)
           o = obj.obj->c6dof_nodelta.orientation;
         obj.scene->mtx_geometry.unlock();
-        std::string path;
+        const TASCAR::zyx_euler_t& dori(obj.obj->dorientation);
         switch(mode) {
         case 0:
-          path = obj.name + "/pos";
-          lo_send(target, path.c_str(), "fff", p.x, p.y, p.z);
-          path = obj.name + "/rot";
-          lo_send(target, path.c_str(), "fff", RAD2DEG * o.z * oscale,
-                  RAD2DEG * o.y * oscale, RAD2DEG * o.x * oscale);
+          post_floats(omsgs[0], 0, {(float)p.x, (float)p.y, (float)p.z});
+          post_floats(omsgs[1], 0,
+                      {(float)(RAD2DEG * o.z * oscale),
+                       (float)(RAD2DEG * o.y * oscale),
+                       (float)(RAD2DEG * o.x * oscale)});
           break;
         case 1:
-          path = obj.name + "/pos";
-          lo_send(target, path.c_str(), "ffffff", p.x, p.y, p.z,
-                  RAD2DEG * o.z * oscale, RAD2DEG * o.y * oscale,
-                  RAD2DEG * o.x * oscale);
+          post_floats(omsgs[0], 0,
+                      {(float)p.x, (float)p.y, (float)p.z,
+                       (float)(RAD2DEG * o.z * oscale),
+                       (float)(RAD2DEG * o.y * oscale),
+                       (float)(RAD2DEG * o.x * oscale)});
           break;
         case 2:
-          path = "/tascarpos";
-          lo_send(target, path.c_str(), "sffffff", obj.name.c_str(), p.x, p.y,
-                  p.z, RAD2DEG * o.z * oscale, RAD2DEG * o.y * oscale,
-                  RAD2DEG * o.x * oscale);
-          break;
         case 3:
-          path = "/tascarpos";
-          lo_send(target, path.c_str(), "sffffff", obj.obj->get_name().c_str(),
-                  p.x, p.y, p.z, RAD2DEG * o.z * oscale, RAD2DEG * o.y * oscale,
-                  RAD2DEG * o.x * oscale);
-          if(sendsounds) {
+          post_floats(omsgs[0], 1,
+                      {(float)p.x, (float)p.y, (float)p.z,
+                       (float)(RAD2DEG * o.z * oscale),
+                       (float)(RAD2DEG * o.y * oscale),
+                       (float)(RAD2DEG * o.x * oscale)});
+          if(mode == 3) {
+            // the slots of sound vertices follow the object slot:
             TASCAR::Scene::src_object_t* src(
                 dynamic_cast<TASCAR::Scene::src_object_t*>(obj.obj));
-            if(src) {
-              std::string parentname(obj.obj->get_name());
-              for(const auto& isnd : src->sound) {
-                std::string soundname;
-                if(addparentname)
-                  soundname = parentname + "." + isnd->get_name();
-                else
-                  soundname = isnd->get_name();
+            if(src && (omsgs.size() == src->sound.size() + 1u)) {
+              for(size_t ksnd = 0; ksnd < src->sound.size(); ++ksnd) {
                 if(obj.scene->mtx_geometry.try_lock()) {
-                  auto ipos = isnd->position;
-                  auto iori = isnd->orientation;
+                  auto ipos = src->sound[ksnd]->position;
+                  auto iori = src->sound[ksnd]->orientation;
                   obj.scene->mtx_geometry.unlock();
-                  lo_send(target, path.c_str(), "sffffff", soundname.c_str(),
-                          ipos.x, ipos.y, ipos.z, RAD2DEG * iori.z * oscale,
-                          RAD2DEG * iori.y * oscale, RAD2DEG * iori.x * oscale);
+                  post_floats(omsgs[ksnd + 1u], 1,
+                              {(float)ipos.x, (float)ipos.y, (float)ipos.z,
+                               (float)(RAD2DEG * iori.z * oscale),
+                               (float)(RAD2DEG * iori.y * oscale),
+                               (float)(RAD2DEG * iori.x * oscale)});
                 }
               }
             }
           }
           break;
         case 4:
-          path = "/" + avatar;
           if(lookatlen > 0)
-            lo_send(target, path.c_str(), "sffff", "/lookAt", p.x, p.y, p.z,
-                    lookatlen);
+            post_floats(omsgs[0], 1,
+                        {(float)p.x, (float)p.y, (float)p.z,
+                         (float)lookatlen});
           else
-            lo_send(target, path.c_str(), "sfff", "/lookAt", p.x, p.y, p.z);
+            post_floats(omsgs[1], 1, {(float)p.x, (float)p.y, (float)p.z});
           break;
         case 5:
-          path = "/" + avatar;
-          lo_send(target, path.c_str(), "f", RAD2DEG * o.z * oscale);
+          post_floats(omsgs[0], 0, {(float)(RAD2DEG * o.z * oscale)});
           break;
         case 6:
-          if(avatar.size())
-            path = "/" + avatar;
-          else
-            path = "/" + obj.obj->get_name();
-          lo_send(target, path.c_str(), "sfff", orientationname.c_str(),
-                  obj.obj->dorientation.y * oscale,
-                  obj.obj->dorientation.z * oscale,
-                  obj.obj->dorientation.x * oscale);
+          post_floats(omsgs[0], 1,
+                      {(float)(dori.y * oscale), (float)(dori.z * oscale),
+                       (float)(dori.x * oscale)});
           break;
         case 7:
-          if(avatar.size())
-            path = "/" + avatar;
-          else
-            path = "/" + obj.obj->get_name();
-          lo_send(target, path.c_str(), "sfff", orientationname.c_str(),
-                  o.y * oscale, o.z * oscale, o.x * oscale);
+          post_floats(omsgs[0], 1,
+                      {(float)(o.y * oscale), (float)(o.z * oscale),
+                       (float)(o.x * oscale)});
           break;
         case 8:
-          if(avatar.size())
-            path = "/" + avatar;
-          else
-            path = "/" + obj.obj->get_name();
-          lo_send(target, path.c_str(), "fff",
-                  RAD2DEG * obj.obj->dorientation.z * oscale,
-                  RAD2DEG * obj.obj->dorientation.y * oscale,
-                  RAD2DEG * obj.obj->dorientation.x * oscale);
+          post_floats(omsgs[0], 0,
+                      {(float)(RAD2DEG * dori.z * oscale),
+                       (float)(RAD2DEG * dori.y * oscale),
+                       (float)(RAD2DEG * dori.x * oscale)});
           break;
         case 9:
-          if(avatar.size())
-            path = "/" + avatar;
-          else
-            path = "/" + obj.obj->get_name();
-          lo_send(target, path.c_str(), "sfff", orientationname.c_str(),
-                  obj.obj->dorientation.x * oscale,
-                  obj.obj->dorientation.y * oscale,
-                  obj.obj->dorientation.z * oscale);
+          post_floats(omsgs[0], 1,
+                      {(float)(dori.x * oscale), (float)(dori.y * oscale),
+                       (float)(dori.z * oscale)});
           break;
         case 10:
-          if(avatar.size())
-            path = "/" + avatar;
-          else
-            path = "/" + obj.obj->get_name();
-          lo_send(target, path.c_str(), "sfff", orientationname.c_str(),
-                  obj.obj->dorientation.y * oscale,
-                  obj.obj->dorientation.x * oscale,
-                  obj.obj->dorientation.z * oscale);
+          post_floats(omsgs[0], 1,
+                      {(float)(dori.y * oscale), (float)(dori.x * oscale),
+                       (float)(dori.z * oscale)});
           break;
         case 11:
-          path = "/" + avatar + "/" + obj.obj->get_name();
-          lo_send(target, path.c_str(), "ffffff", p.x, p.y, p.z,
-                  RAD2DEG * o.z * oscale, RAD2DEG * o.y * oscale,
-                  RAD2DEG * o.x * oscale);
-          break;
-        case 12:
-          path = "/" + avatar;
-          TASCAR::pos_t p(0, 0, 1);
-          p *= o;
-          lo_send(target, path.c_str(), "f", (float)(1.0 - p.z));
+          post_floats(omsgs[0], 0,
+                      {(float)p.x, (float)p.y, (float)p.z,
+                       (float)(RAD2DEG * o.z * oscale),
+                       (float)(RAD2DEG * o.y * oscale),
+                       (float)(RAD2DEG * o.x * oscale)});
           break;
+        case 12: {
+          TASCAR::pos_t pz(0, 0, 1);
+          pz *= o;
+          post_floats(omsgs[0], 0, {(float)(1.0 - pz.z)});
+        } break;
         }
       }
     }